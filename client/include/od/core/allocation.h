@@ -2,14 +2,34 @@
 
 #include <od/core/module.h>
 
+#define OD_ALLOCATION_CATEGORY_ALL -1
+#define OD_ALLOCATION_CATEGORY_DEFAULT 0
+#define OD_ALLOCATION_CATEGORY_ARRAY 1
+#define OD_ALLOCATION_CATEGORY_IMAGE 2
+#define OD_ALLOCATION_CATEGORY_FILE 3
+#define OD_ALLOCATION_CATEGORY_SCRATCH 4
+#define OD_ALLOCATION_CATEGORY_COUNT 5
+
 struct odAllocation;
 
+// allocation counters, either since startup or over one frame
+struct odAllocationStats {
+	int64_t allocation_count;
+	int64_t free_count;
+	int64_t allocated_bytes;
+	int64_t freed_bytes;
+	int64_t live_bytes;  // since startup, even in frame stats
+	int64_t peak_live_bytes;  // highest within the frame, for frame stats
+};
+
 OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
 odAllocation_check_valid(const struct odAllocation* allocation);
 OD_API_C OD_CORE_MODULE OD_NO_DISCARD const char*
 odAllocation_get_debug_string(const struct odAllocation* allocation);
 OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
 odAllocation_init(struct odAllocation* allocation, int32_t size);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
+odAllocation_init_category(struct odAllocation* allocation, int32_t size, int32_t category);
 OD_API_C OD_CORE_MODULE void
 odAllocation_destroy(struct odAllocation* allocation);
 OD_API_C OD_CORE_MODULE void
@@ -18,3 +38,16 @@ OD_API_C OD_CORE_MODULE OD_NO_DISCARD void*
 odAllocation_get(struct odAllocation* allocation);
 OD_API_C OD_CORE_MODULE OD_NO_DISCARD const void*
 odAllocation_get_const(const struct odAllocation* allocation);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD int32_t
+odAllocation_get_size(const struct odAllocation* allocation);
+
+/* Every allocation is counted, per category and in total (OD_ALLOCATION_CATEGORY_ALL).
+odAllocation_end_frame() publishes the current frame's counters and starts the next frame. */
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD const char*
+odAllocationCategory_get_name(int32_t category);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
+odAllocation_get_stats(int32_t category, struct odAllocationStats* out_stats);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
+odAllocation_get_frame_stats(int32_t category, struct odAllocationStats* out_stats);
+OD_API_C OD_CORE_MODULE void
+odAllocation_end_frame(void);
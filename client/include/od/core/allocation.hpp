@@ -4,6 +4,8 @@
 
 struct odAllocation {
 	void* ptr;
+	int32_t size;
+	int32_t category;
 
 	OD_CORE_MODULE odAllocation();
 	OD_CORE_MODULE odAllocation(odAllocation&& other);
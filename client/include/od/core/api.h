@@ -34,6 +34,10 @@
 #define OD_BUILD_LUAJIT 0
 #endif
 
+#if !defined(OD_BUILD_TAGSET_BITS)
+#define OD_BUILD_TAGSET_BITS 128
+#endif
+
 #if !defined(OD_BUILD_LIBBACKTRACE)
 #define OD_BUILD_LIBBACKTRACE 0
 #endif
@@ -12,6 +12,7 @@
 #define OD_LOG_LEVEL_FIRST 1
 #define OD_LOG_LEVEL_LAST 6
 #define OD_LOG_LEVEL_DEFAULT OD_LOG_LEVEL_INFO
+#define OD_LOG_ASYNC_LINE_CAPACITY 512  // async lines are truncated to fit, including the newline
 #define OD_LOG_GET_CONTEXT() odLogContext_init_inline(__FILE__, __func__, static_cast<int32_t>(__LINE__))
 #define OD_LOG_SET_CONTEXT() odLogContext_init_temp(__FILE__, __func__, static_cast<int32_t>(__LINE__))
 
@@ -58,6 +59,8 @@ odDebugString_format_array(const char* (*to_debug_str)(const void*),
 OD_API_C OD_CORE_MODULE OD_NO_DISCARD int32_t
 odLog_get_logged_error_count(void);
 OD_API_C OD_CORE_MODULE void
+odLog_set_logged_error_count(int32_t count);
+OD_API_C OD_CORE_MODULE void
 odLog_log_variadic(const struct odLogContext* log_context, int32_t log_level, const char* format_c_str, va_list* args);
 OD_API_C OD_CORE_MODULE void
 odLog_log(const struct odLogContext* log_context, int32_t log_level, const char* format_c_str, ...) OD_API_PRINTF(3, 4);
@@ -66,6 +69,22 @@ odLog_check(const struct odLogContext* log_context, bool success, const char* ex
 OD_API_C OD_CORE_MODULE bool
 odLog_assert(const struct odLogContext* log_context, bool success, const char* expression_c_str);
 
+/* In async mode, log lines are formatted into a ring buffer and written in batches by a background thread.
+Lines are dropped (and counted) when the buffer is full, except errors, which wait for space and are flushed
+before returning.  Not available in emscripten builds, where enabling fails. */
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
+odLog_set_async(bool enabled);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
+odLog_get_async(void);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD int32_t
+odLog_get_async_dropped_count(void);
+/* Replaces where the writer thread writes lines, in place of stdout (nullptr restores it).
+Only allowed while async logging is disabled. */
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
+odLog_set_async_write_fn(void (*write_fn)(const char* str, int32_t size));
+OD_API_C OD_CORE_MODULE void
+odLog_flush(void);
+
 OD_API_C OD_CORE_MODULE void
 odLogContext_init(struct odLogContext* log_context, const char* file, const char* function, int32_t line);
 OD_API_C OD_CORE_MODULE OD_NO_DISCARD const struct odLogContext*
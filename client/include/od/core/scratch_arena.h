@@ -0,0 +1,30 @@
+#pragma once
+
+#include <od/core/module.h>
+
+struct odScratchArena;
+
+/* Bump allocator for short-lived temporaries, e.g. per-frame data.
+Allocations are zeroed, and are only released all at once, by odScratchArena_reset().
+Arenas are not thread-safe; give each thread its own. */
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
+odScratchArena_check_valid(const struct odScratchArena* arena);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD const char*
+odScratchArena_get_debug_string(const struct odScratchArena* arena);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
+odScratchArena_init(struct odScratchArena* arena, int32_t capacity);
+OD_API_C OD_CORE_MODULE void
+odScratchArena_destroy(struct odScratchArena* arena);
+OD_API_C OD_CORE_MODULE void
+odScratchArena_swap(struct odScratchArena* arena1, struct odScratchArena* arena2);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD int32_t
+odScratchArena_get_capacity(const struct odScratchArena* arena);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD int32_t
+odScratchArena_get_size(const struct odScratchArena* arena);
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD void*
+odScratchArena_allocate(struct odScratchArena* arena, int32_t size, int32_t alignment);
+// when full, wraps back to the start, reusing the oldest allocations; for temporaries which only need to outlive a few more
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD void*
+odScratchArena_allocate_wrapping(struct odScratchArena* arena, int32_t size, int32_t alignment);
+OD_API_C OD_CORE_MODULE void
+odScratchArena_reset(struct odScratchArena* arena);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <od/core/scratch_arena.h>
+
+#include <od/core/allocation.hpp>
+
+struct odScratchArena {
+	odAllocation allocation;
+	int32_t capacity;
+	int32_t size;
+
+	OD_CORE_MODULE odScratchArena();
+	OD_CORE_MODULE odScratchArena(odScratchArena&& other);
+	OD_CORE_MODULE odScratchArena& operator=(odScratchArena&& other);
+	OD_CORE_MODULE ~odScratchArena();
+
+	odScratchArena(const odScratchArena& other) = delete;
+	odScratchArena& operator=(const odScratchArena& other) = delete;
+};
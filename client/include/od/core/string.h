@@ -38,6 +38,9 @@ OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
 odString_extend_formatted_variadic(struct odString* string, const char* format_c_str, va_list* args);
 OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
 odString_extend_formatted(struct odString* string, const char* format_c_str, ...);
+// appends str as a quoted json string; newlines and tabs are escaped, other control characters dropped
+OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
+odString_extend_json_string(struct odString* string, const char* str);
 OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
 odString_pop(struct odString* string, int32_t pop_count);
 OD_API_C OD_CORE_MODULE OD_NO_DISCARD bool
@@ -43,6 +43,11 @@ OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD const struct odVertex*
 odEntityIndex_get_vertices(const struct odEntityIndex* entity_index, odEntityId entity_id);
 OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD const struct odVertex*
 odEntityIndex_get_all_vertices(const struct odEntityIndex* entity_index, int32_t* out_vertex_count);
+OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD const struct odVertex*
+odEntityIndex_get_all_vertices_interpolated(
+	struct odEntityIndex* entity_index, float interpolation, int32_t* out_vertex_count);
+OD_API_C OD_ENGINE_MODULE void
+odEntityIndex_save_previous(struct odEntityIndex* entity_index);
 OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD const struct odEntity*
 odEntityIndex_get(const struct odEntityIndex* entity_index, odEntityId entity_id);
 OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD const struct odEntity*
@@ -56,6 +61,21 @@ odEntityIndex_set(struct odEntityIndex* entity_index, const struct odEntity* ent
 OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD /*num_results*/ int32_t
 odEntityIndex_search(const struct odEntityIndex* entity_index, const struct odEntitySearch* search);
 
+/* Tag lists track which entities have a tag, for iteration by tag.  Unlike tagset tag ids, any number
+of tag lists can be used, but they are not part of bounds searches. */
+OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD /*was_added*/ bool
+odEntityIndex_add_tagged(struct odEntityIndex* entity_index, int32_t tag_list_id, odEntityId entity_id);
+OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD /*was_removed*/ bool
+odEntityIndex_remove_tagged(struct odEntityIndex* entity_index, int32_t tag_list_id, odEntityId entity_id);
+OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD bool
+odEntityIndex_get_is_tagged(const struct odEntityIndex* entity_index, int32_t tag_list_id, odEntityId entity_id);
+// unordered, and invalidated by the next add/remove
+OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD const odEntityId*
+odEntityIndex_get_all_tagged(const struct odEntityIndex* entity_index, int32_t tag_list_id, int32_t* out_count);
+OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD /*num_results*/ int32_t
+odEntityIndex_get_tag_lists(
+	const struct odEntityIndex* entity_index, odEntityId entity_id, int32_t* out_tag_list_ids, int32_t max_results);
+
 OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD const char*
 odEntitySearch_get_debug_string(const struct odEntitySearch* search);
 OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD bool
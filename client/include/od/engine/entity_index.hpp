@@ -15,10 +15,18 @@ struct odEntityChunk {
 	odTrivialArrayT<odEntityId> entity_ids;
 };
 
+// sparse set of tagged entity ids, for O(1) add/remove and dense iteration
+struct odEntityTagList {
+	odTrivialArrayT<odEntityId> entity_ids;
+	odTrivialArrayT<int32_t> entity_slots;  // by entity id; index in entity_ids + 1, or 0 if not tagged
+};
+
 struct odEntityIndex {
 	odTrivialArrayT<odEntityIndexEntity> entities;
 	odTrivialArrayT<odVertex> entity_vertices;
+	odTrivialArrayT<odVertex> interpolated_vertices;
 	odEntityChunk chunks[OD_ENTITY_CHUNK_ID_COUNT];
+	odArrayT<odEntityTagList> tag_lists;
 
 	OD_ENGINE_MODULE odEntityIndex();
 	OD_ENGINE_MODULE odEntityIndex(odEntityIndex&& other);
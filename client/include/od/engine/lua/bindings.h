@@ -13,6 +13,13 @@
 #define OD_LUA_BINDINGS_MUSIC "Music"
 #define OD_LUA_BINDINGS_TEXTURE_ATLAS "TextureAtlas"
 #define OD_LUA_BINDINGS_ENTITY_INDEX "EntityIndex"
+#define OD_LUA_BINDINGS_SNAPSHOT "Snapshot"
+#define OD_LUA_BINDINGS_DEBUGGING "Debugging"
+#define OD_LUA_BINDINGS_JSON "Json"
+#define OD_LUA_BINDINGS_PROFILE "Profile"
+#define OD_LUA_BINDINGS_ALLOCATION "Allocation"
+#define OD_LUA_BINDINGS_LUA_PROFILER "LuaProfiler"
+#define OD_LUA_BINDINGS_FRAME_WATCHDOG "FrameWatchdog"
 
 struct lua_State;
 
@@ -39,4 +46,18 @@ odLuaBindings_odTextureAtlas_register(struct lua_State* lua);
 OD_API_C OD_ENGINE_MODULE bool
 odLuaBindings_odEntityIndex_register(struct lua_State* lua);
 OD_API_C OD_ENGINE_MODULE bool
+odLuaBindings_odSnapshot_register(struct lua_State* lua);
+OD_API_C OD_ENGINE_MODULE bool
+odLuaBindings_odDebugging_register(struct lua_State* lua);
+OD_API_C OD_ENGINE_MODULE bool
+odLuaBindings_odJson_register(struct lua_State* lua);
+OD_API_C OD_ENGINE_MODULE bool
+odLuaBindings_odProfile_register(struct lua_State* lua);
+OD_API_C OD_ENGINE_MODULE bool
+odLuaBindings_odAllocation_register(struct lua_State* lua);
+OD_API_C OD_ENGINE_MODULE bool
+odLuaBindings_odLuaProfiler_register(struct lua_State* lua);
+OD_API_C OD_ENGINE_MODULE bool
+odLuaBindings_odFrameWatchdog_register(struct lua_State* lua);
+OD_API_C OD_ENGINE_MODULE bool
 odLuaBindings_register(struct lua_State* lua);
@@ -2,18 +2,22 @@
 
 #include <od/engine/module.h>
 
-#define OD_TAGSET_ELEMENT_COUNT 3
+// width is set at build time with OD_BUILD_TAGSET_BITS (64, 128 or 256)
+#define OD_TAGSET_BIT_SIZE (OD_BUILD_TAGSET_BITS)
+#define OD_TAGSET_BYTE_SIZE (OD_TAGSET_BIT_SIZE / 8)
 #define OD_TAGSET_ELEMENT_SIZE 4
 #define OD_TAGSET_ELEMENT_BIT_SIZE (8 * OD_TAGSET_ELEMENT_SIZE)
-#define OD_TAGSET_BYTE_SIZE (OD_TAGSET_ELEMENT_COUNT * OD_TAGSET_ELEMENT_SIZE)
-#define OD_TAGSET_BIT_SIZE (8 * OD_TAGSET_BYTE_SIZE)
+#define OD_TAGSET_ELEMENT_COUNT (OD_TAGSET_BYTE_SIZE / OD_TAGSET_ELEMENT_SIZE)
+
+// aligned to whole 128-bit lanes where possible, so intersection tests are a few vector ops
+#define OD_TAGSET_ALIGNMENT ((OD_TAGSET_BYTE_SIZE < 16) ? OD_TAGSET_BYTE_SIZE : 16)
 
 #define OD_TAG_ID_COUNT (OD_TAGSET_BIT_SIZE)
 
 typedef uint32_t odTagsetElement;
 
 struct odTagset {
-	odTagsetElement tagset[OD_TAGSET_ELEMENT_COUNT];
+	alignas(OD_TAGSET_ALIGNMENT) odTagsetElement tagset[OD_TAGSET_ELEMENT_COUNT];
 };
 
 OD_API_C OD_ENGINE_MODULE OD_NO_DISCARD const char*
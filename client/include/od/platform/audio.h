@@ -20,6 +20,16 @@ struct odAudioPlaybackSettings {
 	bool is_cutoff_time_enabled;
 };
 
+/* Decoded audio is shared between odAudio loaded from the same file or wav content,
+and freed once its last odAudio (or preload) releases it. */
+struct odAudioCacheStats {
+	int32_t lookup_count;
+	int32_t hit_count;
+	int32_t entry_count;
+	int32_t preloaded_count;
+	int64_t decoded_bytes;
+};
+
 OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
 odAudioPlaybackId_check_valid(odAudioPlaybackId playback_id);
 
@@ -55,3 +65,15 @@ OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
 odAudio_stop_all(void);
 OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
 odAudio_is_playing(odAudioPlaybackId playback_id);
+
+// holds each file's decoded audio until odAudioCache_release_preloaded(); background decoding is skipped on emscripten
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odAudioCache_preload_files(const char* const* filenames, int32_t filenames_count, bool background);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odAudioCache_get_preloading(void);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odAudioCache_wait_preload(void);
+OD_API_C OD_PLATFORM_MODULE void
+odAudioCache_release_preloaded(void);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odAudioCache_get_stats(struct odAudioCacheStats* out_stats);
@@ -4,6 +4,11 @@
 
 struct odAudio {
 	void* audio_native;
+	int32_t cache_index;
+	int32_t mixer_index;  // slot in the mixer's list of live audio, so release is O(1)
+	uint32_t owner_id;  // identifies this audio's playbacks, as the struct may move
+	uint64_t playback_channels;  // channels this audio has played on, to stop on destroy
+	float volume;
 
 	OD_PLATFORM_MODULE odAudio();
 	OD_PLATFORM_MODULE odAudio(odAudio&& other);
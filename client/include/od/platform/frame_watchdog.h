@@ -0,0 +1,33 @@
+#pragma once
+
+#include <od/platform/module.h>
+
+#define OD_FRAME_WATCHDOG_FRAME_CAPACITY 16
+#define OD_FRAME_WATCHDOG_FRAME_ZONE_CAPACITY 16
+#define OD_FRAME_WATCHDOG_NOTE_CAPACITY 512
+#define OD_FRAME_WATCHDOG_BUDGET_MS_DEFAULT 33.0f
+#define OD_FRAME_WATCHDOG_FILE_COUNT_DEFAULT 4
+
+/* Times each frame against a budget.  When a frame goes over, the last OD_FRAME_WATCHDOG_FRAME_CAPACITY
+frames (duration, slowest profile zones, allocation counters, draw count and note) are written as JSON
+to the next of file_count files, "filename.0" to "filename.<file_count - 1>", overwriting the oldest.
+
+Time between odFrameWatchdog_end_frame() and the next odFrameWatchdog_begin_frame(), e.g. waiting for vsync,
+is not counted.  Allocation counters are read at the end of the frame, so end it after odAllocation_end_frame().
+Profile zones are read at the start of the next frame, so odProfile_end_frame() can run in between. */
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odFrameWatchdog_start(const char* filename, float budget_ms, int32_t file_count);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odFrameWatchdog_stop(void);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odFrameWatchdog_get_running(void);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD int32_t
+odFrameWatchdog_get_dump_count(void);
+OD_API_C OD_PLATFORM_MODULE void
+odFrameWatchdog_begin_frame(void);
+OD_API_C OD_PLATFORM_MODULE void
+odFrameWatchdog_end_frame(void);
+
+// e.g. the lua stack of the frame's slowest system; truncated to fit, and replaces any earlier note in the frame
+OD_API_C OD_PLATFORM_MODULE void
+odFrameWatchdog_set_note(const char* note);
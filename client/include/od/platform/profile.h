@@ -0,0 +1,54 @@
+#pragma once
+
+#include <od/platform/module.h>
+
+#define OD_PROFILE_ZONE_CAPACITY 512
+#define OD_PROFILE_ZONE_NAME_CAPACITY 64
+#define OD_PROFILE_OPEN_ZONE_CAPACITY 64
+#define OD_PROFILE_ZONE_ID_INVALID -1
+#define OD_PROFILE_TRACE_EVENT_CAPACITY (1 << 20)
+
+// totals for one zone over one frame
+struct odProfileZoneStats {
+	int32_t count;
+	int64_t total_ns;
+	int64_t max_ns;
+};
+
+/* Named profiling zones, aggregated per frame.
+Zones are registered by name on first use, and live for the rest of the program.
+odProfile_end_frame() publishes the current frame's stats and starts the next frame.
+Zones are only recorded from the main thread.*/
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD int32_t
+odProfile_get_zone_id(const char* name);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD int32_t
+odProfile_get_zone_count(void);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD const char*
+odProfile_get_zone_name(int32_t zone_id);
+OD_API_C OD_PLATFORM_MODULE void
+odProfile_add_sample(int32_t zone_id, int64_t start_ns, int64_t end_ns);
+
+// for zones which cannot be scoped, e.g. from lua; ending a zone also discards any zones left open inside it
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odProfile_begin(int32_t zone_id);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odProfile_end(int32_t zone_id);
+
+OD_API_C OD_PLATFORM_MODULE void
+odProfile_end_frame(void);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD int32_t
+odProfile_get_frame_count(void);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD const struct odProfileZoneStats*
+odProfile_get_frame_stats(int32_t zone_id);
+
+/* Records every zone sample for the next frame_count frames, then writes them to filename as
+Chrome trace event JSON (viewable in Perfetto or chrome://tracing).
+odProfile_end_trace() writes early; counters are only recorded while tracing. */
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odProfile_begin_trace(const char* filename, int32_t frame_count);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odProfile_end_trace(void);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odProfile_get_tracing(void);
+OD_API_C OD_PLATFORM_MODULE void
+odProfile_add_counter(int32_t zone_id, int64_t value);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <od/platform/profile.h>
+
+#define OD_PROFILE_CONCAT_IMPL(A, B) A##B
+#define OD_PROFILE_CONCAT(A, B) OD_PROFILE_CONCAT_IMPL(A, B)
+
+// times the rest of the enclosing scope as zone NAME, when built with OD_BUILD_PROFILE
+#if OD_BUILD_PROFILE
+#define OD_PROFILE_SCOPE(NAME) \
+	static const int32_t OD_PROFILE_CONCAT(odProfile_zone_id_, __LINE__) = odProfile_get_zone_id(NAME); \
+	odProfileScope OD_PROFILE_CONCAT(odProfile_scope_, __LINE__){OD_PROFILE_CONCAT(odProfile_zone_id_, __LINE__)}
+#else
+#define OD_PROFILE_SCOPE(NAME)
+#endif
+
+struct odProfileScope {
+	int32_t zone_id;
+	int64_t start_ns;
+
+	OD_PLATFORM_MODULE explicit odProfileScope(int32_t in_zone_id);
+	OD_PLATFORM_MODULE ~odProfileScope();
+
+	odProfileScope(const odProfileScope&) = delete;
+	odProfileScope(odProfileScope&&) = delete;
+	odProfileScope& operator=(const odProfileScope&) = delete;
+	odProfileScope& operator=(odProfileScope&&) = delete;
+};
@@ -44,3 +44,6 @@ OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
 odRenderer_draw_texture(struct odRenderer* renderer, const struct odRenderState* state, const struct odTexture* src_texture,
 					    const struct odBounds* opt_src_bounds, const struct odMatrix* opt_transform,
 					    struct odRenderTexture* opt_render_texture);
+// non-empty draw calls since startup, across all renderers
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD int64_t
+odRenderer_get_draw_count(void);
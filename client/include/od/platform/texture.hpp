@@ -2,12 +2,15 @@
 
 #include <od/platform/texture.h>
 
+#include <od/core/array.hpp>
+#include <od/core/color.h>
 #include <od/platform/window.hpp>
 
 struct odTexture : odWindowResource {
 	uint32_t texture;
 	int32_t width;
 	int32_t height;
+	odTrivialArrayT<odColor> pixels;  // only populated for software renderer windows
 
 	OD_PLATFORM_MODULE odTexture();
 	OD_PLATFORM_MODULE odTexture(odTexture&& other);
@@ -2,6 +2,9 @@
 
 #include <od/platform/module.h>
 
+#define OD_WINDOW_FRAME_HISTORY_COUNT 128
+#define OD_WINDOW_KEY_COUNT 512  // key handles are in [0, OD_WINDOW_KEY_COUNT)
+
 struct odType;
 struct odWindow;
 struct odWindowResource;
@@ -15,6 +18,8 @@ struct odWindowSettings {
 	bool is_fps_limit_enabled;
 	bool is_vsync_enabled;
 	bool is_visible;
+	bool is_headless;  // no native window or render context; rendering is a no-op unless software rendered
+	bool is_software_renderer_enabled;  // headless only; rasterize on the cpu instead of skipping rendering
 };
 struct odWindowMouseState {
 	int32_t x;
@@ -23,6 +28,21 @@ struct odWindowMouseState {
 	bool is_middle_down;
 	bool is_right_down;
 };
+struct odWindowKeyState {
+	bool is_down;
+	bool is_pressed;  // pressed since the last step, even if released again before it
+	bool is_released;  // released since the last step
+};
+struct odWindowFrameStats {
+	int32_t frame_count;
+	int32_t missed_frame_count;  // frames which took over 1.5x the fps_limit frame duration
+	float last_frame_ms;
+
+	// over the last OD_WINDOW_FRAME_HISTORY_COUNT frames
+	float mean_frame_ms;
+	float p99_frame_ms;
+	float max_frame_ms;
+};
 
 OD_API_C OD_PLATFORM_MODULE const char*
 odWindowSettings_get_debug_string(const struct odWindowSettings* settings);
@@ -30,9 +50,14 @@ OD_API_C OD_PLATFORM_MODULE const struct odWindowSettings*
 odWindowSettings_get_defaults(void);
 OD_API_C OD_PLATFORM_MODULE const struct odWindowSettings*
 odWindowSettings_get_headless_defaults(void);
+OD_API_C OD_PLATFORM_MODULE const struct odWindowSettings*
+odWindowSettings_get_hidden_defaults(void);
 OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
 odWindowSettings_check_valid(const struct odWindowSettings* settings);
 
+OD_API_C OD_PLATFORM_MODULE const char*
+odWindowFrameStats_get_debug_string(const struct odWindowFrameStats* stats);
+
 OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD const struct odType*
 odWindow_get_type_constructor(void);
 OD_API_C OD_PLATFORM_MODULE void
@@ -42,6 +67,10 @@ odWindow_get_debug_string(const struct odWindow* window);
 OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
 odWindow_check_valid(const struct odWindow* window);
 OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odWindow_is_headless(const struct odWindow* opt_window);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odWindow_is_software_renderer_enabled(const struct odWindow* opt_window);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
 odWindow_init(struct odWindow* window, const struct odWindowSettings* opt_settings);
 OD_API_C OD_PLATFORM_MODULE void
 odWindow_destroy(struct odWindow* window);
@@ -61,6 +90,16 @@ OD_API_C OD_PLATFORM_MODULE void
 odWindow_get_mouse_state(const struct odWindow* window, struct odWindowMouseState* out_mouse_state);
 OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
 odWindow_get_key_state(const struct odWindow* window, const char* key_name);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odWindow_get_key_handle(const struct odWindow* window, const char* key_name, int32_t* out_key_handle);
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
+odWindow_get_key_states(const struct odWindow* window, const int32_t* key_handles, int32_t key_handles_count,
+						struct odWindowKeyState* out_key_states);
+OD_API_C OD_PLATFORM_MODULE void
+odWindow_get_frame_stats(const struct odWindow* window, struct odWindowFrameStats* out_stats);
+/* Duration of the last frame, or 0 before the first frame; unlike odWindow_get_frame_stats(), cheap per step */
+OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD float
+odWindow_get_last_frame_ms(const struct odWindow* window);
 
 
 OD_API_C OD_PLATFORM_MODULE OD_NO_DISCARD bool
@@ -3,19 +3,31 @@
 #include <od/platform/window.h>
 
 #include <od/core/array.hpp>
-
+#include <od/core/color.h>
+
+struct odWindowFramePacer {
+	uint64_t next_frame_counter;
+	uint64_t frame_remainder_counter;  // fractional frame accumulator, in units of 1/fps_limit counts
+	uint64_t last_frame_counter;
+	int32_t frame_count;
+	int32_t missed_frame_count;
+	float frame_durations_ms[OD_WINDOW_FRAME_HISTORY_COUNT];
+};
 struct odWindow {
 	odWindowSettings settings;
 	void* window_native;
 	void* render_context_native;
 	bool is_sdl_init;
 	bool is_open;
-	int32_t next_frame_ms;
+	odWindowFramePacer frame_pacer;
 
 	odWindowMouseState mouse_state;
+	uint8_t key_events[OD_WINDOW_KEY_COUNT];  // key press/release flags since the last step, and down flags, by key handle
 
 	odTrivialArrayT<odWindowResource*> resources;
 
+	odTrivialArrayT<odColor> software_framebuffer;
+
 	OD_PLATFORM_MODULE odWindow();
 	OD_PLATFORM_MODULE odWindow(odWindow&& other);
 	OD_PLATFORM_MODULE odWindow& operator=(odWindow&& other);
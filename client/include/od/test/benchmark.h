@@ -0,0 +1,33 @@
+#pragma once
+
+#include <od/test/module.h>
+#include <od/core/debug.h>
+
+#define OD_BENCHMARK_WARMUP_COUNT_DEFAULT 3
+#define OD_BENCHMARK_SAMPLE_COUNT_DEFAULT 30
+#define OD_BENCHMARK_SAMPLE_CAPACITY 1024
+#define OD_BENCHMARK_MAX_REGRESSION_PERCENT_DEFAULT 10
+
+struct odBenchmarkRun;
+
+struct odBenchmarkSettings {
+	const char* name_filter;  // optional
+	const char* json_path;  // optional, results are written here
+	const char* baseline_path;  // optional, results of an earlier run to compare to
+	int32_t max_regression_percent;  // if comparing to a baseline, slower medians than this fail the run
+};
+
+#if OD_BUILD_TESTS
+/* Runs each benchmark fn once per sample, after untimed warmup runs, and reports min/median/p95 times.
+Results are written as json, with one benchmark per line:
+{"benchmarks":[
+{"name":"...","suite":"...","samples":30,"min_ns":1,"median_ns":2,"p95_ns":3,"mean_ns":2},
+]}
+Other tools (e.g. the lua benchmarks) may write the same format, and add their own fields. */
+OD_API_C OD_TEST_MODULE OD_NO_DISCARD bool
+odBenchmark_run(const struct odBenchmarkSettings* settings);
+
+// loop condition for benchmark bodies: times the work done between calls, returns false once enough samples are taken
+OD_API_C OD_TEST_MODULE OD_NO_DISCARD bool
+odBenchmarkRun_next(struct odBenchmarkRun* run);
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <od/test/benchmark.h>
+
+#if OD_BUILD_TESTS
+#include <od/core/debug.hpp>
+
+struct odBenchmarkRun {
+	int32_t warmup_count;
+	int32_t sample_count;
+	int32_t iteration;
+	int64_t start_ns;
+	int64_t samples_ns[OD_BENCHMARK_SAMPLE_CAPACITY];
+};
+
+struct odBenchmark {
+	const char* name;
+	void (*fn)(odBenchmarkRun* run);
+	int32_t warmup_count;
+	int32_t sample_count;
+
+	OD_TEST_MODULE odBenchmark(
+		const char* in_name, void (*in_fn)(odBenchmarkRun* run), int32_t in_warmup_count, int32_t in_sample_count);
+};
+
+struct odBenchmarkSuite {
+	const char* name;
+	const odBenchmark* benchmarks;
+	int32_t benchmarks_count;
+};
+
+/* Benchmark bodies do any setup, then loop on odBenchmarkRun_next(run), e.g.:
+OD_BENCHMARK(odBenchmark_odThing_do) {
+	odThing thing{};
+	while (odBenchmarkRun_next(run)) {
+		odThing_do(&thing);
+	}
+}*/
+#define OD_BENCHMARK_SAMPLED(BENCHMARK_NAME, WARMUP_COUNT, SAMPLE_COUNT) \
+	static void BENCHMARK_NAME##_run(odBenchmarkRun* run); \
+	static odBenchmark BENCHMARK_NAME = odBenchmark{ \
+		#BENCHMARK_NAME, &BENCHMARK_NAME##_run, (WARMUP_COUNT), (SAMPLE_COUNT)}; \
+	static void BENCHMARK_NAME##_run(odBenchmarkRun* run)
+
+#define OD_BENCHMARK(BENCHMARK_NAME) \
+	OD_BENCHMARK_SAMPLED(BENCHMARK_NAME, OD_BENCHMARK_WARMUP_COUNT_DEFAULT, OD_BENCHMARK_SAMPLE_COUNT_DEFAULT)
+
+#define OD_BENCHMARK_SUITE_DECLARE(SUITE_NAME) extern OD_TEST_MODULE odBenchmarkSuite SUITE_NAME();
+
+#define OD_BENCHMARK_SUITE(SUITE_NAME, ...) \
+	odBenchmarkSuite SUITE_NAME() { \
+		static odBenchmark benchmarks[] = { __VA_ARGS__ }; \
+		return odBenchmarkSuite{#SUITE_NAME, benchmarks, (sizeof(benchmarks) / sizeof(odBenchmark))}; \
+	}
+
+OD_BENCHMARK_SUITE_DECLARE(odBenchmarkSuite_odArray)
+
+OD_BENCHMARK_SUITE_DECLARE(odBenchmarkSuite_odAsciiFont)
+OD_BENCHMARK_SUITE_DECLARE(odBenchmarkSuite_odPrimitive)
+OD_BENCHMARK_SUITE_DECLARE(odBenchmarkSuite_odRenderer)
+
+OD_BENCHMARK_SUITE_DECLARE(odBenchmarkSuite_odAtlas)
+OD_BENCHMARK_SUITE_DECLARE(odBenchmarkSuite_odEntityIndex)
+OD_BENCHMARK_SUITE_DECLARE(odBenchmarkSuite_odTagset)
+
+#endif
@@ -41,8 +41,10 @@ OD_TEST_SUITE_DECLARE(odTestSuite_odBox)
 OD_TEST_SUITE_DECLARE(odTestSuite_odBounds)
 OD_TEST_SUITE_DECLARE(odTestSuite_odMatrix)
 OD_TEST_SUITE_DECLARE(odTestSuite_odString)
+OD_TEST_SUITE_DECLARE(odTestSuite_odScratchArena)
 
 OD_TEST_SUITE_DECLARE(odTestSuite_odAsciiFont)
+OD_TEST_SUITE_DECLARE(odTestSuite_odPrimitive)
 OD_TEST_SUITE_DECLARE(odTestSuite_odFile)
 OD_TEST_SUITE_DECLARE(odTestSuite_odImage)
 OD_TEST_SUITE_DECLARE(odTestSuite_odWindow)
@@ -51,12 +53,18 @@ OD_TEST_SUITE_DECLARE(odTestSuite_odRenderTexture)
 OD_TEST_SUITE_DECLARE(odTestSuite_odRenderer)
 OD_TEST_SUITE_DECLARE(odTestSuite_odAudio)
 OD_TEST_SUITE_DECLARE(odTestSuite_odMusic)
+OD_TEST_SUITE_DECLARE(odTestSuite_odTimer)
+OD_TEST_SUITE_DECLARE(odTestSuite_odProfile)
+OD_TEST_SUITE_DECLARE(odTestSuite_odFrameWatchdog)
 
 OD_TEST_SUITE_DECLARE(odTestSuite_odAtlas)
 OD_TEST_SUITE_DECLARE(odTestSuite_odTextureAtlas)
+OD_TEST_SUITE_DECLARE(odTestSuite_odTagset)
 OD_TEST_SUITE_DECLARE(odTestSuite_odEntityIndex)
 OD_TEST_SUITE_DECLARE(odTestSuite_odLua)
 OD_TEST_SUITE_DECLARE(odTestSuite_odLuaBindings)
 OD_TEST_SUITE_DECLARE(odTestSuite_odLuaClient)
 
+OD_TEST_SUITE_DECLARE(odTestSuite_odBenchmark)
+
 #endif
@@ -2,10 +2,15 @@
 #include <cstdlib>
 
 #include <od/core/debug.h>
+#include <od/platform/profile.h>
+#include <od/platform/frame_watchdog.h>
 #include <od/engine/client.hpp>
 #include <od/engine/lua/wrappers.hpp>
 #include <od/engine/lua/client.hpp>
 #include <od/test/test.hpp>
+#include <od/test/benchmark.hpp>
+
+#define OD_MAIN_PROFILE_TRACE_FRAMES_DEFAULT 300
 
 const char* __asan_default_options();
 
@@ -21,13 +26,31 @@ const char* __asan_default_options() {
 			":detect_leaks=1");
 }
 
+/* Parses a whole non-negative decimal integer; atoi() would read "abc" or "10%" as a valid value */
+static bool odMain_parse_non_negative_int(const char* str, int32_t* out_value) {
+	char* end = nullptr;
+	long value = strtol(str, &end, 10);
+	if ((end == str) || (*end != '\0') || (value < 0) || (value > INT32_MAX)) {
+		return false;
+	}
+
+	*out_value = static_cast<int32_t>(value);
+	return true;
+}
+
 int main(int argc, char** argv) {
 	bool run_tests = false;
+	bool run_benchmarks = false;
 	bool run_client = false;
 	bool run_lua_client = false;
 	int32_t test_filter = OD_TEST_FILTER_NONE;
 	char const* test_name_filter = nullptr;
+	odBenchmarkSettings benchmark_settings{nullptr, nullptr, nullptr, OD_BENCHMARK_MAX_REGRESSION_PERCENT_DEFAULT};
 	char const* lua_client_path = nullptr;
+	char const* profile_trace_path = nullptr;
+	int32_t profile_trace_frames = OD_MAIN_PROFILE_TRACE_FRAMES_DEFAULT;
+	char const* frame_watchdog_path = nullptr;
+	float frame_budget_ms = OD_FRAME_WATCHDOG_BUDGET_MS_DEFAULT;
 
 	if (strcmp(OD_BUILD_LUA_CLIENT, "") != 0) {
 		lua_client_path = OD_BUILD_LUA_CLIENT;
@@ -70,6 +93,47 @@ int main(int argc, char** argv) {
 			continue;
 		}
 
+		if (strncmp(argv[i], "--profile-trace", arg_size) == 0) {
+			if (((i + 1) >= argc) || (strcmp(argv[i + 1], "") == 0)) {
+				OD_ERROR("Missing value for --profile-trace");
+				return 1;
+			}
+
+			i++;
+			profile_trace_path = argv[i];
+			continue;
+		}
+		if (strncmp(argv[i], "--profile-trace-frames", arg_size) == 0) {
+			if (((i + 1) >= argc) || (atoi(argv[i + 1]) <= 0)) {
+				OD_ERROR("Missing or invalid value for --profile-trace-frames");
+				return 1;
+			}
+
+			i++;
+			profile_trace_frames = static_cast<int32_t>(atoi(argv[i]));
+			continue;
+		}
+		if (strncmp(argv[i], "--frame-watchdog", arg_size) == 0) {
+			if (((i + 1) >= argc) || (strcmp(argv[i + 1], "") == 0)) {
+				OD_ERROR("Missing value for --frame-watchdog");
+				return 1;
+			}
+
+			i++;
+			frame_watchdog_path = argv[i];
+			continue;
+		}
+		if (strncmp(argv[i], "--frame-budget-ms", arg_size) == 0) {
+			if (((i + 1) >= argc) || (atof(argv[i + 1]) <= 0.0)) {
+				OD_ERROR("Missing or invalid value for --frame-budget-ms");
+				return 1;
+			}
+
+			i++;
+			frame_budget_ms = static_cast<float>(atof(argv[i]));
+			continue;
+		}
+
 		if (OD_BUILD_LOGS) {
 			if (strncmp(argv[i], "--log", arg_size) == 0) {
 				odLogLevel_set_max(OD_LOG_LEVEL_INFO);
@@ -79,6 +143,20 @@ int main(int argc, char** argv) {
 				odLogLevel_set_max(OD_LOG_LEVEL_NONE);
 				continue;
 			}
+			if (strncmp(argv[i], "--async-log", arg_size) == 0) {
+				if (!odLog_set_async(true)) {
+					OD_ERROR("Async logging is not supported on this platform");
+					return 1;
+				}
+				continue;
+			}
+			if (strncmp(argv[i], "--no-async-log", arg_size) == 0) {
+				if (!odLog_set_async(false)) {
+					OD_ERROR("Failed to disable async logging");
+					return 1;
+				}
+				continue;
+			}
 		}
 		if (OD_BUILD_LOGS && OD_BUILD_DEBUG) {
 			if (strncmp(argv[i], "--debug", arg_size) == 0) {
@@ -127,6 +205,55 @@ int main(int argc, char** argv) {
 				test_name_filter = argv[i];
 				continue;
 			}
+			if (strncmp(argv[i], "--benchmark", arg_size) == 0) {
+				run_benchmarks = true;
+				continue;
+			}
+			if (strncmp(argv[i], "--no-benchmark", arg_size) == 0) {
+				run_benchmarks = false;
+				continue;
+			}
+			if (strncmp(argv[i], "--benchmark-filter", arg_size) == 0) {
+				if (((i + 1) >= argc) || (strcmp(argv[i + 1], "") == 0)) {
+					OD_ERROR("Missing value for --benchmark-filter");
+					return 1;
+				}
+
+				i++;
+				benchmark_settings.name_filter = argv[i];
+				run_benchmarks = true;
+				continue;
+			}
+			if (strncmp(argv[i], "--benchmark-json", arg_size) == 0) {
+				if (((i + 1) >= argc) || (strcmp(argv[i + 1], "") == 0)) {
+					OD_ERROR("Missing value for --benchmark-json");
+					return 1;
+				}
+
+				i++;
+				benchmark_settings.json_path = argv[i];
+				continue;
+			}
+			if (strncmp(argv[i], "--benchmark-baseline", arg_size) == 0) {
+				if (((i + 1) >= argc) || (strcmp(argv[i + 1], "") == 0)) {
+					OD_ERROR("Missing value for --benchmark-baseline");
+					return 1;
+				}
+
+				i++;
+				benchmark_settings.baseline_path = argv[i];
+				continue;
+			}
+			if (strncmp(argv[i], "--benchmark-max-regression", arg_size) == 0) {
+				if (((i + 1) >= argc)
+					|| !odMain_parse_non_negative_int(argv[i + 1], &benchmark_settings.max_regression_percent)) {
+					OD_ERROR("Missing or invalid value for --benchmark-max-regression (percent)");
+					return 1;
+				}
+
+				i++;
+				continue;
+			}
 		}
 		if (i > 0) {
 			OD_ERROR("Unknown argument \"%s\"", argv[i]);
@@ -141,10 +268,28 @@ int main(int argc, char** argv) {
 			return 1;
 		}
 	}
+	if (run_benchmarks) {
+		if (!odBenchmark_run(&benchmark_settings)) {
+			OD_ERROR("Benchmarks exited with error(s)");
+			return 1;
+		}
+	}
 #endif
 	OD_MAYBE_UNUSED(run_tests);
 	OD_MAYBE_UNUSED(test_filter);
 	OD_MAYBE_UNUSED(test_name_filter);
+	OD_MAYBE_UNUSED(run_benchmarks);
+	OD_MAYBE_UNUSED(benchmark_settings);
+
+	if ((profile_trace_path != nullptr) && !odProfile_begin_trace(profile_trace_path, profile_trace_frames)) {
+		OD_ERROR("Failed to start profile trace");
+		return 1;
+	}
+	if ((frame_watchdog_path != nullptr)
+		&& !odFrameWatchdog_start(frame_watchdog_path, frame_budget_ms, OD_FRAME_WATCHDOG_FILE_COUNT_DEFAULT)) {
+		OD_ERROR("Failed to start frame watchdog");
+		return 1;
+	}
 
 	if (run_lua_client) {
 		odLuaClient lua_client;
@@ -167,6 +312,18 @@ int main(int argc, char** argv) {
 		}
 	}
 
+	// a slow last frame is only written once the next frame would begin
+	if (odFrameWatchdog_get_running() && !odFrameWatchdog_stop()) {
+		OD_ERROR("Failed to write frame watchdog dump");
+		return 1;
+	}
+
+	// runs which end before the requested frame count still write what was recorded
+	if (odProfile_get_tracing() && !odProfile_end_trace()) {
+		OD_ERROR("Failed to write profile trace");
+		return 1;
+	}
+
 	OD_INFO("Exited gracefully");
 	return 0;
 }
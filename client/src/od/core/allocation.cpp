@@ -1,9 +1,72 @@
 #include <od/core/allocation.hpp>
 
+#include <atomic>
 #include <cstdlib>
 
 #include <od/core/debug.h>
 
+// counters are atomic, as any thread may allocate (e.g. each thread's debug string arena)
+struct odAllocationCounters {
+	std::atomic<int64_t> allocation_count;
+	std::atomic<int64_t> free_count;
+	std::atomic<int64_t> allocated_bytes;
+	std::atomic<int64_t> freed_bytes;
+	std::atomic<int64_t> peak_live_bytes;
+};
+// indexed by category, with the total last
+struct odAllocationAccounting {
+	std::atomic<int64_t> live_bytes[OD_ALLOCATION_CATEGORY_COUNT + 1];
+	odAllocationCounters totals[OD_ALLOCATION_CATEGORY_COUNT + 1];
+	odAllocationCounters frame[OD_ALLOCATION_CATEGORY_COUNT + 1];
+	odAllocationStats last_frame[OD_ALLOCATION_CATEGORY_COUNT + 1];
+};
+
+static odAllocationAccounting odAllocation_accounting{};
+
+static void odAllocationCounters_update_peak(odAllocationCounters* counters, int64_t live_bytes) {
+	int64_t peak_live_bytes = counters->peak_live_bytes.load(std::memory_order_relaxed);
+	while ((live_bytes > peak_live_bytes)
+		   && !counters->peak_live_bytes.compare_exchange_weak(
+			   peak_live_bytes, live_bytes, std::memory_order_relaxed)) {
+	}
+}
+static void odAllocation_account(int32_t category, int64_t size, bool is_free) {
+	const int32_t indices[] = {category, OD_ALLOCATION_CATEGORY_COUNT};
+	for (int32_t index : indices) {
+		odAllocationCounters* counters[] = {
+			&odAllocation_accounting.totals[index], &odAllocation_accounting.frame[index]};
+
+		if (is_free) {
+			odAllocation_accounting.live_bytes[index].fetch_sub(size, std::memory_order_relaxed);
+			for (odAllocationCounters* counter : counters) {
+				counter->free_count.fetch_add(1, std::memory_order_relaxed);
+				counter->freed_bytes.fetch_add(size, std::memory_order_relaxed);
+			}
+			continue;
+		}
+
+		int64_t live_bytes = odAllocation_accounting.live_bytes[index].fetch_add(size, std::memory_order_relaxed) + size;
+		for (odAllocationCounters* counter : counters) {
+			counter->allocation_count.fetch_add(1, std::memory_order_relaxed);
+			counter->allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+			odAllocationCounters_update_peak(counter, live_bytes);
+		}
+	}
+}
+static bool odAllocationCategory_get_index(int32_t category, int32_t* out_index) {
+	if (category == OD_ALLOCATION_CATEGORY_ALL) {
+		*out_index = OD_ALLOCATION_CATEGORY_COUNT;
+		return true;
+	}
+
+	if ((category < 0) || (category >= OD_ALLOCATION_CATEGORY_COUNT)) {
+		return false;
+	}
+
+	*out_index = category;
+	return true;
+}
+
 bool odAllocation_check_valid(const odAllocation* allocation) {
 	if (!OD_CHECK(allocation != nullptr)) {
 		return false;
@@ -21,10 +84,14 @@ const char* odAllocation_get_debug_string(const odAllocation* allocation) {
 		static_cast<const void*>(allocation->ptr));
 }
 bool odAllocation_init(odAllocation* allocation, int32_t size) {
-	OD_TRACE("allocation=%s, size=%d", odAllocation_get_debug_string(allocation), size);
+	return odAllocation_init_category(allocation, size, OD_ALLOCATION_CATEGORY_DEFAULT);
+}
+bool odAllocation_init_category(odAllocation* allocation, int32_t size, int32_t category) {
+	OD_TRACE("allocation=%s, size=%d, category=%d", odAllocation_get_debug_string(allocation), size, category);
 
 	if (!OD_DEBUG_CHECK(odAllocation_check_valid(allocation))
-		|| !OD_DEBUG_CHECK(size >= 0)) {
+		|| !OD_DEBUG_CHECK(size >= 0)
+		|| !OD_DEBUG_CHECK((category >= 0) && (category < OD_ALLOCATION_CATEGORY_COUNT))) {
 		return false;
 	}
 
@@ -38,6 +105,10 @@ bool odAllocation_init(odAllocation* allocation, int32_t size) {
 	if (!OD_CHECK(allocation->ptr != nullptr)) {
 		return false;
 	}
+
+	allocation->size = size;
+	allocation->category = category;
+	odAllocation_account(category, size, /*is_free*/ false);
 	OD_TRACE("allocation->ptr=%p", static_cast<const void*>(allocation->ptr));
 
 	return true;
@@ -49,9 +120,15 @@ void odAllocation_destroy(odAllocation* allocation) {
 		return;
 	}
 
+	if (allocation->ptr != nullptr) {
+		odAllocation_account(allocation->category, allocation->size, /*is_free*/ true);
+	}
+
 	free(allocation->ptr);
 
 	allocation->ptr = nullptr;
+	allocation->size = 0;
+	allocation->category = OD_ALLOCATION_CATEGORY_DEFAULT;
 }
 void odAllocation_swap(odAllocation* allocation1, odAllocation* allocation2) {
 	if (!OD_DEBUG_CHECK(odAllocation_check_valid(allocation1))
@@ -60,10 +137,16 @@ void odAllocation_swap(odAllocation* allocation1, odAllocation* allocation2) {
 	}
 
 	void* swap_ptr = allocation1->ptr;
+	int32_t swap_size = allocation1->size;
+	int32_t swap_category = allocation1->category;
 
 	allocation1->ptr = allocation2->ptr;
+	allocation1->size = allocation2->size;
+	allocation1->category = allocation2->category;
 
 	allocation2->ptr = swap_ptr;
+	allocation2->size = swap_size;
+	allocation2->category = swap_category;
 }
 void* odAllocation_get(odAllocation* allocation) {
 	if (!OD_DEBUG_CHECK(odAllocation_check_valid(allocation))) {
@@ -75,7 +158,83 @@ void* odAllocation_get(odAllocation* allocation) {
 const void* odAllocation_get_const(const odAllocation* allocation) {
 	return odAllocation_get(const_cast<odAllocation*>(allocation));
 }
-odAllocation::odAllocation() : ptr{nullptr} {
+int32_t odAllocation_get_size(const odAllocation* allocation) {
+	if (!OD_DEBUG_CHECK(odAllocation_check_valid(allocation))) {
+		return 0;
+	}
+
+	return allocation->size;
+}
+const char* odAllocationCategory_get_name(int32_t category) {
+	switch (category) {
+		case OD_ALLOCATION_CATEGORY_ALL: {
+			return "all";
+		}
+		case OD_ALLOCATION_CATEGORY_DEFAULT: {
+			return "default";
+		}
+		case OD_ALLOCATION_CATEGORY_ARRAY: {
+			return "array";
+		}
+		case OD_ALLOCATION_CATEGORY_IMAGE: {
+			return "image";
+		}
+		case OD_ALLOCATION_CATEGORY_FILE: {
+			return "file";
+		}
+		case OD_ALLOCATION_CATEGORY_SCRATCH: {
+			return "scratch";
+		}
+		default: {
+			return "\"<allocation_category_unknown>\"";
+		}
+	}
+}
+bool odAllocation_get_stats(int32_t category, odAllocationStats* out_stats) {
+	int32_t index = 0;
+	if (!OD_DEBUG_CHECK(out_stats != nullptr)
+		|| !OD_DEBUG_CHECK(odAllocationCategory_get_index(category, &index))) {
+		return false;
+	}
+
+	const odAllocationCounters* totals = &odAllocation_accounting.totals[index];
+	*out_stats = odAllocationStats{
+		totals->allocation_count.load(std::memory_order_relaxed),
+		totals->free_count.load(std::memory_order_relaxed),
+		totals->allocated_bytes.load(std::memory_order_relaxed),
+		totals->freed_bytes.load(std::memory_order_relaxed),
+		odAllocation_accounting.live_bytes[index].load(std::memory_order_relaxed),
+		totals->peak_live_bytes.load(std::memory_order_relaxed),
+	};
+	return true;
+}
+bool odAllocation_get_frame_stats(int32_t category, odAllocationStats* out_stats) {
+	int32_t index = 0;
+	if (!OD_DEBUG_CHECK(out_stats != nullptr)
+		|| !OD_DEBUG_CHECK(odAllocationCategory_get_index(category, &index))) {
+		return false;
+	}
+
+	*out_stats = odAllocation_accounting.last_frame[index];
+	return true;
+}
+void odAllocation_end_frame(void) {
+	for (int32_t i = 0; i <= OD_ALLOCATION_CATEGORY_COUNT; i++) {
+		odAllocationCounters* frame = &odAllocation_accounting.frame[i];
+		int64_t live_bytes = odAllocation_accounting.live_bytes[i].load(std::memory_order_relaxed);
+
+		// the next frame's peak starts from what is live now
+		odAllocation_accounting.last_frame[i] = odAllocationStats{
+			frame->allocation_count.exchange(0, std::memory_order_relaxed),
+			frame->free_count.exchange(0, std::memory_order_relaxed),
+			frame->allocated_bytes.exchange(0, std::memory_order_relaxed),
+			frame->freed_bytes.exchange(0, std::memory_order_relaxed),
+			live_bytes,
+			frame->peak_live_bytes.exchange(live_bytes, std::memory_order_relaxed),
+		};
+	}
+}
+odAllocation::odAllocation() : ptr{nullptr}, size{0}, category{OD_ALLOCATION_CATEGORY_DEFAULT} {
 }
 odAllocation::odAllocation(odAllocation&& other) : odAllocation{} {
 	odAllocation_swap(this, &other);
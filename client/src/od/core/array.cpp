@@ -117,7 +117,7 @@ bool odTrivialArray_set_capacity(odTrivialArray* array, int32_t new_capacity, in
 	odAllocation new_allocation{};
 	// over-allocate to guarantee null termination of allocated strings
 	int32_t new_allocation_size = new_size + static_cast<int32_t>(sizeof(char32_t));
-	if (!OD_CHECK(odAllocation_init(&new_allocation, new_allocation_size))) {
+	if (!OD_CHECK(odAllocation_init_category(&new_allocation, new_allocation_size, OD_ALLOCATION_CATEGORY_ARRAY))) {
 		return false;
 	}
 
@@ -390,7 +390,7 @@ bool odArray_set_capacity(odArray* array, int32_t new_capacity) {
 	}
 
 	odAllocation new_allocation;
-	if (!OD_CHECK(odAllocation_init(&new_allocation, new_capacity * array->type->size))) {
+	if (!OD_CHECK(odAllocation_init_category(&new_allocation, new_capacity * array->type->size, OD_ALLOCATION_CATEGORY_ARRAY))) {
 		return false;
 	}
 
@@ -4,45 +4,69 @@
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <atomic>
+
+#if !OD_BUILD_EMSCRIPTEN
+#include <chrono>
+#include <thread>
+#endif
+
+#include <od/core/scratch_arena.hpp>
 
 // we intentionally don't mix streams, to avoid out-of-order output
 #define OD_DEBUG_OUT_STREAM stdout
 
 #define OD_TEMP_BUFFER_CAPACITY 262144
 
-static int32_t odLog_logged_error_count = 0;
+#define OD_LOG_TIME_STR_CAPACITY 9
+#define OD_LOG_ASYNC_SLOT_COUNT 1024  // power of 2, see odLogAsync_push()
+#define OD_LOG_ASYNC_IDLE_SLEEP_MS 2
+#define OD_LOG_ASYNC_DROPPED_LINE_CAPACITY 64
+
+// incremented from any thread that logs
+static std::atomic<int32_t> odLog_logged_error_count{0};
 
 static int32_t odLogLevel_max = OD_LOG_LEVEL_DEFAULT;
 
 static bool (*odDebug_platform_backtrace_handler)() = nullptr;
 static bool odDebug_backtrace_handler_enabled = true;
 
-void* odDebugString_allocate(int32_t size, int32_t alignment) {
-	static int32_t currentSize = 0;
-	static char buffer[OD_TEMP_BUFFER_CAPACITY] = {0};
+enum odDebugStringArenaState {
+	OD_DEBUG_STRING_ARENA_STATE_NEW,
+	OD_DEBUG_STRING_ARENA_STATE_INITIALIZING,
+	OD_DEBUG_STRING_ARENA_STATE_READY,
+	OD_DEBUG_STRING_ARENA_STATE_DESTROYED,
+};
+struct odDebugStringArena {
+	odScratchArena arena;
 
-	int32_t allocated_size = size + alignment - 1;
+	~odDebugStringArena();
+};
 
-	if (allocated_size > OD_TEMP_BUFFER_CAPACITY) {
-		return nullptr;
-	}
+// trivially destructible, so it can still be read once the thread's arena is destroyed
+static thread_local odDebugStringArenaState odDebugString_arena_state = OD_DEBUG_STRING_ARENA_STATE_NEW;
+static thread_local odDebugStringArena odDebugString_arena;
 
-	if ((currentSize + allocated_size) > OD_TEMP_BUFFER_CAPACITY) {
-		currentSize = 0;
-	}
-	char* allocation = buffer + currentSize;
-	memset(static_cast<void*>(allocation), 0, static_cast<size_t>(allocated_size));
-	currentSize += allocated_size;
+odDebugStringArena::~odDebugStringArena() {
+	odDebugString_arena_state = OD_DEBUG_STRING_ARENA_STATE_DESTROYED;
+}
 
-	uintptr_t allocation_uint = reinterpret_cast<uintptr_t>(allocation);
-	uintptr_t aligned_allocation_uint = ((
-		(allocation_uint + static_cast<uintptr_t>(alignment) - 1) / static_cast<uintptr_t>(alignment))
-		* static_cast<uintptr_t>(alignment));
-	// calculate offset and add that to pointer instead of casting (performance-no-int-to-ptr)
-	uintptr_t aligned_offset_uint = aligned_allocation_uint - reinterpret_cast<uintptr_t>(allocation);
-	char* aligned_allocation = allocation + aligned_offset_uint;
+void* odDebugString_allocate(int32_t size, int32_t alignment) {
+	// allocating the arena can itself format debug strings, which get nothing until it is ready
+	if (odDebugString_arena_state != OD_DEBUG_STRING_ARENA_STATE_READY) {
+		if (odDebugString_arena_state != OD_DEBUG_STRING_ARENA_STATE_NEW) {
+			return nullptr;
+		}
+
+		odDebugString_arena_state = OD_DEBUG_STRING_ARENA_STATE_INITIALIZING;
+		bool init_ok = odScratchArena_init(&odDebugString_arena.arena, OD_TEMP_BUFFER_CAPACITY);
+		odDebugString_arena_state = init_ok ? OD_DEBUG_STRING_ARENA_STATE_READY : OD_DEBUG_STRING_ARENA_STATE_NEW;
+		if (!init_ok) {
+			return nullptr;
+		}
+	}
 
-	return aligned_allocation;
+	return odScratchArena_allocate_wrapping(&odDebugString_arena.arena, size, alignment);
 }
 const char* odDebugString_format_variadic(const char* format_c_str, va_list* args) {
 	if (format_c_str == nullptr) {
@@ -153,6 +177,194 @@ static const char* odLog_get_short_filename(const char* file) {
 
 	return file;
 }
+static void odLog_get_time_str(char out_time_str[OD_LOG_TIME_STR_CAPACITY]) {
+	time_t time_val = time(nullptr);
+	struct tm time_parts{};
+#if defined(_WIN32)
+	localtime_s(&time_parts, &time_val);
+#else
+	localtime_r(&time_val, &time_parts);
+#endif
+	if (strftime(out_time_str, OD_LOG_TIME_STR_CAPACITY, "%H:%M:%S", &time_parts) == 0) {
+		out_time_str[0] = '\0';
+	}
+}
+
+#if !OD_BUILD_EMSCRIPTEN
+/* Bounded multi-producer queue of formatted lines, with a single writer thread.
+Each slot's sequence tells producers and the writer whose turn it is:
+seq == pos means free for the producer at pos, seq == pos + 1 means written and ready to flush. */
+struct odLogAsyncSlot {
+	std::atomic<uint32_t> sequence;
+	int32_t size;
+	char line[OD_LOG_ASYNC_LINE_CAPACITY];
+};
+struct odLogAsync {
+	odLogAsyncSlot slots[OD_LOG_ASYNC_SLOT_COUNT];
+	std::atomic<uint32_t> push_pos;
+	std::atomic<uint32_t> flushed_pos;
+	std::atomic<int32_t> dropped_count;
+	std::atomic<int32_t> producer_count;  // threads between checking odLog_async_enabled and finishing their push
+	std::atomic<bool> running;
+	uint32_t write_pos;  // writer thread only
+	int32_t dropped_reported_count;  // writer thread only
+	void (*write_fn)(const char* str, int32_t size);  // nullptr for OD_DEBUG_OUT_STREAM; only set while stopped
+	std::thread thread;
+};
+
+static odLogAsync odLog_async;
+static std::atomic<bool> odLog_async_enabled{false};
+
+static bool odLogAsync_push(
+	const odLogContext* log_context, int32_t log_level, const char* format_c_str, va_list* args, bool wait_if_full) {
+	uint32_t pos = odLog_async.push_pos.load(std::memory_order_relaxed);
+	odLogAsyncSlot* slot = nullptr;
+	for (;;) {
+		slot = &odLog_async.slots[pos & (OD_LOG_ASYNC_SLOT_COUNT - 1)];
+		uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+		int32_t diff = static_cast<int32_t>(sequence - pos);
+		if (diff == 0) {
+			if (odLog_async.push_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			// full: the writer hasn't reached this slot since the last lap
+			if (!wait_if_full) {
+				odLog_async.dropped_count.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			if (!odLog_async.running.load(std::memory_order_acquire)) {
+				return false;
+			}
+
+			std::this_thread::yield();
+			pos = odLog_async.push_pos.load(std::memory_order_relaxed);
+		} else {
+			pos = odLog_async.push_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	char time_str[OD_LOG_TIME_STR_CAPACITY] = {};
+	odLog_get_time_str(time_str);
+
+	// one byte is kept back for the newline; longer lines are truncated
+	const int32_t text_capacity = OD_LOG_ASYNC_LINE_CAPACITY - 1;
+	int32_t size = snprintf(
+		slot->line, static_cast<size_t>(text_capacity), "[%.8s %s %s:%d %s] ", time_str, odLogLevel_get_name(log_level),
+		odLog_get_short_filename(log_context->file), log_context->line, log_context->function);
+	if ((size >= 0) && (size < text_capacity)) {
+		int32_t message_size = vsnprintf(
+			slot->line + size, static_cast<size_t>(text_capacity - size), format_c_str, *args);
+		size = (message_size >= 0) ? (size + message_size) : size;
+	}
+
+	// sprintf-style calls return the untruncated count
+	if (size < 0) {
+		size = 0;
+	} else if (size > (text_capacity - 1)) {
+		size = text_capacity - 1;
+	}
+	slot->line[size] = '\n';
+	slot->size = size + 1;
+
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+static void odLogAsync_write(const char* str, int32_t size) {
+	if (odLog_async.write_fn != nullptr) {
+		odLog_async.write_fn(str, size);
+		return;
+	}
+
+	fwrite(str, 1, static_cast<size_t>(size), OD_DEBUG_OUT_STREAM);
+}
+static int32_t odLogAsync_write_ready(void) {
+	int32_t written_count = 0;
+	for (;;) {
+		uint32_t pos = odLog_async.write_pos;
+		odLogAsyncSlot* slot = &odLog_async.slots[pos & (OD_LOG_ASYNC_SLOT_COUNT - 1)];
+		if (slot->sequence.load(std::memory_order_acquire) != (pos + 1)) {
+			break;
+		}
+
+		odLogAsync_write(slot->line, slot->size);
+		slot->sequence.store(pos + OD_LOG_ASYNC_SLOT_COUNT, std::memory_order_release);
+		odLog_async.write_pos = pos + 1;
+		written_count++;
+	}
+
+	int32_t dropped_count = odLog_async.dropped_count.load(std::memory_order_relaxed);
+	if (dropped_count != odLog_async.dropped_reported_count) {
+		char dropped_line[OD_LOG_ASYNC_DROPPED_LINE_CAPACITY] = {};
+		int32_t size = snprintf(
+			dropped_line, sizeof(dropped_line), "[log] async log buffer full, dropped %d line(s)\n",
+			dropped_count - odLog_async.dropped_reported_count);
+		if ((size > 0) && (size < OD_LOG_ASYNC_DROPPED_LINE_CAPACITY)) {
+			odLogAsync_write(dropped_line, size);
+		}
+		odLog_async.dropped_reported_count = dropped_count;
+		written_count++;
+	}
+
+	if (written_count > 0) {
+		if (odLog_async.write_fn == nullptr) {
+			fflush(OD_DEBUG_OUT_STREAM);
+		}
+		odLog_async.flushed_pos.store(odLog_async.write_pos, std::memory_order_release);
+	}
+	return written_count;
+}
+static void odLogAsync_run(void) {
+	for (;;) {
+		// read before writing, so lines pushed before stopping are always written
+		bool running = odLog_async.running.load(std::memory_order_acquire);
+		if (odLogAsync_write_ready() > 0) {
+			continue;
+		}
+		if (!running) {
+			break;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(OD_LOG_ASYNC_IDLE_SLEEP_MS));
+	}
+}
+static void odLogAsync_flush(void) {
+	uint32_t pushed_pos = odLog_async.push_pos.load(std::memory_order_acquire);
+	while (static_cast<int32_t>(odLog_async.flushed_pos.load(std::memory_order_acquire) - pushed_pos) < 0) {
+		// once stopping, the writer drains everything before exiting, and nothing is left to wait for
+		if (!odLog_async.running.load(std::memory_order_acquire)) {
+			return;
+		}
+		std::this_thread::yield();
+	}
+}
+/* Returns false if async logging is disabled, or the line must be written directly instead.
+Producers are counted, so odLog_set_async(false) waits for pushes in progress before stopping the writer. */
+static bool odLogAsync_log(const odLogContext* log_context, int32_t log_level, const char* format_c_str, va_list* args) {
+	odLog_async.producer_count.fetch_add(1, std::memory_order_seq_cst);
+	if (!odLog_async_enabled.load(std::memory_order_seq_cst)) {
+		odLog_async.producer_count.fetch_sub(1, std::memory_order_release);
+		return false;
+	}
+
+	bool is_error = (log_level <= OD_LOG_LEVEL_ERROR);
+	bool pushed = odLogAsync_push(log_context, log_level, format_c_str, args, /*wait_if_full*/ is_error);
+	if (pushed && is_error) {
+		odLogAsync_flush();
+	}
+	odLog_async.producer_count.fetch_sub(1, std::memory_order_release);
+
+	// errors are never dropped
+	return pushed || !is_error;
+}
+static void odLogAsync_stop_at_exit(void) {
+	if (!odLog_set_async(false)) {
+		fprintf(OD_DEBUG_OUT_STREAM, "error stopping async logging at exit\n");
+		fflush(OD_DEBUG_OUT_STREAM);
+	}
+}
+#endif  // !OD_BUILD_EMSCRIPTEN
+
 void odLog_log_variadic(const struct odLogContext* log_context, int32_t log_level, const char* format_c_str, va_list* args) {
 	if (OD_BUILD_DEBUG) {
 		// preconditions without assertions/logs special case here:
@@ -183,12 +395,20 @@ void odLog_log_variadic(const struct odLogContext* log_context, int32_t log_leve
 	}
 
 	if (log_level <= OD_LOG_LEVEL_WARN) {
-		odLog_logged_error_count++;
+		odLog_logged_error_count.fetch_add(1, std::memory_order_relaxed);
 	}
 
-	time_t time_val = time(nullptr);
-	char time_str[9] = {};
-	strncpy(time_str, ctime(&time_val) + 11, 9);
+#if !OD_BUILD_EMSCRIPTEN
+	if (odLogAsync_log(log_context, log_level, format_c_str, args)) {
+		if (OD_BUILD_DEBUG && (log_level <= OD_LOG_LEVEL_ERROR)) {
+			odDebug_error();
+		}
+		return;
+	}
+#endif  // !OD_BUILD_EMSCRIPTEN
+
+	char time_str[OD_LOG_TIME_STR_CAPACITY] = {};
+	odLog_get_time_str(time_str);
 
     fprintf(OD_DEBUG_OUT_STREAM, "[%.8s %s %s:%d %s] ", time_str, odLogLevel_get_name(log_level), odLog_get_short_filename(log_context->file), log_context->line, log_context->function);
 
@@ -221,7 +441,89 @@ bool odLog_assert(const struct odLogContext* log_context, bool success, const ch
 	return success;
 }
 int32_t odLog_get_logged_error_count() {
-	return odLog_logged_error_count;
+	return odLog_logged_error_count.load(std::memory_order_relaxed);
+}
+void odLog_set_logged_error_count(int32_t count) {
+	odLog_logged_error_count.store(count, std::memory_order_relaxed);
+}
+bool odLog_set_async(bool enabled) {
+#if OD_BUILD_EMSCRIPTEN
+	return !enabled;
+#else
+	if (enabled == odLog_async_enabled.load(std::memory_order_acquire)) {
+		return true;
+	}
+
+	if (enabled) {
+		static bool stop_at_exit_registered = false;
+		if (!stop_at_exit_registered) {
+			if (atexit(odLogAsync_stop_at_exit) != 0) {
+				return false;
+			}
+			stop_at_exit_registered = true;
+		}
+
+		for (uint32_t i = 0; i < OD_LOG_ASYNC_SLOT_COUNT; i++) {
+			odLog_async.slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		odLog_async.push_pos.store(0, std::memory_order_relaxed);
+		odLog_async.flushed_pos.store(0, std::memory_order_relaxed);
+		odLog_async.dropped_count.store(0, std::memory_order_relaxed);
+		odLog_async.write_pos = 0;
+		odLog_async.dropped_reported_count = 0;
+		odLog_async.running.store(true, std::memory_order_release);
+
+		fflush(OD_DEBUG_OUT_STREAM);
+		odLog_async.thread = std::thread{odLogAsync_run};
+		odLog_async_enabled.store(true, std::memory_order_release);
+		return true;
+	}
+
+	// new lines are written directly from here; the writer drains everything pushed before it stops
+	odLog_async_enabled.store(false, std::memory_order_seq_cst);
+	while (odLog_async.producer_count.load(std::memory_order_seq_cst) > 0) {
+		std::this_thread::yield();
+	}
+	odLog_async.running.store(false, std::memory_order_release);
+	odLog_async.thread.join();
+	return true;
+#endif  // #else  // OD_BUILD_EMSCRIPTEN
+}
+bool odLog_set_async_write_fn(void (*write_fn)(const char* str, int32_t size)) {
+#if OD_BUILD_EMSCRIPTEN
+	return write_fn == nullptr;
+#else
+	if (odLog_async_enabled.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	odLog_async.write_fn = write_fn;
+	return true;
+#endif  // #else  // OD_BUILD_EMSCRIPTEN
+}
+bool odLog_get_async(void) {
+#if OD_BUILD_EMSCRIPTEN
+	return false;
+#else
+	return odLog_async_enabled.load(std::memory_order_acquire);
+#endif
+}
+int32_t odLog_get_async_dropped_count(void) {
+#if OD_BUILD_EMSCRIPTEN
+	return 0;
+#else
+	return odLog_async.dropped_count.load(std::memory_order_relaxed);
+#endif
+}
+void odLog_flush(void) {
+#if !OD_BUILD_EMSCRIPTEN
+	if (odLog_async_enabled.load(std::memory_order_acquire)) {
+		odLogAsync_flush();
+		return;
+	}
+#endif
+
+	fflush(OD_DEBUG_OUT_STREAM);
 }
 
 void odLogContext_init(struct odLogContext* log_context, const char* file, const char* function, int32_t line) {
@@ -244,7 +546,8 @@ void odLogContext_init(struct odLogContext* log_context, const char* file, const
 	*log_context = odLogContext{file, function, line};
 }
 const odLogContext* odLogContext_init_temp(const char* file, const char* function, int32_t line) {
-	static odLogContext log_context{};
+	// per thread, as it is returned to the caller
+	static thread_local odLogContext log_context{};
 	log_context = odLogContext_init_inline(file, function, line);
 
 	return &log_context;
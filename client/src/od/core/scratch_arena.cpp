@@ -0,0 +1,140 @@
+#include <od/core/scratch_arena.hpp>
+
+#include <cstring>
+
+#include <od/core/debug.h>
+
+/* Nothing here logs outside of failed checks, as odDebugString allocates from a scratch arena:
+debug strings formatted here would recurse. */
+
+bool odScratchArena_check_valid(const odScratchArena* arena) {
+	if (!OD_CHECK(arena != nullptr)
+		|| !OD_CHECK(arena->capacity >= 0)
+		|| !OD_CHECK(arena->size >= 0)
+		|| !OD_CHECK(arena->size <= arena->capacity)
+		|| !OD_CHECK((arena->capacity == 0) || (arena->allocation.ptr != nullptr))) {
+		return false;
+	}
+
+	return true;
+}
+const char* odScratchArena_get_debug_string(const odScratchArena* arena) {
+	if (arena == nullptr) {
+		return "null";
+	}
+
+	return odDebugString_format("{\"size\": %d, \"capacity\": %d}", arena->size, arena->capacity);
+}
+bool odScratchArena_init(odScratchArena* arena, int32_t capacity) {
+	if (!OD_DEBUG_CHECK(odScratchArena_check_valid(arena))
+		|| !OD_DEBUG_CHECK(capacity >= 0)) {
+		return false;
+	}
+
+	odScratchArena_destroy(arena);
+
+	if (!OD_CHECK(odAllocation_init_category(&arena->allocation, capacity, OD_ALLOCATION_CATEGORY_SCRATCH))) {
+		return false;
+	}
+
+	arena->capacity = capacity;
+	return true;
+}
+void odScratchArena_destroy(odScratchArena* arena) {
+	if (!OD_DEBUG_CHECK(arena != nullptr)) {
+		return;
+	}
+
+	// size and capacity are cleared first, so allocations made while the buffer is freed can't reach it
+	arena->size = 0;
+	arena->capacity = 0;
+	odAllocation_destroy(&arena->allocation);
+}
+void odScratchArena_swap(odScratchArena* arena1, odScratchArena* arena2) {
+	if (!OD_DEBUG_CHECK(arena1 != nullptr)
+		|| !OD_DEBUG_CHECK(arena2 != nullptr)) {
+		return;
+	}
+
+	odAllocation_swap(&arena1->allocation, &arena2->allocation);
+
+	int32_t capacity_swap = arena1->capacity;
+	arena1->capacity = arena2->capacity;
+	arena2->capacity = capacity_swap;
+
+	int32_t size_swap = arena1->size;
+	arena1->size = arena2->size;
+	arena2->size = size_swap;
+}
+int32_t odScratchArena_get_capacity(const odScratchArena* arena) {
+	if (!OD_DEBUG_CHECK(odScratchArena_check_valid(arena))) {
+		return 0;
+	}
+
+	return arena->capacity;
+}
+int32_t odScratchArena_get_size(const odScratchArena* arena) {
+	if (!OD_DEBUG_CHECK(odScratchArena_check_valid(arena))) {
+		return 0;
+	}
+
+	return arena->size;
+}
+static void* odScratchArena_allocate_impl(odScratchArena* arena, int32_t size, int32_t alignment, bool wrap) {
+	if (!OD_DEBUG_CHECK(odScratchArena_check_valid(arena))
+		|| !OD_DEBUG_CHECK(size >= 0)
+		|| !OD_DEBUG_CHECK(alignment > 0)
+		|| !OD_DEBUG_CHECK((alignment & (alignment - 1)) == 0)) {
+		return nullptr;
+	}
+
+	// worst case size, so the start can be aligned wherever the buffer happens to be
+	int32_t allocated_size = size + alignment - 1;
+	if (allocated_size > arena->capacity) {
+		return nullptr;
+	}
+
+	if ((arena->size + allocated_size) > arena->capacity) {
+		if (!wrap) {
+			return nullptr;
+		}
+
+		arena->size = 0;
+	}
+
+	char* allocation = static_cast<char*>(arena->allocation.ptr) + arena->size;
+	memset(static_cast<void*>(allocation), 0, static_cast<size_t>(allocated_size));
+	arena->size += allocated_size;
+
+	// calculate offset and add that to pointer instead of casting (performance-no-int-to-ptr)
+	uintptr_t allocation_uint = reinterpret_cast<uintptr_t>(allocation);
+	uintptr_t alignment_mask = static_cast<uintptr_t>(alignment) - 1;
+	uintptr_t aligned_offset_uint = ((allocation_uint + alignment_mask) & ~alignment_mask) - allocation_uint;
+	return static_cast<void*>(allocation + aligned_offset_uint);
+}
+void* odScratchArena_allocate(odScratchArena* arena, int32_t size, int32_t alignment) {
+	return odScratchArena_allocate_impl(arena, size, alignment, /*wrap*/ false);
+}
+void* odScratchArena_allocate_wrapping(odScratchArena* arena, int32_t size, int32_t alignment) {
+	return odScratchArena_allocate_impl(arena, size, alignment, /*wrap*/ true);
+}
+void odScratchArena_reset(odScratchArena* arena) {
+	if (!OD_DEBUG_CHECK(odScratchArena_check_valid(arena))) {
+		return;
+	}
+
+	arena->size = 0;
+}
+
+odScratchArena::odScratchArena() : allocation{}, capacity{0}, size{0} {
+}
+odScratchArena::odScratchArena(odScratchArena&& other) : odScratchArena{} {
+	odScratchArena_swap(this, &other);
+}
+odScratchArena& odScratchArena::operator=(odScratchArena&& other) {
+	odScratchArena_swap(this, &other);
+	return *this;
+}
+odScratchArena::~odScratchArena() {
+	odScratchArena_destroy(this);
+}
@@ -190,6 +190,53 @@ bool odString_extend_formatted(odString* string, const char* format_c_str, ...)
 
 	return result;
 }
+bool odString_extend_json_string(odString* string, const char* str) {
+	if (!OD_DEBUG_CHECK(odString_check_valid(string))
+		|| !OD_DEBUG_CHECK(str != nullptr)) {
+		return false;
+	}
+
+	if (!OD_CHECK(odString_extend(string, "\"", 1))) {
+		return false;
+	}
+
+	for (const char* iter = str; *iter != '\0'; iter++) {
+		const char* escaped = nullptr;
+		switch (*iter) {
+			case '"': {
+				escaped = "\\\"";
+				break;
+			}
+			case '\\': {
+				escaped = "\\\\";
+				break;
+			}
+			case '\n': {
+				escaped = "\\n";
+				break;
+			}
+			case '\t': {
+				escaped = "\\t";
+				break;
+			}
+			default: {
+				break;
+			}
+		}
+
+		bool ok = true;
+		if (escaped != nullptr) {
+			ok = odString_extend(string, escaped, 2);
+		} else if (static_cast<unsigned char>(*iter) >= 0x20) {
+			ok = odString_extend(string, iter, 1);
+		}
+		if (!OD_CHECK(ok)) {
+			return false;
+		}
+	}
+
+	return OD_CHECK(odString_extend(string, "\"", 1));
+}
 bool odString_pop(odString* string, int32_t pop_count) {
 	if (!OD_DEBUG_CHECK(odString_check_valid(string))) {
 		return false;
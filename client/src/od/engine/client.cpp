@@ -7,9 +7,12 @@
 #endif   // OD_BUILD_EMSCRIPTEN
 
 #include <od/core/math.h>
+#include <od/core/allocation.h>
 #include <od/core/debug.h>
 #include <od/core/bounds.h>
 #include <od/platform/primitive.h>
+#include <od/platform/frame_watchdog.h>
+#include <od/platform/profile.hpp>
 #include <od/platform/image.hpp>
 #include <od/platform/texture.hpp>
 #include <od/platform/render_texture.hpp>
@@ -151,6 +154,8 @@ bool odClient_set_settings(odClient* client, const odClientSettings* settings) {
 	return true;
 }
 bool odClient_step(odClient* client) {
+	OD_PROFILE_SCOPE("odClient_step");
+
 	if (!OD_CHECK(client != nullptr)) {
 		return false;
 	}
@@ -159,6 +164,8 @@ bool odClient_step(odClient* client) {
 		return false;
 	}
 
+	odFrameWatchdog_begin_frame();
+
 	int32_t entity_vertices_count;
 	const odVertex* entity_vertices = odEntityIndex_get_all_vertices(&client->entity_index, &entity_vertices_count);
 	if (entity_vertices_count > 0) {
@@ -301,6 +308,10 @@ bool odClient_step(odClient* client) {
 	}
 
 	odClientFrame_start_next(&client->frame);
+	odAllocation_end_frame();
+
+	// before the window step, which waits for the next frame
+	odFrameWatchdog_end_frame();
 
 	if (!odWindow_step(&client->window)) {
 		return false;
@@ -2,12 +2,15 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 
 #include <od/core/math.h>
 #include <od/core/bounds.h>
+#include <od/core/matrix.h>
 #include <od/core/array.hpp>
 #include <od/core/vertex.h>
 #include <od/platform/primitive.h>
+#include <od/platform/profile.hpp>
 #include <od/engine/tagset.h>
 #include <od/engine/entity.hpp>
 
@@ -16,6 +19,11 @@ typedef int32_t odEntityChunkId;
 
 struct odEntityIndexEntity {
 	odEntity entity;
+
+	// state as of the last odEntityIndex_save_previous(), for render interpolation;
+	// reset to the current state when an id is first set, or reused after destroy
+	odBounds previous_bounds;
+	odMatrix previous_transform;
 };
 struct odEntityChunkIterator {
 	odEntityChunkCoord x_start;
@@ -69,12 +77,17 @@ static OD_NO_DISCARD bool
 odEntityIndex_ensure_count(odEntityIndex* entity_index, int32_t min_count);
 static OD_NO_DISCARD odEntityIndexEntity*
 odEntityIndex_get_or_add_allocation(odEntityIndex* entity_index, odEntityId entity_id);
+static void
+odEntityIndex_get_sprite_vertices_impl(
+	const odBounds* bounds, const odEntitySprite* sprite, const odMatrix* transform, odVertex* out_vertices);
 static OD_NO_DISCARD bool
 odEntityIndex_update_vertices_impl(odEntityIndex* entity_index, const odEntityIndexEntity* entity);
 static OD_NO_DISCARD bool
 odEntityIndex_set_collider_impl(odEntityIndex* entity_index, odEntityCollider* old_collider, const odEntityCollider* collider);
 static OD_NO_DISCARD bool
 odEntityIndex_set_sprite_impl(odEntityIndex* entity_index, odEntitySprite* old_sprite, const odEntitySprite* sprite);
+static void
+odEntityIndex_reset_previous_impl(odEntityIndexEntity* entity);
 
 bool odEntityIndexEntity_check_valid(const odEntityIndexEntity* entity) {
 	if (!OD_CHECK(entity != nullptr)) {
@@ -402,15 +415,21 @@ odEntityIndexEntity* odEntityIndex_get_or_add_allocation(odEntityIndex* entity_i
 
 	return entity_allocation;
 }
+void odEntityIndex_get_sprite_vertices_impl(
+	const odBounds* bounds, const odEntitySprite* sprite, const odMatrix* transform, odVertex* out_vertices) {
+	odSpritePrimitive sprite_primitive{*bounds, sprite->texture_bounds, sprite->color, sprite->depth};
+	odSpritePrimitive_get_vertices(&sprite_primitive, out_vertices);
+
+	for (int32_t i = 0; i < OD_ENTITY_VERTEX_COUNT; i++) {
+		odVertex_transform_3d(out_vertices + i, transform);
+	}
+}
 bool odEntityIndex_update_vertices_impl(odEntityIndex* entity_index, const odEntityIndexEntity* entity) {
 	if (!OD_DEBUG_CHECK(entity_index != nullptr)
 		|| !OD_DEBUG_CHECK(odEntityIndexEntity_check_valid(entity))) {
 		return false;
 	}
 
-	odSpritePrimitive sprite{};
-	odEntity_get_sprite(&entity->entity, &sprite);
-
 	int32_t vertex_index = static_cast<int32_t>(entity->entity.collider.id) * OD_SPRITE_VERTEX_COUNT;
 
 	if (!OD_DEBUG_CHECK((vertex_index + OD_SPRITE_VERTEX_COUNT) <= entity_index->entity_vertices.get_count())) {
@@ -422,11 +441,8 @@ bool odEntityIndex_update_vertices_impl(odEntityIndex* entity_index, const odEnt
 		return false;
 	}
 
-	odSpritePrimitive_get_vertices(&sprite, vertices);
-
-	for (int32_t i = 0; i < OD_ENTITY_VERTEX_COUNT; i++) {
-		odVertex_transform_3d(vertices + i, &entity->entity.sprite.transform);
-	}
+	odEntityIndex_get_sprite_vertices_impl(
+		&entity->entity.collider.bounds, &entity->entity.sprite, &entity->entity.sprite.transform, vertices);
 
 	return true;
 }
@@ -470,6 +486,14 @@ bool odEntityIndex_set_sprite_impl(odEntityIndex* entity_index, odEntitySprite*
 
 	return true;
 }
+void odEntityIndex_reset_previous_impl(odEntityIndexEntity* entity) {
+	if (!OD_DEBUG_CHECK(odEntityIndexEntity_check_valid(entity))) {
+		return;
+	}
+
+	entity->previous_bounds = entity->entity.collider.bounds;
+	entity->previous_transform = entity->entity.sprite.transform;
+}
 const char* odEntityIndex_get_debug_string(const odEntityIndex* entity_index) {
 	if (entity_index == nullptr) {
 		return "null";
@@ -518,9 +542,11 @@ void odEntityIndex_destroy(odEntityIndex* entity_index) {
 
 	odTrivialArray_destroy(&entity_index->entities);
 	odTrivialArray_destroy(&entity_index->entity_vertices);
+	odTrivialArray_destroy(&entity_index->interpolated_vertices);
 	for (odEntityChunkId i = 0; i < OD_ENTITY_CHUNK_ID_COUNT; i++) {
 		odTrivialArray_destroy(&entity_index->chunks[i].colliders);
 	}
+	OD_DISCARD(OD_CHECK(entity_index->tag_lists.set_count(0)));
 }
 odEntityId odEntityIndex_get_count(const odEntityIndex* entity_index) {
 	if (!OD_DEBUG_CHECK(entity_index != nullptr)) {
@@ -567,6 +593,83 @@ const struct odVertex* odEntityIndex_get_all_vertices(const odEntityIndex* entit
 	*out_vertex_count = entity_index->entity_vertices.get_count();
 	return vertices;
 }
+const struct odVertex* odEntityIndex_get_all_vertices_interpolated(
+	odEntityIndex* entity_index, float interpolation, int32_t* out_vertex_count) {
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)
+		|| !OD_DEBUG_CHECK(odFloat_is_normalized(interpolation))
+		|| !OD_DEBUG_CHECK(out_vertex_count != nullptr)) {
+		return nullptr;
+	}
+
+	if (interpolation >= 1.0f) {
+		return odEntityIndex_get_all_vertices(entity_index, out_vertex_count);
+	}
+
+	*out_vertex_count = 0;
+
+	int32_t vertex_count = entity_index->entity_vertices.get_count();
+	if (vertex_count == 0) {
+		return nullptr;
+	}
+
+	if (!OD_CHECK(entity_index->interpolated_vertices.set_count(vertex_count))) {
+		return nullptr;
+	}
+
+	const odVertex* vertices = entity_index->entity_vertices.begin();
+	odVertex* interpolated_vertices = entity_index->interpolated_vertices.begin();
+	const float previous_weight = 1.0f - interpolation;
+
+	int32_t entity_count = entity_index->entities.get_count();
+	for (int32_t i = 0; i < entity_count; i++) {
+		const odEntityIndexEntity& entity = entity_index->entities[i];
+		const odBounds& bounds = entity.entity.collider.bounds;
+		const odBounds& previous_bounds = entity.previous_bounds;
+		const odMatrix& transform = entity.entity.sprite.transform;
+		const odMatrix& previous_transform = entity.previous_transform;
+		int32_t vertex_index = i * OD_ENTITY_VERTEX_COUNT;
+
+		// no previous state to interpolate from (e.g. new, or not visible last step)
+		if (!odBounds_has_area(&previous_bounds)
+			|| (odBounds_get_equals(&previous_bounds, &bounds)
+				&& odMatrix_get_equals(&previous_transform, &transform))) {
+			memcpy(
+				interpolated_vertices + vertex_index,
+				vertices + vertex_index,
+				sizeof(odVertex) * OD_ENTITY_VERTEX_COUNT);
+			continue;
+		}
+
+		odBounds lerped_bounds{
+			(previous_bounds.x1 * previous_weight) + (bounds.x1 * interpolation),
+			(previous_bounds.y1 * previous_weight) + (bounds.y1 * interpolation),
+			(previous_bounds.x2 * previous_weight) + (bounds.x2 * interpolation),
+			(previous_bounds.y2 * previous_weight) + (bounds.y2 * interpolation),
+		};
+
+		odMatrix lerped_transform{};
+		for (int32_t j = 0; j < OD_MATRIX_ELEM_COUNT; j++) {
+			lerped_transform.matrix[j] =
+				(previous_transform.matrix[j] * previous_weight) + (transform.matrix[j] * interpolation);
+		}
+
+		odEntityIndex_get_sprite_vertices_impl(
+			&lerped_bounds, &entity.entity.sprite, &lerped_transform, interpolated_vertices + vertex_index);
+	}
+
+	*out_vertex_count = vertex_count;
+	return interpolated_vertices;
+}
+void odEntityIndex_save_previous(odEntityIndex* entity_index) {
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)) {
+		return;
+	}
+
+	for (odEntityIndexEntity& entity: entity_index->entities) {
+		entity.previous_bounds = entity.entity.collider.bounds;
+		entity.previous_transform = entity.entity.sprite.transform;
+	}
+}
 const odEntity* odEntityIndex_get(const odEntityIndex* entity_index, odEntityId entity_id) {
 	if (!OD_DEBUG_CHECK(entity_index != nullptr)
 		|| !OD_DEBUG_CHECK((entity_id >= 0) && (entity_id < entity_index->entities.get_count()))) {
@@ -595,10 +698,17 @@ void odEntityIndex_set_collider(odEntityIndex* entity_index, const odEntityColli
 		return;
 	}
 
+	// new or destroyed entities have no area, and must not interpolate from a previous occupant
+	bool is_new = !odBounds_has_area(&old_entity->entity.collider.bounds);
+
 	if (!OD_CHECK(odEntityIndex_set_collider_impl(entity_index, &old_entity->entity.collider, collider))) {
 		return;
 	}
 
+	if (is_new) {
+		odEntityIndex_reset_previous_impl(old_entity);
+	}
+
 	if (!OD_CHECK(odEntityIndex_update_vertices_impl(entity_index, old_entity))) {
 		return;
 	}
@@ -634,6 +744,9 @@ void odEntityIndex_set(odEntityIndex* entity_index, const odEntity* entity) {
 		return;
 	}
 
+	// new or destroyed entities have no area, and must not interpolate from a previous occupant
+	bool is_new = !odBounds_has_area(&old_entity->entity.collider.bounds);
+
 	if (!OD_CHECK(odEntityIndex_set_collider_impl(entity_index, &old_entity->entity.collider, &entity->collider))) {
 		return;
 	}
@@ -642,11 +755,17 @@ void odEntityIndex_set(odEntityIndex* entity_index, const odEntity* entity) {
 		return;
 	}
 
+	if (is_new) {
+		odEntityIndex_reset_previous_impl(old_entity);
+	}
+
 	if (!OD_CHECK(odEntityIndex_update_vertices_impl(entity_index, old_entity))) {
 		return;
 	}
 }
 /*num_results*/ int32_t odEntityIndex_search(const odEntityIndex* entity_index, const odEntitySearch* search) {
+	OD_PROFILE_SCOPE("odEntityIndex_search");
+
 	if (!OD_DEBUG_CHECK(entity_index != nullptr)
 		|| !OD_DEBUG_CHECK(odEntitySearch_check_valid(search))) {
 		return 0;
@@ -705,8 +824,116 @@ void odEntityIndex_set(odEntityIndex* entity_index, const odEntity* entity) {
 
 	return count;
 }
+bool odEntityIndex_add_tagged(odEntityIndex* entity_index, int32_t tag_list_id, odEntityId entity_id) {
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)
+		|| !OD_DEBUG_CHECK(tag_list_id >= 0)
+		|| !OD_DEBUG_CHECK(entity_id >= 0)) {
+		return false;
+	}
+
+	if (!OD_CHECK(entity_index->tag_lists.ensure_count(tag_list_id + 1))) {
+		return false;
+	}
+
+	odEntityTagList& tag_list = entity_index->tag_lists[tag_list_id];
+	if (!OD_CHECK(tag_list.entity_slots.ensure_count(entity_id + 1))) {
+		return false;
+	}
+
+	int32_t& entity_slot = tag_list.entity_slots[entity_id];
+	if (entity_slot != 0) {
+		return false;
+	}
+
+	if (!OD_CHECK(tag_list.entity_ids.push(entity_id))) {
+		return false;
+	}
+
+	entity_slot = tag_list.entity_ids.get_count();
+	return true;
+}
+bool odEntityIndex_remove_tagged(odEntityIndex* entity_index, int32_t tag_list_id, odEntityId entity_id) {
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)
+		|| !OD_DEBUG_CHECK(tag_list_id >= 0)
+		|| !OD_DEBUG_CHECK(entity_id >= 0)) {
+		return false;
+	}
+
+	if (!odEntityIndex_get_is_tagged(entity_index, tag_list_id, entity_id)) {
+		return false;
+	}
+
+	odEntityTagList& tag_list = entity_index->tag_lists[tag_list_id];
+	int32_t index = tag_list.entity_slots[entity_id] - 1;
+	int32_t last_index = tag_list.entity_ids.get_count() - 1;
+
+	odEntityId swap_entity_id = tag_list.entity_ids[last_index];
+	tag_list.entity_slots[swap_entity_id] = index + 1;
+	tag_list.entity_slots[entity_id] = 0;
+
+	if (!OD_CHECK(tag_list.entity_ids.swap_pop(index))) {
+		return false;
+	}
+
+	return true;
+}
+bool odEntityIndex_get_is_tagged(const odEntityIndex* entity_index, int32_t tag_list_id, odEntityId entity_id) {
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)
+		|| !OD_DEBUG_CHECK(tag_list_id >= 0)
+		|| !OD_DEBUG_CHECK(entity_id >= 0)) {
+		return false;
+	}
+
+	if (tag_list_id >= entity_index->tag_lists.get_count()) {
+		return false;
+	}
+
+	const odEntityTagList& tag_list = entity_index->tag_lists[tag_list_id];
+	return (entity_id < tag_list.entity_slots.get_count()) && (tag_list.entity_slots[entity_id] != 0);
+}
+const odEntityId* odEntityIndex_get_all_tagged(const odEntityIndex* entity_index, int32_t tag_list_id, int32_t* out_count) {
+	if (!OD_DEBUG_CHECK(out_count != nullptr)) {
+		return nullptr;
+	}
+
+	*out_count = 0;
+
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)
+		|| !OD_DEBUG_CHECK(tag_list_id >= 0)) {
+		return nullptr;
+	}
+
+	if (tag_list_id >= entity_index->tag_lists.get_count()) {
+		return nullptr;
+	}
+
+	const odEntityTagList& tag_list = entity_index->tag_lists[tag_list_id];
+	*out_count = tag_list.entity_ids.get_count();
+	return tag_list.entity_ids.begin();
+}
+int32_t odEntityIndex_get_tag_lists(
+	const odEntityIndex* entity_index, odEntityId entity_id, int32_t* out_tag_list_ids, int32_t max_results) {
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)
+		|| !OD_DEBUG_CHECK(entity_id >= 0)
+		|| !OD_DEBUG_CHECK((out_tag_list_ids != nullptr) || (max_results == 0))
+		|| !OD_DEBUG_CHECK(max_results >= 0)) {
+		return 0;
+	}
+
+	int32_t count = 0;
+	int32_t tag_list_count = entity_index->tag_lists.get_count();
+	for (int32_t tag_list_id = 0; (tag_list_id < tag_list_count) && (count < max_results); tag_list_id++) {
+		const odEntityTagList& tag_list = entity_index->tag_lists[tag_list_id];
+		if ((entity_id < tag_list.entity_slots.get_count()) && (tag_list.entity_slots[entity_id] != 0)) {
+			out_tag_list_ids[count] = tag_list_id;
+			count++;
+		}
+	}
+
+	return count;
+}
 odEntityIndex::odEntityIndex()
-: entities{}, chunks{} {
+: entities{}, chunks{}, tag_lists{} {
 }
 odEntityIndex::odEntityIndex(odEntityIndex&& other) = default;
 odEntityIndex& odEntityIndex::operator=(odEntityIndex&& other) = default;
@@ -753,6 +980,9 @@ bool odEntitySearch_matches_collider(const odEntitySearch* search, const odEntit
 static_assert(
 	OD_ENTITY_CHUNK_COORD_MASK_BITS <= (8 * sizeof(odEntityChunkCoord)),
 	"chunk coord must fit chunk coord type");
+static_assert(
+	(sizeof(odEntityCollider) % 16) == 0,
+	"colliders should stay a multiple of 16 bytes, to keep the collider array stride 16-byte aligned");
 static_assert(
 	OD_ENTITY_CHUNK_ID_BITS <= 14,
 	"chunk count must not exceed 2^14 chunks (this limit is already excessive)");
@@ -20,7 +20,14 @@ bool odLuaBindings_register(lua_State* lua) {
 		|| !OD_CHECK(odLuaBindings_odAudio_register(lua))
 		|| !OD_CHECK(odLuaBindings_odMusic_register(lua))
 		|| !OD_CHECK(odLuaBindings_odTextureAtlas_register(lua))
-		|| !OD_CHECK(odLuaBindings_odEntityIndex_register(lua))) {
+		|| !OD_CHECK(odLuaBindings_odEntityIndex_register(lua))
+		|| !OD_CHECK(odLuaBindings_odSnapshot_register(lua))
+		|| !OD_CHECK(odLuaBindings_odDebugging_register(lua))
+		|| !OD_CHECK(odLuaBindings_odJson_register(lua))
+		|| !OD_CHECK(odLuaBindings_odProfile_register(lua))
+		|| !OD_CHECK(odLuaBindings_odAllocation_register(lua))
+		|| !OD_CHECK(odLuaBindings_odLuaProfiler_register(lua))
+		|| !OD_CHECK(odLuaBindings_odFrameWatchdog_register(lua))) {
 		return false;
 	}
 
@@ -0,0 +1,78 @@
+#include <od/engine/lua/bindings.h>
+
+#include <od/core/debug.h>
+#include <od/core/allocation.h>
+#include <od/engine/lua/includes.h>
+#include <od/engine/lua/wrappers.h>
+
+typedef bool (odLuaBindings_odAllocation_get_stats_fn)(int32_t category, odAllocationStats* out_stats);
+
+// {[category_name] = {allocation_count, free_count, allocated_bytes, freed_bytes, live_bytes, peak_live_bytes}}
+static int odLuaBindings_odAllocation_push_stats(lua_State* lua, odLuaBindings_odAllocation_get_stats_fn* get_stats) {
+	lua_createtable(lua, 0, OD_ALLOCATION_CATEGORY_COUNT + 1);
+	for (int32_t category = OD_ALLOCATION_CATEGORY_ALL; category < OD_ALLOCATION_CATEGORY_COUNT; category++) {
+		odAllocationStats stats{};
+		if (!OD_CHECK(get_stats(category, &stats))) {
+			return luaL_error(lua, "odAllocation_get_stats(%d) failed", category);
+		}
+
+		lua_createtable(lua, 0, 6);
+		lua_pushnumber(lua, static_cast<lua_Number>(stats.allocation_count));
+		lua_setfield(lua, -2, "allocation_count");
+		lua_pushnumber(lua, static_cast<lua_Number>(stats.free_count));
+		lua_setfield(lua, -2, "free_count");
+		lua_pushnumber(lua, static_cast<lua_Number>(stats.allocated_bytes));
+		lua_setfield(lua, -2, "allocated_bytes");
+		lua_pushnumber(lua, static_cast<lua_Number>(stats.freed_bytes));
+		lua_setfield(lua, -2, "freed_bytes");
+		lua_pushnumber(lua, static_cast<lua_Number>(stats.live_bytes));
+		lua_setfield(lua, -2, "live_bytes");
+		lua_pushnumber(lua, static_cast<lua_Number>(stats.peak_live_bytes));
+		lua_setfield(lua, -2, "peak_live_bytes");
+		lua_setfield(lua, -2, odAllocationCategory_get_name(category));
+	}
+
+	return 1;
+}
+static int odLuaBindings_odAllocation_get_stats(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	return odLuaBindings_odAllocation_push_stats(lua, odAllocation_get_stats);
+}
+static int odLuaBindings_odAllocation_get_frame_stats(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	return odLuaBindings_odAllocation_push_stats(lua, odAllocation_get_frame_stats);
+}
+static int odLuaBindings_odAllocation_end_frame(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	odAllocation_end_frame();
+	return 0;
+}
+bool odLuaBindings_odAllocation_register(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return false;
+	}
+
+	if (!OD_CHECK(odLua_metatable_declare(lua, OD_LUA_BINDINGS_ALLOCATION))) {
+		return false;
+	}
+
+	auto add_method = [lua](const char* name, odLuaFn* fn) -> bool {
+		return odLua_metatable_set_function(lua, OD_LUA_BINDINGS_ALLOCATION, name, fn);
+	};
+	if (!OD_CHECK(add_method("get_stats", odLuaBindings_odAllocation_get_stats))
+		|| !OD_CHECK(add_method("get_frame_stats", odLuaBindings_odAllocation_get_frame_stats))
+		|| !OD_CHECK(add_method("end_frame", odLuaBindings_odAllocation_end_frame))) {
+		return false;
+	}
+
+	return true;
+}
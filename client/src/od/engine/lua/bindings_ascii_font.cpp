@@ -192,23 +192,24 @@ static int odLuaBindings_odAsciiFont_add_text_to_vertex_array(lua_State* lua) {
 
 	int32_t max_vertices_count = odAsciiTextPrimitive_get_max_vertices_count(&text);
 
-	odTrivialArrayT<odVertex> text_vertex_array{};
-	if (!OD_CHECK(text_vertex_array.set_count(max_vertices_count))) {
-		return luaL_error(lua, "text_vertex_array.set_count(%d) failed", max_vertices_count);
+	// vertices are written in place and the unused tail trimmed, so no temporary array is allocated
+	int32_t start_count = vertex_array->get_count();
+	if (!OD_CHECK(vertex_array->set_count(start_count + max_vertices_count))) {
+		return luaL_error(lua, "vertex_array->set_count(%d) failed", start_count + max_vertices_count);
 	}
-	odVertex* text_vertices_raw = text_vertex_array.begin();
-	if (!OD_CHECK(text_vertices_raw != nullptr)) {
-		return luaL_error(lua, "text_vertex_array.set_count(%d) failed", max_vertices_count);
+	if (!OD_CHECK(vertex_array->begin() != nullptr)) {
+		return luaL_error(lua, "vertex_array->set_count(%d) failed", start_count + max_vertices_count);
 	}
+	odVertex* text_vertices_raw = vertex_array->begin() + start_count;
 
 	int32_t vertices_count = 0;
 	odBounds bounds{};
-	if (!OD_CHECK(odAsciiFont_text_get_vertices(font, &text, &vertices_count, &bounds, text_vertices_raw))) {
-		return luaL_error(lua, "odAsciiFont_text_get_vertices() failed");
+	bool ok = odAsciiFont_text_get_vertices(font, &text, &vertices_count, &bounds, text_vertices_raw);
+	if (!OD_CHECK(vertex_array->set_count(start_count + (ok ? vertices_count : 0)))) {
+		return luaL_error(lua, "vertex_array->set_count(%d) failed", start_count + vertices_count);
 	}
-
-	if (!OD_CHECK(vertex_array->extend(text_vertices_raw, vertices_count))) {
-		return luaL_error(lua, "vertex_array->extend() failed");
+	if (!OD_CHECK(ok)) {
+		return luaL_error(lua, "odAsciiFont_text_get_vertices() failed");
 	}
 
 	return 0;
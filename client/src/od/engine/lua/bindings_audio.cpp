@@ -1,6 +1,7 @@
 #include <od/engine/lua/bindings.h>
 
 #include <od/core/debug.h>
+#include <od/core/array.hpp>
 #include <od/core/type.hpp>
 #include <od/core/math.h>
 #include <od/platform/file.h>
@@ -278,6 +279,97 @@ static int odLuaBindings_odAudio_is_playing(lua_State* lua) {
 	lua_pushboolean(lua, odAudio_is_playing(playback_id));
 	return 1;
 }
+// takes {filenames = {...}, background = bool}; the decoded audio is kept until release_preloaded()
+static int odLuaBindings_odAudio_preload_files(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int settings_index = 1;
+	luaL_checktype(lua, settings_index, LUA_TTABLE);
+
+	lua_getfield(lua, settings_index, "filenames");
+	const int filenames_index = lua_gettop(lua);
+	luaL_checktype(lua, filenames_index, LUA_TTABLE);
+
+	bool background = false;
+	lua_getfield(lua, settings_index, "background");
+	if (lua_type(lua, OD_LUA_STACK_TOP) != LUA_TNIL) {
+		if (!OD_CHECK(lua_type(lua, OD_LUA_STACK_TOP) == LUA_TBOOLEAN)) {
+			return luaL_error(lua, "settings.background must be a boolean or nil");
+		}
+		background = lua_toboolean(lua, OD_LUA_STACK_TOP);
+	}
+
+	const int32_t filenames_count = static_cast<int32_t>(lua_objlen(lua, filenames_index));
+	for (int32_t i = 1; i <= filenames_count; i++) {
+		lua_rawgeti(lua, filenames_index, i);
+		if (!OD_CHECK(lua_type(lua, OD_LUA_STACK_TOP) == LUA_TSTRING)) {
+			return luaL_error(lua, "settings.filenames[%d] must be a string", static_cast<int>(i));
+		}
+		lua_pop(lua, 1);
+	}
+
+	// no lua errors while the array is alive, as they would skip its destructor
+	bool is_ok = false;
+	{
+		odTrivialArrayT<const char*> filenames;
+		if (OD_CHECK(filenames.set_count(filenames_count))) {
+			for (int32_t i = 0; i < filenames_count; i++) {
+				lua_rawgeti(lua, filenames_index, i + 1);
+				filenames[i] = lua_tostring(lua, OD_LUA_STACK_TOP);  // kept alive by the filenames table
+				lua_pop(lua, 1);
+			}
+
+			is_ok = OD_CHECK(odAudioCache_preload_files(filenames.begin(), filenames_count, background));
+		}
+	}
+	if (!is_ok) {
+		return luaL_error(lua, "odAudioCache_preload_files() failed");
+	}
+
+	return 0;
+}
+static int odLuaBindings_odAudio_wait_preload(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_pushboolean(lua, odAudioCache_wait_preload());
+	return 1;
+}
+static int odLuaBindings_odAudio_release_preloaded(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	odAudioCache_release_preloaded();
+	return 0;
+}
+// {lookup_count, hit_count, entry_count, preloaded_count, decoded_bytes}
+static int odLuaBindings_odAudio_get_cache_stats(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	odAudioCacheStats stats{};
+	if (!OD_CHECK(odAudioCache_get_stats(&stats))) {
+		return luaL_error(lua, "odAudioCache_get_stats() failed");
+	}
+
+	lua_createtable(lua, 0, 5);
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.lookup_count));
+	lua_setfield(lua, -2, "lookup_count");
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.hit_count));
+	lua_setfield(lua, -2, "hit_count");
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.entry_count));
+	lua_setfield(lua, -2, "entry_count");
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.preloaded_count));
+	lua_setfield(lua, -2, "preloaded_count");
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.decoded_bytes));
+	lua_setfield(lua, -2, "decoded_bytes");
+	return 1;
+}
 bool odLuaBindings_odAudio_register(lua_State* lua) {
 	if (!OD_CHECK(lua != nullptr)) {
 		return false;
@@ -300,7 +392,11 @@ bool odLuaBindings_odAudio_register(lua_State* lua) {
 		|| !OD_CHECK(add_method("play", odLuaBindings_odAudio_play))
 		|| !OD_CHECK(add_method("stop", odLuaBindings_odAudio_stop))
 		|| !OD_CHECK(add_method("stop_all", odLuaBindings_odAudio_stop_all))
-		|| !OD_CHECK(add_method("is_playing", odLuaBindings_odAudio_is_playing))) {
+		|| !OD_CHECK(add_method("is_playing", odLuaBindings_odAudio_is_playing))
+		|| !OD_CHECK(add_method("preload_files", odLuaBindings_odAudio_preload_files))
+		|| !OD_CHECK(add_method("wait_preload", odLuaBindings_odAudio_wait_preload))
+		|| !OD_CHECK(add_method("release_preloaded", odLuaBindings_odAudio_release_preloaded))
+		|| !OD_CHECK(add_method("get_cache_stats", odLuaBindings_odAudio_get_cache_stats))) {
 		return false;
 	}
 
@@ -0,0 +1,81 @@
+#include <od/engine/lua/bindings.h>
+
+#include <od/core/debug.h>
+#include <od/engine/lua/includes.h>
+#include <od/engine/lua/wrappers.h>
+
+#define OD_LUA_BINDINGS_DEBUGGING_TRACEBACK_LEVEL 2
+
+static int odLuaBindings_odDebugging_traceback(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int message_index = 1;
+
+	// non-string errors (e.g. tables) are passed through untouched, as debug.traceback does
+	if (!lua_isstring(lua, message_index)) {
+		lua_settop(lua, message_index);
+		return 1;
+	}
+
+	lua_getglobal(lua, "debug");
+	if (!lua_istable(lua, OD_LUA_STACK_TOP)) {
+		lua_settop(lua, message_index);
+		return 1;
+	}
+	lua_getfield(lua, OD_LUA_STACK_TOP, "traceback");
+	if (!lua_isfunction(lua, OD_LUA_STACK_TOP)) {
+		lua_settop(lua, message_index);
+		return 1;
+	}
+
+	lua_pushvalue(lua, message_index);
+	lua_pushinteger(lua, OD_LUA_BINDINGS_DEBUGGING_TRACEBACK_LEVEL);
+	lua_call(lua, 2, 1);
+	return 1;
+}
+/* Works like pcall(), but appends a traceback to errors.
+Arguments are passed through on the stack, and the handler is only invoked on failure,
+so successful calls allocate nothing beyond what the callee does. */
+static int odLuaBindings_odDebugging_pcall(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int metatable_index = lua_upvalueindex(1);
+	const int fn_index = 1;
+	luaL_checkany(lua, fn_index);
+
+	int args_count = lua_gettop(lua) - fn_index;
+
+	const int handler_index = 1;
+	lua_getfield(lua, metatable_index, "traceback");
+	lua_insert(lua, handler_index);
+
+	int result = lua_pcall(lua, args_count, LUA_MULTRET, handler_index);
+
+	// replace the handler with the status, leaving (status, results...) or (status, err)
+	lua_pushboolean(lua, result == 0);
+	lua_replace(lua, handler_index);
+	return lua_gettop(lua);
+}
+bool odLuaBindings_odDebugging_register(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return false;
+	}
+
+	if (!OD_CHECK(odLua_metatable_declare(lua, OD_LUA_BINDINGS_DEBUGGING))) {
+		return false;
+	}
+
+	auto add_method = [lua](const char* name, odLuaFn* fn) -> bool {
+		return odLua_metatable_set_function(lua, OD_LUA_BINDINGS_DEBUGGING, name, fn);
+	};
+	if (!OD_CHECK(add_method("traceback", odLuaBindings_odDebugging_traceback))
+		|| !OD_CHECK(add_method("pcall", odLuaBindings_odDebugging_pcall))) {
+		return false;
+	}
+
+	return true;
+}
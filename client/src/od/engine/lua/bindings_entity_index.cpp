@@ -64,12 +64,22 @@ static int odLuaBindings_odEntityIndex_add_to_vertex_array(lua_State* lua) {
 	luaL_checktype(lua, self_index, LUA_TUSERDATA);
 	luaL_checktype(lua, settings_index, LUA_TTABLE);
 
-	const odEntityIndex* entity_index = static_cast<odEntityIndex*>(odLua_get_userdata_typed(
+	odEntityIndex* entity_index = static_cast<odEntityIndex*>(odLua_get_userdata_typed(
 		lua, self_index, OD_LUA_BINDINGS_ENTITY_INDEX));
 	if (!OD_CHECK(entity_index != nullptr)) {
 		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_ENTITY_INDEX);
 	}
 
+	float interpolation = 1.0f;
+	lua_getfield(lua, settings_index, "interpolation");
+	const int interpolation_index = lua_gettop(lua);
+	if (lua_type(lua, interpolation_index) != LUA_TNIL) {
+		if (!OD_CHECK(lua_type(lua, interpolation_index) == LUA_TNUMBER)) {
+			return luaL_error(lua, "settings.interpolation must be of type number");
+		}
+		interpolation = static_cast<float>(lua_tonumber(lua, interpolation_index));
+	}
+
 	lua_getfield(lua, settings_index, "vertex_array");
 	const int vertex_array_index = lua_gettop(lua);
 	if (!OD_CHECK(lua_type(lua, vertex_array_index) == LUA_TUSERDATA)) {
@@ -82,7 +92,8 @@ static int odLuaBindings_odEntityIndex_add_to_vertex_array(lua_State* lua) {
 	}
 
 	int32_t vertex_count = 0;
-	const odVertex* vertices = odEntityIndex_get_all_vertices(entity_index, &vertex_count);
+	const odVertex* vertices = odEntityIndex_get_all_vertices_interpolated(
+		entity_index, interpolation, &vertex_count);
 
 	if ((vertices != nullptr) && !OD_CHECK(vertex_array->extend(vertices, vertex_count))) {
 		return luaL_error(lua, "vertex_array->extend(%d) failed", vertex_count);
@@ -543,7 +554,7 @@ static int odLuaBindings_odEntityIndex_get(lua_State* lua) {
 
 		int32_t i_bit = (i * OD_TAGSET_ELEMENT_BIT_SIZE);
 		for (int32_t j = 0; j < OD_TAGSET_ELEMENT_BIT_SIZE; j++) {
-			if ((element & (1 << j)) > 0) {
+			if ((element & (1u << j)) > 0) {
 				lua_pushnumber(lua, static_cast<lua_Number>(i_bit + j));
 				return_count++;
 			}
@@ -619,7 +630,7 @@ static int odLuaBindings_odEntityIndex_get_tags(lua_State* lua) {
 
 		int32_t i_bit = (i * OD_TAGSET_ELEMENT_BIT_SIZE);
 		for (int32_t j = 0; j < OD_TAGSET_ELEMENT_BIT_SIZE; j++) {
-			if ((element & (1 << j)) > 0) {
+			if ((element & (1u << j)) > 0) {
 				lua_pushnumber(lua, static_cast<lua_Number>(i_bit + j));
 				return_count++;
 			}
@@ -908,6 +919,268 @@ static int odLuaBindings_odEntityIndex_count(lua_State* lua) {
 	lua_pushnumber(lua, static_cast<lua_Number>(result_count));
 	return 1;
 }
+static int odLuaBindings_odEntityIndex_add_tagged(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+	const int tag_list_id_index = 2;
+	const int id_index = 3;
+
+	if (OD_BUILD_DEBUG) {
+		luaL_checktype(lua, self_index, LUA_TUSERDATA);
+		luaL_checktype(lua, tag_list_id_index, LUA_TNUMBER);
+		luaL_checktype(lua, id_index, LUA_TNUMBER);
+	}
+
+	odEntityIndex* entity_index = static_cast<odEntityIndex*>(odLua_get_userdata_typed(
+		lua, self_index, OD_LUA_BINDINGS_ENTITY_INDEX));
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_ENTITY_INDEX);
+	}
+
+	int32_t tag_list_id = static_cast<int32_t>(lua_tonumber(lua, tag_list_id_index));
+	odEntityId entity_id = static_cast<odEntityId>(lua_tonumber(lua, id_index));
+	if (!OD_DEBUG_CHECK(tag_list_id >= 0)
+		|| !OD_DEBUG_CHECK(entity_id >= 0)) {
+		return luaL_error(lua, "tag_list_id and id must be non-negative");
+	}
+
+	lua_pushboolean(lua, odEntityIndex_add_tagged(entity_index, tag_list_id, entity_id));
+	return 1;
+}
+static int odLuaBindings_odEntityIndex_remove_tagged(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+	const int tag_list_id_index = 2;
+	const int id_index = 3;
+
+	if (OD_BUILD_DEBUG) {
+		luaL_checktype(lua, self_index, LUA_TUSERDATA);
+		luaL_checktype(lua, tag_list_id_index, LUA_TNUMBER);
+		luaL_checktype(lua, id_index, LUA_TNUMBER);
+	}
+
+	odEntityIndex* entity_index = static_cast<odEntityIndex*>(odLua_get_userdata_typed(
+		lua, self_index, OD_LUA_BINDINGS_ENTITY_INDEX));
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_ENTITY_INDEX);
+	}
+
+	int32_t tag_list_id = static_cast<int32_t>(lua_tonumber(lua, tag_list_id_index));
+	odEntityId entity_id = static_cast<odEntityId>(lua_tonumber(lua, id_index));
+	if (!OD_DEBUG_CHECK(tag_list_id >= 0)
+		|| !OD_DEBUG_CHECK(entity_id >= 0)) {
+		return luaL_error(lua, "tag_list_id and id must be non-negative");
+	}
+
+	lua_pushboolean(lua, odEntityIndex_remove_tagged(entity_index, tag_list_id, entity_id));
+	return 1;
+}
+static int odLuaBindings_odEntityIndex_is_tagged(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+	const int tag_list_id_index = 2;
+	const int id_index = 3;
+
+	if (OD_BUILD_DEBUG) {
+		luaL_checktype(lua, self_index, LUA_TUSERDATA);
+		luaL_checktype(lua, tag_list_id_index, LUA_TNUMBER);
+		luaL_checktype(lua, id_index, LUA_TNUMBER);
+	}
+
+	odEntityIndex* entity_index = static_cast<odEntityIndex*>(odLua_get_userdata_typed(
+		lua, self_index, OD_LUA_BINDINGS_ENTITY_INDEX));
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_ENTITY_INDEX);
+	}
+
+	int32_t tag_list_id = static_cast<int32_t>(lua_tonumber(lua, tag_list_id_index));
+	odEntityId entity_id = static_cast<odEntityId>(lua_tonumber(lua, id_index));
+	if (!OD_DEBUG_CHECK(tag_list_id >= 0)
+		|| !OD_DEBUG_CHECK(entity_id >= 0)) {
+		return luaL_error(lua, "tag_list_id and id must be non-negative");
+	}
+
+	lua_pushboolean(lua, odEntityIndex_get_is_tagged(entity_index, tag_list_id, entity_id));
+	return 1;
+}
+/* Returns an array of the ids of all entities in the tag list.  If opt_out_ids is passed, it is reused
+and returned, to avoid allocating a table for each call. */
+static int odLuaBindings_odEntityIndex_all_tagged(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+	const int tag_list_id_index = 2;
+	const int opt_out_ids_index = 3;
+
+	if (OD_BUILD_DEBUG) {
+		luaL_checktype(lua, self_index, LUA_TUSERDATA);
+		luaL_checktype(lua, tag_list_id_index, LUA_TNUMBER);
+	}
+
+	odEntityIndex* entity_index = static_cast<odEntityIndex*>(odLua_get_userdata_typed(
+		lua, self_index, OD_LUA_BINDINGS_ENTITY_INDEX));
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_ENTITY_INDEX);
+	}
+
+	int32_t tag_list_id = static_cast<int32_t>(lua_tonumber(lua, tag_list_id_index));
+	if (!OD_DEBUG_CHECK(tag_list_id >= 0)) {
+		return luaL_error(lua, "tag_list_id must be non-negative");
+	}
+
+	int32_t count = 0;
+	const odEntityId* entity_ids = odEntityIndex_get_all_tagged(entity_index, tag_list_id, &count);
+
+	int32_t old_count = 0;
+	if (lua_type(lua, opt_out_ids_index) == LUA_TTABLE) {
+		lua_pushvalue(lua, opt_out_ids_index);
+		old_count = static_cast<int32_t>(lua_objlen(lua, opt_out_ids_index));
+	} else {
+		lua_createtable(lua, count, /*nrec*/ 0);
+	}
+	const int out_ids_index = lua_gettop(lua);
+
+	for (int32_t i = 0; i < count; i++) {
+		lua_pushnumber(lua, static_cast<lua_Number>(entity_ids[i]));
+		lua_rawseti(lua, out_ids_index, static_cast<int>(i + 1));
+	}
+
+	// clear from the end, so the array length stays well defined
+	for (int32_t i = old_count; i > count; i--) {
+		lua_pushnil(lua);
+		lua_rawseti(lua, out_ids_index, static_cast<int>(i));
+	}
+
+	return 1;
+}
+static int odLuaBindings_odEntityIndex_first_tagged(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+	const int tag_list_id_index = 2;
+
+	if (OD_BUILD_DEBUG) {
+		luaL_checktype(lua, self_index, LUA_TUSERDATA);
+		luaL_checktype(lua, tag_list_id_index, LUA_TNUMBER);
+	}
+
+	odEntityIndex* entity_index = static_cast<odEntityIndex*>(odLua_get_userdata_typed(
+		lua, self_index, OD_LUA_BINDINGS_ENTITY_INDEX));
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_ENTITY_INDEX);
+	}
+
+	int32_t tag_list_id = static_cast<int32_t>(lua_tonumber(lua, tag_list_id_index));
+	if (!OD_DEBUG_CHECK(tag_list_id >= 0)) {
+		return luaL_error(lua, "tag_list_id must be non-negative");
+	}
+
+	int32_t count = 0;
+	const odEntityId* entity_ids = odEntityIndex_get_all_tagged(entity_index, tag_list_id, &count);
+	if (count == 0) {
+		return 0;
+	}
+
+	lua_pushnumber(lua, static_cast<lua_Number>(entity_ids[0]));
+	return 1;
+}
+/* Returns the ids of the tag lists the entity is in.  If opt_out_tag_list_ids is passed, it is filled and returned
+as an array, to avoid allocating a table for each call; otherwise the ids are returned as multiple values. */
+static int odLuaBindings_odEntityIndex_get_tag_lists(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+	const int id_index = 2;
+	const int opt_out_tag_list_ids_index = 3;
+
+	if (OD_BUILD_DEBUG) {
+		luaL_checktype(lua, self_index, LUA_TUSERDATA);
+		luaL_checktype(lua, id_index, LUA_TNUMBER);
+	}
+
+	odEntityIndex* entity_index = static_cast<odEntityIndex*>(odLua_get_userdata_typed(
+		lua, self_index, OD_LUA_BINDINGS_ENTITY_INDEX));
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_ENTITY_INDEX);
+	}
+
+	odEntityId entity_id = static_cast<odEntityId>(lua_tonumber(lua, id_index));
+	if (!OD_DEBUG_CHECK(entity_id >= 0)) {
+		return luaL_error(lua, "id must be non-negative");
+	}
+
+	// results go straight to lua, so no native buffer is shared between calls
+	int32_t tag_lists_count = entity_index->tag_lists.get_count();
+	if (lua_type(lua, opt_out_tag_list_ids_index) == LUA_TTABLE) {
+		lua_pushvalue(lua, opt_out_tag_list_ids_index);
+		const int out_tag_list_ids_index = lua_gettop(lua);
+		int32_t old_count = static_cast<int32_t>(lua_objlen(lua, out_tag_list_ids_index));
+
+		int32_t count = 0;
+		for (int32_t tag_list_id = 0; tag_list_id < tag_lists_count; tag_list_id++) {
+			if (odEntityIndex_get_is_tagged(entity_index, tag_list_id, entity_id)) {
+				count++;
+				lua_pushnumber(lua, static_cast<lua_Number>(tag_list_id));
+				lua_rawseti(lua, out_tag_list_ids_index, static_cast<int>(count));
+			}
+		}
+
+		// clear from the end, so the array length stays well defined
+		for (int32_t i = old_count; i > count; i--) {
+			lua_pushnil(lua);
+			lua_rawseti(lua, out_tag_list_ids_index, static_cast<int>(i));
+		}
+
+		return 1;
+	}
+
+	int32_t count = 0;
+	for (int32_t tag_list_id = 0; tag_list_id < tag_lists_count; tag_list_id++) {
+		if (odEntityIndex_get_is_tagged(entity_index, tag_list_id, entity_id)) {
+			if (!lua_checkstack(lua, 1)) {
+				return luaL_error(lua, "lua_checkstack(%d) failed", count + 1);
+			}
+
+			lua_pushnumber(lua, static_cast<lua_Number>(tag_list_id));
+			count++;
+		}
+	}
+
+	return count;
+}
+static int odLuaBindings_odEntityIndex_save_previous(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+
+	luaL_checktype(lua, self_index, LUA_TUSERDATA);
+
+	odEntityIndex* entity_index = static_cast<odEntityIndex*>(odLua_get_userdata_typed(
+		lua, self_index, OD_LUA_BINDINGS_ENTITY_INDEX));
+	if (!OD_DEBUG_CHECK(entity_index != nullptr)) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_ENTITY_INDEX);
+	}
+
+	odEntityIndex_save_previous(entity_index);
+	return 0;
+}
 static int odLuaBindings_odEntityIndex_get_max_tag_id(lua_State* lua) {
 	if (!OD_DEBUG_CHECK(lua != nullptr)) {
 		return 0;
@@ -945,6 +1218,13 @@ bool odLuaBindings_odEntityIndex_register(lua_State* lua) {
 		|| !OD_CHECK(add_method("first", odLuaBindings_odEntityIndex_first))
 		|| !OD_CHECK(add_method("all", odLuaBindings_odEntityIndex_all))
 		|| !OD_CHECK(add_method("count", odLuaBindings_odEntityIndex_count))
+		|| !OD_CHECK(add_method("add_tagged", odLuaBindings_odEntityIndex_add_tagged))
+		|| !OD_CHECK(add_method("remove_tagged", odLuaBindings_odEntityIndex_remove_tagged))
+		|| !OD_CHECK(add_method("is_tagged", odLuaBindings_odEntityIndex_is_tagged))
+		|| !OD_CHECK(add_method("all_tagged", odLuaBindings_odEntityIndex_all_tagged))
+		|| !OD_CHECK(add_method("first_tagged", odLuaBindings_odEntityIndex_first_tagged))
+		|| !OD_CHECK(add_method("get_tag_lists", odLuaBindings_odEntityIndex_get_tag_lists))
+		|| !OD_CHECK(add_method("save_previous", odLuaBindings_odEntityIndex_save_previous))
 		|| !OD_CHECK(add_method("get_max_tag_id", odLuaBindings_odEntityIndex_get_max_tag_id))) {
 		return false;
 	}
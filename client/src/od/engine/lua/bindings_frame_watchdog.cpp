@@ -0,0 +1,94 @@
+#include <od/engine/lua/bindings.h>
+
+#include <od/core/debug.h>
+#include <od/platform/frame_watchdog.h>
+#include <od/engine/lua/includes.h>
+#include <od/engine/lua/wrappers.h>
+
+static int odLuaBindings_odFrameWatchdog_start(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const char* filename = luaL_checkstring(lua, 1);
+	lua_Number budget_ms = luaL_optnumber(lua, 2, static_cast<lua_Number>(OD_FRAME_WATCHDOG_BUDGET_MS_DEFAULT));
+	int32_t file_count = static_cast<int32_t>(luaL_optinteger(lua, 3, OD_FRAME_WATCHDOG_FILE_COUNT_DEFAULT));
+	if (budget_ms <= 0) {
+		return luaL_argerror(lua, 2, "budget must be positive");
+	}
+	if (file_count <= 0) {
+		return luaL_argerror(lua, 3, "file count must be positive");
+	}
+
+	lua_pushboolean(lua, odFrameWatchdog_start(filename, static_cast<float>(budget_ms), file_count));
+	return 1;
+}
+static int odLuaBindings_odFrameWatchdog_stop(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_pushboolean(lua, odFrameWatchdog_stop());
+	return 1;
+}
+static int odLuaBindings_odFrameWatchdog_is_running(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_pushboolean(lua, odFrameWatchdog_get_running());
+	return 1;
+}
+static int odLuaBindings_odFrameWatchdog_get_dump_count(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_pushinteger(lua, odFrameWatchdog_get_dump_count());
+	return 1;
+}
+static int odLuaBindings_odFrameWatchdog_begin_frame(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	odFrameWatchdog_begin_frame();
+	return 0;
+}
+// end_frame(opt_note): the note is attached to the frame being ended
+static int odLuaBindings_odFrameWatchdog_end_frame(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const char* note = luaL_optstring(lua, 1, nullptr);
+	if (note != nullptr) {
+		odFrameWatchdog_set_note(note);
+	}
+
+	odFrameWatchdog_end_frame();
+	return 0;
+}
+bool odLuaBindings_odFrameWatchdog_register(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return false;
+	}
+
+	if (!OD_CHECK(odLua_metatable_declare(lua, OD_LUA_BINDINGS_FRAME_WATCHDOG))) {
+		return false;
+	}
+
+	auto add_method = [lua](const char* name, odLuaFn* fn) -> bool {
+		return odLua_metatable_set_function(lua, OD_LUA_BINDINGS_FRAME_WATCHDOG, name, fn);
+	};
+	if (!OD_CHECK(add_method("start", odLuaBindings_odFrameWatchdog_start))
+		|| !OD_CHECK(add_method("stop", odLuaBindings_odFrameWatchdog_stop))
+		|| !OD_CHECK(add_method("is_running", odLuaBindings_odFrameWatchdog_is_running))
+		|| !OD_CHECK(add_method("get_dump_count", odLuaBindings_odFrameWatchdog_get_dump_count))
+		|| !OD_CHECK(add_method("begin_frame", odLuaBindings_odFrameWatchdog_begin_frame))
+		|| !OD_CHECK(add_method("end_frame", odLuaBindings_odFrameWatchdog_end_frame))) {
+		return false;
+	}
+
+	return true;
+}
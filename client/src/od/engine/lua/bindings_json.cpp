@@ -0,0 +1,869 @@
+#include <od/engine/lua/bindings.h>
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <od/core/debug.h>
+#include <od/core/array.hpp>
+#include <od/core/string.hpp>
+#include <od/engine/lua/includes.h>
+#include <od/engine/lua/wrappers.h>
+
+/* JSON codec with the value mapping and errors of engine/lib/json/json.lua:
+- tables are arrays if their keys are positive integers (plus an optional numeric "n") and not too sparse
+- empty tables are arrays, unless their metatable has __jsontype = "object"
+- decoded tables get {__jsontype = "object"} and {__jsontype = "array"} metatables, so they re-encode the same
+- nan and infinities encode as null, null decodes to nil (or the nullval argument)
+- encode raises errors; decode returns nil, position, error
+Of the encode options, only indent and level are supported.*/
+
+#define OD_LUA_BINDINGS_JSON_MAX_DEPTH 256
+#define OD_LUA_BINDINGS_JSON_ERROR_SIZE 256
+#define OD_LUA_BINDINGS_JSON_NUMBER_SIZE 128
+#define OD_LUA_BINDINGS_JSON_SPARSE_MIN 10
+
+struct odLuaJsonEncoder {
+	odString buffer;
+	odTrivialArrayT<const void*> tables;  // tables being encoded, to detect reference cycles
+	bool indent;
+	char error[OD_LUA_BINDINGS_JSON_ERROR_SIZE];
+};
+struct odLuaJsonDecoder {
+	const char* str;
+	int32_t size;
+	int null_index;
+	int object_metatable_index;
+	int array_metatable_index;
+	int32_t error_pos;  // 1-based, as json.lua reports it
+	char error[OD_LUA_BINDINGS_JSON_ERROR_SIZE];
+};
+
+OD_NO_DISCARD static bool
+odLuaJsonEncoder_write_value(odLuaJsonEncoder* encoder, lua_State* lua, int index, int32_t level);
+OD_NO_DISCARD static bool
+odLuaJsonDecoder_read_value(odLuaJsonDecoder* decoder, lua_State* lua, int32_t* pos, int32_t depth);
+
+static bool odLuaJsonEncoder_fail(odLuaJsonEncoder* encoder, const char* format, ...) {
+	va_list args = {};
+	va_start(args, format);
+	vsnprintf(encoder->error, sizeof(encoder->error), format, args);
+	va_end(args);
+	return false;
+}
+static bool odLuaJsonEncoder_write(odLuaJsonEncoder* encoder, const char* data, int32_t size) {
+	if (!OD_CHECK(encoder->buffer.extend(data, size))) {
+		return odLuaJsonEncoder_fail(encoder, "out of memory");
+	}
+
+	return true;
+}
+static bool odLuaJsonEncoder_write_newline(odLuaJsonEncoder* encoder, int32_t level) {
+	if (!odLuaJsonEncoder_write(encoder, "\n", 1)) {
+		return false;
+	}
+	for (int32_t i = 0; i < level; i++) {
+		if (!odLuaJsonEncoder_write(encoder, "  ", 2)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+static bool odLuaJsonEncoder_write_unicode_escape(odLuaJsonEncoder* encoder, uint32_t codepoint) {
+	char escape[16];
+	int32_t size = snprintf(escape, sizeof(escape), "\\u%.4x", static_cast<unsigned>(codepoint));
+	return odLuaJsonEncoder_write(encoder, escape, size);
+}
+/* Size of the sequence at str that json.lua escapes, or 0: control characters, quotes, backslashes, and
+unicode characters which some javascript parsers treat as line breaks or strip*/
+static int32_t odLuaJson_get_escaped_size(const uint8_t* str, size_t size) {
+	uint8_t a = str[0];
+	if ((a < 0x20) || (a == '\"') || (a == '\\') || (a == 0x7f)) {
+		return 1;
+	}
+	if (a < 0xc2) {
+		return 0;
+	}
+
+	uint8_t b = (size > 1) ? str[1] : 0;
+	uint8_t c = (size > 2) ? str[2] : 0;
+	switch (a) {
+		case 0xc2: return (((b >= 0x80) && (b <= 0x9f)) || (b == 0xad)) ? 2 : 0;
+		case 0xd8: return ((b >= 0x80) && (b <= 0x84)) ? 2 : 0;
+		case 0xdc: return (b == 0x8f) ? 2 : 0;
+		case 0xe1: return ((b == 0x9e) && (c >= 0xb4) && (c <= 0xb5)) ? 3 : 0;
+		case 0xe2: {
+			if (b == 0x80) {
+				return (((c >= 0x8c) && (c <= 0x8f)) || ((c >= 0xa8) && (c <= 0xaf))) ? 3 : 0;
+			}
+			return ((b == 0x81) && (c >= 0xa0) && (c <= 0xaf)) ? 3 : 0;
+		}
+		case 0xef: {
+			if (b == 0xbb) {
+				return (c == 0xbf) ? 3 : 0;
+			}
+			return ((b == 0xbf) && (c >= 0xb0)) ? 3 : 0;
+		}
+		default: return 0;
+	}
+}
+static bool odLuaJsonEncoder_write_escape(odLuaJsonEncoder* encoder, const uint8_t* str, int32_t size) {
+	if (size == 2) {
+		return odLuaJsonEncoder_write_unicode_escape(encoder, ((str[0] - 0xc0u) << 6) + (str[1] - 0x80u));
+	}
+	if (size == 3) {
+		return odLuaJsonEncoder_write_unicode_escape(
+			encoder, ((str[0] - 0xe0u) << 12) + ((str[1] - 0x80u) << 6) + (str[2] - 0x80u));
+	}
+
+	switch (str[0]) {
+		case '\"': return odLuaJsonEncoder_write(encoder, "\\\"", 2);
+		case '\\': return odLuaJsonEncoder_write(encoder, "\\\\", 2);
+		case '\b': return odLuaJsonEncoder_write(encoder, "\\b", 2);
+		case '\f': return odLuaJsonEncoder_write(encoder, "\\f", 2);
+		case '\n': return odLuaJsonEncoder_write(encoder, "\\n", 2);
+		case '\r': return odLuaJsonEncoder_write(encoder, "\\r", 2);
+		case '\t': return odLuaJsonEncoder_write(encoder, "\\t", 2);
+		default: return odLuaJsonEncoder_write_unicode_escape(encoder, str[0]);
+	}
+}
+static bool odLuaJsonEncoder_write_string(odLuaJsonEncoder* encoder, const char* str, size_t size) {
+	if (size > 0x7fffffff) {
+		return odLuaJsonEncoder_fail(encoder, "string too large");
+	}
+
+	if (!odLuaJsonEncoder_write(encoder, "\"", 1)) {
+		return false;
+	}
+
+	// unescaped runs are copied whole
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+	size_t run_start = 0;
+	size_t i = 0;
+	while (i < size) {
+		int32_t escaped_size = odLuaJson_get_escaped_size(bytes + i, size - i);
+		if (escaped_size == 0) {
+			i++;
+			continue;
+		}
+
+		if (!odLuaJsonEncoder_write(encoder, str + run_start, static_cast<int32_t>(i - run_start))
+			|| !odLuaJsonEncoder_write_escape(encoder, bytes + i, escaped_size)) {
+			return false;
+		}
+		i += static_cast<size_t>(escaped_size);
+		run_start = i;
+	}
+
+	return odLuaJsonEncoder_write(encoder, str + run_start, static_cast<int32_t>(size - run_start))
+		&& odLuaJsonEncoder_write(encoder, "\"", 1);
+}
+static int32_t odLuaJson_format_number(char* out, size_t out_size, lua_Number number) {
+	// matches tostring()
+	return snprintf(out, out_size, LUA_NUMBER_FMT, number);
+}
+static bool odLuaJsonEncoder_write_number(odLuaJsonEncoder* encoder, lua_Number number) {
+	if ((number != number) || (number >= HUGE_VAL) || (-number >= HUGE_VAL)) {
+		return odLuaJsonEncoder_write(encoder, "null", 4);
+	}
+
+	char str[OD_LUA_BINDINGS_JSON_NUMBER_SIZE];
+	return odLuaJsonEncoder_write(encoder, str, odLuaJson_format_number(str, sizeof(str), number));
+}
+static bool odLuaJsonEncoder_write_key(odLuaJsonEncoder* encoder, lua_State* lua, int key_index) {
+	int key_type = lua_type(lua, key_index);
+	if (key_type == LUA_TSTRING) {
+		size_t size = 0;
+		const char* str = lua_tolstring(lua, key_index, &size);
+		return odLuaJsonEncoder_write_string(encoder, str, size);
+	}
+	if (key_type == LUA_TNUMBER) {
+		// formatted here, as lua_tolstring() on a key would break lua_next()
+		char str[OD_LUA_BINDINGS_JSON_NUMBER_SIZE];
+		int32_t size = odLuaJson_format_number(str, sizeof(str), lua_tonumber(lua, key_index));
+		return odLuaJsonEncoder_write_string(encoder, str, static_cast<size_t>(size));
+	}
+
+	return odLuaJsonEncoder_fail(encoder, "type '%s' is not supported as a key by JSON.", lua_typename(lua, key_type));
+}
+static bool odLuaJsonEncoder_get_is_array(lua_State* lua, int index, int32_t* out_count) {
+	lua_Number max = 0;
+	lua_Number count = 0;
+	lua_Number array_length = 0;
+	lua_pushnil(lua);
+	while (lua_next(lua, index) != 0) {
+		int key_type = lua_type(lua, -2);
+		if ((key_type == LUA_TSTRING) && (strcmp(lua_tostring(lua, -2), "n") == 0)
+			&& (lua_type(lua, -1) == LUA_TNUMBER)) {
+			array_length = lua_tonumber(lua, -1);
+			max = (array_length > max) ? array_length : max;
+		} else {
+			lua_Number key = (key_type == LUA_TNUMBER) ? lua_tonumber(lua, -2) : 0;
+			if ((key_type != LUA_TNUMBER) || (key < 1) || (floor(key) != key)) {
+				lua_pop(lua, 2);
+				return false;
+			}
+			max = (key > max) ? key : max;
+			count++;
+		}
+		lua_pop(lua, 1);
+	}
+
+	// too many holes
+	if ((max > OD_LUA_BINDINGS_JSON_SPARSE_MIN) && (max > array_length) && (max > count * 2)) {
+		return false;
+	}
+
+	*out_count = (max < 0x7fffffff) ? static_cast<int32_t>(max) : 0x7fffffff;
+	return true;
+}
+static bool odLuaJsonEncoder_get_is_object_type(lua_State* lua, int index) {
+	if (!lua_getmetatable(lua, index)) {
+		return false;
+	}
+
+	lua_getfield(lua, -1, "__jsontype");
+	const char* json_type = lua_tostring(lua, -1);
+	bool is_object = (json_type != nullptr) && (strcmp(json_type, "object") == 0);
+	lua_pop(lua, 2);
+	return is_object;
+}
+static bool odLuaJsonEncoder_push_table(odLuaJsonEncoder* encoder, lua_State* lua, int index) {
+	const void* table = lua_topointer(lua, index);
+	for (const void* visited : encoder->tables) {
+		if (visited == table) {
+			return odLuaJsonEncoder_fail(encoder, "reference cycle");
+		}
+	}
+
+	if (encoder->tables.get_count() >= OD_LUA_BINDINGS_JSON_MAX_DEPTH) {
+		return odLuaJsonEncoder_fail(encoder, "max depth exceeded");
+	}
+	if (!lua_checkstack(lua, 4)) {
+		return odLuaJsonEncoder_fail(encoder, "lua stack exhausted");
+	}
+	if (!OD_CHECK(encoder->tables.push(table))) {
+		return odLuaJsonEncoder_fail(encoder, "out of memory");
+	}
+
+	return true;
+}
+static bool odLuaJsonEncoder_pop_table(odLuaJsonEncoder* encoder) {
+	if (!OD_CHECK(encoder->tables.pop())) {
+		return odLuaJsonEncoder_fail(encoder, "table stack underflow");
+	}
+
+	return true;
+}
+static bool odLuaJsonEncoder_write_custom(odLuaJsonEncoder* encoder, lua_State* lua, int index, int32_t level) {
+	// json.lua passes its encoder state; only the options are available here
+	lua_pushvalue(lua, index);
+	lua_createtable(lua, 0, 2);
+	lua_pushboolean(lua, encoder->indent);
+	lua_setfield(lua, -2, "indent");
+	lua_pushinteger(lua, level);
+	lua_setfield(lua, -2, "level");
+	if (lua_pcall(lua, 2, 2, 0) != 0) {
+		const char* error = lua_tostring(lua, -1);
+		odLuaJsonEncoder_fail(encoder, "%s", (error != nullptr) ? error : "custom encoder failed");
+		lua_pop(lua, 1);
+		return false;
+	}
+
+	if (!lua_toboolean(lua, -2)) {
+		const char* error = lua_tostring(lua, -1);
+		odLuaJsonEncoder_fail(encoder, "%s", (error != nullptr) ? error : "custom encoder failed");
+		lua_pop(lua, 2);
+		return false;
+	}
+
+	bool ok = true;
+	if (lua_type(lua, -2) == LUA_TSTRING) {
+		size_t size = 0;
+		const char* str = lua_tolstring(lua, -2, &size);
+		ok = odLuaJsonEncoder_write(encoder, str, static_cast<int32_t>(size));
+	}
+	lua_pop(lua, 2);
+	return ok;
+}
+static bool odLuaJsonEncoder_write_table(odLuaJsonEncoder* encoder, lua_State* lua, int index, int32_t level) {
+	if (!odLuaJsonEncoder_push_table(encoder, lua, index)) {
+		return false;
+	}
+
+	if (lua_getmetatable(lua, index)) {
+		lua_getfield(lua, -1, "__tojson");
+		lua_remove(lua, -2);
+		if (!lua_isnil(lua, -1)) {
+			return odLuaJsonEncoder_write_custom(encoder, lua, index, level) && odLuaJsonEncoder_pop_table(encoder);
+		}
+		lua_pop(lua, 1);
+	}
+
+	level++;
+
+	int32_t count = 0;
+	bool is_array = odLuaJsonEncoder_get_is_array(lua, index, &count);
+	if (is_array && (count == 0) && odLuaJsonEncoder_get_is_object_type(lua, index)) {
+		is_array = false;
+	}
+
+	if (is_array) {
+		if (!odLuaJsonEncoder_write(encoder, "[", 1)) {
+			return false;
+		}
+		for (int32_t i = 1; i <= count; i++) {
+			if ((i > 1) && !odLuaJsonEncoder_write(encoder, ",", 1)) {
+				return false;
+			}
+
+			lua_rawgeti(lua, index, i);
+			bool ok = odLuaJsonEncoder_write_value(encoder, lua, lua_gettop(lua), level);
+			lua_pop(lua, 1);
+			if (!ok) {
+				return false;
+			}
+		}
+		if (!odLuaJsonEncoder_write(encoder, "]", 1)) {
+			return false;
+		}
+	} else {
+		if (!odLuaJsonEncoder_write(encoder, "{", 1)) {
+			return false;
+		}
+		bool is_first = true;
+		lua_pushnil(lua);
+		while (lua_next(lua, index) != 0) {
+			bool ok = (is_first || odLuaJsonEncoder_write(encoder, ",", 1))
+				&& (!encoder->indent || odLuaJsonEncoder_write_newline(encoder, level))
+				&& odLuaJsonEncoder_write_key(encoder, lua, lua_gettop(lua) - 1)
+				&& odLuaJsonEncoder_write(encoder, ":", 1)
+				&& odLuaJsonEncoder_write_value(encoder, lua, lua_gettop(lua), level);
+			lua_pop(lua, 1);
+			if (!ok) {
+				lua_pop(lua, 1);
+				return false;
+			}
+			is_first = false;
+		}
+		if (encoder->indent && !odLuaJsonEncoder_write_newline(encoder, level - 1)) {
+			return false;
+		}
+		if (!odLuaJsonEncoder_write(encoder, "}", 1)) {
+			return false;
+		}
+	}
+
+	return odLuaJsonEncoder_pop_table(encoder);
+}
+static bool odLuaJsonEncoder_write_value(odLuaJsonEncoder* encoder, lua_State* lua, int index, int32_t level) {
+	int value_type = lua_type(lua, index);
+	switch (value_type) {
+		case LUA_TNIL: {
+			return odLuaJsonEncoder_write(encoder, "null", 4);
+		}
+		case LUA_TBOOLEAN: {
+			return lua_toboolean(lua, index)
+				? odLuaJsonEncoder_write(encoder, "true", 4)
+				: odLuaJsonEncoder_write(encoder, "false", 5);
+		}
+		case LUA_TNUMBER: {
+			return odLuaJsonEncoder_write_number(encoder, lua_tonumber(lua, index));
+		}
+		case LUA_TSTRING: {
+			size_t size = 0;
+			const char* str = lua_tolstring(lua, index, &size);
+			return odLuaJsonEncoder_write_string(encoder, str, size);
+		}
+		case LUA_TTABLE: {
+			return odLuaJsonEncoder_write_table(encoder, lua, index, level);
+		}
+		default: {
+			return odLuaJsonEncoder_fail(
+				encoder, "type '%s' is not supported by JSON.", lua_typename(lua, value_type));
+		}
+	}
+}
+
+static bool odLuaJsonDecoder_fail(odLuaJsonDecoder* decoder, int32_t error_pos, const char* format, ...) {
+	decoder->error_pos = error_pos;
+
+	va_list args = {};
+	va_start(args, format);
+	vsnprintf(decoder->error, sizeof(decoder->error), format, args);
+	va_end(args);
+	return false;
+}
+static void odLuaJsonDecoder_get_location(const odLuaJsonDecoder* decoder, int32_t pos, int32_t* out_line, int32_t* out_column) {
+	int32_t line = 1;
+	int32_t line_start = 0;
+	for (int32_t i = 0; i < pos; i++) {
+		if (decoder->str[i] == '\n') {
+			line++;
+			line_start = i + 1;
+		}
+	}
+
+	*out_line = line;
+	*out_column = pos + 1 - line_start;
+}
+static bool odLuaJsonDecoder_fail_at(odLuaJsonDecoder* decoder, int32_t pos, const char* message) {
+	int32_t line = 0;
+	int32_t column = 0;
+	odLuaJsonDecoder_get_location(decoder, pos, &line, &column);
+	return odLuaJsonDecoder_fail(decoder, pos + 1, "%s at line %d, column %d", message, line, column);
+}
+static bool odLuaJsonDecoder_fail_unterminated(odLuaJsonDecoder* decoder, const char* what, int32_t start_pos) {
+	int32_t line = 0;
+	int32_t column = 0;
+	odLuaJsonDecoder_get_location(decoder, start_pos, &line, &column);
+	return odLuaJsonDecoder_fail(
+		decoder, decoder->size + 1, "unterminated %s at line %d, column %d", what, line, column);
+}
+static bool odLuaJson_get_is_space(char c) {
+	return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\v') || (c == '\f') || (c == '\r');
+}
+static bool odLuaJson_get_is_digit(char c) {
+	return (c >= '0') && (c <= '9');
+}
+static bool odLuaJson_get_is_alpha(char c) {
+	return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'));
+}
+// skips whitespace, byte order marks and comments; false if the end is reached
+static bool odLuaJsonDecoder_skip_whitespace(const odLuaJsonDecoder* decoder, int32_t* pos) {
+	const char* str = decoder->str;
+	int32_t size = decoder->size;
+	int32_t i = *pos;
+	while (true) {
+		while ((i < size) && odLuaJson_get_is_space(str[i])) {
+			i++;
+		}
+		if (i >= size) {
+			return false;
+		}
+
+		if (((i + 2) < size) && (memcmp(str + i, "\xef\xbb\xbf", 3) == 0)) {
+			i += 3;
+		} else if (((i + 1) < size) && (str[i] == '/') && (str[i + 1] == '/')) {
+			i += 2;
+			while ((i < size) && (str[i] != '\n') && (str[i] != '\r')) {
+				i++;
+			}
+			if (i >= size) {
+				return false;
+			}
+		} else if (((i + 1) < size) && (str[i] == '/') && (str[i + 1] == '*')) {
+			i += 2;
+			while (((i + 1) < size) && !((str[i] == '*') && (str[i + 1] == '/'))) {
+				i++;
+			}
+			if ((i + 1) >= size) {
+				return false;
+			}
+			i += 2;
+		} else {
+			*pos = i;
+			return true;
+		}
+	}
+}
+// matches tonumber(str, 16) on the 4 characters at pos
+static bool odLuaJsonDecoder_read_hex4(const odLuaJsonDecoder* decoder, int32_t pos, unsigned long* out_value) {
+	if ((pos + 4) > decoder->size) {
+		return false;
+	}
+
+	char hex[5] = {};
+	memcpy(hex, decoder->str + pos, 4);
+	char* end = nullptr;
+	unsigned long value = strtoul(hex, &end, 16);
+	if (end == hex) {
+		return false;
+	}
+	while (odLuaJson_get_is_space(*end)) {
+		end++;
+	}
+	if (*end != '\0') {
+		return false;
+	}
+
+	*out_value = value;
+	return true;
+}
+static int32_t odLuaJson_get_utf8(unsigned long codepoint, char* out) {
+	if (codepoint <= 0x7f) {
+		out[0] = static_cast<char>(codepoint);
+		return 1;
+	}
+	if (codepoint <= 0x7ff) {
+		out[0] = static_cast<char>(0xc0 + (codepoint >> 6));
+		out[1] = static_cast<char>(0x80 + (codepoint & 0x3f));
+		return 2;
+	}
+	if (codepoint <= 0xffff) {
+		out[0] = static_cast<char>(0xe0 + (codepoint >> 12));
+		out[1] = static_cast<char>(0x80 + ((codepoint >> 6) & 0x3f));
+		out[2] = static_cast<char>(0x80 + (codepoint & 0x3f));
+		return 3;
+	}
+	if (codepoint <= 0x10ffff) {
+		out[0] = static_cast<char>(0xf0 + (codepoint >> 18));
+		out[1] = static_cast<char>(0x80 + ((codepoint >> 12) & 0x3f));
+		out[2] = static_cast<char>(0x80 + ((codepoint >> 6) & 0x3f));
+		out[3] = static_cast<char>(0x80 + (codepoint & 0x3f));
+		return 4;
+	}
+	return 0;
+}
+/* Strings without escapes are pushed straight from the source; escaped strings are built in a luaL_Buffer,
+as it is freed by lua if an error unwinds past it*/
+static bool odLuaJsonDecoder_read_string(odLuaJsonDecoder* decoder, lua_State* lua, int32_t* pos) {
+	const char* str = decoder->str;
+	int32_t size = decoder->size;
+	int32_t start_pos = *pos;
+	int32_t run_start = start_pos + 1;
+
+	luaL_Buffer buffer;
+	bool is_buffered = false;
+	int32_t i = run_start;
+	while (true) {
+		while ((i < size) && (str[i] != '\"') && (str[i] != '\\')) {
+			i++;
+		}
+		if (i >= size) {
+			return odLuaJsonDecoder_fail_unterminated(decoder, "string", start_pos);
+		}
+
+		if (str[i] == '\"') {
+			if (is_buffered) {
+				luaL_addlstring(&buffer, str + run_start, static_cast<size_t>(i - run_start));
+				luaL_pushresult(&buffer);
+			} else {
+				lua_pushlstring(lua, str + run_start, static_cast<size_t>(i - run_start));
+			}
+			*pos = i + 1;
+			return true;
+		}
+
+		if (!is_buffered) {
+			luaL_buffinit(lua, &buffer);
+			is_buffered = true;
+		}
+		luaL_addlstring(&buffer, str + run_start, static_cast<size_t>(i - run_start));
+
+		char escape = ((i + 1) < size) ? str[i + 1] : '\0';
+		char utf8[4];
+		int32_t utf8_size = 0;
+		int32_t escape_size = 2;
+		unsigned long codepoint = 0;
+		if ((escape == 'u') && odLuaJsonDecoder_read_hex4(decoder, i + 2, &codepoint)) {
+			escape_size = 6;
+
+			// utf-16 surrogate pairs are combined
+			unsigned long low_surrogate = 0;
+			if ((codepoint >= 0xd800) && (codepoint <= 0xdbff) && ((i + 7) < size) && (str[i + 6] == '\\')
+				&& (str[i + 7] == 'u') && odLuaJsonDecoder_read_hex4(decoder, i + 8, &low_surrogate)
+				&& (low_surrogate >= 0xdc00) && (low_surrogate <= 0xdfff)) {
+				codepoint = ((codepoint - 0xd800) << 10) + (low_surrogate - 0xdc00) + 0x10000;
+				escape_size = 12;
+			}
+
+			utf8_size = odLuaJson_get_utf8(codepoint, utf8);
+		}
+
+		if (utf8_size > 0) {
+			luaL_addlstring(&buffer, utf8, static_cast<size_t>(utf8_size));
+		} else {
+			escape_size = 2;
+			switch (escape) {
+				case 'b': luaL_addchar(&buffer, '\b'); break;
+				case 'f': luaL_addchar(&buffer, '\f'); break;
+				case 'n': luaL_addchar(&buffer, '\n'); break;
+				case 'r': luaL_addchar(&buffer, '\r'); break;
+				case 't': luaL_addchar(&buffer, '\t'); break;
+				case '\0': {
+					if ((i + 1) < size) {
+						luaL_addchar(&buffer, '\0');
+					}
+					break;
+				}
+				default: luaL_addchar(&buffer, escape); break;
+			}
+		}
+
+		i += escape_size;
+		run_start = i;
+	}
+}
+// matches the pattern ^%-?[%d%.]+[eE]?[%+%-]?%d* then tonumber()
+static bool odLuaJsonDecoder_read_number(odLuaJsonDecoder* decoder, lua_State* lua, int32_t* pos) {
+	const char* str = decoder->str;
+	int32_t size = decoder->size;
+	int32_t start = *pos;
+	int32_t i = start;
+	if ((i < size) && (str[i] == '-')) {
+		i++;
+	}
+	int32_t digits_start = i;
+	while ((i < size) && (odLuaJson_get_is_digit(str[i]) || (str[i] == '.'))) {
+		i++;
+	}
+	if (i == digits_start) {
+		return false;
+	}
+	if ((i < size) && ((str[i] == 'e') || (str[i] == 'E'))) {
+		i++;
+	}
+	if ((i < size) && ((str[i] == '+') || (str[i] == '-'))) {
+		i++;
+	}
+	while ((i < size) && odLuaJson_get_is_digit(str[i])) {
+		i++;
+	}
+
+	int32_t number_size = i - start;
+	lua_Number number = 0;
+	if (number_size < OD_LUA_BINDINGS_JSON_NUMBER_SIZE) {
+		char number_str[OD_LUA_BINDINGS_JSON_NUMBER_SIZE];
+		memcpy(number_str, str + start, static_cast<size_t>(number_size));
+		number_str[number_size] = '\0';
+
+		char* end = nullptr;
+		number = static_cast<lua_Number>(strtod(number_str, &end));
+		if (end != (number_str + number_size)) {
+			return false;
+		}
+	} else {
+		lua_pushlstring(lua, str + start, static_cast<size_t>(number_size));
+		bool is_number = lua_isnumber(lua, -1);
+		number = lua_tonumber(lua, -1);
+		lua_pop(lua, 1);
+		if (!is_number) {
+			return false;
+		}
+	}
+
+	lua_pushnumber(lua, number);
+	*pos = i;
+	return true;
+}
+static bool odLuaJsonDecoder_read_name(odLuaJsonDecoder* decoder, lua_State* lua, int32_t* pos) {
+	const char* str = decoder->str;
+	int32_t size = decoder->size;
+	int32_t start = *pos;
+	if ((start >= size) || !odLuaJson_get_is_alpha(str[start])) {
+		return false;
+	}
+
+	int32_t i = start + 1;
+	while ((i < size) && (odLuaJson_get_is_alpha(str[i]) || odLuaJson_get_is_digit(str[i]))) {
+		i++;
+	}
+
+	int32_t name_size = i - start;
+	if ((name_size == 4) && (memcmp(str + start, "true", 4) == 0)) {
+		lua_pushboolean(lua, true);
+	} else if ((name_size == 5) && (memcmp(str + start, "false", 5) == 0)) {
+		lua_pushboolean(lua, false);
+	} else if ((name_size == 4) && (memcmp(str + start, "null", 4) == 0)) {
+		lua_pushvalue(lua, decoder->null_index);
+	} else {
+		return false;
+	}
+
+	*pos = i;
+	return true;
+}
+/* Objects and arrays are read the same way as in json.lua: values followed by ":" are keys, other values
+are appended, and separators are optional*/
+static bool
+odLuaJsonDecoder_read_table(odLuaJsonDecoder* decoder, lua_State* lua, int32_t* pos, bool is_object, int32_t depth) {
+	const char* what = is_object ? "object" : "array";
+	char close = is_object ? '}' : ']';
+	const char* str = decoder->str;
+	int32_t start_pos = *pos;
+
+	if (!lua_checkstack(lua, 4)) {
+		return odLuaJsonDecoder_fail(decoder, start_pos + 1, "lua stack exhausted");
+	}
+
+	lua_newtable(lua);
+	int table_index = lua_gettop(lua);
+	int metatable_index = is_object ? decoder->object_metatable_index : decoder->array_metatable_index;
+	if (lua_istable(lua, metatable_index)) {
+		lua_pushvalue(lua, metatable_index);
+		lua_setmetatable(lua, table_index);
+	}
+
+	int32_t count = 0;
+	int32_t i = start_pos + 1;
+	while (true) {
+		if (!odLuaJsonDecoder_skip_whitespace(decoder, &i)) {
+			return odLuaJsonDecoder_fail_unterminated(decoder, what, start_pos);
+		}
+		if (str[i] == close) {
+			*pos = i + 1;
+			return true;
+		}
+
+		if (!odLuaJsonDecoder_read_value(decoder, lua, &i, depth + 1)) {
+			return false;
+		}
+		if (!odLuaJsonDecoder_skip_whitespace(decoder, &i)) {
+			return odLuaJsonDecoder_fail_unterminated(decoder, what, start_pos);
+		}
+
+		if (str[i] == ':') {
+			if (lua_isnil(lua, -1)) {
+				int32_t line = 0;
+				int32_t column = 0;
+				odLuaJsonDecoder_get_location(decoder, i, &line, &column);
+				return odLuaJsonDecoder_fail(
+					decoder, i + 1, "cannot use nil as table index (at line %d, column %d)", line, column);
+			}
+
+			i++;
+			if (!odLuaJsonDecoder_skip_whitespace(decoder, &i)) {
+				return odLuaJsonDecoder_fail_unterminated(decoder, what, start_pos);
+			}
+			if (!odLuaJsonDecoder_read_value(decoder, lua, &i, depth + 1)) {
+				return false;
+			}
+			lua_rawset(lua, table_index);
+			if (!odLuaJsonDecoder_skip_whitespace(decoder, &i)) {
+				return odLuaJsonDecoder_fail_unterminated(decoder, what, start_pos);
+			}
+		} else {
+			count++;
+			lua_rawseti(lua, table_index, count);
+		}
+
+		if (str[i] == ',') {
+			i++;
+		}
+	}
+}
+static bool odLuaJsonDecoder_read_value(odLuaJsonDecoder* decoder, lua_State* lua, int32_t* pos, int32_t depth) {
+	if (depth >= OD_LUA_BINDINGS_JSON_MAX_DEPTH) {
+		return odLuaJsonDecoder_fail_at(decoder, *pos, "max depth exceeded");
+	}
+
+	if (!odLuaJsonDecoder_skip_whitespace(decoder, pos)) {
+		return odLuaJsonDecoder_fail(decoder, decoder->size + 1, "no valid JSON value (reached the end)");
+	}
+
+	switch (decoder->str[*pos]) {
+		case '{': return odLuaJsonDecoder_read_table(decoder, lua, pos, /*is_object*/ true, depth);
+		case '[': return odLuaJsonDecoder_read_table(decoder, lua, pos, /*is_object*/ false, depth);
+		case '\"': return odLuaJsonDecoder_read_string(decoder, lua, pos);
+		default: break;
+	}
+
+	if (odLuaJsonDecoder_read_number(decoder, lua, pos) || odLuaJsonDecoder_read_name(decoder, lua, pos)) {
+		return true;
+	}
+
+	return odLuaJsonDecoder_fail_at(decoder, *pos, "no valid JSON value");
+}
+
+static int odLuaBindings_odJson_encode(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int value_index = 1;
+	const int state_index = 2;
+	luaL_checkany(lua, value_index);
+	lua_settop(lua, state_index);
+
+	bool indent = false;
+	int32_t level = 0;
+	if (lua_istable(lua, state_index)) {
+		lua_getfield(lua, state_index, "indent");
+		indent = lua_toboolean(lua, -1);
+		lua_getfield(lua, state_index, "level");
+		level = static_cast<int32_t>(lua_tointeger(lua, -1));
+		lua_pop(lua, 2);
+	}
+
+	char error[OD_LUA_BINDINGS_JSON_ERROR_SIZE] = {};
+	{
+		odLuaJsonEncoder encoder{odString{}, odTrivialArrayT<const void*>{}, indent, {}};
+		if (odLuaJsonEncoder_write_value(&encoder, lua, value_index, level)) {
+			lua_pushlstring(lua, encoder.buffer.begin(), static_cast<size_t>(encoder.buffer.get_count()));
+			return 1;
+		}
+		memcpy(error, encoder.error, sizeof(error));
+	}
+
+	// raised after encoder is destroyed, as lua errors longjmp past destructors
+	return luaL_error(lua, "%s", error);
+}
+static int odLuaBindings_odJson_decode(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int str_index = 1;
+	const int pos_index = 2;
+	const int null_index = 3;
+	const int object_metatable_index = 4;
+	const int array_metatable_index = 5;
+
+	size_t size = 0;
+	const char* str = luaL_checklstring(lua, str_index, &size);
+	if (size > 0x7fffffff) {
+		return luaL_argerror(lua, str_index, "string too large");
+	}
+	int32_t pos = static_cast<int32_t>(luaL_optinteger(lua, pos_index, 1)) - 1;
+	pos = (pos > 0) ? pos : 0;
+
+	// as in json.lua, passing any metatable arguments replaces both defaults
+	bool has_metatables = lua_gettop(lua) >= object_metatable_index;
+	lua_settop(lua, array_metatable_index);
+	if (!has_metatables) {
+		lua_createtable(lua, 0, 1);
+		lua_pushstring(lua, "object");
+		lua_setfield(lua, -2, "__jsontype");
+		lua_replace(lua, object_metatable_index);
+		lua_createtable(lua, 0, 1);
+		lua_pushstring(lua, "array");
+		lua_setfield(lua, -2, "__jsontype");
+		lua_replace(lua, array_metatable_index);
+	}
+
+	odLuaJsonDecoder decoder{
+		str, static_cast<int32_t>(size), null_index, object_metatable_index, array_metatable_index, 0, {}};
+	if (!odLuaJsonDecoder_read_value(&decoder, lua, &pos, 0)) {
+		lua_settop(lua, array_metatable_index);
+		lua_pushnil(lua);
+		lua_pushinteger(lua, decoder.error_pos);
+		lua_pushstring(lua, decoder.error);
+		return 3;
+	}
+
+	lua_pushinteger(lua, pos + 1);
+	return 2;
+}
+bool odLuaBindings_odJson_register(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return false;
+	}
+
+	if (!OD_CHECK(odLua_metatable_declare(lua, OD_LUA_BINDINGS_JSON))) {
+		return false;
+	}
+
+	auto add_method = [lua](const char* name, odLuaFn* fn) -> bool {
+		return odLua_metatable_set_function(lua, OD_LUA_BINDINGS_JSON, name, fn);
+	};
+	if (!OD_CHECK(add_method("encode", odLuaBindings_odJson_encode))
+		|| !OD_CHECK(add_method("decode", odLuaBindings_odJson_decode))) {
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,499 @@
+#include <od/engine/lua/bindings.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include <od/core/debug.h>
+#include <od/core/array.hpp>
+#include <od/core/string.hpp>
+#include <od/platform/file.h>
+#include <od/engine/lua/includes.h>
+#include <od/engine/lua/wrappers.h>
+
+#define OD_LUA_PROFILER_PERIOD_DEFAULT 10000
+#define OD_LUA_PROFILER_MAX_DEPTH 64
+#define OD_LUA_PROFILER_NAME_CAPACITY 128
+#define OD_LUA_PROFILER_FUNCTION_CAPACITY (1 << 12)
+#define OD_LUA_PROFILER_NODE_CAPACITY (1 << 16)
+#define OD_LUA_PROFILER_LINE_CAPACITY (1 << 14)
+#define OD_LUA_PROFILER_ID_INVALID -1
+
+#if OD_BUILD_LUAJIT
+#define OD_LUA_PROFILER_CAVEAT \
+	"luajit: hooks only run in the interpreter, so compiled traces are not sampled; call jit.off() for a complete profile"
+#else
+#define OD_LUA_PROFILER_CAVEAT ""
+#endif
+
+/* Sampling profiler for Lua code: a count hook samples the call stack every `period` VM instructions.
+Samples are aggregated into a call tree of functions (written out as folded stacks, for flamegraphs),
+and per source line of the sampled function.
+Samples are counted in instructions, not time, so C functions only show up as callers of Lua code.
+The hook is set on the calling thread, and inherited by coroutines created while it is set. */
+struct odLuaProfilerFunction {
+	char source[LUA_IDSIZE];
+	int32_t line_defined;
+	char name[OD_LUA_PROFILER_NAME_CAPACITY];  // "name (source:line_defined)", as written to folded stacks
+	int32_t self_samples;
+	int32_t total_samples;  // counts recursive calls once; computed when reporting
+};
+struct odLuaProfilerNode {
+	int32_t parent_id;
+	int32_t function_id;
+	int32_t self_samples;
+	int32_t total_samples;  // computed when reporting
+};
+struct odLuaProfilerLine {
+	int32_t function_id;
+	int32_t line;
+	int32_t samples;
+};
+struct odLuaProfilerState {
+	odTrivialArrayT<odLuaProfilerFunction> functions;
+	odTrivialArrayT<odLuaProfilerNode> nodes;
+	odTrivialArrayT<odLuaProfilerLine> lines;
+
+	// open addressing hash indices of the above, twice the capacity so they never fill
+	odTrivialArrayT<int32_t> function_index;
+	odTrivialArrayT<int32_t> node_index;
+	odTrivialArrayT<int32_t> line_index;
+
+	int32_t period;
+	int32_t samples;
+	int32_t samples_dropped;
+};
+
+static odLuaProfilerState odLuaProfiler_state{};
+
+static uint32_t odLuaProfiler_hash_combine(uint32_t hash, uint32_t value) {
+	return (hash ^ value) * 16777619u;  // fnv-1a prime
+}
+static uint32_t odLuaProfiler_hash_str(uint32_t hash, const char* str) {
+	for (const char* iter = str; *iter != '\0'; iter++) {
+		hash = odLuaProfiler_hash_combine(hash, static_cast<uint8_t>(*iter));
+	}
+	return hash;
+}
+// returns the index slot holding the matching id, or the empty slot it should be added to
+template <typename Equals>
+static int32_t* odLuaProfiler_index_find(odTrivialArrayT<int32_t>* index, uint32_t hash, Equals equals) {
+	uint32_t mask = static_cast<uint32_t>(index->get_count() - 1);
+	int32_t* slots = index->begin();
+	for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+		if ((slots[i] == OD_LUA_PROFILER_ID_INVALID) || equals(slots[i])) {
+			return &slots[i];
+		}
+	}
+}
+static bool odLuaProfiler_index_init(odTrivialArrayT<int32_t>* index, int32_t capacity) {
+	if (!OD_CHECK(index->set_count(capacity * 2))) {
+		return false;
+	}
+
+	memset(static_cast<void*>(index->begin()), 0xFF, static_cast<size_t>(index->get_count()) * sizeof(int32_t));
+	return true;
+}
+static bool odLuaProfiler_reset(void) {
+	odLuaProfilerState* state = &odLuaProfiler_state;
+	state->samples = 0;
+	state->samples_dropped = 0;
+
+	return OD_CHECK(state->functions.set_count(0))
+		&& OD_CHECK(state->nodes.set_count(0))
+		&& OD_CHECK(state->lines.set_count(0))
+		&& odLuaProfiler_index_init(&state->function_index, OD_LUA_PROFILER_FUNCTION_CAPACITY)
+		&& odLuaProfiler_index_init(&state->node_index, OD_LUA_PROFILER_NODE_CAPACITY)
+		&& odLuaProfiler_index_init(&state->line_index, OD_LUA_PROFILER_LINE_CAPACITY);
+}
+static int32_t odLuaProfiler_get_function_id(lua_State* lua, lua_Debug* ar) {
+	odLuaProfilerState* state = &odLuaProfiler_state;
+
+	// C functions have no source to tell them apart, so are told apart by the name they are called by
+	bool is_c = (ar->what != nullptr) && (strcmp(ar->what, "C") == 0);
+	if (is_c) {
+		lua_getinfo(lua, "n", ar);
+	}
+	const char* c_name = (is_c && (ar->name != nullptr)) ? ar->name : "";
+
+	uint32_t hash = odLuaProfiler_hash_str(2166136261u, ar->short_src);  // fnv-1a offset basis
+	hash = odLuaProfiler_hash_combine(hash, static_cast<uint32_t>(ar->linedefined));
+	hash = odLuaProfiler_hash_str(hash, c_name);
+
+	int32_t* slot = odLuaProfiler_index_find(&state->function_index, hash, [&](int32_t function_id) {
+		const odLuaProfilerFunction* function = state->functions.get(function_id);
+		return (function->line_defined == ar->linedefined)
+			&& (strcmp(function->source, ar->short_src) == 0)
+			&& (!is_c || (strncmp(function->name, c_name, OD_LUA_PROFILER_NAME_CAPACITY - 1) == 0));
+	});
+	if (*slot != OD_LUA_PROFILER_ID_INVALID) {
+		return *slot;
+	}
+
+	if (state->functions.get_count() >= OD_LUA_PROFILER_FUNCTION_CAPACITY) {
+		return OD_LUA_PROFILER_ID_INVALID;
+	}
+
+	if (!is_c) {
+		lua_getinfo(lua, "n", ar);
+	}
+
+	odLuaProfilerFunction function{};
+	strncpy(function.source, ar->short_src, sizeof(function.source) - 1);
+	function.line_defined = ar->linedefined;
+	if (is_c) {
+		strncpy(function.name, (c_name[0] != '\0') ? c_name : "?", sizeof(function.name) - 1);
+	} else if ((ar->what != nullptr) && (strcmp(ar->what, "main") == 0)) {
+		snprintf(function.name, sizeof(function.name), "main (%s)", ar->short_src);
+	} else if ((ar->what != nullptr) && (strcmp(ar->what, "tail") == 0)) {
+		strncpy(function.name, "(tail call)", sizeof(function.name) - 1);
+	} else {
+		snprintf(
+			function.name,
+			sizeof(function.name),
+			"%s (%s:%d)",
+			(ar->name != nullptr) ? ar->name : "?",
+			ar->short_src,
+			ar->linedefined);
+	}
+
+	// ';' separates frames in folded stacks
+	for (char* iter = function.name; *iter != '\0'; iter++) {
+		if ((*iter == ';') || (*iter == '\n')) {
+			*iter = ',';
+		}
+	}
+
+	if (!state->functions.push(function)) {
+		return OD_LUA_PROFILER_ID_INVALID;
+	}
+
+	*slot = state->functions.get_count() - 1;
+	return *slot;
+}
+static int32_t odLuaProfiler_get_node_id(int32_t parent_id, int32_t function_id) {
+	odLuaProfilerState* state = &odLuaProfiler_state;
+
+	uint32_t hash = odLuaProfiler_hash_combine(2166136261u, static_cast<uint32_t>(parent_id));
+	hash = odLuaProfiler_hash_combine(hash, static_cast<uint32_t>(function_id));
+
+	int32_t* slot = odLuaProfiler_index_find(&state->node_index, hash, [&](int32_t node_id) {
+		const odLuaProfilerNode* node = state->nodes.get(node_id);
+		return (node->parent_id == parent_id) && (node->function_id == function_id);
+	});
+	if (*slot != OD_LUA_PROFILER_ID_INVALID) {
+		return *slot;
+	}
+
+	if ((state->nodes.get_count() >= OD_LUA_PROFILER_NODE_CAPACITY)
+		|| !state->nodes.push(odLuaProfilerNode{parent_id, function_id, 0, 0})) {
+		return OD_LUA_PROFILER_ID_INVALID;
+	}
+
+	*slot = state->nodes.get_count() - 1;
+	return *slot;
+}
+static int32_t odLuaProfiler_get_line_id(int32_t function_id, int32_t line) {
+	odLuaProfilerState* state = &odLuaProfiler_state;
+
+	uint32_t hash = odLuaProfiler_hash_combine(2166136261u, static_cast<uint32_t>(function_id));
+	hash = odLuaProfiler_hash_combine(hash, static_cast<uint32_t>(line));
+
+	int32_t* slot = odLuaProfiler_index_find(&state->line_index, hash, [&](int32_t line_id) {
+		const odLuaProfilerLine* profiler_line = state->lines.get(line_id);
+		return (profiler_line->function_id == function_id) && (profiler_line->line == line);
+	});
+	if (*slot != OD_LUA_PROFILER_ID_INVALID) {
+		return *slot;
+	}
+
+	if ((state->lines.get_count() >= OD_LUA_PROFILER_LINE_CAPACITY)
+		|| !state->lines.push(odLuaProfilerLine{function_id, line, 0})) {
+		return OD_LUA_PROFILER_ID_INVALID;
+	}
+
+	*slot = state->lines.get_count() - 1;
+	return *slot;
+}
+static void odLuaProfiler_hook(lua_State* lua, lua_Debug* /*hook_ar*/) {
+	odLuaProfilerState* state = &odLuaProfiler_state;
+
+	// leaf first; stacks deeper than the max depth lose their outermost frames
+	int32_t function_ids[OD_LUA_PROFILER_MAX_DEPTH];
+	int32_t depth = 0;
+	int32_t leaf_line = 0;
+	lua_Debug ar;
+	for (int level = 0; (depth < OD_LUA_PROFILER_MAX_DEPTH) && lua_getstack(lua, level, &ar); level++) {
+		lua_getinfo(lua, (level == 0) ? "Sl" : "S", &ar);
+		if (level == 0) {
+			leaf_line = ar.currentline;
+		}
+
+		function_ids[depth] = odLuaProfiler_get_function_id(lua, &ar);
+		if (function_ids[depth] == OD_LUA_PROFILER_ID_INVALID) {
+			state->samples_dropped++;
+			return;
+		}
+		depth++;
+	}
+	if (depth == 0) {
+		return;
+	}
+
+	int32_t node_id = OD_LUA_PROFILER_ID_INVALID;
+	for (int32_t i = depth - 1; i >= 0; i--) {
+		node_id = odLuaProfiler_get_node_id(node_id, function_ids[i]);
+		if (node_id == OD_LUA_PROFILER_ID_INVALID) {
+			state->samples_dropped++;
+			return;
+		}
+	}
+
+	int32_t line_id = odLuaProfiler_get_line_id(function_ids[0], leaf_line);
+	if (line_id == OD_LUA_PROFILER_ID_INVALID) {
+		state->samples_dropped++;
+		return;
+	}
+
+	state->nodes.get(node_id)->self_samples++;
+	state->functions.get(function_ids[0])->self_samples++;
+	state->lines.get(line_id)->samples++;
+	state->samples++;
+}
+static void odLuaProfiler_update_totals(void) {
+	odLuaProfilerState* state = &odLuaProfiler_state;
+
+	int32_t functions_count = state->functions.get_count();
+	for (int32_t i = 0; i < functions_count; i++) {
+		state->functions.get(i)->total_samples = 0;
+	}
+
+	// children are always added after their parents, so totals propagate up in one reverse pass
+	int32_t nodes_count = state->nodes.get_count();
+	for (int32_t i = 0; i < nodes_count; i++) {
+		odLuaProfilerNode* node = state->nodes.get(i);
+		node->total_samples = node->self_samples;
+	}
+	for (int32_t i = nodes_count - 1; i >= 0; i--) {
+		const odLuaProfilerNode* node = state->nodes.get(i);
+		if (node->parent_id != OD_LUA_PROFILER_ID_INVALID) {
+			state->nodes.get(node->parent_id)->total_samples += node->total_samples;
+		}
+	}
+
+	// a node only adds to its function's total if the function is not already further up the stack
+	for (int32_t i = 0; i < nodes_count; i++) {
+		const odLuaProfilerNode* node = state->nodes.get(i);
+		bool is_recursive = false;
+		for (int32_t parent_id = node->parent_id; parent_id != OD_LUA_PROFILER_ID_INVALID;) {
+			const odLuaProfilerNode* parent = state->nodes.get(parent_id);
+			if (parent->function_id == node->function_id) {
+				is_recursive = true;
+				break;
+			}
+			parent_id = parent->parent_id;
+		}
+
+		if (!is_recursive) {
+			state->functions.get(node->function_id)->total_samples += node->total_samples;
+		}
+	}
+}
+static bool odLuaProfiler_write_folded(const char* filename) {
+	odLuaProfilerState* state = &odLuaProfiler_state;
+	if (state->samples == 0) {
+		OD_WARN("lua profile has no samples to write, filename=%s", filename);
+		return false;
+	}
+
+	odString folded;
+	int32_t path[OD_LUA_PROFILER_MAX_DEPTH];
+	int32_t nodes_count = state->nodes.get_count();
+	for (int32_t i = 0; i < nodes_count; i++) {
+		const odLuaProfilerNode* node = state->nodes.get(i);
+		if (node->self_samples == 0) {
+			continue;
+		}
+
+		int32_t depth = 0;
+		for (int32_t node_id = i; node_id != OD_LUA_PROFILER_ID_INVALID; node_id = state->nodes.get(node_id)->parent_id) {
+			if (!OD_CHECK(depth < OD_LUA_PROFILER_MAX_DEPTH)) {
+				return false;
+			}
+			path[depth] = node_id;
+			depth++;
+		}
+
+		for (int32_t j = depth - 1; j >= 0; j--) {
+			const odLuaProfilerFunction* function = state->functions.get(state->nodes.get(path[j])->function_id);
+			if (!OD_CHECK(folded.extend(function->name))
+				|| !OD_CHECK(folded.extend((j > 0) ? ";" : " "))) {
+				return false;
+			}
+		}
+
+		if (!OD_CHECK(odString_extend_formatted(&folded, "%d\n", node->self_samples))) {
+			return false;
+		}
+	}
+
+	if (!OD_CHECK(odFile_write_all(filename, "wb", folded.begin(), folded.get_count()))) {
+		return false;
+	}
+
+	OD_INFO(
+		"lua profile written, filename=%s, samples=%d, samples_dropped=%d, period=%d",
+		filename,
+		state->samples,
+		state->samples_dropped,
+		state->period);
+	if (OD_LUA_PROFILER_CAVEAT[0] != '\0') {
+		OD_WARN("lua profile is partial, %s", OD_LUA_PROFILER_CAVEAT);
+	}
+	return true;
+}
+static bool odLuaProfiler_get_running(lua_State* lua) {
+	return lua_gethook(lua) == odLuaProfiler_hook;
+}
+
+static int odLuaBindings_odLuaProfiler_start(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	int32_t period = static_cast<int32_t>(luaL_optinteger(lua, 1, OD_LUA_PROFILER_PERIOD_DEFAULT));
+	if (period <= 0) {
+		return luaL_argerror(lua, 1, "period must be positive");
+	}
+
+	// the debugger and coverage tools also use hooks, and only one can be set
+	lua_Hook hook = lua_gethook(lua);
+	if ((hook != nullptr) && (hook != odLuaProfiler_hook)) {
+		return luaL_error(lua, "another lua hook is already set");
+	}
+
+	lua_sethook(lua, nullptr, 0, 0);
+	if (!OD_CHECK(odLuaProfiler_reset())) {
+		return luaL_error(lua, "odLuaProfiler_reset() failed");
+	}
+
+	odLuaProfiler_state.period = period;
+	lua_sethook(lua, odLuaProfiler_hook, LUA_MASKCOUNT, period);
+
+	if (OD_LUA_PROFILER_CAVEAT[0] != '\0') {
+		OD_WARN("lua profile will be partial, %s", OD_LUA_PROFILER_CAVEAT);
+	}
+	return 0;
+}
+static int odLuaBindings_odLuaProfiler_stop(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	bool running = odLuaProfiler_get_running(lua);
+	if (running) {
+		lua_sethook(lua, nullptr, 0, 0);
+	}
+
+	lua_pushboolean(lua, running);
+	return 1;
+}
+static int odLuaBindings_odLuaProfiler_is_running(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_pushboolean(lua, odLuaProfiler_get_running(lua));
+	return 1;
+}
+/* {samples, samples_dropped, period, caveat,
+functions = {{name, source, line, self_samples, total_samples}, ...},
+lines = {{function, source, line, samples}, ...}} */
+static int odLuaBindings_odLuaProfiler_get_stats(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	odLuaProfilerState* state = &odLuaProfiler_state;
+	odLuaProfiler_update_totals();
+
+	lua_createtable(lua, 0, 6);
+	lua_pushinteger(lua, state->samples);
+	lua_setfield(lua, -2, "samples");
+	lua_pushinteger(lua, state->samples_dropped);
+	lua_setfield(lua, -2, "samples_dropped");
+	lua_pushinteger(lua, state->period);
+	lua_setfield(lua, -2, "period");
+	lua_pushstring(lua, OD_LUA_PROFILER_CAVEAT);
+	lua_setfield(lua, -2, "caveat");
+
+	int32_t functions_count = state->functions.get_count();
+	lua_createtable(lua, functions_count, 0);
+	for (int32_t i = 0; i < functions_count; i++) {
+		const odLuaProfilerFunction* function = state->functions.get(i);
+		lua_createtable(lua, 0, 5);
+		lua_pushstring(lua, function->name);
+		lua_setfield(lua, -2, "name");
+		lua_pushstring(lua, function->source);
+		lua_setfield(lua, -2, "source");
+		lua_pushinteger(lua, function->line_defined);
+		lua_setfield(lua, -2, "line");
+		lua_pushinteger(lua, function->self_samples);
+		lua_setfield(lua, -2, "self_samples");
+		lua_pushinteger(lua, function->total_samples);
+		lua_setfield(lua, -2, "total_samples");
+		lua_rawseti(lua, -2, i + 1);
+	}
+	lua_setfield(lua, -2, "functions");
+
+	int32_t lines_count = state->lines.get_count();
+	lua_createtable(lua, lines_count, 0);
+	for (int32_t i = 0; i < lines_count; i++) {
+		const odLuaProfilerLine* line = state->lines.get(i);
+		const odLuaProfilerFunction* function = state->functions.get(line->function_id);
+		lua_createtable(lua, 0, 4);
+		lua_pushstring(lua, function->name);
+		lua_setfield(lua, -2, "function");
+		lua_pushstring(lua, function->source);
+		lua_setfield(lua, -2, "source");
+		lua_pushinteger(lua, line->line);
+		lua_setfield(lua, -2, "line");
+		lua_pushinteger(lua, line->samples);
+		lua_setfield(lua, -2, "samples");
+		lua_rawseti(lua, -2, i + 1);
+	}
+	lua_setfield(lua, -2, "lines");
+
+	return 1;
+}
+// writes samples as folded stacks ("outer;inner count" per line), as read by flamegraph.pl, inferno and speedscope
+static int odLuaBindings_odLuaProfiler_write_folded(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const char* filename = luaL_checkstring(lua, 1);
+	lua_pushboolean(lua, odLuaProfiler_write_folded(filename));
+	return 1;
+}
+bool odLuaBindings_odLuaProfiler_register(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return false;
+	}
+
+	if (!OD_CHECK(odLua_metatable_declare(lua, OD_LUA_BINDINGS_LUA_PROFILER))) {
+		return false;
+	}
+
+	auto add_method = [lua](const char* name, odLuaFn* fn) -> bool {
+		return odLua_metatable_set_function(lua, OD_LUA_BINDINGS_LUA_PROFILER, name, fn);
+	};
+	if (!OD_CHECK(add_method("start", odLuaBindings_odLuaProfiler_start))
+		|| !OD_CHECK(add_method("stop", odLuaBindings_odLuaProfiler_stop))
+		|| !OD_CHECK(add_method("is_running", odLuaBindings_odLuaProfiler_is_running))
+		|| !OD_CHECK(add_method("get_stats", odLuaBindings_odLuaProfiler_get_stats))
+		|| !OD_CHECK(add_method("write_folded", odLuaBindings_odLuaProfiler_write_folded))) {
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,177 @@
+#include <od/engine/lua/bindings.h>
+
+#include <od/core/debug.h>
+#include <od/platform/profile.h>
+#include <od/platform/timer.h>
+#include <od/engine/lua/includes.h>
+#include <od/engine/lua/wrappers.h>
+
+static int odLuaBindings_odProfile_is_enabled(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_pushboolean(lua, OD_BUILD_PROFILE);
+	return 1;
+}
+static int odLuaBindings_odProfile_get_zone_id(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const char* name = luaL_checkstring(lua, 1);
+	int32_t zone_id = odProfile_get_zone_id(name);
+	if (zone_id == OD_PROFILE_ZONE_ID_INVALID) {
+		return luaL_error(lua, "odProfile_get_zone_id(%s) failed", name);
+	}
+
+	lua_pushinteger(lua, zone_id);
+	return 1;
+}
+static int odLuaBindings_odProfile_begin_zone(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	int32_t zone_id = static_cast<int32_t>(luaL_checkinteger(lua, 1));
+	if ((zone_id < 0) || (zone_id >= odProfile_get_zone_count())) {
+		return luaL_argerror(lua, 1, "unknown zone id");
+	}
+	if (!odProfile_begin(zone_id)) {
+		return luaL_error(lua, "odProfile_begin() failed, too many open zones");
+	}
+
+	return 0;
+}
+static int odLuaBindings_odProfile_end_zone(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	int32_t zone_id = static_cast<int32_t>(luaL_checkinteger(lua, 1));
+	lua_pushboolean(lua, odProfile_end(zone_id));
+	return 1;
+}
+static int odLuaBindings_odProfile_get_frame_count(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_pushinteger(lua, odProfile_get_frame_count());
+	return 1;
+}
+// {[zone_name] = {count, total_ms, max_ms}} for the last completed frame, for zones recorded in that frame
+static int odLuaBindings_odProfile_get_frame_stats(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_newtable(lua);
+	int32_t zone_count = odProfile_get_zone_count();
+	for (int32_t zone_id = 0; zone_id < zone_count; zone_id++) {
+		const odProfileZoneStats* stats = odProfile_get_frame_stats(zone_id);
+		if (!OD_CHECK(stats != nullptr)) {
+			return luaL_error(lua, "odProfile_get_frame_stats() failed");
+		}
+		if (stats->count == 0) {
+			continue;
+		}
+
+		lua_createtable(lua, 0, 3);
+		lua_pushinteger(lua, stats->count);
+		lua_setfield(lua, -2, "count");
+		lua_pushnumber(lua, static_cast<lua_Number>(stats->total_ns) / 1e6);
+		lua_setfield(lua, -2, "total_ms");
+		lua_pushnumber(lua, static_cast<lua_Number>(stats->max_ns) / 1e6);
+		lua_setfield(lua, -2, "max_ms");
+		lua_setfield(lua, -2, odProfile_get_zone_name(zone_id));
+	}
+
+	return 1;
+}
+static int odLuaBindings_odProfile_begin_trace(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const char* filename = luaL_checkstring(lua, 1);
+	int32_t frame_count = static_cast<int32_t>(luaL_checkinteger(lua, 2));
+	if (frame_count <= 0) {
+		return luaL_argerror(lua, 2, "frame count must be positive");
+	}
+
+	lua_pushboolean(lua, odProfile_begin_trace(filename, frame_count));
+	return 1;
+}
+static int odLuaBindings_odProfile_end_trace(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	if (!odProfile_get_tracing()) {
+		lua_pushboolean(lua, false);
+		return 1;
+	}
+
+	lua_pushboolean(lua, odProfile_end_trace());
+	return 1;
+}
+static int odLuaBindings_odProfile_is_tracing(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_pushboolean(lua, odProfile_get_tracing());
+	return 1;
+}
+// monotonic clock for benchmarks; doubles hold whole nanoseconds for ~100 days of uptime
+static int odLuaBindings_odProfile_get_now_ns(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	lua_pushnumber(lua, static_cast<lua_Number>(odTimer_get_now_ns()));
+	return 1;
+}
+static int odLuaBindings_odProfile_add_counter(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	int32_t zone_id = static_cast<int32_t>(luaL_checkinteger(lua, 1));
+	lua_Number value = luaL_checknumber(lua, 2);
+	if ((zone_id < 0) || (zone_id >= odProfile_get_zone_count())) {
+		return luaL_argerror(lua, 1, "unknown zone id");
+	}
+
+	odProfile_add_counter(zone_id, static_cast<int64_t>(value));
+	return 0;
+}
+bool odLuaBindings_odProfile_register(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return false;
+	}
+
+	if (!OD_CHECK(odLua_metatable_declare(lua, OD_LUA_BINDINGS_PROFILE))) {
+		return false;
+	}
+
+	auto add_method = [lua](const char* name, odLuaFn* fn) -> bool {
+		return odLua_metatable_set_function(lua, OD_LUA_BINDINGS_PROFILE, name, fn);
+	};
+	if (!OD_CHECK(add_method("is_enabled", odLuaBindings_odProfile_is_enabled))
+		|| !OD_CHECK(add_method("get_zone_id", odLuaBindings_odProfile_get_zone_id))
+		|| !OD_CHECK(add_method("begin_zone", odLuaBindings_odProfile_begin_zone))
+		|| !OD_CHECK(add_method("end_zone", odLuaBindings_odProfile_end_zone))
+		|| !OD_CHECK(add_method("get_frame_count", odLuaBindings_odProfile_get_frame_count))
+		|| !OD_CHECK(add_method("get_frame_stats", odLuaBindings_odProfile_get_frame_stats))
+		|| !OD_CHECK(add_method("begin_trace", odLuaBindings_odProfile_begin_trace))
+		|| !OD_CHECK(add_method("end_trace", odLuaBindings_odProfile_end_trace))
+		|| !OD_CHECK(add_method("is_tracing", odLuaBindings_odProfile_is_tracing))
+		|| !OD_CHECK(add_method("add_counter", odLuaBindings_odProfile_add_counter))
+		|| !OD_CHECK(add_method("get_now_ns", odLuaBindings_odProfile_get_now_ns))) {
+		return false;
+	}
+
+	return true;
+}
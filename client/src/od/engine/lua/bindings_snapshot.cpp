@@ -0,0 +1,749 @@
+#include <od/engine/lua/bindings.h>
+
+#include <cmath>
+#include <cstring>
+
+#include <od/core/debug.h>
+#include <od/core/allocation.hpp>
+#include <od/core/array.hpp>
+#include <od/platform/file.hpp>
+#include <od/engine/lua/includes.h>
+#include <od/engine/lua/wrappers.h>
+
+/* Compact binary encoding of serializable lua values (see Schema.Serializable):
+header: OD_LUA_BINDINGS_SNAPSHOT_MAGIC, then one version byte
+value: one tag byte, then:
+- false, true: nothing
+- integer: zigzag varint, for integral numbers within +-2^53
+- number: 8 byte little-endian double
+- string: varint size, then bytes
+- array: varint count, then values
+- object: varint count, then (varint size, key bytes, value) pairs*/
+
+#define OD_LUA_BINDINGS_SNAPSHOT_MAGIC "odSn"
+#define OD_LUA_BINDINGS_SNAPSHOT_MAGIC_SIZE 4
+#define OD_LUA_BINDINGS_SNAPSHOT_VERSION 1
+#define OD_LUA_BINDINGS_SNAPSHOT_MAX_DEPTH 128
+#define OD_LUA_BINDINGS_SNAPSHOT_FLUSH_SIZE (64 * 1024)
+#define OD_LUA_BINDINGS_SNAPSHOT_MAX_INTEGER 9007199254740992.0  // 2^53
+#define OD_LUA_BINDINGS_SNAPSHOT_RESTORE_VISITED "odSnapshot_restore_visited"
+
+enum odLuaSnapshotTag : uint8_t {
+	OD_LUA_SNAPSHOT_TAG_FALSE = 0,
+	OD_LUA_SNAPSHOT_TAG_TRUE = 1,
+	OD_LUA_SNAPSHOT_TAG_INTEGER = 2,
+	OD_LUA_SNAPSHOT_TAG_NUMBER = 3,
+	OD_LUA_SNAPSHOT_TAG_STRING = 4,
+	OD_LUA_SNAPSHOT_TAG_ARRAY = 5,
+	OD_LUA_SNAPSHOT_TAG_OBJECT = 6,
+};
+
+struct odLuaSnapshotWriter {
+	odFile* opt_file;  // if set, buffer is flushed to it as it fills
+	odTrivialArrayT<uint8_t> buffer;
+	const char* error;
+};
+struct odLuaSnapshotReader {
+	const uint8_t* data;
+	int32_t size;
+	int32_t offset;
+	const char* error;
+};
+struct odLuaSnapshotCopier {
+	/* weak-keyed table of target tables already restored, so aliased tables are not restored twice.
+	entries equal to generation were visited by this restore; kept across restores so it never regrows*/
+	int visited_index;
+	lua_Number generation;
+	const char* error;
+};
+
+OD_NO_DISCARD static bool
+odLuaSnapshotWriter_write_value(odLuaSnapshotWriter* writer, lua_State* lua, int index, int32_t depth);
+OD_NO_DISCARD static bool
+odLuaSnapshotReader_read_value(odLuaSnapshotReader* reader, lua_State* lua, int32_t depth);
+OD_NO_DISCARD static bool
+odLuaSnapshotCopier_copy_value(odLuaSnapshotCopier* copier, lua_State* lua, int index, int32_t depth);
+
+static bool odLuaSnapshotWriter_flush(odLuaSnapshotWriter* writer) {
+	if ((writer->opt_file == nullptr) || (writer->buffer.get_count() == 0)) {
+		return true;
+	}
+
+	if (!OD_CHECK(odFile_write(writer->opt_file, writer->buffer.begin(), writer->buffer.get_count()))) {
+		writer->error = "odFile_write() failed";
+		return false;
+	}
+
+	return OD_CHECK(writer->buffer.set_count(0));
+}
+static bool odLuaSnapshotWriter_write(odLuaSnapshotWriter* writer, const void* data, int32_t size) {
+	if (!OD_CHECK(writer->buffer.extend(static_cast<const uint8_t*>(data), size))) {
+		writer->error = "out of memory";
+		return false;
+	}
+
+	if (writer->buffer.get_count() >= OD_LUA_BINDINGS_SNAPSHOT_FLUSH_SIZE) {
+		return odLuaSnapshotWriter_flush(writer);
+	}
+
+	return true;
+}
+static bool odLuaSnapshotWriter_write_tag(odLuaSnapshotWriter* writer, odLuaSnapshotTag tag) {
+	uint8_t tag_byte = tag;
+	return odLuaSnapshotWriter_write(writer, &tag_byte, 1);
+}
+static bool odLuaSnapshotWriter_write_varint(odLuaSnapshotWriter* writer, uint64_t value) {
+	uint8_t bytes[10];
+	int32_t count = 0;
+	do {
+		uint8_t byte = static_cast<uint8_t>(value & 0x7f);
+		value >>= 7;
+		bytes[count] = static_cast<uint8_t>(byte | ((value != 0) ? 0x80 : 0));
+		count++;
+	} while (value != 0);
+
+	return odLuaSnapshotWriter_write(writer, bytes, count);
+}
+static bool odLuaSnapshotWriter_write_string(odLuaSnapshotWriter* writer, lua_State* lua, int index) {
+	size_t size = 0;
+	const char* str = lua_tolstring(lua, index, &size);
+	if (size > 0x7fffffff) {
+		writer->error = "string too large";
+		return false;
+	}
+
+	return odLuaSnapshotWriter_write_varint(writer, static_cast<uint64_t>(size))
+		&& odLuaSnapshotWriter_write(writer, str, static_cast<int32_t>(size));
+}
+static bool odLuaSnapshotWriter_write_number(odLuaSnapshotWriter* writer, lua_Number number) {
+	double value = static_cast<double>(number);
+	if ((floor(value) == value)
+		&& (value <= OD_LUA_BINDINGS_SNAPSHOT_MAX_INTEGER)
+		&& (value >= -OD_LUA_BINDINGS_SNAPSHOT_MAX_INTEGER)
+		&& !((value == 0.0) && std::signbit(value))) {
+		int64_t integer = static_cast<int64_t>(value);
+		uint64_t zigzag = (static_cast<uint64_t>(integer) << 1) ^ static_cast<uint64_t>(integer >> 63);
+		return odLuaSnapshotWriter_write_tag(writer, OD_LUA_SNAPSHOT_TAG_INTEGER)
+			&& odLuaSnapshotWriter_write_varint(writer, zigzag);
+	}
+
+	uint64_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+	uint8_t bytes[8];
+	for (int32_t i = 0; i < 8; i++) {
+		bytes[i] = static_cast<uint8_t>(bits >> (8 * i));
+	}
+	return odLuaSnapshotWriter_write_tag(writer, OD_LUA_SNAPSHOT_TAG_NUMBER)
+		&& odLuaSnapshotWriter_write(writer, bytes, 8);
+}
+static bool odLuaSnapshotWriter_write_table(odLuaSnapshotWriter* writer, lua_State* lua, int index, int32_t depth) {
+	if (depth >= OD_LUA_BINDINGS_SNAPSHOT_MAX_DEPTH) {
+		writer->error = "max depth exceeded, table may be cyclic";
+		return false;
+	}
+
+	if (!lua_checkstack(lua, 4)) {
+		writer->error = "lua stack exhausted";
+		return false;
+	}
+
+	// tables are arrays if all keys are 1..n, objects if all keys are strings; mixed tables are not serializable
+	int32_t length = odLua_get_length(lua, index);
+	int32_t key_count = 0;
+	bool has_string_keys = false;
+	bool has_number_keys = false;
+	lua_pushnil(lua);
+	while (lua_next(lua, index) != 0) {
+		int key_type = lua_type(lua, -2);
+		if (key_type == LUA_TSTRING) {
+			has_string_keys = true;
+		} else if (key_type == LUA_TNUMBER) {
+			lua_Number key = lua_tonumber(lua, -2);
+			if ((floor(key) != key) || (key < 1) || (key > static_cast<lua_Number>(length))) {
+				writer->error = "table has non-array number keys";
+				lua_pop(lua, 2);
+				return false;
+			}
+			has_number_keys = true;
+		} else {
+			writer->error = "table has keys which are not strings or numbers";
+			lua_pop(lua, 2);
+			return false;
+		}
+		key_count++;
+		lua_pop(lua, 1);
+	}
+
+	if (has_string_keys && has_number_keys) {
+		writer->error = "table has mixed string and number keys";
+		return false;
+	}
+
+	if (!has_string_keys) {
+		if (key_count != length) {
+			writer->error = "table is a sparse array";
+			return false;
+		}
+
+		if (!odLuaSnapshotWriter_write_tag(writer, OD_LUA_SNAPSHOT_TAG_ARRAY)
+			|| !odLuaSnapshotWriter_write_varint(writer, static_cast<uint64_t>(length))) {
+			return false;
+		}
+
+		for (int32_t i = 1; i <= length; i++) {
+			lua_rawgeti(lua, index, i);
+			bool ok = odLuaSnapshotWriter_write_value(writer, lua, lua_gettop(lua), depth + 1);
+			lua_pop(lua, 1);
+			if (!ok) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	if (!odLuaSnapshotWriter_write_tag(writer, OD_LUA_SNAPSHOT_TAG_OBJECT)
+		|| !odLuaSnapshotWriter_write_varint(writer, static_cast<uint64_t>(key_count))) {
+		return false;
+	}
+
+	lua_pushnil(lua);
+	while (lua_next(lua, index) != 0) {
+		bool ok = odLuaSnapshotWriter_write_string(writer, lua, lua_gettop(lua) - 1)
+			&& odLuaSnapshotWriter_write_value(writer, lua, lua_gettop(lua), depth + 1);
+		if (!ok) {
+			lua_pop(lua, 2);
+			return false;
+		}
+		lua_pop(lua, 1);
+	}
+
+	return true;
+}
+static bool odLuaSnapshotWriter_write_value(odLuaSnapshotWriter* writer, lua_State* lua, int index, int32_t depth) {
+	switch (lua_type(lua, index)) {
+		case LUA_TBOOLEAN: {
+			return odLuaSnapshotWriter_write_tag(
+				writer, lua_toboolean(lua, index) ? OD_LUA_SNAPSHOT_TAG_TRUE : OD_LUA_SNAPSHOT_TAG_FALSE);
+		}
+		case LUA_TNUMBER: {
+			return odLuaSnapshotWriter_write_number(writer, lua_tonumber(lua, index));
+		}
+		case LUA_TSTRING: {
+			return odLuaSnapshotWriter_write_tag(writer, OD_LUA_SNAPSHOT_TAG_STRING)
+				&& odLuaSnapshotWriter_write_string(writer, lua, index);
+		}
+		case LUA_TTABLE: {
+			return odLuaSnapshotWriter_write_table(writer, lua, index, depth);
+		}
+		default: {
+			writer->error = "value is not serializable";
+			return false;
+		}
+	}
+}
+static bool odLuaSnapshotWriter_write_snapshot(odLuaSnapshotWriter* writer, lua_State* lua, int index) {
+	uint8_t version = OD_LUA_BINDINGS_SNAPSHOT_VERSION;
+	return odLuaSnapshotWriter_write(writer, OD_LUA_BINDINGS_SNAPSHOT_MAGIC, OD_LUA_BINDINGS_SNAPSHOT_MAGIC_SIZE)
+		&& odLuaSnapshotWriter_write(writer, &version, 1)
+		&& odLuaSnapshotWriter_write_value(writer, lua, index, 0)
+		&& odLuaSnapshotWriter_flush(writer);
+}
+
+static bool odLuaSnapshotReader_read(odLuaSnapshotReader* reader, int32_t size, const uint8_t** out_data) {
+	if ((size < 0) || (size > (reader->size - reader->offset))) {
+		reader->error = "unexpected end of snapshot";
+		return false;
+	}
+
+	*out_data = reader->data + reader->offset;
+	reader->offset += size;
+	return true;
+}
+static bool odLuaSnapshotReader_read_varint(odLuaSnapshotReader* reader, uint64_t* out_value) {
+	uint64_t value = 0;
+	for (int32_t shift = 0; shift < 64; shift += 7) {
+		const uint8_t* byte = nullptr;
+		if (!odLuaSnapshotReader_read(reader, 1, &byte)) {
+			return false;
+		}
+
+		value |= static_cast<uint64_t>(*byte & 0x7f) << shift;
+		if ((*byte & 0x80) == 0) {
+			*out_value = value;
+			return true;
+		}
+	}
+
+	reader->error = "invalid varint";
+	return false;
+}
+static bool odLuaSnapshotReader_read_count(odLuaSnapshotReader* reader, int32_t* out_count) {
+	uint64_t count = 0;
+	if (!odLuaSnapshotReader_read_varint(reader, &count)) {
+		return false;
+	}
+
+	// every counted item takes at least one byte, which also bounds table preallocation
+	if (count > static_cast<uint64_t>(reader->size - reader->offset)) {
+		reader->error = "count exceeds snapshot size";
+		return false;
+	}
+
+	*out_count = static_cast<int32_t>(count);
+	return true;
+}
+static bool odLuaSnapshotReader_read_string(odLuaSnapshotReader* reader, lua_State* lua) {
+	int32_t size = 0;
+	const uint8_t* str = nullptr;
+	if (!odLuaSnapshotReader_read_count(reader, &size)
+		|| !odLuaSnapshotReader_read(reader, size, &str)) {
+		return false;
+	}
+
+	lua_pushlstring(lua, reinterpret_cast<const char*>(str), static_cast<size_t>(size));
+	return true;
+}
+static bool odLuaSnapshotReader_read_value(odLuaSnapshotReader* reader, lua_State* lua, int32_t depth) {
+	if (depth >= OD_LUA_BINDINGS_SNAPSHOT_MAX_DEPTH) {
+		reader->error = "max depth exceeded";
+		return false;
+	}
+
+	if (!lua_checkstack(lua, 4)) {
+		reader->error = "lua stack exhausted";
+		return false;
+	}
+
+	const uint8_t* tag = nullptr;
+	if (!odLuaSnapshotReader_read(reader, 1, &tag)) {
+		return false;
+	}
+
+	switch (*tag) {
+		case OD_LUA_SNAPSHOT_TAG_FALSE:
+		case OD_LUA_SNAPSHOT_TAG_TRUE: {
+			lua_pushboolean(lua, *tag == OD_LUA_SNAPSHOT_TAG_TRUE);
+			return true;
+		}
+		case OD_LUA_SNAPSHOT_TAG_INTEGER: {
+			uint64_t zigzag = 0;
+			if (!odLuaSnapshotReader_read_varint(reader, &zigzag)) {
+				return false;
+			}
+
+			int64_t integer = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+			lua_pushnumber(lua, static_cast<lua_Number>(integer));
+			return true;
+		}
+		case OD_LUA_SNAPSHOT_TAG_NUMBER: {
+			const uint8_t* bytes = nullptr;
+			if (!odLuaSnapshotReader_read(reader, 8, &bytes)) {
+				return false;
+			}
+
+			uint64_t bits = 0;
+			for (int32_t i = 0; i < 8; i++) {
+				bits |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+			}
+			double value = 0.0;
+			memcpy(&value, &bits, sizeof(value));
+			lua_pushnumber(lua, static_cast<lua_Number>(value));
+			return true;
+		}
+		case OD_LUA_SNAPSHOT_TAG_STRING: {
+			return odLuaSnapshotReader_read_string(reader, lua);
+		}
+		case OD_LUA_SNAPSHOT_TAG_ARRAY: {
+			int32_t count = 0;
+			if (!odLuaSnapshotReader_read_count(reader, &count)) {
+				return false;
+			}
+
+			lua_createtable(lua, count, 0);
+			int table_index = lua_gettop(lua);
+			for (int32_t i = 1; i <= count; i++) {
+				if (!odLuaSnapshotReader_read_value(reader, lua, depth + 1)) {
+					return false;
+				}
+				lua_rawseti(lua, table_index, i);
+			}
+			return true;
+		}
+		case OD_LUA_SNAPSHOT_TAG_OBJECT: {
+			int32_t count = 0;
+			if (!odLuaSnapshotReader_read_count(reader, &count)) {
+				return false;
+			}
+
+			lua_createtable(lua, 0, count);
+			int table_index = lua_gettop(lua);
+			for (int32_t i = 0; i < count; i++) {
+				if (!odLuaSnapshotReader_read_string(reader, lua)
+					|| !odLuaSnapshotReader_read_value(reader, lua, depth + 1)) {
+					return false;
+				}
+				lua_rawset(lua, table_index);
+			}
+			return true;
+		}
+		default: {
+			reader->error = "invalid tag";
+			return false;
+		}
+	}
+}
+static bool odLuaSnapshotReader_read_snapshot(odLuaSnapshotReader* reader, lua_State* lua) {
+	const uint8_t* magic = nullptr;
+	const uint8_t* version = nullptr;
+	if (!odLuaSnapshotReader_read(reader, OD_LUA_BINDINGS_SNAPSHOT_MAGIC_SIZE, &magic)
+		|| !odLuaSnapshotReader_read(reader, 1, &version)) {
+		return false;
+	}
+
+	if (memcmp(magic, OD_LUA_BINDINGS_SNAPSHOT_MAGIC, OD_LUA_BINDINGS_SNAPSHOT_MAGIC_SIZE) != 0) {
+		reader->error = "not a snapshot";
+		return false;
+	}
+
+	if (*version != OD_LUA_BINDINGS_SNAPSHOT_VERSION) {
+		reader->error = "unsupported snapshot version";
+		return false;
+	}
+
+	int top = lua_gettop(lua);
+	if (!odLuaSnapshotReader_read_value(reader, lua, 0)) {
+		lua_settop(lua, top);
+		return false;
+	}
+
+	if (reader->offset != reader->size) {
+		reader->error = "trailing data after snapshot";
+		lua_settop(lua, top);
+		return false;
+	}
+
+	return true;
+}
+
+static bool odLuaSnapshotCopier_copy_table(odLuaSnapshotCopier* copier, lua_State* lua, int index, int32_t depth) {
+	if (depth >= OD_LUA_BINDINGS_SNAPSHOT_MAX_DEPTH) {
+		copier->error = "max depth exceeded, table may be cyclic";
+		return false;
+	}
+
+	if (!lua_checkstack(lua, 4)) {
+		copier->error = "lua stack exhausted";
+		return false;
+	}
+
+	// presized, so copies never rehash
+	int32_t length = odLua_get_length(lua, index);
+	int32_t key_count = 0;
+	lua_pushnil(lua);
+	while (lua_next(lua, index) != 0) {
+		key_count++;
+		lua_pop(lua, 1);
+	}
+
+	lua_createtable(lua, length, (key_count > length) ? (key_count - length) : 0);
+	int copy_index = lua_gettop(lua);
+
+	lua_pushnil(lua);
+	while (lua_next(lua, index) != 0) {
+		lua_pushvalue(lua, -2);
+		if (!odLuaSnapshotCopier_copy_value(copier, lua, lua_gettop(lua) - 1, depth + 1)) {
+			lua_settop(lua, copy_index - 1);
+			return false;
+		}
+		lua_rawset(lua, copy_index);
+		lua_pop(lua, 1);
+	}
+
+	return true;
+}
+static bool odLuaSnapshotCopier_copy_value(odLuaSnapshotCopier* copier, lua_State* lua, int index, int32_t depth) {
+	switch (lua_type(lua, index)) {
+		case LUA_TTABLE: {
+			return odLuaSnapshotCopier_copy_table(copier, lua, index, depth);
+		}
+		case LUA_TNIL:
+		case LUA_TBOOLEAN:
+		case LUA_TNUMBER:
+		case LUA_TSTRING:
+		case LUA_TFUNCTION: {
+			if (!lua_checkstack(lua, 1)) {
+				copier->error = "lua stack exhausted";
+				return false;
+			}
+			lua_pushvalue(lua, index);
+			return true;
+		}
+		default: {
+			copier->error = "value has a type which cannot be copied";
+			return false;
+		}
+	}
+}
+static bool odLuaSnapshotCopier_is_visited(odLuaSnapshotCopier* copier, lua_State* lua, int index) {
+	lua_pushvalue(lua, index);
+	lua_rawget(lua, copier->visited_index);
+	bool visited = lua_tonumber(lua, -1) == copier->generation;
+	lua_pop(lua, 1);
+	return visited;
+}
+// makes target deep-equal to source, writing only the fields which differ and reusing target's tables
+static bool odLuaSnapshotCopier_restore_table(
+	odLuaSnapshotCopier* copier, lua_State* lua, int target_index, int source_index, int32_t depth) {
+	if (depth >= OD_LUA_BINDINGS_SNAPSHOT_MAX_DEPTH) {
+		copier->error = "max depth exceeded, table may be cyclic";
+		return false;
+	}
+
+	if (!lua_checkstack(lua, 6)) {
+		copier->error = "lua stack exhausted";
+		return false;
+	}
+
+	lua_pushvalue(lua, target_index);
+	lua_pushnumber(lua, copier->generation);
+	lua_rawset(lua, copier->visited_index);
+
+	lua_pushnil(lua);
+	while (lua_next(lua, source_index) != 0) {
+		int value_index = lua_gettop(lua);
+		int key_index = value_index - 1;
+
+		lua_pushvalue(lua, key_index);
+		lua_rawget(lua, target_index);
+		int target_value_index = lua_gettop(lua);
+
+		bool ok = true;
+		if (lua_istable(lua, value_index)) {
+			// tables aliased within target, or shared with source, are replaced by copies rather than restored
+			bool can_restore = lua_istable(lua, target_value_index)
+				&& !lua_rawequal(lua, target_value_index, value_index)
+				&& !odLuaSnapshotCopier_is_visited(copier, lua, target_value_index);
+			if (can_restore) {
+				ok = odLuaSnapshotCopier_restore_table(copier, lua, target_value_index, value_index, depth + 1);
+			} else {
+				lua_pushvalue(lua, key_index);
+				ok = odLuaSnapshotCopier_copy_table(copier, lua, value_index, depth + 1);
+				if (ok) {
+					lua_rawset(lua, target_index);
+				}
+			}
+		} else if (!lua_rawequal(lua, target_value_index, value_index)) {
+			lua_pushvalue(lua, key_index);
+			ok = odLuaSnapshotCopier_copy_value(copier, lua, value_index, depth + 1);
+			if (ok) {
+				lua_rawset(lua, target_index);
+			}
+		}
+
+		lua_settop(lua, key_index);
+		if (!ok) {
+			lua_pop(lua, 1);
+			return false;
+		}
+	}
+
+	// clearing existing fields during traversal is allowed by lua_next
+	lua_pushnil(lua);
+	while (lua_next(lua, target_index) != 0) {
+		lua_pop(lua, 1);
+		lua_pushvalue(lua, -1);
+		lua_rawget(lua, source_index);
+		bool is_removed = lua_isnil(lua, -1);
+		lua_pop(lua, 1);
+
+		if (is_removed) {
+			lua_pushvalue(lua, -1);
+			lua_pushnil(lua);
+			lua_rawset(lua, target_index);
+		}
+	}
+
+	return true;
+}
+
+static int odLuaBindings_odSnapshot_encode(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int value_index = 1;
+	luaL_checkany(lua, value_index);
+
+	const char* error = nullptr;
+	{
+		odLuaSnapshotWriter writer{nullptr, odTrivialArrayT<uint8_t>{}, nullptr};
+		if (odLuaSnapshotWriter_write_snapshot(&writer, lua, value_index)) {
+			lua_pushlstring(
+				lua, reinterpret_cast<const char*>(writer.buffer.begin()), static_cast<size_t>(writer.buffer.get_count()));
+			return 1;
+		}
+		error = writer.error;
+	}
+
+	// raised after writer is destroyed, as lua errors longjmp past destructors
+	return luaL_error(lua, "Snapshot.encode() failed: %s", error);
+}
+static int odLuaBindings_odSnapshot_decode(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int str_index = 1;
+	size_t size = 0;
+	const char* str = luaL_checklstring(lua, str_index, &size);
+	if (size > 0x7fffffff) {
+		return luaL_argerror(lua, str_index, "snapshot too large");
+	}
+
+	odLuaSnapshotReader reader{reinterpret_cast<const uint8_t*>(str), static_cast<int32_t>(size), 0, nullptr};
+	if (!odLuaSnapshotReader_read_snapshot(&reader, lua)) {
+		return luaL_error(lua, "Snapshot.decode() failed: %s", reader.error);
+	}
+
+	return 1;
+}
+static int odLuaBindings_odSnapshot_copy(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int value_index = 1;
+	luaL_checkany(lua, value_index);
+
+	odLuaSnapshotCopier copier{0, 0, nullptr};
+	if (!odLuaSnapshotCopier_copy_value(&copier, lua, value_index, 0)) {
+		return luaL_error(lua, "Snapshot.copy() failed: %s", copier.error);
+	}
+
+	return 1;
+}
+static int odLuaBindings_odSnapshot_restore(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int target_index = 1;
+	const int source_index = 2;
+	luaL_checktype(lua, target_index, LUA_TTABLE);
+	luaL_checktype(lua, source_index, LUA_TTABLE);
+	lua_settop(lua, source_index);
+
+	lua_getfield(lua, LUA_REGISTRYINDEX, OD_LUA_BINDINGS_SNAPSHOT_RESTORE_VISITED);
+	if (!lua_istable(lua, -1)) {
+		lua_pop(lua, 1);
+		lua_newtable(lua);
+		lua_createtable(lua, 0, 1);
+		lua_pushstring(lua, "k");
+		lua_setfield(lua, -2, "__mode");
+		lua_setmetatable(lua, -2);
+		lua_pushvalue(lua, -1);
+		lua_setfield(lua, LUA_REGISTRYINDEX, OD_LUA_BINDINGS_SNAPSHOT_RESTORE_VISITED);
+	}
+	int visited_index = lua_gettop(lua);
+
+	lua_rawgeti(lua, visited_index, 1);
+	lua_Number generation = lua_tonumber(lua, -1) + 1;
+	lua_pop(lua, 1);
+	lua_pushnumber(lua, generation);
+	lua_rawseti(lua, visited_index, 1);
+
+	odLuaSnapshotCopier copier{visited_index, generation, nullptr};
+	if (!odLuaSnapshotCopier_restore_table(&copier, lua, target_index, source_index, 0)) {
+		return luaL_error(lua, "Snapshot.restore() failed: %s", copier.error);
+	}
+
+	lua_pushvalue(lua, target_index);
+	return 1;
+}
+static int odLuaBindings_odSnapshot_save(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int filename_index = 1;
+	const int value_index = 2;
+	const char* filename = luaL_checkstring(lua, filename_index);
+	luaL_checkany(lua, value_index);
+
+	const char* error = nullptr;
+	{
+		odFile file;
+		if (!odFile_open(&file, "wb", filename)) {
+			lua_pushboolean(lua, false);
+			lua_pushfstring(lua, "Snapshot.save(%s) failed to open file for writing", filename);
+			return 2;
+		}
+
+		odLuaSnapshotWriter writer{&file, odTrivialArrayT<uint8_t>{}, nullptr};
+		if (!OD_CHECK(writer.buffer.set_capacity(OD_LUA_BINDINGS_SNAPSHOT_FLUSH_SIZE))) {
+			lua_pushboolean(lua, false);
+			lua_pushfstring(lua, "Snapshot.save(%s) failed to allocate write buffer", filename);
+			return 2;
+		}
+
+		if (odLuaSnapshotWriter_write_snapshot(&writer, lua, value_index)) {
+			lua_pushboolean(lua, true);
+			return 1;
+		}
+		error = writer.error;
+	}
+
+	return luaL_error(lua, "Snapshot.save(%s) failed: %s", filename, error);
+}
+static int odLuaBindings_odSnapshot_load(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int filename_index = 1;
+	const char* filename = luaL_checkstring(lua, filename_index);
+
+	const char* error = nullptr;
+	{
+		odAllocation allocation;
+		int32_t size = 0;
+		if (!odFile_read_all(filename, "rb", &allocation, &size)) {
+			lua_pushnil(lua);
+			lua_pushfstring(lua, "Snapshot.load(%s) failed to read file", filename);
+			return 2;
+		}
+
+		odLuaSnapshotReader reader{static_cast<const uint8_t*>(odAllocation_get_const(&allocation)), size, 0, nullptr};
+		if (odLuaSnapshotReader_read_snapshot(&reader, lua)) {
+			return 1;
+		}
+		error = reader.error;
+	}
+
+	return luaL_error(lua, "Snapshot.load(%s) failed: %s", filename, error);
+}
+bool odLuaBindings_odSnapshot_register(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return false;
+	}
+
+	if (!OD_CHECK(odLua_metatable_declare(lua, OD_LUA_BINDINGS_SNAPSHOT))
+		|| !OD_CHECK(odLua_metatable_set_string(lua, OD_LUA_BINDINGS_SNAPSHOT, "magic", OD_LUA_BINDINGS_SNAPSHOT_MAGIC))) {
+		return false;
+	}
+
+	auto add_method = [lua](const char* name, odLuaFn* fn) -> bool {
+		return odLua_metatable_set_function(lua, OD_LUA_BINDINGS_SNAPSHOT, name, fn);
+	};
+	if (!OD_CHECK(add_method("encode", odLuaBindings_odSnapshot_encode))
+		|| !OD_CHECK(add_method("decode", odLuaBindings_odSnapshot_decode))
+		|| !OD_CHECK(add_method("copy", odLuaBindings_odSnapshot_copy))
+		|| !OD_CHECK(add_method("restore", odLuaBindings_odSnapshot_restore))
+		|| !OD_CHECK(add_method("save", odLuaBindings_odSnapshot_save))
+		|| !OD_CHECK(add_method("load", odLuaBindings_odSnapshot_load))) {
+		return false;
+	}
+
+	return true;
+}
@@ -596,7 +596,10 @@ static int odLuaBindings_odVertexArray_init(lua_State* lua) {
 		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_VERTEX_ARRAY);
 	}
 
-	*vertex_array = odVertexArray{};
+	// capacity is kept, so arrays reinitialized every frame stop allocating once warmed up
+	if (!OD_CHECK(vertex_array->set_count(0))) {
+		return luaL_error(lua, "vertex_array->set_count(0) failed");
+	}
 
 	lua_getfield(lua, self_index, "add_vertices");
 	lua_pushvalue(lua, self_index);
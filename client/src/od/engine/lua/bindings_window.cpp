@@ -279,6 +279,24 @@ static bool odLuaBindings_odWindow_get_settings_impl(lua_State* lua, odWindowSet
 		settings->is_visible = static_cast<bool>(lua_toboolean(lua, OD_LUA_STACK_TOP));
 	}
 
+	lua_getfield(lua, settings_index, "headless");
+	if ((lua_type(lua, OD_LUA_STACK_TOP) != LUA_TNIL)) {
+		if (!OD_CHECK(lua_type(lua, OD_LUA_STACK_TOP) == LUA_TBOOLEAN)) {
+			return luaL_error(lua, "settings.headless must be a boolean or nil");
+		}
+
+		settings->is_headless = static_cast<bool>(lua_toboolean(lua, OD_LUA_STACK_TOP));
+	}
+
+	lua_getfield(lua, settings_index, "software_renderer");
+	if ((lua_type(lua, OD_LUA_STACK_TOP) != LUA_TNIL)) {
+		if (!OD_CHECK(lua_type(lua, OD_LUA_STACK_TOP) == LUA_TBOOLEAN)) {
+			return luaL_error(lua, "settings.software_renderer must be a boolean or nil");
+		}
+
+		settings->is_software_renderer_enabled = static_cast<bool>(lua_toboolean(lua, OD_LUA_STACK_TOP));
+	}
+
 	return true;
 }
 static int odLuaBindings_odWindow_init(lua_State* lua) {
@@ -416,6 +434,10 @@ static int odLuaBindings_odWindow_get_settings(lua_State* lua) {
 	lua_setfield(lua, settings_index, "vsync");
 	lua_pushboolean(lua, settings->is_visible);
 	lua_setfield(lua, settings_index, "visible");
+	lua_pushboolean(lua, settings->is_headless);
+	lua_setfield(lua, settings_index, "headless");
+	lua_pushboolean(lua, settings->is_software_renderer_enabled);
+	lua_setfield(lua, settings_index, "software_renderer");
 
 	lua_pushvalue(lua, settings_index);
 	return 1;
@@ -461,6 +483,7 @@ static int odLuaBindings_odWindow_get_key_state(lua_State* lua) {
 
 	const int self_index = 1;
 	const int key_name_index = 2;
+	const int opt_pressed_index = 3;
 
 	luaL_checktype(lua, self_index, LUA_TUSERDATA);
 	luaL_checktype(lua, key_name_index, LUA_TSTRING);
@@ -472,7 +495,159 @@ static int odLuaBindings_odWindow_get_key_state(lua_State* lua) {
 
 	const char* key_name = luaL_checkstring(lua, key_name_index);
 
-	lua_pushboolean(lua, odWindow_get_key_state(window, key_name));
+	// if opt_pressed is set, only presses since the last step count
+	const bool pressed = lua_toboolean(lua, opt_pressed_index);
+
+	int32_t key_handle = 0;
+	odWindowKeyState key_state{};
+	if (!odWindow_get_key_handle(window, key_name, &key_handle)
+		|| !odWindow_get_key_states(window, &key_handle, 1, &key_state)) {
+		return luaL_error(lua, "odWindow_get_key_states() failed, key_name=%s", key_name);
+	}
+
+	lua_pushboolean(lua, pressed ? key_state.is_pressed : key_state.is_down);
+	return 1;
+}
+static int odLuaBindings_odWindow_get_key_handle(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+	const int key_name_index = 2;
+
+	luaL_checktype(lua, self_index, LUA_TUSERDATA);
+	luaL_checktype(lua, key_name_index, LUA_TSTRING);
+
+	odWindow* window = static_cast<odWindow*>(odLua_get_userdata_typed(lua, self_index, OD_LUA_BINDINGS_WINDOW));
+	if (!OD_CHECK(odWindow_check_valid(window))) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_WINDOW);
+	}
+
+	const char* key_name = luaL_checkstring(lua, key_name_index);
+
+	int32_t key_handle = 0;
+	if (!odWindow_get_key_handle(window, key_name, &key_handle)) {
+		return luaL_error(lua, "odWindow_get_key_handle() failed, key_name=%s", key_name);
+	}
+
+	lua_pushnumber(lua, static_cast<lua_Number>(key_handle));
+	return 1;
+}
+/* Writes the state of every handle in key_handles into out_held[handle] (and opt_out_pressed[handle]),
+with one call per step rather than per key.  Keys pressed and released again since the last step
+count as held, so taps shorter than a step are not lost. */
+static int odLuaBindings_odWindow_get_key_states(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+	const int key_handles_index = 2;
+	const int out_held_index = 3;
+	const int opt_out_pressed_index = 4;
+
+	luaL_checktype(lua, self_index, LUA_TUSERDATA);
+	luaL_checktype(lua, key_handles_index, LUA_TTABLE);
+	luaL_checktype(lua, out_held_index, LUA_TTABLE);
+
+	const bool has_out_pressed = !lua_isnoneornil(lua, opt_out_pressed_index);
+	if (has_out_pressed) {
+		luaL_checktype(lua, opt_out_pressed_index, LUA_TTABLE);
+	}
+
+	odWindow* window = static_cast<odWindow*>(odLua_get_userdata_typed(lua, self_index, OD_LUA_BINDINGS_WINDOW));
+	if (!OD_CHECK(odWindow_check_valid(window))) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_WINDOW);
+	}
+
+	const int32_t key_handles_count = static_cast<int32_t>(lua_objlen(lua, key_handles_index));
+
+	const int32_t batch_capacity = 64;
+	int32_t key_handles[batch_capacity];
+	odWindowKeyState key_states[batch_capacity];
+	for (int32_t batch_begin = 0; batch_begin < key_handles_count; batch_begin += batch_capacity) {
+		int32_t batch_count = key_handles_count - batch_begin;
+		if (batch_count > batch_capacity) {
+			batch_count = batch_capacity;
+		}
+
+		for (int32_t i = 0; i < batch_count; i++) {
+			lua_rawgeti(lua, key_handles_index, batch_begin + i + 1);
+			key_handles[i] = static_cast<int32_t>(luaL_checknumber(lua, -1));
+			lua_pop(lua, 1);
+		}
+
+		if (!odWindow_get_key_states(window, key_handles, batch_count, key_states)) {
+			return luaL_error(lua, "odWindow_get_key_states() failed");
+		}
+
+		for (int32_t i = 0; i < batch_count; i++) {
+			lua_pushboolean(lua, key_states[i].is_down || key_states[i].is_pressed);
+			lua_rawseti(lua, out_held_index, key_handles[i]);
+
+			if (has_out_pressed) {
+				lua_pushboolean(lua, key_states[i].is_pressed);
+				lua_rawseti(lua, opt_out_pressed_index, key_handles[i]);
+			}
+		}
+	}
+
+	return 0;
+}
+static int odLuaBindings_odWindow_get_frame_stats(lua_State* lua) {
+	if (!OD_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+
+	luaL_checktype(lua, self_index, LUA_TUSERDATA);
+
+	odWindow* window = static_cast<odWindow*>(odLua_get_userdata_typed(lua, self_index, OD_LUA_BINDINGS_WINDOW));
+	if (!OD_CHECK(odWindow_check_valid(window))) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_WINDOW);
+	}
+
+	odWindowFrameStats stats{};
+	odWindow_get_frame_stats(window, &stats);
+
+	lua_newtable(lua);
+	const int stats_index = lua_gettop(lua);
+
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.frame_count));
+	lua_setfield(lua, stats_index, "frame_count");
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.missed_frame_count));
+	lua_setfield(lua, stats_index, "missed_frame_count");
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.last_frame_ms));
+	lua_setfield(lua, stats_index, "last_frame_ms");
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.mean_frame_ms));
+	lua_setfield(lua, stats_index, "mean_frame_ms");
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.p99_frame_ms));
+	lua_setfield(lua, stats_index, "p99_frame_ms");
+	lua_pushnumber(lua, static_cast<lua_Number>(stats.max_frame_ms));
+	lua_setfield(lua, stats_index, "max_frame_ms");
+
+	lua_pushvalue(lua, stats_index);
+	return 1;
+}
+static int odLuaBindings_odWindow_get_last_frame_ms(lua_State* lua) {
+	if (!OD_DEBUG_CHECK(lua != nullptr)) {
+		return 0;
+	}
+
+	const int self_index = 1;
+
+	if (OD_BUILD_DEBUG) {
+		luaL_checktype(lua, self_index, LUA_TUSERDATA);
+	}
+
+	odWindow* window = static_cast<odWindow*>(odLua_get_userdata_typed(lua, self_index, OD_LUA_BINDINGS_WINDOW));
+	if (!OD_DEBUG_CHECK(odWindow_check_valid(window))) {
+		return luaL_error(lua, "odLua_get_userdata_typed(%s) failed", OD_LUA_BINDINGS_WINDOW);
+	}
+
+	lua_pushnumber(lua, static_cast<lua_Number>(odWindow_get_last_frame_ms(window)));
 	return 1;
 }
 static int odLuaBindings_odWindow_get_key_names(lua_State* lua) {
@@ -532,7 +707,11 @@ bool odLuaBindings_odWindow_register(lua_State* lua) {
 		|| !OD_CHECK(add_method("get_settings", odLuaBindings_odWindow_get_settings))
 		|| !OD_CHECK(add_method("get_mouse_state", odLuaBindings_odWindow_get_mouse_state))
 		|| !OD_CHECK(add_method("get_key_state", odLuaBindings_odWindow_get_key_state))
-		|| !OD_CHECK(add_method("get_key_names", odLuaBindings_odWindow_get_key_names))) {
+		|| !OD_CHECK(add_method("get_key_handle", odLuaBindings_odWindow_get_key_handle))
+		|| !OD_CHECK(add_method("get_key_states", odLuaBindings_odWindow_get_key_states))
+		|| !OD_CHECK(add_method("get_key_names", odLuaBindings_odWindow_get_key_names))
+		|| !OD_CHECK(add_method("get_frame_stats", odLuaBindings_odWindow_get_frame_stats))
+		|| !OD_CHECK(add_method("get_last_frame_ms", odLuaBindings_odWindow_get_last_frame_ms))) {
 		return false;
 	}
 
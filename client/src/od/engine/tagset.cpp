@@ -2,12 +2,33 @@
 
 #include <cstdio>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // defined(__SSE2__)
+
 #include <od/core/debug.h>
 #include <od/core/math.h>
 
 static_assert(
 	OD_TAGSET_ELEMENT_SIZE == sizeof(odTagsetElement),
 	"tagset element size must match size of element type");
+static_assert(
+	(OD_TAGSET_BIT_SIZE == 64) || (OD_TAGSET_BIT_SIZE == 128) || (OD_TAGSET_BIT_SIZE == 256),
+	"tagset width must be 64, 128 or 256 bits");
+static_assert(
+	sizeof(odTagset) == OD_TAGSET_BYTE_SIZE,
+	"tagset must not be padded");
+
+// tagsets narrower than a 128-bit lane use scalar compares
+#if defined(__SSE2__) && ((OD_TAGSET_BYTE_SIZE % 16) == 0)
+#define OD_TAGSET_SIMD 1
+#define OD_TAGSET_LANE_COUNT (OD_TAGSET_BYTE_SIZE / 16)
+
+// unaligned loads, as tagsets may be embedded in memory with weaker alignment (e.g. lua userdata)
+static __m128i odTagset_load_lane(const odTagset* tagset, int32_t lane) {
+	return _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(tagset->tagset + (4 * lane))));
+}
+#endif  // defined(OD_TAGSET_SIMD)
 
 const char* odTagset_get_debug_string(const odTagset* tagset) {
 	if (tagset == nullptr) {
@@ -30,27 +51,27 @@ const char* odTagset_get_debug_string(const odTagset* tagset) {
 }
 void odTagset_set(odTagset *tagset, int32_t tag_id, bool enabled) {
 	if (!OD_DEBUG_CHECK(tagset != nullptr)
-		|| !OD_DEBUG_CHECK((tag_id >= 0) && (tag_id <= OD_TAG_ID_COUNT))) {
+		|| !OD_DEBUG_CHECK((tag_id >= 0) && (tag_id < OD_TAG_ID_COUNT))) {
 		return;
 	}
 
 	odTagsetElement element = static_cast<odTagsetElement>(tag_id / OD_TAGSET_ELEMENT_BIT_SIZE);
 	odTagsetElement bit = static_cast<odTagsetElement>(tag_id & (OD_TAGSET_ELEMENT_BIT_SIZE - 1));
-	odTagsetElement bit_mask = static_cast<odTagsetElement>(1 << bit);
-	uint8_t enabled_bit_mask = static_cast<uint8_t>(enabled << bit);
+	odTagsetElement bit_mask = static_cast<odTagsetElement>(1u << bit);
+	odTagsetElement enabled_bit_mask = enabled ? bit_mask : 0;
 
-	tagset->tagset[element] = (tagset->tagset[element] ^ bit_mask) | enabled_bit_mask;
+	tagset->tagset[element] = (tagset->tagset[element] & ~bit_mask) | enabled_bit_mask;
 }
 
 bool odTagset_get(const odTagset *tagset, int32_t required_tag_id) {
 	if (!OD_DEBUG_CHECK(tagset != nullptr)
-		|| !OD_DEBUG_CHECK((required_tag_id >= 0) && (required_tag_id <= OD_TAG_ID_COUNT))) {
+		|| !OD_DEBUG_CHECK((required_tag_id >= 0) && (required_tag_id < OD_TAG_ID_COUNT))) {
 		return false;
 	}
 
 	odTagsetElement element = static_cast<odTagsetElement>(required_tag_id / OD_TAGSET_ELEMENT_BIT_SIZE);
 	odTagsetElement bit = static_cast<odTagsetElement>(required_tag_id & (OD_TAGSET_ELEMENT_BIT_SIZE - 1));
-	odTagsetElement bit_mask = static_cast<odTagsetElement>(1 << bit);
+	odTagsetElement bit_mask = static_cast<odTagsetElement>(1u << bit);
 
 	return (tagset->tagset[element] & bit_mask) > 0;
 }
@@ -71,12 +92,23 @@ bool odTagset_intersects(const odTagset* tagset, const odTagset* required_tags)
 		return false;
 	}
 
-	bool intersects = true;
+#if defined(OD_TAGSET_SIMD)
+	__m128i matches = _mm_set1_epi32(-1);
+	for (int32_t i = 0; i < OD_TAGSET_LANE_COUNT; i++) {
+		__m128i required_lane = odTagset_load_lane(required_tags, i);
+		__m128i lane = _mm_and_si128(odTagset_load_lane(tagset, i), required_lane);
+		matches = _mm_and_si128(matches, _mm_cmpeq_epi32(lane, required_lane));
+	}
+
+	return _mm_movemask_epi8(matches) == 0xFFFF;
+#else
+	odTagsetElement missing = 0;
 	for (int32_t i = 0; i < OD_TAGSET_ELEMENT_COUNT; i++) {
-		intersects = intersects && ((tagset->tagset[i] & required_tags->tagset[i]) == required_tags->tagset[i]);
+		missing |= (required_tags->tagset[i] & ~tagset->tagset[i]);
 	}
 
-	return intersects;
+	return missing == 0;
+#endif  // defined(OD_TAGSET_SIMD)
 }
 bool odTagset_get_equals(const odTagset* a, const odTagset* b) {
 	if (!OD_DEBUG_CHECK(a != nullptr)
@@ -84,10 +116,19 @@ bool odTagset_get_equals(const odTagset* a, const odTagset* b) {
 		return false;
 	}
 
-	bool get_equals = true;
+#if defined(OD_TAGSET_SIMD)
+	__m128i matches = _mm_set1_epi32(-1);
+	for (int32_t i = 0; i < OD_TAGSET_LANE_COUNT; i++) {
+		matches = _mm_and_si128(matches, _mm_cmpeq_epi32(odTagset_load_lane(a, i), odTagset_load_lane(b, i)));
+	}
+
+	return _mm_movemask_epi8(matches) == 0xFFFF;
+#else
+	odTagsetElement differences = 0;
 	for (int32_t i = 0; i < OD_TAGSET_ELEMENT_COUNT; i++) {
-		get_equals = get_equals && (a->tagset[i] == b->tagset[i]);
+		differences |= (a->tagset[i] ^ b->tagset[i]);
 	}
 
-	return get_equals;
+	return differences == 0;
+#endif  // defined(OD_TAGSET_SIMD)
 }
@@ -4,6 +4,7 @@
 
 #include <od/core/debug.h>
 #include <od/core/color.h>
+#include <od/platform/profile.hpp>
 #include <od/platform/texture.hpp>
 #include <od/engine/atlas.hpp>
 
@@ -89,6 +90,8 @@ const odBounds* odTextureAtlas_get_region_bounds(const odTextureAtlas* atlas, od
 	return odAtlas_get_region_bounds(&atlas->atlas, region_id);
 }
 static bool odTextureAtlas_update_texture(odTextureAtlas* atlas) {
+	OD_PROFILE_SCOPE("odTextureAtlas_update_texture");
+
 	if (!OD_CHECK(odTextureAtlas_check_valid(atlas))) {
 		return false;
 	}
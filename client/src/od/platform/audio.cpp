@@ -1,22 +1,74 @@
 #include <od/platform/audio.hpp>
 
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#if !OD_BUILD_EMSCRIPTEN
+#include <thread>
+#endif
+
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
 
 #include <od/core/debug.h>
 #include <od/core/math.h>
 #include <od/core/allocation.hpp>
+#include <od/core/array.hpp>
 #include <od/platform/sdl.h>
 #include <od/platform/file.h>
 
 #define OD_AUDIO_PLAYBACK_CHANNEL_BITS 8
 #define OD_AUDIO_PLAYBACK_CHANNEL_MASK 0xFF
 #define OD_AUDIO_PLAYBACK_GENERATION_MASK 0xFF00
+#define OD_AUDIO_CACHE_INDEX_NONE -1
+#define OD_AUDIO_MIXER_INDEX_NONE -1
+#define OD_AUDIO_HASH_OFFSET_BASIS 14695981039346656037ull  // fnv-1a
+#define OD_AUDIO_HASH_PRIME 1099511628211ull
+
+static_assert(OD_AUDIO_MIXER_CHANNELS <= 64, "odAudio::playback_channels must have a bit per channel");
 
 struct odAudioMixer;
+struct odAudioCache;
 
 static void
-odAudioMixer_stop_audio_ptr(const odAudio* audio);
+odAudioMixer_stop_audio_ptr(odAudioMixer* mixer, const odAudio* audio);
+
+static uint64_t
+odAudio_hash(uint64_t hash, const void* data, int32_t size);
+static Mix_Chunk*
+odAudio_decode_wav(const void* src_wav, int32_t src_wav_size);
+static bool
+odAudio_init_cached(odAudio* audio, odAudioMixer* mixer, int32_t cache_index, Mix_Chunk* chunk);
+static void
+odAudio_release(odAudio* audio, odAudioMixer* mixer);
+
+static int32_t
+odAudioCache_find_filename(const odAudioCache* cache, uint64_t filename_hash);
+static int32_t
+odAudioCache_find_content(const odAudioCache* cache, uint64_t content_hash, int32_t content_size);
+static int32_t
+odAudioCache_acquire_filename(odAudioCache* cache, uint64_t filename_hash, Mix_Chunk** out_chunk);
+static Mix_Chunk*
+odAudioCache_acquire_index_locked(odAudioCache* cache, int32_t cache_index, uint64_t filename_hash);
+static int32_t
+odAudioCache_acquire_wav(
+	odAudioCache* cache, uint64_t filename_hash, const void* src_wav, int32_t src_wav_size,
+	Mix_Chunk** out_chunk, bool* out_is_hit);
+static int32_t
+odAudioCache_acquire_wav_file(
+	odAudioCache* cache, const char* filename, Mix_Chunk** out_chunk, bool* out_is_hit);
+static void
+odAudioCache_release_locked(odAudioCache* cache, int32_t cache_index);
+static void
+odAudioCache_release(odAudioCache* cache, int32_t cache_index);
+static void
+odAudioCache_count_lookup(odAudioCache* cache, bool is_hit);
+static bool
+odAudioCache_preload(odAudioCache* cache);
+static bool
+odAudioCache_join_preload(odAudioCache* cache);
+static void
+odAudioCache_destroy(odAudioCache* cache);
 
 static odAudioPlaybackId
 odAudioPlaybackId_init(uint8_t channel, uint16_t generation);
@@ -25,9 +77,37 @@ odAudioPlaybackId_get_channel(odAudioPlaybackId playback_id);
 static uint16_t
 odAudioPlaybackId_get_generation(odAudioPlaybackId playback_id);
 
+struct odAudioCacheEntry {
+	uint64_t filename_hash;  // 0 if only loaded from memory
+	uint64_t content_hash;
+	int32_t content_size;
+	int32_t ref_count;
+	Mix_Chunk* chunk;  // nullptr if the entry is free for reuse
+	bool is_preloaded;  // holds a reference until odAudioCache_release_preloaded()
+};
+struct odAudioCache {
+	std::mutex mutex;  // guards entries, which the preload thread adds to
+	odTrivialArrayT<odAudioCacheEntry> entries;
+	std::atomic<int32_t> lookup_count;
+	std::atomic<int32_t> hit_count;
+
+	odTrivialArrayT<char> preload_filenames;  // nul-separated
+	int32_t preload_filenames_count;
+	bool is_preload_ok;
+	std::atomic<bool> is_preloading;
+#if !OD_BUILD_EMSCRIPTEN
+	std::thread preload_thread;
+#endif
+};
+
 struct odAudioMixer {
 	bool is_mixer_init;
 	uint16_t channel_generation[OD_AUDIO_MIXER_CHANNELS];
+	uint32_t channel_owner_id[OD_AUDIO_MIXER_CHANNELS];
+	float channel_settings_volume[OD_AUDIO_MIXER_CHANNELS];  // playback volume, before odAudio::volume
+	uint32_t next_owner_id;
+	odTrivialArrayT<odAudio*> audios;  // released before the cache frees their chunks
+	odAudioCache cache;
 
 	OD_PLATFORM_MODULE odAudioMixer();
 	OD_PLATFORM_MODULE ~odAudioMixer();
@@ -108,28 +188,17 @@ bool odAudio_init_wav(odAudio* audio, const void* src_wav, int32_t src_wav_size)
 
 	odAudio_destroy(audio);
 
-	SDL_RWops* wav_rw = SDL_RWFromMem(const_cast<void*>(src_wav), static_cast<int>(src_wav_size));
-	if (!OD_CHECK(wav_rw != nullptr)) {
-		OD_ERROR("SDL_RWFromMem failed, error=%s", SDL_GetError());
-		return false;
-	}
-
-	audio->audio_native = static_cast<void*>(Mix_LoadWAV_RW(wav_rw, /*freesrc*/ 0));
-	if (!OD_CHECK(audio->audio_native != nullptr)) {
-		OD_ERROR("Mix_LoadWAV_RW failed, error=%s", Mix_GetError());
-
-		if (!OD_CHECK(SDL_RWclose(wav_rw) == 0)) {
-			OD_ERROR("SDL_RWclose failed, error=%s", SDL_GetError());
-		}
-
-		return false;
-	}
-	if (!OD_CHECK(SDL_RWclose(wav_rw) == 0)) {
-		OD_ERROR("SDL_RWclose failed, error=%s", SDL_GetError());
+	odAudioMixer* mixer = odAudioMixer_get_singleton();
+	Mix_Chunk* chunk = nullptr;
+	bool is_hit = false;
+	int32_t cache_index = odAudioCache_acquire_wav(
+		&mixer->cache, /*filename_hash*/ 0, src_wav, src_wav_size, &chunk, &is_hit);
+	if (!OD_CHECK(cache_index != OD_AUDIO_CACHE_INDEX_NONE)) {
 		return false;
 	}
+	odAudioCache_count_lookup(&mixer->cache, is_hit);
 
-	return true;
+	return odAudio_init_cached(audio, mixer, cache_index, chunk);
 }
 bool odAudio_init_wav_file(odAudio* audio, const char* filename) {
 	if (!OD_CHECK(audio != nullptr)
@@ -138,23 +207,43 @@ bool odAudio_init_wav_file(odAudio* audio, const char* filename) {
 		return false;
 	}
 
+	odAudio_destroy(audio);
 
-	odAllocation allocation{};
-	int32_t file_size = 0;
-	if (!OD_CHECK(odFile_read_all(filename, "rb", &allocation, &file_size))) {
+	odAudioMixer* mixer = odAudioMixer_get_singleton();
+	Mix_Chunk* chunk = nullptr;
+	bool is_hit = false;
+	int32_t cache_index = odAudioCache_acquire_wav_file(&mixer->cache, filename, &chunk, &is_hit);
+	if (!OD_CHECK(cache_index != OD_AUDIO_CACHE_INDEX_NONE)) {
 		return false;
 	}
+	odAudioCache_count_lookup(&mixer->cache, is_hit);
 
-	void* file_data = odAllocation_get(&allocation);
-	if (!OD_CHECK(file_data != nullptr)
-		|| !OD_CHECK(file_size > 0)) {
+	return odAudio_init_cached(audio, mixer, cache_index, chunk);
+}
+bool odAudio_init_cached(odAudio* audio, odAudioMixer* mixer, int32_t cache_index, Mix_Chunk* chunk) {
+	if (!OD_DEBUG_CHECK(audio != nullptr)
+		|| !OD_DEBUG_CHECK(mixer != nullptr)
+		|| !OD_DEBUG_CHECK(chunk != nullptr)) {
 		return false;
 	}
 
-	if (!OD_CHECK(odAudio_init_wav(audio, file_data, file_size))) {
+	int32_t mixer_index = mixer->audios.get_count();
+	if (!OD_CHECK(mixer->audios.push(audio))) {
+		odAudioCache_release(&mixer->cache, cache_index);
 		return false;
 	}
 
+	mixer->next_owner_id++;
+	if (mixer->next_owner_id == 0) {
+		mixer->next_owner_id++;  // 0 = unowned channel
+	}
+
+	audio->audio_native = static_cast<void*>(chunk);
+	audio->cache_index = cache_index;
+	audio->mixer_index = mixer_index;
+	audio->owner_id = mixer->next_owner_id;
+	audio->playback_channels = 0;
+	audio->volume = 1.0f;
 	return true;
 }
 void odAudio_destroy(odAudio* audio) {
@@ -163,11 +252,17 @@ void odAudio_destroy(odAudio* audio) {
 	}
 
 	if (audio->audio_native != nullptr) {
-		odAudioMixer_stop_audio_ptr(audio);
-
-		Mix_FreeChunk(static_cast<Mix_Chunk*>(audio->audio_native));
+		odAudioMixer* mixer = odAudioMixer_get_singleton();
+		if (OD_CHECK(odAudioMixer_check_valid(mixer))) {
+			odAudio_release(audio, mixer);
+		}
 	}
 	audio->audio_native = nullptr;
+	audio->cache_index = OD_AUDIO_CACHE_INDEX_NONE;
+	audio->mixer_index = OD_AUDIO_MIXER_INDEX_NONE;
+	audio->owner_id = 0;
+	audio->playback_channels = 0;
+	audio->volume = 1.0f;
 }
 void odAudio_swap(odAudio* audio1, odAudio* audio2) {
 	if (!OD_CHECK(audio1 != nullptr)
@@ -176,8 +271,66 @@ void odAudio_swap(odAudio* audio1, odAudio* audio2) {
 	}
 
 	void* audio_native_swap = audio1->audio_native;
+	int32_t cache_index_swap = audio1->cache_index;
+	int32_t mixer_index_swap = audio1->mixer_index;
+	uint32_t owner_id_swap = audio1->owner_id;
+	uint64_t playback_channels_swap = audio1->playback_channels;
+	float volume_swap = audio1->volume;
+
 	audio1->audio_native = audio2->audio_native;
+	audio1->cache_index = audio2->cache_index;
+	audio1->mixer_index = audio2->mixer_index;
+	audio1->owner_id = audio2->owner_id;
+	audio1->playback_channels = audio2->playback_channels;
+	audio1->volume = audio2->volume;
+
 	audio2->audio_native = audio_native_swap;
+	audio2->cache_index = cache_index_swap;
+	audio2->mixer_index = mixer_index_swap;
+	audio2->owner_id = owner_id_swap;
+	audio2->playback_channels = playback_channels_swap;
+	audio2->volume = volume_swap;
+
+	// registrations follow their contents to the other address
+	if ((audio1->audio_native == nullptr) && (audio2->audio_native == nullptr)) {
+		return;
+	}
+
+	odAudioMixer* mixer = odAudioMixer_get_singleton();
+	if (!OD_CHECK(odAudioMixer_check_valid(mixer))) {
+		return;
+	}
+
+	if (audio1->audio_native != nullptr) {
+		*mixer->audios.get(audio1->mixer_index) = audio1;
+	}
+	if (audio2->audio_native != nullptr) {
+		*mixer->audios.get(audio2->mixer_index) = audio2;
+	}
+}
+void odAudio_release(odAudio* audio, odAudioMixer* mixer) {
+	if (!OD_DEBUG_CHECK(audio != nullptr)
+		|| !OD_DEBUG_CHECK(mixer != nullptr)
+		|| !OD_DEBUG_CHECK(audio->audio_native != nullptr)) {
+		return;
+	}
+
+	odAudioMixer_stop_audio_ptr(mixer, audio);
+	odAudioCache_release(&mixer->cache, audio->cache_index);
+
+	int32_t mixer_index = audio->mixer_index;
+	if (OD_DEBUG_CHECK(*mixer->audios.get(mixer_index) == audio)
+		&& OD_CHECK(mixer->audios.swap_pop(mixer_index))
+		&& (mixer_index < mixer->audios.get_count())) {
+		(*mixer->audios.get(mixer_index))->mixer_index = mixer_index;
+	}
+
+	audio->audio_native = nullptr;
+	audio->cache_index = OD_AUDIO_CACHE_INDEX_NONE;
+	audio->mixer_index = OD_AUDIO_MIXER_INDEX_NONE;
+	audio->owner_id = 0;
+	audio->playback_channels = 0;
+	audio->volume = 1.0f;
 }
 bool odAudio_check_valid(const odAudio* audio) {
 	if (!OD_CHECK(audio != nullptr)
@@ -198,9 +351,18 @@ bool odAudio_set_volume(odAudio* audio, float volume) {
 		return false;
 	}
 
-	Mix_VolumeChunk(
-		static_cast<Mix_Chunk*>(audio->audio_native),
-		static_cast<int>(volume * static_cast<float>(MIX_MAX_VOLUME)));
+	// the chunk may be shared, so volume is applied per channel, including to channels already playing
+	audio->volume = volume;
+
+	uint64_t channels = audio->playback_channels;
+	for (int32_t i = 0; (i < OD_AUDIO_MIXER_CHANNELS) && (channels != 0); i++, channels >>= 1) {
+		if (((channels & 1) != 0) && (mixer->channel_owner_id[i] == audio->owner_id)) {
+			Mix_Volume(
+				i,
+				static_cast<int>(mixer->channel_settings_volume[i] * volume * static_cast<float>(MIX_MAX_VOLUME)));
+		}
+	}
+
 	return true;
 }
 odAudioPlaybackId odAudio_play(odAudio* audio, const odAudioPlaybackSettings* opt_settings) {
@@ -231,31 +393,40 @@ odAudioPlaybackId odAudio_play(odAudio* audio, const odAudioPlaybackSettings* op
 
 	int fadein_time_ms = static_cast<int>(settings.fadein_time_ms);
 
+	int channel = Mix_GroupAvailable(/*tag*/ -1);  // -1 = first unused channel
+	if (!OD_CHECK(channel >= 0)) {
+		OD_WARN("Mix_GroupAvailable() found no free channel, audio not played");
+		return OD_AUDIO_PLAYBACK_ID_NO_CHANNELS;
+	}
+	if (!OD_CHECK(channel < OD_AUDIO_MIXER_CHANNELS)) {
+		OD_ERROR("Mix_GroupAvailable() returned channel >= OD_AUDIO_MIXER_CHANNELS");
+		return 0;
+	}
+
 	Mix_Volume(
-		-1,
-		static_cast<int>(settings.volume * static_cast<float>(MIX_MAX_VOLUME)));
+		channel,
+		static_cast<int>(settings.volume * audio->volume * static_cast<float>(MIX_MAX_VOLUME)));
 
-	int channel = Mix_FadeInChannelTimed(
-		/*channel*/ -1,  // -1 = first unused channel
+	int played_channel = Mix_FadeInChannelTimed(
+		channel,
 		static_cast<Mix_Chunk*>(audio->audio_native),
 		loop_count,
 		fadein_time_ms,
 		cutoff_time_ms
 	);
-	if (!OD_CHECK(channel >= 0)) {
+	if (!OD_CHECK(played_channel == channel)) {
 		OD_WARN("Mix_FadeInChannelTimed() failed, audio not played, error=%s", Mix_GetError());
 		return OD_AUDIO_PLAYBACK_ID_NO_CHANNELS;
 	}
-	if (!OD_CHECK(channel < OD_AUDIO_MIXER_CHANNELS)) {
-		OD_ERROR("Mix_FadeInChannelTimed() returned channel >= OD_AUDIO_MIXER_CHANNELS");
-		Mix_HaltChannel(channel);
-		return 0;
-	}
 	if (!OD_CHECK(Mix_Playing(channel) == 1)) {
 		OD_ERROR("Mix_FadeInChannelTimed() failed, error=%s", Mix_GetError());
 		return 0;
 	}
 
+	mixer->channel_owner_id[channel] = audio->owner_id;
+	mixer->channel_settings_volume[channel] = settings.volume;
+	audio->playback_channels |= (uint64_t{1} << channel);
+
 	mixer->channel_generation[channel]++;
 	uint16_t generation = mixer->channel_generation[channel];
 
@@ -322,8 +493,354 @@ bool odAudio_is_playing(odAudioPlaybackId playback_id) {
 	return true;
 }
 
+uint64_t odAudio_hash(uint64_t hash, const void* data, int32_t size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (int32_t i = 0; i < size; i++) {
+		hash = (hash ^ bytes[i]) * OD_AUDIO_HASH_PRIME;
+	}
+	return hash;
+}
+Mix_Chunk* odAudio_decode_wav(const void* src_wav, int32_t src_wav_size) {
+	if (!OD_CHECK(src_wav != nullptr)
+		|| !OD_CHECK(src_wav_size > 0)) {
+		return nullptr;
+	}
+
+	SDL_RWops* wav_rw = SDL_RWFromMem(const_cast<void*>(src_wav), static_cast<int>(src_wav_size));
+	if (!OD_CHECK(wav_rw != nullptr)) {
+		OD_ERROR("SDL_RWFromMem failed, error=%s", SDL_GetError());
+		return nullptr;
+	}
+
+	Mix_Chunk* chunk = Mix_LoadWAV_RW(wav_rw, /*freesrc*/ 0);
+	if (!OD_CHECK(chunk != nullptr)) {
+		OD_ERROR("Mix_LoadWAV_RW failed, error=%s", Mix_GetError());
+
+		if (!OD_CHECK(SDL_RWclose(wav_rw) == 0)) {
+			OD_ERROR("SDL_RWclose failed, error=%s", SDL_GetError());
+		}
+
+		return nullptr;
+	}
+	if (!OD_CHECK(SDL_RWclose(wav_rw) == 0)) {
+		OD_ERROR("SDL_RWclose failed, error=%s", SDL_GetError());
+		Mix_FreeChunk(chunk);
+		return nullptr;
+	}
+
+	return chunk;
+}
+
+int32_t odAudioCache_find_filename(const odAudioCache* cache, uint64_t filename_hash) {
+	for (int32_t i = 0; i < cache->entries.get_count(); i++) {
+		const odAudioCacheEntry* entry = cache->entries.get(i);
+		if ((entry->chunk != nullptr) && (entry->filename_hash == filename_hash)) {
+			return i;
+		}
+	}
+
+	return OD_AUDIO_CACHE_INDEX_NONE;
+}
+int32_t odAudioCache_find_content(const odAudioCache* cache, uint64_t content_hash, int32_t content_size) {
+	for (int32_t i = 0; i < cache->entries.get_count(); i++) {
+		const odAudioCacheEntry* entry = cache->entries.get(i);
+		if ((entry->chunk != nullptr)
+			&& (entry->content_hash == content_hash)
+			&& (entry->content_size == content_size)) {
+			return i;
+		}
+	}
+
+	return OD_AUDIO_CACHE_INDEX_NONE;
+}
+int32_t odAudioCache_acquire_filename(odAudioCache* cache, uint64_t filename_hash, Mix_Chunk** out_chunk) {
+	std::lock_guard<std::mutex> lock{cache->mutex};
+
+	int32_t cache_index = odAudioCache_find_filename(cache, filename_hash);
+	if (cache_index == OD_AUDIO_CACHE_INDEX_NONE) {
+		return OD_AUDIO_CACHE_INDEX_NONE;
+	}
+
+	*out_chunk = odAudioCache_acquire_index_locked(cache, cache_index, filename_hash);
+	return cache_index;
+}
+Mix_Chunk* odAudioCache_acquire_index_locked(odAudioCache* cache, int32_t cache_index, uint64_t filename_hash) {
+	odAudioCacheEntry* entry = cache->entries.get(cache_index);
+	entry->ref_count++;
+	if (entry->filename_hash == 0) {
+		entry->filename_hash = filename_hash;
+	}
+	return entry->chunk;
+}
+int32_t odAudioCache_acquire_wav(
+	odAudioCache* cache, uint64_t filename_hash, const void* src_wav, int32_t src_wav_size,
+	Mix_Chunk** out_chunk, bool* out_is_hit) {
+	if (!OD_DEBUG_CHECK(cache != nullptr)
+		|| !OD_CHECK(src_wav != nullptr)
+		|| !OD_CHECK(src_wav_size > 0)
+		|| !OD_DEBUG_CHECK(out_chunk != nullptr)
+		|| !OD_DEBUG_CHECK(out_is_hit != nullptr)) {
+		return OD_AUDIO_CACHE_INDEX_NONE;
+	}
+
+	uint64_t content_hash = odAudio_hash(OD_AUDIO_HASH_OFFSET_BASIS, src_wav, src_wav_size);
+
+	{
+		std::lock_guard<std::mutex> lock{cache->mutex};
+		int32_t cache_index = odAudioCache_find_content(cache, content_hash, src_wav_size);
+		if (cache_index != OD_AUDIO_CACHE_INDEX_NONE) {
+			*out_chunk = odAudioCache_acquire_index_locked(cache, cache_index, filename_hash);
+			*out_is_hit = true;
+			return cache_index;
+		}
+	}
+
+	// decoding is slow so happens unlocked; if a preload decoded the same audio meanwhile, its copy wins
+	Mix_Chunk* chunk = odAudio_decode_wav(src_wav, src_wav_size);
+	if (!OD_CHECK(chunk != nullptr)) {
+		return OD_AUDIO_CACHE_INDEX_NONE;
+	}
+	*out_is_hit = false;
+
+	std::lock_guard<std::mutex> lock{cache->mutex};
+	int32_t cache_index = odAudioCache_find_content(cache, content_hash, src_wav_size);
+	if (cache_index != OD_AUDIO_CACHE_INDEX_NONE) {
+		Mix_FreeChunk(chunk);
+		*out_chunk = odAudioCache_acquire_index_locked(cache, cache_index, filename_hash);
+		return cache_index;
+	}
+
+	for (cache_index = 0; cache_index < cache->entries.get_count(); cache_index++) {
+		if (cache->entries.get(cache_index)->chunk == nullptr) {
+			break;
+		}
+	}
+	if (!OD_CHECK(cache->entries.ensure_count(cache_index + 1))) {
+		Mix_FreeChunk(chunk);
+		return OD_AUDIO_CACHE_INDEX_NONE;
+	}
+
+	*cache->entries.get(cache_index) = odAudioCacheEntry{filename_hash, content_hash, src_wav_size, 0, chunk, false};
+	*out_chunk = odAudioCache_acquire_index_locked(cache, cache_index, filename_hash);
+	return cache_index;
+}
+int32_t odAudioCache_acquire_wav_file(
+	odAudioCache* cache, const char* filename, Mix_Chunk** out_chunk, bool* out_is_hit) {
+	if (!OD_DEBUG_CHECK(cache != nullptr)
+		|| !OD_CHECK(filename != nullptr)
+		|| !OD_DEBUG_CHECK(out_chunk != nullptr)
+		|| !OD_DEBUG_CHECK(out_is_hit != nullptr)) {
+		return OD_AUDIO_CACHE_INDEX_NONE;
+	}
+
+	uint64_t filename_hash = odAudio_hash(
+		OD_AUDIO_HASH_OFFSET_BASIS, filename, static_cast<int32_t>(strlen(filename)));
+	if (filename_hash == 0) {
+		filename_hash = 1;  // 0 = no filename
+	}
+
+	int32_t cache_index = odAudioCache_acquire_filename(cache, filename_hash, out_chunk);
+	if (cache_index != OD_AUDIO_CACHE_INDEX_NONE) {
+		*out_is_hit = true;
+		return cache_index;
+	}
+
+	odAllocation allocation{};
+	int32_t file_size = 0;
+	if (!OD_CHECK(odFile_read_all(filename, "rb", &allocation, &file_size))) {
+		return OD_AUDIO_CACHE_INDEX_NONE;
+	}
+
+	const void* file_data = odAllocation_get(&allocation);
+	if (!OD_CHECK(file_data != nullptr)
+		|| !OD_CHECK(file_size > 0)) {
+		return OD_AUDIO_CACHE_INDEX_NONE;
+	}
+
+	return odAudioCache_acquire_wav(cache, filename_hash, file_data, file_size, out_chunk, out_is_hit);
+}
+void odAudioCache_release_locked(odAudioCache* cache, int32_t cache_index) {
+	odAudioCacheEntry* entry = cache->entries.get(cache_index);
+	if (!OD_CHECK(entry != nullptr)
+		|| !OD_CHECK(entry->chunk != nullptr)
+		|| !OD_CHECK(entry->ref_count > 0)) {
+		return;
+	}
+
+	entry->ref_count--;
+	if (entry->ref_count > 0) {
+		return;
+	}
+
+	Mix_FreeChunk(entry->chunk);
+	*entry = odAudioCacheEntry{};
+}
+void odAudioCache_release(odAudioCache* cache, int32_t cache_index) {
+	if (!OD_DEBUG_CHECK(cache != nullptr)) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock{cache->mutex};
+	odAudioCache_release_locked(cache, cache_index);
+}
+void odAudioCache_count_lookup(odAudioCache* cache, bool is_hit) {
+	cache->lookup_count.fetch_add(1, std::memory_order_relaxed);
+	if (is_hit) {
+		cache->hit_count.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+bool odAudioCache_preload(odAudioCache* cache) {
+	bool is_ok = true;
+	const char* filename = cache->preload_filenames.begin();
+	for (int32_t i = 0; i < cache->preload_filenames_count; i++, filename += strlen(filename) + 1) {
+		Mix_Chunk* chunk = nullptr;
+		bool is_hit = false;
+		int32_t cache_index = odAudioCache_acquire_wav_file(cache, filename, &chunk, &is_hit);
+		if (!OD_CHECK(cache_index != OD_AUDIO_CACHE_INDEX_NONE)) {
+			OD_ERROR("Failed to preload audio, filename=%s", filename);
+			is_ok = false;
+			continue;
+		}
+
+		std::lock_guard<std::mutex> lock{cache->mutex};
+		odAudioCacheEntry* entry = cache->entries.get(cache_index);
+		if (entry->is_preloaded) {
+			odAudioCache_release_locked(cache, cache_index);  // already held by an earlier preload
+		} else {
+			entry->is_preloaded = true;
+		}
+	}
+
+	cache->is_preloading.store(false, std::memory_order_release);
+	return is_ok;
+}
+bool odAudioCache_join_preload(odAudioCache* cache) {
+#if !OD_BUILD_EMSCRIPTEN
+	if (cache->preload_thread.joinable()) {
+		cache->preload_thread.join();
+	}
+#endif
+
+	return cache->is_preload_ok;
+}
+void odAudioCache_destroy(odAudioCache* cache) {
+	OD_DISCARD(odAudioCache_join_preload(cache));
+
+	std::lock_guard<std::mutex> lock{cache->mutex};
+	for (odAudioCacheEntry& entry : cache->entries) {
+		if (entry.chunk != nullptr) {
+			Mix_FreeChunk(entry.chunk);
+		}
+		entry = odAudioCacheEntry{};
+	}
+}
+
+bool odAudioCache_preload_files(const char* const* filenames, int32_t filenames_count, bool background) {
+	if (!OD_CHECK((filenames != nullptr) || (filenames_count == 0))
+		|| !OD_CHECK(filenames_count >= 0)) {
+		return false;
+	}
+
+	odAudioMixer* mixer = odAudioMixer_get_singleton();
+	if (!OD_CHECK(odAudioMixer_check_valid(mixer))) {
+		return false;
+	}
+
+	odAudioCache* cache = &mixer->cache;
+	OD_DISCARD(odAudioCache_join_preload(cache));
+
+	if (!OD_CHECK(cache->preload_filenames.set_count(0))) {
+		return false;
+	}
+	for (int32_t i = 0; i < filenames_count; i++) {
+		if (!OD_CHECK(filenames[i] != nullptr)
+			|| !OD_CHECK(cache->preload_filenames.extend(filenames[i], static_cast<int32_t>(strlen(filenames[i])) + 1))) {
+			return false;
+		}
+	}
+	cache->preload_filenames_count = filenames_count;
+	cache->is_preloading.store(true, std::memory_order_release);
+
+#if !OD_BUILD_EMSCRIPTEN
+	// Mix_LoadWAV_RW only reads the opened device's format, so is safe to call off the main thread
+	if (background) {
+		cache->preload_thread = std::thread{[cache]() {
+			cache->is_preload_ok = odAudioCache_preload(cache);
+		}};
+		return true;
+	}
+#else
+	OD_MAYBE_UNUSED(background);
+#endif
+
+	cache->is_preload_ok = odAudioCache_preload(cache);
+	return cache->is_preload_ok;
+}
+bool odAudioCache_get_preloading(void) {
+	odAudioMixer* mixer = odAudioMixer_get_singleton();
+	if (!OD_CHECK(odAudioMixer_check_valid(mixer))) {
+		return false;
+	}
+
+	return mixer->cache.is_preloading.load(std::memory_order_acquire);
+}
+bool odAudioCache_wait_preload(void) {
+	odAudioMixer* mixer = odAudioMixer_get_singleton();
+	if (!OD_CHECK(odAudioMixer_check_valid(mixer))) {
+		return false;
+	}
+
+	return odAudioCache_join_preload(&mixer->cache);
+}
+void odAudioCache_release_preloaded(void) {
+	odAudioMixer* mixer = odAudioMixer_get_singleton();
+	if (!OD_CHECK(odAudioMixer_check_valid(mixer))) {
+		return;
+	}
+
+	odAudioCache* cache = &mixer->cache;
+	OD_DISCARD(odAudioCache_join_preload(cache));
+
+	std::lock_guard<std::mutex> lock{cache->mutex};
+	for (int32_t i = 0; i < cache->entries.get_count(); i++) {
+		odAudioCacheEntry* entry = cache->entries.get(i);
+		if (entry->is_preloaded) {
+			entry->is_preloaded = false;
+			odAudioCache_release_locked(cache, i);
+		}
+	}
+}
+bool odAudioCache_get_stats(odAudioCacheStats* out_stats) {
+	if (!OD_CHECK(out_stats != nullptr)) {
+		return false;
+	}
+
+	odAudioMixer* mixer = odAudioMixer_get_singleton();
+	if (!OD_CHECK(odAudioMixer_check_valid(mixer))) {
+		return false;
+	}
+
+	odAudioCache* cache = &mixer->cache;
+	*out_stats = odAudioCacheStats{};
+	out_stats->lookup_count = cache->lookup_count.load(std::memory_order_relaxed);
+	out_stats->hit_count = cache->hit_count.load(std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock{cache->mutex};
+	for (const odAudioCacheEntry& entry : cache->entries) {
+		if (entry.chunk == nullptr) {
+			continue;
+		}
+
+		out_stats->entry_count++;
+		out_stats->preloaded_count += entry.is_preloaded ? 1 : 0;
+		out_stats->decoded_bytes += static_cast<int64_t>(entry.chunk->alen);
+	}
+
+	return true;
+}
+
 odAudio::odAudio()
-: audio_native{nullptr} {
+: audio_native{nullptr}, cache_index{OD_AUDIO_CACHE_INDEX_NONE}, mixer_index{OD_AUDIO_MIXER_INDEX_NONE}, owner_id{0}, playback_channels{0}, volume{1.0f} {
 }
 odAudio::odAudio(odAudio&& other)
 : odAudio{} {
@@ -354,34 +871,40 @@ bool odAudioMixer_check_valid(const odAudioMixer* mixer) {
 
 	return true;
 }
-void odAudioMixer_stop_audio_ptr(const odAudio* audio) {
-	if (!OD_CHECK(audio != nullptr)) {
+void odAudioMixer_stop_audio_ptr(odAudioMixer* mixer, const odAudio* audio) {
+	if (!OD_DEBUG_CHECK(mixer != nullptr)
+		|| !OD_DEBUG_CHECK(audio != nullptr)) {
 		return;
 	}
 
-	odAudioMixer* mixer = odAudioMixer_get_singleton();
-	if (!OD_CHECK(odAudioMixer_check_valid(mixer))) {
-		return;
-	}
-
-	for (int32_t i = 0; i < OD_AUDIO_MIXER_CHANNELS; i++) {
-		if (Mix_GetChunk(static_cast<int>(i)) == static_cast<const Mix_Chunk*>(audio->audio_native)) {
+	// other audio may share the chunk, so only channels this audio still owns are halted
+	uint64_t channels = audio->playback_channels;
+	for (int32_t i = 0; (i < OD_AUDIO_MIXER_CHANNELS) && (channels != 0); i++, channels >>= 1) {
+		if (((channels & 1) != 0) && (mixer->channel_owner_id[i] == audio->owner_id)) {
 			Mix_HaltChannel(i);
+			mixer->channel_owner_id[i] = 0;
 		}
 	}
 }
 odAudioMixer::odAudioMixer()
-: is_mixer_init{false}, channel_generation{} {
+: is_mixer_init{false}, channel_generation{}, channel_owner_id{}, channel_settings_volume{}, next_owner_id{0}, audios{}, cache{} {
 	if (!is_mixer_init) {
 		if (!OD_CHECK(odSDLMixer_init_reentrant())) {
 			return;
 		}
 	}
 	is_mixer_init = true;
+	cache.is_preload_ok = true;
 
 	Mix_AllocateChannels(OD_AUDIO_MIXER_CHANNELS);
 }
 odAudioMixer::~odAudioMixer() {
+	// audio that outlives the mixer is released first, so no odAudio points into a freed chunk
+	for (int32_t i = audios.get_count() - 1; i >= 0; i--) {
+		odAudio_release(*audios.get(i), this);
+	}
+	odAudioCache_destroy(&cache);
+
 	if (is_mixer_init) {
 		odSDLMixer_destroy_reentrant();
 	}
@@ -198,7 +198,7 @@ bool odFile_read_all(
 		return false;
 	}
 
-	if (!OD_CHECK(odAllocation_init(out_allocation, file_size))) {
+	if (!OD_CHECK(odAllocation_init_category(out_allocation, file_size, OD_ALLOCATION_CATEGORY_FILE))) {
 		return false;
 	}
 
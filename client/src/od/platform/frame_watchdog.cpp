@@ -0,0 +1,278 @@
+#include <od/platform/frame_watchdog.h>
+
+#include <cstring>
+
+#include <od/core/debug.h>
+#include <od/core/allocation.h>
+#include <od/core/string.hpp>
+#include <od/platform/file.h>
+#include <od/platform/profile.h>
+#include <od/platform/renderer.h>
+#include <od/platform/timer.h>
+
+struct odFrameWatchdogZone {
+	int32_t zone_id;
+	odProfileZoneStats stats;
+};
+struct odFrameWatchdogFrame {
+	int32_t index;
+	int64_t duration_ns;
+	int64_t draw_count;
+	odAllocationStats allocation_stats;
+	odFrameWatchdogZone zones[OD_FRAME_WATCHDOG_FRAME_ZONE_CAPACITY];
+	int32_t zone_count;
+	char note[OD_FRAME_WATCHDOG_NOTE_CAPACITY];
+};
+struct odFrameWatchdogState {
+	odString filename;
+	int64_t budget_ns;
+	int32_t file_count;
+	int32_t dump_count;
+	bool running;
+
+	bool in_frame;
+	odTimer timer;
+	int64_t draw_count_start;
+	int32_t profile_frame_count_start;
+
+	// the last ended frame's zones are only published by the next odProfile_end_frame()
+	bool zones_pending;
+	bool dump_pending;
+
+	int32_t frame_count;
+	odFrameWatchdogFrame frames[OD_FRAME_WATCHDOG_FRAME_CAPACITY];
+};
+
+static odFrameWatchdogState odFrameWatchdog_state{};
+
+static odFrameWatchdogFrame* odFrameWatchdog_get_frame(int32_t index) {
+	return &odFrameWatchdog_state.frames[index % OD_FRAME_WATCHDOG_FRAME_CAPACITY];
+}
+// keeps the frame's slowest zones by total time, if the profile has published a frame since it began
+static void odFrameWatchdog_read_zones(odFrameWatchdogFrame* frame) {
+	frame->zone_count = 0;
+	if (odProfile_get_frame_count() == odFrameWatchdog_state.profile_frame_count_start) {
+		return;
+	}
+
+	int32_t zone_count = odProfile_get_zone_count();
+	for (int32_t zone_id = 0; zone_id < zone_count; zone_id++) {
+		const odProfileZoneStats* stats = odProfile_get_frame_stats(zone_id);
+		if ((stats == nullptr) || (stats->count == 0)) {
+			continue;
+		}
+
+		int32_t i = frame->zone_count;
+		if (i == OD_FRAME_WATCHDOG_FRAME_ZONE_CAPACITY) {
+			if (stats->total_ns <= frame->zones[i - 1].stats.total_ns) {
+				continue;
+			}
+			i--;
+		} else {
+			frame->zone_count++;
+		}
+
+		for (; (i > 0) && (frame->zones[i - 1].stats.total_ns < stats->total_ns); i--) {
+			frame->zones[i] = frame->zones[i - 1];
+		}
+		frame->zones[i] = odFrameWatchdogZone{zone_id, *stats};
+	}
+}
+static bool odFrameWatchdog_extend_frame_json(odString* json, const odFrameWatchdogFrame* frame) {
+	const odAllocationStats* allocation_stats = &frame->allocation_stats;
+	if (!OD_CHECK(odString_extend_formatted(
+			json,
+			"{\"frame\":%d,\"duration_ms\":%.3f,\"draw_count\":%lld,"
+			"\"allocations\":{\"count\":%lld,\"free_count\":%lld,\"allocated_bytes\":%lld,\"freed_bytes\":%lld,"
+			"\"peak_live_bytes\":%lld},\"note\":",
+			frame->index,
+			static_cast<double>(frame->duration_ns) / 1e6,
+			static_cast<long long>(frame->draw_count),
+			static_cast<long long>(allocation_stats->allocation_count),
+			static_cast<long long>(allocation_stats->free_count),
+			static_cast<long long>(allocation_stats->allocated_bytes),
+			static_cast<long long>(allocation_stats->freed_bytes),
+			static_cast<long long>(allocation_stats->peak_live_bytes)))
+		|| !OD_CHECK(odString_extend_json_string(json, frame->note))
+		|| !OD_CHECK(json->extend(",\"zones\":["))) {
+		return false;
+	}
+
+	for (int32_t i = 0; i < frame->zone_count; i++) {
+		const odFrameWatchdogZone* zone = &frame->zones[i];
+		if (!OD_CHECK(json->extend((i > 0) ? ",{\"name\":" : "{\"name\":"))
+			|| !OD_CHECK(odString_extend_json_string(json, odProfile_get_zone_name(zone->zone_id)))
+			|| !OD_CHECK(odString_extend_formatted(
+				json,
+				",\"count\":%d,\"total_ms\":%.3f,\"max_ms\":%.3f}",
+				zone->stats.count,
+				static_cast<double>(zone->stats.total_ns) / 1e6,
+				static_cast<double>(zone->stats.max_ns) / 1e6))) {
+			return false;
+		}
+	}
+
+	return OD_CHECK(json->extend("]}"));
+}
+static bool odFrameWatchdog_write_dump(void) {
+	odFrameWatchdogState* state = &odFrameWatchdog_state;
+	int32_t slow_frame_index = state->frame_count - 1;
+
+	odString json;
+	if (!OD_CHECK(odString_extend_formatted(
+			&json,
+			"{\"budget_ms\":%.3f,\"slow_frame\":%d,\"frames\":[\n",
+			static_cast<double>(state->budget_ns) / 1e6,
+			slow_frame_index))) {
+		return false;
+	}
+
+	int32_t first_index = state->frame_count - OD_FRAME_WATCHDOG_FRAME_CAPACITY;
+	for (int32_t index = (first_index > 0) ? first_index : 0; index < state->frame_count; index++) {
+		if (!odFrameWatchdog_extend_frame_json(&json, odFrameWatchdog_get_frame(index))
+			|| !OD_CHECK(json.extend((index < slow_frame_index) ? ",\n" : "\n"))) {
+			return false;
+		}
+	}
+
+	if (!OD_CHECK(json.extend("]}\n"))) {
+		return false;
+	}
+
+	odString filename;
+	if (!OD_CHECK(odString_extend_formatted(
+			&filename, "%s.%d", odString_get_c_str(&state->filename), state->dump_count % state->file_count))) {
+		return false;
+	}
+	state->dump_count++;
+
+	if (!OD_CHECK(odFile_write_all(odString_get_c_str(&filename), "wb", json.begin(), json.get_count()))) {
+		return false;
+	}
+
+	OD_INFO(
+		"frame watchdog dump written, filename=%s, frame=%d, duration_ms=%.3f",
+		odString_get_c_str(&filename),
+		slow_frame_index,
+		static_cast<double>(odFrameWatchdog_get_frame(slow_frame_index)->duration_ns) / 1e6);
+	return true;
+}
+static bool odFrameWatchdog_flush(void) {
+	odFrameWatchdogState* state = &odFrameWatchdog_state;
+	if (state->zones_pending) {
+		state->zones_pending = false;
+		odFrameWatchdog_read_zones(odFrameWatchdog_get_frame(state->frame_count - 1));
+	}
+
+	if (state->dump_pending) {
+		state->dump_pending = false;
+		return odFrameWatchdog_write_dump();
+	}
+
+	return true;
+}
+bool odFrameWatchdog_start(const char* filename, float budget_ms, int32_t file_count) {
+	if (!OD_CHECK(filename != nullptr)
+		|| !OD_CHECK(budget_ms > 0.0f)
+		|| !OD_CHECK(file_count > 0)) {
+		return false;
+	}
+
+	odFrameWatchdogState* state = &odFrameWatchdog_state;
+	if (state->running) {
+		OD_ERROR("frame watchdog already running, filename=%s", odString_get_c_str(&state->filename));
+		return false;
+	}
+
+	if (!OD_CHECK(odString_assign(&state->filename, filename, static_cast<int32_t>(strlen(filename))))) {
+		return false;
+	}
+
+	state->budget_ns = static_cast<int64_t>(static_cast<double>(budget_ms) * 1e6);
+	state->file_count = file_count;
+	state->dump_count = 0;
+	state->in_frame = false;
+	state->zones_pending = false;
+	state->dump_pending = false;
+	state->frame_count = 0;
+	state->running = true;
+
+	OD_INFO("frame watchdog started, filename=%s, budget_ms=%g, file_count=%d", filename, static_cast<double>(budget_ms), file_count);
+	return true;
+}
+bool odFrameWatchdog_stop(void) {
+	odFrameWatchdogState* state = &odFrameWatchdog_state;
+	if (!state->running) {
+		return false;
+	}
+
+	bool ok = odFrameWatchdog_flush();
+	state->running = false;
+	state->in_frame = false;
+	return ok;
+}
+bool odFrameWatchdog_get_running(void) {
+	return odFrameWatchdog_state.running;
+}
+int32_t odFrameWatchdog_get_dump_count(void) {
+	return odFrameWatchdog_state.dump_count;
+}
+void odFrameWatchdog_begin_frame(void) {
+	odFrameWatchdogState* state = &odFrameWatchdog_state;
+	if (!state->running) {
+		return;
+	}
+
+	if (!odFrameWatchdog_flush()) {
+		OD_ERROR("odFrameWatchdog_write_dump() failed");
+	}
+
+	odFrameWatchdog_get_frame(state->frame_count)->note[0] = '\0';
+	state->in_frame = true;
+	state->draw_count_start = odRenderer_get_draw_count();
+	state->profile_frame_count_start = odProfile_get_frame_count();
+	odTimer_start(&state->timer);
+}
+void odFrameWatchdog_end_frame(void) {
+	odFrameWatchdogState* state = &odFrameWatchdog_state;
+	if (!state->running || !state->in_frame) {
+		return;
+	}
+
+	odFrameWatchdogFrame* frame = odFrameWatchdog_get_frame(state->frame_count);
+	frame->index = state->frame_count;
+	frame->duration_ns = odTimer_get_elapsed_ns(&state->timer);
+	frame->draw_count = odRenderer_get_draw_count() - state->draw_count_start;
+	frame->zone_count = 0;
+	if (!OD_CHECK(odAllocation_get_frame_stats(OD_ALLOCATION_CATEGORY_ALL, &frame->allocation_stats))) {
+		frame->allocation_stats = odAllocationStats{};
+	}
+
+	state->in_frame = false;
+	state->frame_count++;
+	state->zones_pending = true;
+
+	// logged as info: warnings count as errors, which fail runs (see odTimer_warn_if_exceeded)
+	if (frame->duration_ns > state->budget_ns) {
+		OD_INFO(
+			"frame over budget, frame=%d, duration_ms=%.3f, budget_ms=%.3f",
+			frame->index,
+			static_cast<double>(frame->duration_ns) / 1e6,
+			static_cast<double>(state->budget_ns) / 1e6);
+		state->dump_pending = true;
+	}
+}
+void odFrameWatchdog_set_note(const char* note) {
+	if (!OD_DEBUG_CHECK(note != nullptr)) {
+		return;
+	}
+
+	odFrameWatchdogState* state = &odFrameWatchdog_state;
+	if (!state->running) {
+		return;
+	}
+
+	char* frame_note = odFrameWatchdog_get_frame(state->frame_count)->note;
+	strncpy(frame_note, note, OD_FRAME_WATCHDOG_NOTE_CAPACITY - 1);
+	frame_note[OD_FRAME_WATCHDOG_NOTE_CAPACITY - 1] = '\0';
+}
@@ -45,7 +45,7 @@ bool odImage_init(odImage* image, int32_t width, int32_t height) {
 		return true;
 	}
 
-	if (!OD_CHECK(odAllocation_init(&image->allocation, size))) {
+	if (!OD_CHECK(odAllocation_init_category(&image->allocation, size, OD_ALLOCATION_CATEGORY_IMAGE))) {
 		return false;
 	}
 
@@ -144,7 +144,7 @@ bool odImage_copy(odImage* image, const odImage* src_image) {
 		return true;
 	}
 
-	if (!OD_CHECK(odAllocation_init(&image->allocation, size))) {
+	if (!OD_CHECK(odAllocation_init_category(&image->allocation, size, OD_ALLOCATION_CATEGORY_IMAGE))) {
 		return false;
 	}
 
@@ -0,0 +1,282 @@
+#include <od/platform/profile.hpp>
+
+#include <cstring>
+
+#include <od/core/debug.h>
+#include <od/core/array.hpp>
+#include <od/core/string.hpp>
+#include <od/platform/file.h>
+#include <od/platform/timer.h>
+
+#define OD_PROFILE_TRACE_FRAME_ZONE_NAME "frame"
+
+struct odProfileZone {
+	char name[OD_PROFILE_ZONE_NAME_CAPACITY];
+	odProfileZoneStats frame_stats;
+	odProfileZoneStats last_frame_stats;
+};
+struct odProfileOpenZone {
+	int32_t zone_id;
+	int64_t start_ns;
+};
+struct odProfileTraceEvent {
+	int32_t zone_id;
+	bool is_counter;
+	int64_t start_ns;
+	int64_t end_ns_or_value;
+};
+struct odProfileTrace {
+	odString filename;
+	odTrivialArrayT<odProfileTraceEvent> events;
+	int32_t events_dropped;
+	int32_t frames_remaining;
+	int32_t frame_zone_id;
+	int64_t start_ns;
+	int64_t frame_start_ns;
+};
+struct odProfileState {
+	odProfileZone zones[OD_PROFILE_ZONE_CAPACITY];
+	int32_t zone_count;
+	odProfileOpenZone open_zones[OD_PROFILE_OPEN_ZONE_CAPACITY];
+	int32_t open_zone_count;
+	int32_t frame_count;
+	bool tracing;
+	odProfileTrace trace;
+};
+
+static odProfileState odProfile_state{};
+
+static bool odProfile_check_zone_id(int32_t zone_id) {
+	return (zone_id >= 0) && (zone_id < odProfile_state.zone_count);
+}
+static void odProfile_add_trace_event(int32_t zone_id, bool is_counter, int64_t start_ns, int64_t end_ns_or_value) {
+	odProfileTrace* trace = &odProfile_state.trace;
+	if (trace->events.get_count() >= OD_PROFILE_TRACE_EVENT_CAPACITY) {
+		trace->events_dropped++;
+		return;
+	}
+
+	if (!OD_CHECK(trace->events.push(odProfileTraceEvent{zone_id, is_counter, start_ns, end_ns_or_value}))) {
+		trace->events_dropped++;
+	}
+}
+static bool odProfile_write_trace(const odProfileTrace* trace) {
+	odString json;
+	if (!OD_CHECK(odString_extend_formatted(&json, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"))) {
+		return false;
+	}
+
+	int32_t events_count = trace->events.get_count();
+	for (int32_t i = 0; i < events_count; i++) {
+		const odProfileTraceEvent* event = trace->events.get(i);
+		double start_us = static_cast<double>(event->start_ns - trace->start_ns) / 1e3;
+
+		if (!OD_CHECK(json.extend("{\"name\":"))
+			|| !OD_CHECK(odString_extend_json_string(&json, odProfile_state.zones[event->zone_id].name))) {
+			return false;
+		}
+
+		bool ok = false;
+		if (event->is_counter) {
+			ok = odString_extend_formatted(
+				&json,
+				",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+				start_us,
+				static_cast<long long>(event->end_ns_or_value));
+		} else {
+			ok = odString_extend_formatted(
+				&json,
+				",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+				start_us,
+				static_cast<double>(event->end_ns_or_value - event->start_ns) / 1e3);
+		}
+		if (!OD_CHECK(ok)
+			|| !OD_CHECK(json.extend((i + 1 < events_count) ? ",\n" : "\n"))) {
+			return false;
+		}
+	}
+
+	if (!OD_CHECK(json.extend("]}\n"))) {
+		return false;
+	}
+
+	if (!OD_CHECK(odFile_write_all(odString_get_c_str(&trace->filename), "wb", json.begin(), json.get_count()))) {
+		return false;
+	}
+
+	OD_INFO(
+		"profile trace written, filename=%s, events=%d, events_dropped=%d",
+		odString_get_c_str(&trace->filename),
+		events_count,
+		trace->events_dropped);
+	return true;
+}
+int32_t odProfile_get_zone_id(const char* name) {
+	if (!OD_DEBUG_CHECK(name != nullptr)) {
+		return OD_PROFILE_ZONE_ID_INVALID;
+	}
+
+	for (int32_t i = 0; i < odProfile_state.zone_count; i++) {
+		if (strncmp(odProfile_state.zones[i].name, name, OD_PROFILE_ZONE_NAME_CAPACITY - 1) == 0) {
+			return i;
+		}
+	}
+
+	if (!OD_CHECK(odProfile_state.zone_count < OD_PROFILE_ZONE_CAPACITY)) {
+		return OD_PROFILE_ZONE_ID_INVALID;
+	}
+
+	int32_t zone_id = odProfile_state.zone_count;
+	odProfileZone* zone = &odProfile_state.zones[zone_id];
+	*zone = odProfileZone{};
+	strncpy(zone->name, name, OD_PROFILE_ZONE_NAME_CAPACITY - 1);
+	odProfile_state.zone_count++;
+	return zone_id;
+}
+int32_t odProfile_get_zone_count(void) {
+	return odProfile_state.zone_count;
+}
+const char* odProfile_get_zone_name(int32_t zone_id) {
+	if (!OD_DEBUG_CHECK(odProfile_check_zone_id(zone_id))) {
+		return nullptr;
+	}
+
+	return odProfile_state.zones[zone_id].name;
+}
+void odProfile_add_sample(int32_t zone_id, int64_t start_ns, int64_t end_ns) {
+	if (!odProfile_check_zone_id(zone_id)) {
+		return;
+	}
+
+	int64_t elapsed_ns = end_ns - start_ns;
+	odProfileZoneStats* stats = &odProfile_state.zones[zone_id].frame_stats;
+	stats->count++;
+	stats->total_ns += elapsed_ns;
+	if (elapsed_ns > stats->max_ns) {
+		stats->max_ns = elapsed_ns;
+	}
+
+	if (odProfile_state.tracing) {
+		odProfile_add_trace_event(zone_id, false, start_ns, end_ns);
+	}
+}
+void odProfile_add_counter(int32_t zone_id, int64_t value) {
+	if (!odProfile_state.tracing || !odProfile_check_zone_id(zone_id)) {
+		return;
+	}
+
+	odProfile_add_trace_event(zone_id, true, odTimer_get_now_ns(), value);
+}
+bool odProfile_begin(int32_t zone_id) {
+	if (!OD_DEBUG_CHECK(odProfile_check_zone_id(zone_id))
+		|| !OD_CHECK(odProfile_state.open_zone_count < OD_PROFILE_OPEN_ZONE_CAPACITY)) {
+		return false;
+	}
+
+	odProfile_state.open_zones[odProfile_state.open_zone_count] = odProfileOpenZone{zone_id, odTimer_get_now_ns()};
+	odProfile_state.open_zone_count++;
+	return true;
+}
+bool odProfile_end(int32_t zone_id) {
+	int64_t end_ns = odTimer_get_now_ns();
+
+	for (int32_t i = odProfile_state.open_zone_count - 1; i >= 0; i--) {
+		const odProfileOpenZone* open_zone = &odProfile_state.open_zones[i];
+		if (open_zone->zone_id == zone_id) {
+			odProfile_add_sample(zone_id, open_zone->start_ns, end_ns);
+			odProfile_state.open_zone_count = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+void odProfile_end_frame(void) {
+	if (odProfile_state.tracing) {
+		odProfileTrace* trace = &odProfile_state.trace;
+		int64_t now_ns = odTimer_get_now_ns();
+		odProfile_add_sample(trace->frame_zone_id, trace->frame_start_ns, now_ns);
+		trace->frame_start_ns = now_ns;
+
+		trace->frames_remaining--;
+		if ((trace->frames_remaining <= 0) && !odProfile_end_trace()) {
+			OD_ERROR("odProfile_end_trace() failed");
+		}
+	}
+
+	for (int32_t i = 0; i < odProfile_state.zone_count; i++) {
+		odProfileZone* zone = &odProfile_state.zones[i];
+		zone->last_frame_stats = zone->frame_stats;
+		zone->frame_stats = odProfileZoneStats{};
+	}
+
+	odProfile_state.frame_count++;
+}
+int32_t odProfile_get_frame_count(void) {
+	return odProfile_state.frame_count;
+}
+const odProfileZoneStats* odProfile_get_frame_stats(int32_t zone_id) {
+	if (!OD_DEBUG_CHECK(odProfile_check_zone_id(zone_id))) {
+		return nullptr;
+	}
+
+	return &odProfile_state.zones[zone_id].last_frame_stats;
+}
+bool odProfile_begin_trace(const char* filename, int32_t frame_count) {
+	if (!OD_CHECK(filename != nullptr)
+		|| !OD_CHECK(frame_count > 0)) {
+		return false;
+	}
+
+	if (odProfile_state.tracing) {
+		OD_ERROR("profile trace already in progress, filename=%s", odString_get_c_str(&odProfile_state.trace.filename));
+		return false;
+	}
+
+	int32_t frame_zone_id = odProfile_get_zone_id(OD_PROFILE_TRACE_FRAME_ZONE_NAME);
+	if (!OD_CHECK(frame_zone_id != OD_PROFILE_ZONE_ID_INVALID)) {
+		return false;
+	}
+
+	odProfileTrace* trace = &odProfile_state.trace;
+	if (!OD_CHECK(odString_assign(&trace->filename, filename, static_cast<int32_t>(strlen(filename))))
+		|| !OD_CHECK(trace->events.set_count(0))) {
+		return false;
+	}
+
+	trace->events_dropped = 0;
+	trace->frames_remaining = frame_count;
+	trace->frame_zone_id = frame_zone_id;
+	trace->start_ns = odTimer_get_now_ns();
+	trace->frame_start_ns = trace->start_ns;
+	odProfile_state.tracing = true;
+
+	OD_INFO("profile trace started, filename=%s, frame_count=%d", filename, frame_count);
+	return true;
+}
+bool odProfile_end_trace(void) {
+	if (!OD_CHECK(odProfile_state.tracing)) {
+		return false;
+	}
+
+	odProfile_state.tracing = false;
+
+	odProfileTrace* trace = &odProfile_state.trace;
+	bool ok = odProfile_write_trace(trace);
+
+	// traces can hold millions of events, so the buffer is released rather than kept for the next trace
+	odTrivialArrayT<odProfileTraceEvent> events_freed;
+	odTrivialArray_swap(&trace->events, &events_freed);
+
+	return ok;
+}
+bool odProfile_get_tracing(void) {
+	return odProfile_state.tracing;
+}
+
+odProfileScope::odProfileScope(int32_t in_zone_id)
+	: zone_id{in_zone_id}, start_ns{odTimer_get_now_ns()} {
+}
+odProfileScope::~odProfileScope() {
+	odProfile_add_sample(zone_id, start_ns, odTimer_get_now_ns());
+}
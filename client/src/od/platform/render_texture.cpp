@@ -18,15 +18,18 @@ void odRenderTexture_swap(odRenderTexture* render_texture1, odRenderTexture* ren
 		return;
 	}
 
-	odTexture render_texture_swap;
-	memcpy(static_cast<void*>(&render_texture_swap), static_cast<void*>(render_texture1), sizeof(odTexture));
-	memcpy(static_cast<void*>(render_texture1), static_cast<void*>(render_texture2), sizeof(odTexture));
-	memcpy(static_cast<void*>(render_texture2), static_cast<void*>(&render_texture_swap), sizeof(odTexture));
+	odRenderTexture render_texture_swap;
+	memcpy(static_cast<void*>(&render_texture_swap), static_cast<void*>(render_texture1), sizeof(odRenderTexture));
+	memcpy(static_cast<void*>(render_texture1), static_cast<void*>(render_texture2), sizeof(odRenderTexture));
+	memcpy(static_cast<void*>(render_texture2), static_cast<void*>(&render_texture_swap), sizeof(odRenderTexture));
+
+	// render_texture_swap no longer owns its contents, and must not destroy them
+	memset(static_cast<void*>(&render_texture_swap), 0, sizeof(odRenderTexture));
 }
 bool odRenderTexture_check_valid(const odRenderTexture* render_texture) {
 	if (!OD_CHECK(render_texture != nullptr)
 		|| !OD_CHECK(odTexture_check_valid(&render_texture->texture))
-		|| !OD_CHECK(render_texture->fbo > 0)) {
+		|| !OD_CHECK((render_texture->fbo > 0) || odWindow_is_headless(render_texture->texture.window))) {
 		return false;
 	}
 
@@ -64,6 +67,10 @@ bool odRenderTexture_init(odRenderTexture* render_texture, odWindow* window, int
 		return false;
 	}
 
+	if (odWindow_is_headless(window)) {
+		return true;
+	}
+
 	odWindowScope window_scope;
 	if (!OD_CHECK(odWindowScope_bind(&window_scope, render_texture->texture.window))) {
 		return false;
@@ -99,7 +106,7 @@ void odRenderTexture_destroy(odRenderTexture* render_texture) {
 }
 odTexture* odRenderTexture_get_texture(odRenderTexture* render_texture) {
 	if (!OD_DEBUG_CHECK(render_texture != nullptr)
-		|| !OD_DEBUG_CHECK(render_texture->fbo != 0)) {
+		|| !OD_DEBUG_CHECK((render_texture->fbo != 0) || odWindow_is_headless(render_texture->texture.window))) {
 		return nullptr;
 	}
 
@@ -112,7 +119,7 @@ const odTexture* odRenderTexture_get_texture_const(const odRenderTexture* render
 odRenderTexture::odRenderTexture()
 	: texture{}, fbo{0} {
 }
-odRenderTexture::odRenderTexture(odRenderTexture&& other) {
+odRenderTexture::odRenderTexture(odRenderTexture&& other) : odRenderTexture{} {
 	odRenderTexture_swap(this, &other);
 }
 odRenderTexture& odRenderTexture::operator=(odRenderTexture&& other) {
@@ -9,10 +9,12 @@
 #include <od/core/vector.h>
 #include <od/core/vertex.h>
 #include <od/platform/primitive.h>
+#include <od/platform/profile.hpp>
 #include <od/platform/window.hpp>
 #include <od/platform/texture.hpp>
 #include <od/platform/render_texture.hpp>
 #include <od/platform/gl.h>
+#include <od/platform/software_renderer.h>
 
 #if OD_BUILD_EMSCRIPTEN
 #define OD_RENDERER_FRAGMENT_SHADER_PLATFORM_HEADER "precision mediump float;\n"
@@ -59,6 +61,22 @@ static const char odRenderer_fragment_shader[] =
 	}
 )";
 
+// across all renderers, for per-frame draw counts (see odFrameWatchdog)
+static int64_t odRenderer_draw_count = 0;
+
+static odColor* odRenderer_get_software_target(odRenderer* renderer, odRenderTexture* opt_render_texture,
+											   int32_t* out_width, int32_t* out_height) {
+	if (opt_render_texture != nullptr) {
+		*out_width = opt_render_texture->texture.width;
+		*out_height = opt_render_texture->texture.height;
+		return opt_render_texture->texture.pixels.begin();
+	}
+
+	*out_width = renderer->window->settings.width;
+	*out_height = renderer->window->settings.height;
+	return renderer->window->software_framebuffer.begin();
+}
+
 bool odRenderState_check_valid(const odRenderState* state) {
 	if (!OD_CHECK(state != nullptr)
 		|| !OD_CHECK(odMatrix_check_valid_3d(&state->view))
@@ -86,8 +104,16 @@ void odRenderer_swap(odRenderer* renderer1, odRenderer* renderer2) {
 }
 bool odRenderer_check_valid(const odRenderer* renderer) {
 	if (!OD_CHECK(renderer != nullptr)
-		|| !OD_CHECK(odWindow_check_valid(renderer->window))
-		|| !OD_CHECK(renderer->vbo > 0)
+		|| !OD_CHECK(odWindow_check_valid(renderer->window))) {
+		return false;
+	}
+
+	// headless renderers own no gl objects
+	if (odWindow_is_headless(renderer->window)) {
+		return true;
+	}
+
+	if (!OD_CHECK(renderer->vbo > 0)
 #if !OD_BUILD_EMSCRIPTEN
 		|| !OD_CHECK(renderer->vao > 0)
 #endif  // !OD_BUILD_EMSCRIPTEN
@@ -127,6 +153,10 @@ bool odRenderer_init(odRenderer* renderer, odWindow* window) {
 		return false;
 	}
 
+	if (odWindow_is_headless(window)) {
+		return true;
+	}
+
 	odWindowScope window_scope;
 	if (!OD_CHECK(odWindowScope_bind(&window_scope, renderer->window))) {
 		return false;
@@ -303,6 +333,10 @@ bool odRenderer_flush(odRenderer* renderer) {
 		return false;
 	}
 
+	if (odWindow_is_headless(renderer->window)) {
+		return true;
+	}
+
 	odWindowScope window_scope;
 	if (!OD_CHECK(odWindowScope_bind(&window_scope, renderer->window))) {
 		return false;
@@ -319,6 +353,18 @@ bool odRenderer_clear(odRenderer* renderer, const odColor* color, odRenderTextur
 		return false;
 	}
 
+	if (odWindow_is_software_renderer_enabled(renderer->window)) {
+		int32_t target_width = 0;
+		int32_t target_height = 0;
+		odColor* target = odRenderer_get_software_target(renderer, opt_render_texture, &target_width, &target_height);
+		odSoftwareRenderer_clear(target, target_width, target_height, color);
+		return true;
+	}
+
+	if (odWindow_is_headless(renderer->window)) {
+		return true;
+	}
+
 	odWindowScope window_scope;
 	if (!OD_CHECK(odWindowScope_bind(&window_scope, renderer->window))) {
 		return false;
@@ -341,6 +387,8 @@ bool odRenderer_clear(odRenderer* renderer, const odColor* color, odRenderTextur
 }
 bool odRenderer_draw_vertices(odRenderer* renderer, const odVertex* vertices, int32_t vertices_count,
 							  const odRenderState *state, const odTexture* src_texture, odRenderTexture* opt_render_texture) {
+	OD_PROFILE_SCOPE("odRenderer_draw_vertices");
+
 	if (!OD_CHECK(odRenderer_check_valid(renderer))
 		|| !OD_DEBUG_CHECK(odVertex_check_valid_batch_3d(vertices, vertices_count))
 		|| !OD_CHECK(odRenderState_check_valid(state))
@@ -355,6 +403,22 @@ bool odRenderer_draw_vertices(odRenderer* renderer, const odVertex* vertices, in
 		return true;
 	}
 
+	odRenderer_draw_count++;
+
+	if (odWindow_is_software_renderer_enabled(renderer->window)) {
+		int32_t target_width = 0;
+		int32_t target_height = 0;
+		odColor* target = odRenderer_get_software_target(renderer, opt_render_texture, &target_width, &target_height);
+		odSoftwareRenderer_draw_vertices(
+			target, target_width, target_height, vertices, vertices_count, state,
+			src_texture->pixels.begin(), src_texture->width, src_texture->height);
+		return true;
+	}
+
+	if (odWindow_is_headless(renderer->window)) {
+		return true;
+	}
+
 	int32_t texture_width = 0;
 	int32_t texture_height = 0;
 	if (!OD_CHECK(odTexture_get_size(src_texture, &texture_width, &texture_height))) {
@@ -455,6 +519,9 @@ bool odRenderer_draw_texture(odRenderer* renderer, const odRenderState* state, c
 
 	return odRenderer_draw_vertices(renderer, vertices, OD_SPRITE_VERTEX_COUNT, state, src_texture, opt_render_texture);
 }
+int64_t odRenderer_get_draw_count(void) {
+	return odRenderer_draw_count;
+}
 
 static void odRenderer_unbind() {
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
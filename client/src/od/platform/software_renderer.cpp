@@ -0,0 +1,287 @@
+#include <od/platform/software_renderer.h>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // defined(__SSE2__)
+
+#include <od/core/debug.h>
+#include <od/core/bounds.h>
+#include <od/core/color.h>
+#include <od/core/matrix.h>
+#include <od/core/vector.h>
+#include <od/core/vertex.h>
+#include <od/platform/renderer.h>
+
+// vertex positions are snapped to 1/16th pixel, so that edge tests are exact and shared edges never overlap or gap
+#define OD_SOFTWARE_RENDERER_SUBPIXEL_BITS 4
+#define OD_SOFTWARE_RENDERER_SUBPIXEL_SCALE (1 << OD_SOFTWARE_RENDERER_SUBPIXEL_BITS)
+#define OD_SOFTWARE_RENDERER_SPAN_CAPACITY 64
+
+// far offscreen vertices are clamped, to keep edge function products in range
+#define OD_SOFTWARE_RENDERER_COORD_MAX 16777216.0f
+
+struct odSoftwareRendererVertex {
+	int32_t x;  // subpixels
+	int32_t y;  // subpixels
+	float r;
+	float g;
+	float b;
+	float a;
+	float u;
+	float v;
+};
+
+static int32_t odSoftwareRenderer_to_subpixels(float x) {
+	x = floorf((x * static_cast<float>(OD_SOFTWARE_RENDERER_SUBPIXEL_SCALE)) + 0.5f);
+	x = (x < -OD_SOFTWARE_RENDERER_COORD_MAX) ? -OD_SOFTWARE_RENDERER_COORD_MAX : x;
+	x = (x > OD_SOFTWARE_RENDERER_COORD_MAX) ? OD_SOFTWARE_RENDERER_COORD_MAX : x;
+	return static_cast<int32_t>(x);
+}
+static uint32_t odSoftwareRenderer_div255(uint32_t x) {
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+static odColor odSoftwareRenderer_blend(odColor src, odColor dest) {
+	uint32_t src_a = src.a;
+	uint32_t inv_src_a = 255 - src_a;
+	return odColor{
+		static_cast<uint8_t>(odSoftwareRenderer_div255((src.r * src_a) + (dest.r * inv_src_a))),
+		static_cast<uint8_t>(odSoftwareRenderer_div255((src.g * src_a) + (dest.g * inv_src_a))),
+		static_cast<uint8_t>(odSoftwareRenderer_div255((src.b * src_a) + (dest.b * inv_src_a))),
+		static_cast<uint8_t>(odSoftwareRenderer_div255((src.a * src_a) + (dest.a * inv_src_a))),
+	};
+}
+#if defined(__SSE2__)
+static __m128i odSoftwareRenderer_blend_simd_half(__m128i src, __m128i dest) {
+	// 2 pixels of 16-bit channels; src*a + dest*(255-a) <= 255*255, so lanes never overflow
+	__m128i src_a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	__m128i inv_src_a = _mm_sub_epi16(_mm_set1_epi16(255), src_a);
+	__m128i sum = _mm_add_epi16(_mm_mullo_epi16(src, src_a), _mm_mullo_epi16(dest, inv_src_a));
+	sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(sum, _mm_srli_epi16(sum, 8)), 8);
+}
+#endif  // defined(__SSE2__)
+static void odSoftwareRenderer_blend_span(const odColor* src, odColor* dest, int32_t count) {
+	int32_t i = 0;
+
+#if defined(__SSE2__)
+	const __m128i zero = _mm_setzero_si128();
+	for (; (i + 4) <= count; i += 4) {
+		__m128i src_pixels = _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(src + i)));
+		__m128i dest_pixels = _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(dest + i)));
+
+		__m128i blend_lo = odSoftwareRenderer_blend_simd_half(
+			_mm_unpacklo_epi8(src_pixels, zero), _mm_unpacklo_epi8(dest_pixels, zero));
+		__m128i blend_hi = odSoftwareRenderer_blend_simd_half(
+			_mm_unpackhi_epi8(src_pixels, zero), _mm_unpackhi_epi8(dest_pixels, zero));
+
+		_mm_storeu_si128(static_cast<__m128i*>(static_cast<void*>(dest + i)), _mm_packus_epi16(blend_lo, blend_hi));
+	}
+#endif  // defined(__SSE2__)
+
+	for (; i < count; i++) {
+		dest[i] = odSoftwareRenderer_blend(src[i], dest[i]);
+	}
+}
+static bool odSoftwareRenderer_get_is_top_left(const odSoftwareRendererVertex* a, const odSoftwareRendererVertex* b) {
+	// triangles are wound counter-clockwise with y up, so top edges point left and left edges point down
+	return ((a->y == b->y) && (b->x < a->x)) || (b->y < a->y);
+}
+static int64_t odSoftwareRenderer_edge(const odSoftwareRendererVertex* a, const odSoftwareRendererVertex* b,
+									   int64_t x, int64_t y) {
+	return (static_cast<int64_t>(b->x - a->x) * (y - a->y)) - (static_cast<int64_t>(b->y - a->y) * (x - a->x));
+}
+static odColor odSoftwareRenderer_shade(const odSoftwareRendererVertex* v0, const odSoftwareRendererVertex* v1,
+										const odSoftwareRendererVertex* v2, float l1, float l2,
+										const odColor* src_pixels, int32_t src_width, int32_t src_height) {
+	float l0 = 1.0f - l1 - l2;
+
+	float u = (l0 * v0->u) + (l1 * v1->u) + (l2 * v2->u);
+	float v = (l0 * v0->v) + (l1 * v1->v) + (l2 * v2->v);
+	int32_t texel_x = static_cast<int32_t>(floorf(u));
+	int32_t texel_y = static_cast<int32_t>(floorf(v));
+	texel_x = (texel_x < 0) ? 0 : ((texel_x >= src_width) ? (src_width - 1) : texel_x);
+	texel_y = (texel_y < 0) ? 0 : ((texel_y >= src_height) ? (src_height - 1) : texel_y);
+	odColor texel = src_pixels[(texel_y * src_width) + texel_x];
+
+	uint32_t r = static_cast<uint32_t>((l0 * v0->r) + (l1 * v1->r) + (l2 * v2->r) + 0.5f);
+	uint32_t g = static_cast<uint32_t>((l0 * v0->g) + (l1 * v1->g) + (l2 * v2->g) + 0.5f);
+	uint32_t b = static_cast<uint32_t>((l0 * v0->b) + (l1 * v1->b) + (l2 * v2->b) + 0.5f);
+	uint32_t a = static_cast<uint32_t>((l0 * v0->a) + (l1 * v1->a) + (l2 * v2->a) + 0.5f);
+
+	return odColor{
+		static_cast<uint8_t>(odSoftwareRenderer_div255(texel.r * (r > 255 ? 255 : r))),
+		static_cast<uint8_t>(odSoftwareRenderer_div255(texel.g * (g > 255 ? 255 : g))),
+		static_cast<uint8_t>(odSoftwareRenderer_div255(texel.b * (b > 255 ? 255 : b))),
+		static_cast<uint8_t>(odSoftwareRenderer_div255(texel.a * (a > 255 ? 255 : a))),
+	};
+}
+static void odSoftwareRenderer_draw_triangle(odColor* target, int32_t target_width,
+											 int32_t clip_x1, int32_t clip_y1, int32_t clip_x2, int32_t clip_y2,
+											 const odSoftwareRendererVertex* v0, const odSoftwareRendererVertex* v1,
+											 const odSoftwareRendererVertex* v2,
+											 const odColor* src_pixels, int32_t src_width, int32_t src_height) {
+	int64_t area = odSoftwareRenderer_edge(v0, v1, v2->x, v2->y);
+	if (area == 0) {
+		return;
+	}
+
+	// there is no culling; clockwise triangles are rewound
+	if (area < 0) {
+		const odSoftwareRendererVertex* swap = v1;
+		v1 = v2;
+		v2 = swap;
+		area = -area;
+	}
+
+	const int32_t scale = OD_SOFTWARE_RENDERER_SUBPIXEL_SCALE;
+	int32_t min_x = (v0->x < v1->x) ? ((v0->x < v2->x) ? v0->x : v2->x) : ((v1->x < v2->x) ? v1->x : v2->x);
+	int32_t min_y = (v0->y < v1->y) ? ((v0->y < v2->y) ? v0->y : v2->y) : ((v1->y < v2->y) ? v1->y : v2->y);
+	int32_t max_x = (v0->x > v1->x) ? ((v0->x > v2->x) ? v0->x : v2->x) : ((v1->x > v2->x) ? v1->x : v2->x);
+	int32_t max_y = (v0->y > v1->y) ? ((v0->y > v2->y) ? v0->y : v2->y) : ((v1->y > v2->y) ? v1->y : v2->y);
+
+	// pixels whose centers may be covered
+	int32_t x1 = (min_x - (scale / 2) + scale - 1) >> OD_SOFTWARE_RENDERER_SUBPIXEL_BITS;
+	int32_t y1 = (min_y - (scale / 2) + scale - 1) >> OD_SOFTWARE_RENDERER_SUBPIXEL_BITS;
+	int32_t x2 = ((max_x - (scale / 2)) >> OD_SOFTWARE_RENDERER_SUBPIXEL_BITS) + 1;
+	int32_t y2 = ((max_y - (scale / 2)) >> OD_SOFTWARE_RENDERER_SUBPIXEL_BITS) + 1;
+	x1 = (x1 < clip_x1) ? clip_x1 : x1;
+	y1 = (y1 < clip_y1) ? clip_y1 : y1;
+	x2 = (x2 > clip_x2) ? clip_x2 : x2;
+	y2 = (y2 > clip_y2) ? clip_y2 : y2;
+	if ((x1 >= x2) || (y1 >= y2)) {
+		return;
+	}
+
+	// top-left fill rule: pixel centers exactly on an edge are only covered by top or left edges
+	int64_t bias0 = odSoftwareRenderer_get_is_top_left(v1, v2) ? 0 : -1;
+	int64_t bias1 = odSoftwareRenderer_get_is_top_left(v2, v0) ? 0 : -1;
+	int64_t bias2 = odSoftwareRenderer_get_is_top_left(v0, v1) ? 0 : -1;
+
+	// edge function deltas per pixel step in x
+	int64_t step0 = -static_cast<int64_t>(v2->y - v1->y) * scale;
+	int64_t step1 = -static_cast<int64_t>(v0->y - v2->y) * scale;
+	int64_t step2 = -static_cast<int64_t>(v1->y - v0->y) * scale;
+
+	float inv_area = 1.0f / static_cast<float>(area);
+
+	odColor span[OD_SOFTWARE_RENDERER_SPAN_CAPACITY];
+	for (int32_t y = y1; y < y2; y++) {
+		int64_t center_x = (static_cast<int64_t>(x1) * scale) + (scale / 2);
+		int64_t center_y = (static_cast<int64_t>(y) * scale) + (scale / 2);
+		int64_t w0 = odSoftwareRenderer_edge(v1, v2, center_x, center_y) + bias0;
+		int64_t w1 = odSoftwareRenderer_edge(v2, v0, center_x, center_y) + bias1;
+		int64_t w2 = odSoftwareRenderer_edge(v0, v1, center_x, center_y) + bias2;
+
+		// triangles are convex, so covered pixels in a row form a single span
+		int32_t x = x1;
+		for (; (x < x2) && ((w0 | w1 | w2) < 0); x++) {
+			w0 += step0;
+			w1 += step1;
+			w2 += step2;
+		}
+
+		odColor* row = target + (static_cast<int64_t>(y) * target_width);
+		while ((x < x2) && ((w0 | w1 | w2) >= 0)) {
+			int32_t span_x = x;
+			int32_t span_count = 0;
+			for (; (x < x2) && ((w0 | w1 | w2) >= 0) && (span_count < OD_SOFTWARE_RENDERER_SPAN_CAPACITY); x++) {
+				// bias is only a tie-breaker, and is removed before interpolating
+				float l1 = static_cast<float>(w1 - bias1) * inv_area;
+				float l2 = static_cast<float>(w2 - bias2) * inv_area;
+				span[span_count] = odSoftwareRenderer_shade(v0, v1, v2, l1, l2, src_pixels, src_width, src_height);
+				span_count++;
+
+				w0 += step0;
+				w1 += step1;
+				w2 += step2;
+			}
+
+			odSoftwareRenderer_blend_span(span, row + span_x, span_count);
+		}
+	}
+}
+
+void odSoftwareRenderer_clear(odColor* target, int32_t target_width, int32_t target_height, const odColor* color) {
+	if (!OD_DEBUG_CHECK(target != nullptr)
+		|| !OD_DEBUG_CHECK(target_width >= 0)
+		|| !OD_DEBUG_CHECK(target_height >= 0)
+		|| !OD_DEBUG_CHECK(color != nullptr)) {
+		return;
+	}
+
+	int32_t count = target_width * target_height;
+	int32_t i = 0;
+
+#if defined(__SSE2__)
+	uint32_t color_packed = 0;
+	memcpy(static_cast<void*>(&color_packed), static_cast<const void*>(color), sizeof(odColor));
+	const __m128i color_pixels = _mm_set1_epi32(static_cast<int>(color_packed));
+	for (; (i + 4) <= count; i += 4) {
+		_mm_storeu_si128(static_cast<__m128i*>(static_cast<void*>(target + i)), color_pixels);
+	}
+#endif  // defined(__SSE2__)
+
+	for (; i < count; i++) {
+		target[i] = *color;
+	}
+}
+void odSoftwareRenderer_draw_vertices(odColor* target, int32_t target_width, int32_t target_height,
+									  const odVertex* vertices, int32_t vertices_count,
+									  const odRenderState* state,
+									  const odColor* src_pixels, int32_t src_width, int32_t src_height) {
+	if (!OD_DEBUG_CHECK(target != nullptr)
+		|| !OD_DEBUG_CHECK(target_width >= 0)
+		|| !OD_DEBUG_CHECK(target_height >= 0)
+		|| !OD_DEBUG_CHECK((vertices != nullptr) || (vertices_count == 0))
+		|| !OD_DEBUG_CHECK((vertices_count % 3) == 0)
+		|| !OD_DEBUG_CHECK(state != nullptr)
+		|| !OD_DEBUG_CHECK(src_pixels != nullptr)
+		|| !OD_DEBUG_CHECK(src_width > 0)
+		|| !OD_DEBUG_CHECK(src_height > 0)) {
+		return;
+	}
+
+	// opengl clips to the viewport, which we intersect with the target
+	float viewport_width = odBounds_get_width(&state->viewport);
+	float viewport_height = odBounds_get_height(&state->viewport);
+	int32_t clip_x1 = static_cast<int32_t>(state->viewport.x1);
+	int32_t clip_y1 = static_cast<int32_t>(state->viewport.y1);
+	int32_t clip_x2 = static_cast<int32_t>(state->viewport.x2);
+	int32_t clip_y2 = static_cast<int32_t>(state->viewport.y2);
+	clip_x1 = (clip_x1 < 0) ? 0 : clip_x1;
+	clip_y1 = (clip_y1 < 0) ? 0 : clip_y1;
+	clip_x2 = (clip_x2 > target_width) ? target_width : clip_x2;
+	clip_y2 = (clip_y2 > target_height) ? target_height : clip_y2;
+
+	for (int32_t i = 0; (i + 2) < vertices_count; i += 3) {
+		odSoftwareRendererVertex triangle[3];
+		for (int32_t j = 0; j < 3; j++) {
+			const odVertex* vertex = vertices + i + j;
+
+			odVector pos{vertex->pos.x, vertex->pos.y, vertex->pos.z, 1.0f};
+			odMatrix_multiply_vector(&state->view, &pos);
+			odMatrix_multiply_vector(&state->projection, &pos);
+
+			float x = state->viewport.x1 + (((pos.x + 1.0f) * 0.5f) * viewport_width);
+			float y = state->viewport.y1 + (((pos.y + 1.0f) * 0.5f) * viewport_height);
+			triangle[j] = odSoftwareRendererVertex{
+				odSoftwareRenderer_to_subpixels(x),
+				odSoftwareRenderer_to_subpixels(y),
+				static_cast<float>(vertex->color.r),
+				static_cast<float>(vertex->color.g),
+				static_cast<float>(vertex->color.b),
+				static_cast<float>(vertex->color.a),
+				vertex->u,
+				vertex->v,
+			};
+		}
+
+		odSoftwareRenderer_draw_triangle(
+			target, target_width, clip_x1, clip_y1, clip_x2, clip_y2,
+			&triangle[0], &triangle[1], &triangle[2], src_pixels, src_width, src_height);
+	}
+}
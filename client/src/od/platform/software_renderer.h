@@ -0,0 +1,18 @@
+#pragma once
+
+#include <od/platform/module.h>
+
+struct odColor;
+struct odVertex;
+struct odRenderState;
+
+// cpu rasterizer backing odRenderer for software renderer windows.
+// targets are bottom-up rows, as with opengl framebuffers and textures.
+void
+odSoftwareRenderer_clear(struct odColor* target, int32_t target_width, int32_t target_height,
+						 const struct odColor* color);
+void
+odSoftwareRenderer_draw_vertices(struct odColor* target, int32_t target_width, int32_t target_height,
+								 const struct odVertex* vertices, int32_t vertices_count,
+								 const struct odRenderState* state,
+								 const struct odColor* src_pixels, int32_t src_width, int32_t src_height);
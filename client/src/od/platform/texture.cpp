@@ -22,13 +22,18 @@ void odTexture_swap(odTexture* texture1, odTexture* texture2) {
 	memcpy(static_cast<void*>(&texture_swap), static_cast<void*>(texture1), sizeof(odTexture));
 	memcpy(static_cast<void*>(texture1), static_cast<void*>(texture2), sizeof(odTexture));
 	memcpy(static_cast<void*>(texture2), static_cast<void*>(&texture_swap), sizeof(odTexture));
+
+	// texture_swap no longer owns its contents, and must not destroy them
+	memset(static_cast<void*>(&texture_swap), 0, sizeof(odTexture));
 }
 bool odTexture_check_valid(const odTexture* texture) {
 	if (!OD_CHECK(texture != nullptr)
 		|| !OD_CHECK(odWindow_check_valid(texture->window))
-		|| !OD_CHECK(texture->texture > 0)
+		|| !OD_CHECK((texture->texture > 0) || odWindow_is_headless(texture->window))
 		|| !OD_CHECK(texture->width > 0)
-		|| !OD_CHECK(texture->height > 0)) {
+		|| !OD_CHECK(texture->height > 0)
+		|| !OD_CHECK(!odWindow_is_software_renderer_enabled(texture->window)
+			|| (texture->pixels.get_count() == (texture->width * texture->height)))) {
 		return false;
 	}
 
@@ -59,6 +64,26 @@ bool odTexture_init(odTexture* texture, odWindow* window,
 		return false;
 	}
 
+	if (odWindow_is_software_renderer_enabled(window)) {
+		int32_t pixels_count = width * height;
+		if (opt_pixels != nullptr) {
+			if (!OD_CHECK(texture->pixels.assign(opt_pixels, pixels_count))) {
+				return false;
+			}
+		} else {
+			if (!OD_CHECK(texture->pixels.set_count(pixels_count))) {
+				return false;
+			}
+			memset(static_cast<void*>(texture->pixels.begin()), 0, sizeof(odColor) * static_cast<size_t>(pixels_count));
+		}
+	}
+
+	if (odWindow_is_headless(window)) {
+		texture->width = width;
+		texture->height = height;
+		return true;
+	}
+
 	odWindowScope window_scope;
 	if (!OD_CHECK(odWindowScope_bind(&window_scope, texture->window))) {
 		return false;
@@ -113,6 +138,7 @@ void odTexture_destroy(odTexture* texture) {
 	texture->height = 0;
 	texture->width = 0;
 	texture->texture = 0;
+	OD_DISCARD(OD_CHECK(texture->pixels.set_capacity(0)));
 
 	odWindowResource_destroy(texture);
 }
@@ -135,9 +161,9 @@ bool odTexture_get_size(const odTexture* texture, int32_t* out_opt_width, int32_
 }
 
 odTexture::odTexture()
-	: odWindowResource{}, texture{0} {
+	: odWindowResource{}, texture{0}, width{0}, height{0}, pixels{} {
 }
-odTexture::odTexture(odTexture&& other) {
+odTexture::odTexture(odTexture&& other) : odTexture{} {
 	odTexture_swap(this, &other);
 }
 odTexture& odTexture::operator=(odTexture&& other) {
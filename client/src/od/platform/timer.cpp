@@ -1,47 +1,47 @@
 #include <od/platform/timer.h>
 
-#include <ctime>
-#include <cstring>
+#include <chrono>
 
 #include <od/core/debug.h>
 
+int64_t odTimer_get_now_ns(void) {
+	return static_cast<int64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+}
 void odTimer_start(odTimer* timer) {
 	if (!OD_DEBUG_CHECK(timer != nullptr)) {
 		return;
 	}
 
-	timer->start_time = time(nullptr);
+	timer->start_ns = odTimer_get_now_ns();
+}
+int64_t odTimer_get_elapsed_ns(const odTimer* timer) {
+	if (!OD_DEBUG_CHECK(timer != nullptr)) {
+		return 0;
+	}
+
+	return odTimer_get_now_ns() - timer->start_ns;
 }
 float odTimer_get_elapsed_seconds(const odTimer* timer) {
 	if (!OD_DEBUG_CHECK(timer != nullptr)) {
 		return 0.0f;
 	}
 
-	time_t time_now = time(nullptr);
-	return static_cast<float>(difftime(time_now, timer->start_time));
+	return static_cast<float>(static_cast<double>(odTimer_get_elapsed_ns(timer)) / 1e9);
 }
 void odTimer_warn_if_exceeded(const odTimer* timer, float max_time_seconds, const struct odLogContext* log_context) {
 	if (!OD_DEBUG_CHECK(timer != nullptr)) {
 		return;
 	}
 
-	time_t time_now = time(nullptr);
-	char time_now_str[9] = {};
-	strncpy(time_now_str, ctime(&time_now) + 11, 9);
-
-	char start_time_str[9] = {};
-	strncpy(start_time_str, ctime(&timer->start_time) + 11, 9);
-
-	float time_passed = static_cast<float>(difftime(time_now, timer->start_time));
-
+	float time_passed = odTimer_get_elapsed_seconds(timer);
 	if (time_passed > max_time_seconds) {
 		odLog_log(
 			log_context,
 			OD_LOG_LEVEL_WARN,
-			"timer exceeded %g second(s), start_time=%.8s, time_passed~%g second(s), now=%.8s",
+			"timer exceeded %g second(s), time_passed=%g second(s)",
 			static_cast<double>(max_time_seconds),
-			start_time_str,
-			static_cast<double>(time_passed),
-			time_now_str);
+			static_cast<double>(time_passed));
 	}
 }
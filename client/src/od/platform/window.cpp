@@ -1,5 +1,6 @@
 #include <od/platform/window.hpp>
 
+#include <algorithm>
 #include <cstring>
 
 #include <SDL2/SDL.h>
@@ -11,6 +12,7 @@
 #include <od/core/debug.h>
 #include <od/core/math.h>
 #include <od/core/type.hpp>
+#include <od/platform/profile.h>
 #include <od/platform/sdl.h>
 
 OD_NO_DISCARD static bool
@@ -18,6 +20,13 @@ odWindow_try_set_vsync_enabled(odWindow* window);
 OD_NO_DISCARD static bool
 odWindow_set_caption(odWindow* window, const char* caption);
 
+// time before a frame deadline which is busy-waited rather than slept, as sleep wakeups are imprecise
+static const int32_t odWindow_frame_spin_ms = 2;
+
+static const uint8_t odWindow_key_event_pressed = 1 << 0;
+static const uint8_t odWindow_key_event_released = 1 << 1;
+static const uint8_t odWindow_key_event_down = 1 << 2;  // kept between steps, unlike pressed/released
+
 const char* odWindowSettings_get_debug_string(const odWindowSettings* settings) {
 	if (settings == nullptr) {
 		return "null";
@@ -25,14 +34,17 @@ const char* odWindowSettings_get_debug_string(const odWindowSettings* settings)
 
 	return odDebugString_format(
 		"{\"caption\": %s, \"width\": %d, \"height\": %d, \"fps_limit\": %d, "
-		"\"is_fps_limit_enabled\": %d, \"is_vsync_enabled\": %d, \"is_visible\": %d}",
+		"\"is_fps_limit_enabled\": %d, \"is_vsync_enabled\": %d, \"is_visible\": %d, \"is_headless\": %d, "
+		"\"is_software_renderer_enabled\": %d}",
 		settings->caption,
 		settings->width,
 		settings->height,
 		settings->fps_limit,
 		static_cast<int>(settings->is_fps_limit_enabled),
 		static_cast<int>(settings->is_vsync_enabled),
-		static_cast<int>(settings->is_visible)
+		static_cast<int>(settings->is_visible),
+		static_cast<int>(settings->is_headless),
+		static_cast<int>(settings->is_software_renderer_enabled)
 	);
 }
 const odWindowSettings* odWindowSettings_get_defaults() {
@@ -44,6 +56,8 @@ const odWindowSettings* odWindowSettings_get_defaults() {
 		/*is_fps_limit_enabled*/ true,
 		/*is_vsync_enabled"*/ true,
 		/*is_visible*/ true,
+		/*is_headless*/ false,
+		/*is_software_renderer_enabled*/ false,
 	};
 	return &settings;
 }
@@ -56,6 +70,22 @@ const odWindowSettings* odWindowSettings_get_headless_defaults() {
 		/*is_fps_limit_enabled*/ false,
 		/*is_vsync_enabled"*/ false,
 		/*is_visible*/ false,
+		/*is_headless*/ true,
+		/*is_software_renderer_enabled*/ false,
+	};
+	return &settings;
+}
+const odWindowSettings* odWindowSettings_get_hidden_defaults() {
+	static const odWindowSettings settings{
+		/*caption*/ "",
+		/*width*/ 640,
+		/*height*/ 480,
+		/*fps_limit*/ 60,
+		/*is_fps_limit_enabled*/ false,
+		/*is_vsync_enabled"*/ false,
+		/*is_visible*/ false,
+		/*is_headless*/ false,
+		/*is_software_renderer_enabled*/ false,
 	};
 	return &settings;
 }
@@ -66,13 +96,31 @@ bool odWindowSettings_check_valid(const odWindowSettings* settings) {
 		|| !OD_CHECK(odInt32_fits_float(settings->height))
 		|| !OD_CHECK(settings->height > 0)
 		|| !OD_CHECK(settings->fps_limit > 0)
-		|| !OD_CHECK(settings->fps_limit <= 120)) {
+		|| !OD_CHECK(settings->fps_limit <= 120)
+		|| !OD_CHECK(!settings->is_software_renderer_enabled || settings->is_headless)) {
 		return false;
 	}
 
 	return true;
 }
 
+const char* odWindowFrameStats_get_debug_string(const odWindowFrameStats* stats) {
+	if (stats == nullptr) {
+		return "null";
+	}
+
+	return odDebugString_format(
+		"{\"frame_count\": %d, \"missed_frame_count\": %d, \"last_frame_ms\": %g, \"mean_frame_ms\": %g, "
+		"\"p99_frame_ms\": %g, \"max_frame_ms\": %g}",
+		stats->frame_count,
+		stats->missed_frame_count,
+		static_cast<double>(stats->last_frame_ms),
+		static_cast<double>(stats->mean_frame_ms),
+		static_cast<double>(stats->p99_frame_ms),
+		static_cast<double>(stats->max_frame_ms)
+	);
+}
+
 const odType* odWindow_get_type_constructor() {
 	return odType_get<odWindow>();
 }
@@ -84,18 +132,20 @@ void odWindow_swap(odWindow* window1, odWindow* window2) {
 
 	void* window_native_swap = window1->window_native;
 	bool is_open_swap = window1->is_open;
-	int32_t next_frame_ms_swap = window1->next_frame_ms;
+	odWindowFramePacer frame_pacer_swap = window1->frame_pacer;
 	odWindowSettings settings_swap = window1->settings;
 
 	window1->window_native = window2->window_native;
 	window1->is_open = window2->is_open;
-	window1->next_frame_ms = window2->next_frame_ms;
+	window1->frame_pacer = window2->frame_pacer;
 	window1->settings = window2->settings;
 
 	window2->window_native = window_native_swap;
 	window2->is_open = is_open_swap;
-	window2->next_frame_ms = next_frame_ms_swap;
+	window2->frame_pacer = frame_pacer_swap;
 	window2->settings = settings_swap;
+
+	odTrivialArray_swap(&window1->software_framebuffer, &window2->software_framebuffer);
 }
 const char* odWindow_get_debug_string(const odWindow* window) {
 	if (window == nullptr) {
@@ -109,13 +159,19 @@ const char* odWindow_get_debug_string(const odWindow* window) {
 }
 bool odWindow_check_valid(const odWindow* window) {
 	if (!OD_CHECK(window != nullptr)
-		|| !OD_CHECK((!window->is_open) || (window->window_native != nullptr))
-		|| !OD_CHECK((!window->is_open) || (window->render_context_native != nullptr))) {
+		|| !OD_CHECK((!window->is_open) || window->settings.is_headless || (window->window_native != nullptr))
+		|| !OD_CHECK((!window->is_open) || window->settings.is_headless || (window->render_context_native != nullptr))) {
 		return false;
 	}
 
 	return true;
 }
+bool odWindow_is_headless(const odWindow* opt_window) {
+	return (opt_window != nullptr) && opt_window->settings.is_headless;
+}
+bool odWindow_is_software_renderer_enabled(const odWindow* opt_window) {
+	return (opt_window != nullptr) && opt_window->settings.is_software_renderer_enabled;
+}
 static bool odWindow_set_context_impl(void* window_native, void* render_context_native) {
 	if (!OD_CHECK(window_native != nullptr)
 		|| !OD_CHECK(render_context_native != nullptr)) {
@@ -213,6 +269,22 @@ bool odWindow_init(odWindow* window, const odWindowSettings* opt_settings) {
 		window->settings = *opt_settings;
 	}
 
+	if (window->settings.is_headless) {
+		window->settings.is_vsync_enabled = false;
+		window->is_open = true;
+
+		if (window->settings.is_software_renderer_enabled) {
+			int32_t pixels_count = window->settings.width * window->settings.height;
+			if (!OD_CHECK(window->software_framebuffer.set_count(pixels_count))) {
+				return false;
+			}
+			memset(static_cast<void*>(window->software_framebuffer.begin()), 0, sizeof(odColor) * static_cast<size_t>(pixels_count));
+		}
+
+		OD_DEBUG("Headless window opened");
+		return true;
+	}
+
 	window->is_sdl_init = odSDL_init_reentrant();
 	if (!OD_CHECK(window->is_sdl_init)) {
 		return false;
@@ -291,10 +363,13 @@ void odWindow_destroy(odWindow* window) {
 	OD_DISCARD(OD_CHECK(window->resources.set_count(0)));
 
 	window->mouse_state = odWindowMouseState{};
+	memset(window->key_events, 0, sizeof(window->key_events));
 
-	window->next_frame_ms = 0;
+	window->frame_pacer = odWindowFramePacer{};
 	window->is_open = false;
 
+	OD_DISCARD(OD_CHECK(window->software_framebuffer.set_capacity(0)));
+
 	if (window->is_sdl_init) {
 		odSDL_destroy_reentrant();
 	}
@@ -328,6 +403,20 @@ void* odWindow_prepare_render_context(odWindow* window) {
 
 	return window->render_context_native;
 }
+static void odWindow_add_key_event(odWindow* window, SDL_Scancode scancode, uint8_t key_event, bool is_down) {
+	const int32_t key_handle = static_cast<int32_t>(scancode);
+	if ((key_handle <= 0) || (key_handle >= OD_WINDOW_KEY_COUNT)) {
+		return;
+	}
+
+	uint8_t key_events = static_cast<uint8_t>(window->key_events[key_handle] | key_event);
+	if (is_down) {
+		key_events = static_cast<uint8_t>(key_events | odWindow_key_event_down);
+	} else {
+		key_events = static_cast<uint8_t>(key_events & ~odWindow_key_event_down);
+	}
+	window->key_events[key_handle] = key_events;
+}
 OD_NO_DISCARD static bool odWindow_handle_event(odWindow* window, const SDL_Event *event) {
 	if (!OD_CHECK(!window->is_open || odWindow_check_valid(window))) {
 		return false;
@@ -361,6 +450,8 @@ OD_NO_DISCARD static bool odWindow_handle_event(odWindow* window, const SDL_Even
 		case SDL_KEYUP: {
 			OD_DEBUG("SDL_KEYUP, key=%s", SDL_GetKeyName(event->key.keysym.sym));
 
+			odWindow_add_key_event(window, event->key.keysym.scancode, odWindow_key_event_released, /*is_down*/ false);
+
 			switch (event->key.keysym.sym) {
 				case SDLK_ESCAPE: {
 					OD_DEBUG("Escape key released");
@@ -376,6 +467,7 @@ OD_NO_DISCARD static bool odWindow_handle_event(odWindow* window, const SDL_Even
 		case SDL_KEYDOWN: {
 			if (event->key.repeat == 0) {
 				OD_DEBUG("SDL_KEYDOWN, key=%s", SDL_GetKeyName(event->key.keysym.sym));
+				odWindow_add_key_event(window, event->key.keysym.scancode, odWindow_key_event_pressed, /*is_down*/ true);
 			} else {
 				OD_TRACE("SDL_KEYDOWN, key=%s, repeat=%d", SDL_GetKeyName(event->key.keysym.sym), static_cast<int32_t>(event->key.repeat));
 			}
@@ -419,35 +511,87 @@ OD_NO_DISCARD static bool odWindow_handle_event(odWindow* window, const SDL_Even
 	}
 	return true;
 }
+static void odWindow_add_frame(odWindow* window, uint64_t frame_counter) {
+	odWindowFramePacer* pacer = &window->frame_pacer;
+
+	if (pacer->last_frame_counter != 0) {
+		uint64_t frequency = SDL_GetPerformanceFrequency();
+		float frame_ms = static_cast<float>(
+			(static_cast<double>(frame_counter - pacer->last_frame_counter) * 1000.0)
+			/ static_cast<double>(frequency));
+
+		if (window->settings.is_fps_limit_enabled
+			&& (frame_ms > (1500.0f / static_cast<float>(window->settings.fps_limit)))) {
+			pacer->missed_frame_count++;
+		}
+
+		pacer->frame_durations_ms[pacer->frame_count % OD_WINDOW_FRAME_HISTORY_COUNT] = frame_ms;
+		pacer->frame_count++;
+	}
+
+	pacer->last_frame_counter = frame_counter;
+
+	odProfile_end_frame();
+}
 OD_NO_DISCARD static bool odWindow_wait_step(odWindow* window) {
 	if (!OD_CHECK(!window->is_open || odWindow_check_valid(window))) {
 		return false;
 	}
 
+	uint64_t time_counter = SDL_GetPerformanceCounter();
+
 	if (!window->settings.is_fps_limit_enabled || window->settings.is_vsync_enabled) {
+		odWindow_add_frame(window, time_counter);
 		return true;
 	}
 
-	int32_t frame_duration_ms = 1000 / window->settings.fps_limit;
-	int32_t time_ms = static_cast<int32_t>(SDL_GetTicks());
-	int32_t wait_ms = window->next_frame_ms - time_ms;
+	odWindowFramePacer* pacer = &window->frame_pacer;
 
-	// guard against wait_ms underflowing
-	if (time_ms > window->next_frame_ms) {
-		wait_ms = 0;
-		window->next_frame_ms = time_ms;
+	// frequency is rarely a multiple of fps_limit; carry the fractional part between frames to avoid drift
+	uint64_t frequency = SDL_GetPerformanceFrequency();
+	uint64_t fps_limit = static_cast<uint64_t>(window->settings.fps_limit);
+	uint64_t frame_duration = frequency / fps_limit;
+	pacer->frame_remainder_counter += frequency % fps_limit;
+	if (pacer->frame_remainder_counter >= fps_limit) {
+		pacer->frame_remainder_counter -= fps_limit;
+		frame_duration++;
+	}
+
+	// guard against falling behind by over a frame, e.g. after a stall; skip ahead rather than catch up
+	if (time_counter > (pacer->next_frame_counter + frame_duration)) {
+		pacer->next_frame_counter = time_counter;
 	}
 
 	// guard against waiting more than the full frame duration
-	if (wait_ms > frame_duration_ms) {
-		wait_ms = frame_duration_ms;
-		window->next_frame_ms = time_ms;
+	if (pacer->next_frame_counter > (time_counter + frame_duration)) {
+		pacer->next_frame_counter = time_counter;
 	}
 
-	if (wait_ms >= 1) {
-		odSDL_sleep(wait_ms);
+	if (pacer->next_frame_counter > time_counter) {
+		uint64_t wait_counter = pacer->next_frame_counter - time_counter;
+		uint64_t spin_counter = (frequency * static_cast<uint64_t>(odWindow_frame_spin_ms)) / 1000;
+
+		if (OD_BUILD_EMSCRIPTEN) {
+			spin_counter = 0;
+		}
+
+		if (wait_counter > spin_counter) {
+			int32_t sleep_ms = static_cast<int32_t>(((wait_counter - spin_counter) * 1000) / frequency);
+			if (sleep_ms >= 1) {
+				odSDL_sleep(sleep_ms);
+			}
+		}
+
+		if (!OD_BUILD_EMSCRIPTEN) {
+			while (SDL_GetPerformanceCounter() < pacer->next_frame_counter) {
+			}
+		}
+
+		time_counter = SDL_GetPerformanceCounter();
 	}
-	window->next_frame_ms += frame_duration_ms;
+	pacer->next_frame_counter += frame_duration;
+
+	odWindow_add_frame(window, time_counter);
 
 	return true;
 }
@@ -457,12 +601,20 @@ bool odWindow_step(odWindow* window) {
 		return false;
 	}
 
+	if (window->settings.is_headless) {
+		return odWindow_wait_step(window);
+	}
+
 	SDL_GL_SwapWindow(static_cast<SDL_Window*>(window->window_native));
 
 	if (!OD_CHECK(odWindow_wait_step(window))) {
 		return false;
 	}
 
+	for (uint8_t& key_events: window->key_events) {
+		key_events = static_cast<uint8_t>(key_events & odWindow_key_event_down);
+	}
+
 	SDL_Event event;
 	while (SDL_PollEvent(&event)) {
 		if (!OD_CHECK(odWindow_handle_event(window, &event))) {
@@ -504,6 +656,11 @@ bool odWindow_set_visible(odWindow* window, bool is_visible) {
 		return true;
 	}
 
+	if (window->settings.is_headless) {
+		window->settings.is_visible = is_visible;
+		return true;
+	}
+
 	if (is_visible) {
 		SDL_ShowWindow(static_cast<SDL_Window*>(window->window_native));
 	} else {
@@ -525,6 +682,13 @@ bool odWindow_set_size(odWindow* window, int32_t width, int32_t height) {
 		return true;
 	}
 
+	if (window->settings.is_software_renderer_enabled) {
+		if (!OD_CHECK(window->software_framebuffer.set_count(width * height))) {
+			return false;
+		}
+		memset(static_cast<void*>(window->software_framebuffer.begin()), 0, sizeof(odColor) * static_cast<size_t>(width * height));
+	}
+
 	window->settings.width = width;
 	window->settings.height = height;
 
@@ -542,6 +706,10 @@ bool odWindow_try_set_vsync_enabled(odWindow* window) {
 		return false;
 	}
 
+	if (window->settings.is_headless) {
+		return false;
+	}
+
 	if (SDL_GL_GetSwapInterval() != 1) {
 		if (SDL_GL_SetSwapInterval(1) < 0) {
 			OD_INFO("SDL_GL_SetSwapInterval toggle failed, message=\"%s\"\n", SDL_GetError());
@@ -561,7 +729,7 @@ static bool odWindow_set_caption(odWindow* window, const char* caption) {
 
 	SDL_Window* sdl_window = static_cast<SDL_Window*>(window->window_native);
 
-	if (strcmp(window->settings.caption, caption) != 0) {
+	if (!window->settings.is_headless && (strcmp(window->settings.caption, caption) != 0)) {
 		SDL_SetWindowTitle(sdl_window, caption);
 	}
 
@@ -580,7 +748,9 @@ bool odWindow_set_settings(odWindow* window, const odWindowSettings* settings) {
 		return true;
 	}
 
-	if (!OD_CHECK(odWindow_check_valid(window))) {
+	if (!OD_CHECK(odWindow_check_valid(window))
+		|| !OD_CHECK(settings->is_headless == window->settings.is_headless)
+		|| !OD_CHECK(settings->is_software_renderer_enabled == window->settings.is_software_renderer_enabled)) {
 		return false;
 	}
 
@@ -623,8 +793,22 @@ void odWindow_get_mouse_state(const odWindow* window, odWindowMouseState* out_mo
 	*out_mouse_state = window->mouse_state;
 }
 bool odWindow_get_key_state(const odWindow* window, const char* key_name) {
+	int32_t key_handle = 0;
+	if (!OD_CHECK(odWindow_get_key_handle(window, key_name, &key_handle))) {
+		return false;
+	}
+
+	odWindowKeyState key_state{};
+	if (!OD_CHECK(odWindow_get_key_states(window, &key_handle, 1, &key_state))) {
+		return false;
+	}
+
+	return key_state.is_down;
+}
+bool odWindow_get_key_handle(const odWindow* window, const char* key_name, int32_t* out_key_handle) {
 	if (!OD_CHECK(!window->is_open || odWindow_check_valid(window))
-		|| !OD_CHECK(key_name != nullptr)) {
+		|| !OD_CHECK(key_name != nullptr)
+		|| !OD_CHECK(out_key_handle != nullptr)) {
 		return false;
 	}
 
@@ -632,23 +816,101 @@ bool odWindow_get_key_state(const odWindow* window, const char* key_name) {
 	if (!OD_CHECK(key != SDLK_UNKNOWN)) {
 		return false;
 	}
+
+	// the keymap is only populated once sdl video is initialized, so headless windows fall back to the name
 	SDL_Scancode scancode = SDL_GetScancodeFromKey(key);
+	if (scancode == SDL_SCANCODE_UNKNOWN) {
+		scancode = SDL_GetScancodeFromName(key_name);
+	}
 
-	if (SDL_GetKeyboardFocus() != static_cast<SDL_Window*>(window->window_native)) {
+	// keys without a scancode get the unknown handle, which is never down
+	*out_key_handle = static_cast<int32_t>(scancode);
+	if ((*out_key_handle < 0) || (*out_key_handle >= OD_WINDOW_KEY_COUNT)) {
+		*out_key_handle = static_cast<int32_t>(SDL_SCANCODE_UNKNOWN);
+	}
+	return true;
+}
+bool odWindow_get_key_states(const odWindow* window, const int32_t* key_handles, int32_t key_handles_count,
+							 odWindowKeyState* out_key_states) {
+	if (!OD_CHECK(!window->is_open || odWindow_check_valid(window))
+		|| !OD_CHECK((key_handles != nullptr) || (key_handles_count == 0))
+		|| !OD_CHECK(key_handles_count >= 0)
+		|| !OD_CHECK((out_key_states != nullptr) || (key_handles_count == 0))) {
 		return false;
 	}
 
-	int num_keys = 0;
-	const Uint8* scancode_states = SDL_GetKeyboardState(&num_keys);
-	if (!OD_CHECK(scancode < num_keys)) {
-		return false;
+	for (int32_t i = 0; i < key_handles_count; i++) {
+		if (!OD_CHECK((key_handles[i] >= 0) && (key_handles[i] < OD_WINDOW_KEY_COUNT))) {
+			return false;
+		}
+	}
+
+	// down is tracked from key events rather than SDL_GetKeyboardState(), so it always agrees with
+	// pressed/released; sdl sends key ups for held keys when focus is lost
+	for (int32_t i = 0; i < key_handles_count; i++) {
+		const int32_t key_handle = key_handles[i];
+		const uint8_t key_events = window->key_events[key_handle];
+
+		out_key_states[i] = odWindowKeyState{
+			(key_handle > 0) && ((key_events & odWindow_key_event_down) != 0),
+			(key_events & odWindow_key_event_pressed) != 0,
+			(key_events & odWindow_key_event_released) != 0
+		};
+	}
+
+	return true;
+}
+void odWindow_get_frame_stats(const odWindow* window, odWindowFrameStats* out_stats) {
+	if (!OD_CHECK(window != nullptr)
+		|| !OD_CHECK(out_stats != nullptr)) {
+		return;
+	}
+
+	const odWindowFramePacer* pacer = &window->frame_pacer;
+
+	*out_stats = odWindowFrameStats{};
+	out_stats->frame_count = pacer->frame_count;
+	out_stats->missed_frame_count = pacer->missed_frame_count;
+
+	int32_t history_count = pacer->frame_count;
+	if (history_count > OD_WINDOW_FRAME_HISTORY_COUNT) {
+		history_count = OD_WINDOW_FRAME_HISTORY_COUNT;
+	}
+
+	if (history_count == 0) {
+		return;
+	}
+
+	out_stats->last_frame_ms = pacer->frame_durations_ms[(pacer->frame_count - 1) % OD_WINDOW_FRAME_HISTORY_COUNT];
+
+	float frame_durations_ms[OD_WINDOW_FRAME_HISTORY_COUNT];
+	float total_ms = 0.0f;
+	for (int32_t i = 0; i < history_count; i++) {
+		frame_durations_ms[i] = pacer->frame_durations_ms[i];
+		total_ms += frame_durations_ms[i];
+	}
+	std::sort(frame_durations_ms, frame_durations_ms + history_count);
+
+	out_stats->mean_frame_ms = total_ms / static_cast<float>(history_count);
+	out_stats->p99_frame_ms = frame_durations_ms[((history_count - 1) * 99) / 100];
+	out_stats->max_frame_ms = frame_durations_ms[history_count - 1];
+}
+float odWindow_get_last_frame_ms(const odWindow* window) {
+	if (!OD_DEBUG_CHECK(window != nullptr)) {
+		return 0.0f;
+	}
+
+	const odWindowFramePacer* pacer = &window->frame_pacer;
+	if (pacer->frame_count == 0) {
+		return 0.0f;
 	}
 
-	return scancode_states[scancode];
+	return pacer->frame_durations_ms[(pacer->frame_count - 1) % OD_WINDOW_FRAME_HISTORY_COUNT];
 }
 odWindow::odWindow()
 	: settings{*odWindowSettings_get_defaults()}, window_native{nullptr}, render_context_native{nullptr},
-	is_sdl_init{false}, is_open{false}, next_frame_ms{0}, mouse_state{}, resources{} {
+	is_sdl_init{false}, is_open{false}, frame_pacer{}, mouse_state{}, key_events{}, resources{},
+	software_framebuffer{} {
 }
 odWindow::odWindow(odWindow&& other) : odWindow{} {
 	odWindow_swap(this, &other);
@@ -663,7 +925,7 @@ odWindow::~odWindow() {
 
 OD_NO_DISCARD bool odWindowResource_init(odWindowResource* resource, odWindow* opt_window) {
 	if (!OD_CHECK(resource != nullptr)
-		|| !OD_CHECK(opt_window == nullptr || (opt_window->window_native != nullptr))) {
+		|| !OD_CHECK(opt_window == nullptr || opt_window->settings.is_headless || (opt_window->window_native != nullptr))) {
 		return false;
 	}
 
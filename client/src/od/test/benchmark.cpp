@@ -0,0 +1,399 @@
+#include <od/test/benchmark.hpp>
+
+#include <cstring>
+#include <cstdlib>
+
+#include <od/core/allocation.hpp>
+#include <od/core/array.hpp>
+#include <od/core/string.hpp>
+#include <od/platform/file.h>
+#include <od/platform/timer.h>
+#include <od/test/test.hpp>
+
+struct odBenchmarkResult {
+	const char* name;
+	const char* suite_name;
+	int32_t samples;
+	int64_t min_ns;
+	int64_t median_ns;
+	int64_t p95_ns;
+	int64_t mean_ns;
+};
+
+static int odBenchmark_compare_ns(const void* a, const void* b) {
+	int64_t a_ns = *static_cast<const int64_t*>(a);
+	int64_t b_ns = *static_cast<const int64_t*>(b);
+	return (a_ns > b_ns) - (a_ns < b_ns);
+}
+static void odBenchmarkResult_init(odBenchmarkResult* result, odBenchmarkRun* run) {
+	int32_t samples = run->sample_count;
+	result->samples = samples;
+	if (samples == 0) {
+		return;
+	}
+
+	qsort(run->samples_ns, static_cast<size_t>(samples), sizeof(int64_t), odBenchmark_compare_ns);
+
+	int64_t total_ns = 0;
+	for (int32_t i = 0; i < samples; i++) {
+		total_ns += run->samples_ns[i];
+	}
+
+	int32_t p95_index = ((samples * 95) + 99) / 100 - 1;
+	result->min_ns = run->samples_ns[0];
+	result->median_ns = run->samples_ns[samples / 2];
+	result->p95_ns = run->samples_ns[(p95_index > 0) ? p95_index : 0];
+	result->mean_ns = total_ns / samples;
+}
+static bool odBenchmark_write_json(const char* path, const odTrivialArrayT<odBenchmarkResult>* results) {
+	odString json;
+	if (!OD_CHECK(json.extend("{\"benchmarks\":[\n"))) {
+		return false;
+	}
+
+	int32_t results_count = results->get_count();
+	for (int32_t i = 0; i < results_count; i++) {
+		const odBenchmarkResult* result = results->get(i);
+		if (!OD_CHECK(odString_extend_formatted(
+				&json,
+				"{\"name\":\"%s\",\"suite\":\"%s\",\"samples\":%d,"
+				"\"min_ns\":%lld,\"median_ns\":%lld,\"p95_ns\":%lld,\"mean_ns\":%lld}%s\n",
+				result->name,
+				result->suite_name,
+				result->samples,
+				static_cast<long long>(result->min_ns),
+				static_cast<long long>(result->median_ns),
+				static_cast<long long>(result->p95_ns),
+				static_cast<long long>(result->mean_ns),
+				(i + 1 < results_count) ? "," : ""))) {
+			return false;
+		}
+	}
+
+	if (!OD_CHECK(json.extend("]}\n"))) {
+		return false;
+	}
+
+	if (!OD_CHECK(odFile_write_all(path, "wb", json.begin(), json.get_count()))) {
+		return false;
+	}
+
+	OD_INFO("Benchmark results written, path=%s, benchmarks=%d", path, results_count);
+	return true;
+}
+/* Only reads files in the format written by odBenchmark_write_json: each benchmark's name
+is followed by its median in the same object. Returns false if the benchmark is not in the baseline,
+or its median is missing or not a non-negative integer. */
+static bool odBenchmark_get_baseline_median_ns(const char* baseline, const char* name, int64_t* out_median_ns) {
+	const char name_key[] = "\"name\":\"";
+	const char median_key[] = "\"median_ns\":";
+	size_t name_size = strlen(name);
+
+	for (const char* iter = strstr(baseline, name_key); iter != nullptr; iter = strstr(iter, name_key)) {
+		iter += sizeof(name_key) - 1;
+		if ((strncmp(iter, name, name_size) != 0) || (iter[name_size] != '"')) {
+			continue;
+		}
+
+		const char* object_end = strchr(iter, '}');
+		const char* median = strstr(iter, median_key);
+		if ((median == nullptr) || ((object_end != nullptr) && (median > object_end))) {
+			return false;
+		}
+
+		const char* median_str = median + sizeof(median_key) - 1;
+		char* median_end = nullptr;
+		long long median_ns = strtoll(median_str, &median_end, 10);
+		if ((median_end == median_str) || (median_ns < 0)) {
+			return false;
+		}
+
+		*out_median_ns = static_cast<int64_t>(median_ns);
+		return true;
+	}
+
+	return false;
+}
+static bool odBenchmark_compare_baseline(
+	const char* baseline_path, int32_t max_regression_percent, const odTrivialArrayT<odBenchmarkResult>* results) {
+	odAllocation allocation;
+	int32_t size = 0;
+	if (!OD_CHECK(odFile_read_all(baseline_path, "rb", &allocation, &size))) {
+		OD_ERROR("Failed to read benchmark baseline, path=%s", baseline_path);
+		return false;
+	}
+
+	odString baseline;
+	if (!OD_CHECK(baseline.extend(static_cast<const char*>(odAllocation_get(&allocation)), size))) {
+		return false;
+	}
+	const char* baseline_str = odString_get_c_str(&baseline);
+
+	bool ok = true;
+	for (const odBenchmarkResult& result: *results) {
+		int64_t baseline_ns = 0;
+		if (!odBenchmark_get_baseline_median_ns(baseline_str, result.name, &baseline_ns)) {
+			OD_INFO("Benchmark \"%s\" not in baseline", result.name);
+			continue;
+		}
+
+		// no relative change from a zero median, so any slower median is past any threshold
+		if (baseline_ns == 0) {
+			if (result.median_ns > 0) {
+				OD_WARN(
+					"Benchmark \"%s\" regressed, median %lldns vs baseline 0ns",
+					result.name,
+					static_cast<long long>(result.median_ns));
+				ok = false;
+			}
+			continue;
+		}
+
+		double change_percent = (100.0 * static_cast<double>(result.median_ns - baseline_ns)) / static_cast<double>(baseline_ns);
+		if (change_percent > static_cast<double>(max_regression_percent)) {
+			OD_WARN(
+				"Benchmark \"%s\" regressed, median %+.1f%% vs baseline (max %d%%)",
+				result.name,
+				change_percent,
+				max_regression_percent);
+			ok = false;
+			continue;
+		}
+
+		OD_INFO("Benchmark \"%s\" median %+.1f%% vs baseline", result.name, change_percent);
+	}
+
+	return ok;
+}
+
+bool odBenchmark_run(const odBenchmarkSettings* settings) {
+	static const odBenchmarkSuite benchmark_suites[] = {
+		odBenchmarkSuite_odArray(),
+
+		odBenchmarkSuite_odAsciiFont(),
+		odBenchmarkSuite_odPrimitive(),
+		odBenchmarkSuite_odRenderer(),
+
+		odBenchmarkSuite_odAtlas(),
+		odBenchmarkSuite_odEntityIndex(),
+		odBenchmarkSuite_odTagset(),
+	};
+
+	if (!OD_CHECK(settings != nullptr)) {
+		return false;
+	}
+
+	OD_INFO("Running client c++ benchmarks");
+	if (OD_BUILD_DEBUG) {
+		OD_WARN("Benchmarking a build with debug checks; use a release build with tests for representative results");
+	}
+
+	odTrivialArrayT<odBenchmarkResult> results;
+	odBenchmarkRun run{};
+	for (odBenchmarkSuite suite: benchmark_suites) {
+		for (int32_t i = 0; i < suite.benchmarks_count; i++) {
+			odBenchmark benchmark = suite.benchmarks[i];
+
+			if ((settings->name_filter != nullptr) && (strstr(benchmark.name, settings->name_filter) == nullptr)) {
+				OD_DEBUG("Skipping client c++ benchmark \"%s\"", benchmark.name);
+				continue;
+			}
+
+			if (!OD_CHECK(benchmark.sample_count > 0)
+				|| !OD_CHECK(benchmark.sample_count <= OD_BENCHMARK_SAMPLE_CAPACITY)
+				|| !OD_CHECK(benchmark.warmup_count >= 0)) {
+				return false;
+			}
+
+			run.warmup_count = benchmark.warmup_count;
+			run.sample_count = benchmark.sample_count;
+			run.iteration = 0;
+			run.start_ns = 0;
+
+			int32_t logged_errors_before = odLog_get_logged_error_count();
+			benchmark.fn(&run);
+			if (odLog_get_logged_error_count() != logged_errors_before) {
+				OD_ERROR("Failed client c++ benchmark \"%s\"", benchmark.name);
+				return false;
+			}
+			if (!OD_CHECK(run.iteration > (run.warmup_count + run.sample_count))) {
+				OD_ERROR("Client c++ benchmark \"%s\" ended before taking all samples", benchmark.name);
+				return false;
+			}
+
+			odBenchmarkResult result{benchmark.name, suite.name, 0, 0, 0, 0, 0};
+			odBenchmarkResult_init(&result, &run);
+			if (!OD_CHECK(results.push(result))) {
+				return false;
+			}
+
+			OD_INFO(
+				"Benchmark \"%s\": min=%.3fus, median=%.3fus, p95=%.3fus, samples=%d",
+				benchmark.name,
+				static_cast<double>(result.min_ns) / 1e3,
+				static_cast<double>(result.median_ns) / 1e3,
+				static_cast<double>(result.p95_ns) / 1e3,
+				result.samples);
+		}
+	}
+
+	if ((settings->json_path != nullptr) && !odBenchmark_write_json(settings->json_path, &results)) {
+		return false;
+	}
+
+	if ((settings->baseline_path != nullptr)
+		&& !odBenchmark_compare_baseline(settings->baseline_path, settings->max_regression_percent, &results)) {
+		OD_ERROR("Benchmarks regressed vs baseline, path=%s", settings->baseline_path);
+		return false;
+	}
+
+	OD_INFO("Client benchmarks run successfully, %d run", results.get_count());
+	return true;
+}
+bool odBenchmarkRun_next(odBenchmarkRun* run) {
+	int64_t now_ns = odTimer_get_now_ns();
+	if (!OD_DEBUG_CHECK(run != nullptr)) {
+		return false;
+	}
+
+	int32_t sample_index = run->iteration - run->warmup_count - 1;
+	if ((sample_index >= 0) && (sample_index < run->sample_count)) {
+		run->samples_ns[sample_index] = now_ns - run->start_ns;
+	}
+
+	run->iteration++;
+	if (run->iteration > (run->warmup_count + run->sample_count)) {
+		return false;
+	}
+
+	run->start_ns = odTimer_get_now_ns();
+	return true;
+}
+
+odBenchmark::odBenchmark(
+	const char* in_name, void (*in_fn)(odBenchmarkRun* run), int32_t in_warmup_count, int32_t in_sample_count)
+: name{in_name}, fn{in_fn}, warmup_count{in_warmup_count}, sample_count{in_sample_count} {
+}
+
+OD_TEST(odTest_odBenchmarkResult_init) {
+	odBenchmarkRun run{};
+	run.sample_count = 20;
+	for (int32_t i = 0; i < run.sample_count; i++) {
+		run.samples_ns[i] = (run.sample_count - i) * 1000;  // unsorted
+	}
+
+	odBenchmarkResult result{"odTest", "odTestSuite", 0, 0, 0, 0, 0};
+	odBenchmarkResult_init(&result, &run);
+	OD_ASSERT(result.samples == 20);
+	OD_ASSERT(result.min_ns == 1000);
+	OD_ASSERT(result.median_ns == 11000);
+	OD_ASSERT(result.p95_ns == 19000);  // 19th of 20, the smallest sample >= 95% of samples
+	OD_ASSERT(result.mean_ns == 10500);
+
+	run.sample_count = 1;
+	run.samples_ns[0] = 5;
+	odBenchmarkResult_init(&result, &run);
+	OD_ASSERT(result.samples == 1);
+	OD_ASSERT(result.min_ns == 5);
+	OD_ASSERT(result.median_ns == 5);
+	OD_ASSERT(result.p95_ns == 5);
+	OD_ASSERT(result.mean_ns == 5);
+
+	run.sample_count = 0;
+	odBenchmarkResult_init(&result, &run);
+	OD_ASSERT(result.samples == 0);
+}
+OD_TEST(odTest_odBenchmark_write_json) {
+	const char* path = "odTest_odBenchmark_write_json.json";
+	const char expected[] =
+		"{\"benchmarks\":[\n"
+		"{\"name\":\"odTest_a\",\"suite\":\"odTestSuite\",\"samples\":3,"
+		"\"min_ns\":1,\"median_ns\":2,\"p95_ns\":3,\"mean_ns\":2},\n"
+		"{\"name\":\"odTest_b\",\"suite\":\"odTestSuite\",\"samples\":1,"
+		"\"min_ns\":10,\"median_ns\":10,\"p95_ns\":10,\"mean_ns\":10}\n"
+		"]}\n";
+
+	odTrivialArrayT<odBenchmarkResult> results;
+	OD_ASSERT(results.push(odBenchmarkResult{"odTest_a", "odTestSuite", 3, 1, 2, 3, 2}));
+	OD_ASSERT(results.push(odBenchmarkResult{"odTest_b", "odTestSuite", 1, 10, 10, 10, 10}));
+	OD_ASSERT(odBenchmark_write_json(path, &results));
+
+	odAllocation allocation;
+	int32_t size = 0;
+	OD_ASSERT(odFile_read_all(path, "rb", &allocation, &size));
+	OD_ASSERT(size == static_cast<int32_t>(sizeof(expected) - 1));
+	OD_ASSERT(memcmp(odAllocation_get(&allocation), expected, sizeof(expected) - 1) == 0);
+
+	OD_ASSERT(odFile_delete(path));
+}
+OD_TEST(odTest_odBenchmark_get_baseline_median_ns) {
+	const char baseline[] =
+		"{\"benchmarks\":[\n"
+		"{\"name\":\"odTest_a_longer\",\"suite\":\"odTestSuite\",\"median_ns\":7},\n"
+		"{\"name\":\"odTest_a\",\"suite\":\"odTestSuite\",\"median_ns\":42,\"allocated_bytes\":0},\n"
+		"{\"name\":\"odTest_zero\",\"median_ns\":0},\n"
+		"{\"name\":\"odTest_no_median\"},\n"
+		"{\"name\":\"odTest_invalid\",\"median_ns\":\"fast\"},\n"
+		"{\"name\":\"odTest_negative\",\"median_ns\":-1}\n"
+		"]}\n";
+
+	int64_t median_ns = -1;
+	OD_ASSERT(odBenchmark_get_baseline_median_ns(baseline, "odTest_a", &median_ns));
+	OD_ASSERT(median_ns == 42);
+	OD_ASSERT(odBenchmark_get_baseline_median_ns(baseline, "odTest_a_longer", &median_ns));
+	OD_ASSERT(median_ns == 7);
+
+	// a zero median is still in the baseline
+	OD_ASSERT(odBenchmark_get_baseline_median_ns(baseline, "odTest_zero", &median_ns));
+	OD_ASSERT(median_ns == 0);
+
+	// a median from the next object must not be used
+	OD_ASSERT(!odBenchmark_get_baseline_median_ns(baseline, "odTest_no_median", &median_ns));
+	OD_ASSERT(!odBenchmark_get_baseline_median_ns(baseline, "odTest_invalid", &median_ns));
+	OD_ASSERT(!odBenchmark_get_baseline_median_ns(baseline, "odTest_negative", &median_ns));
+	OD_ASSERT(!odBenchmark_get_baseline_median_ns(baseline, "odTest", &median_ns));
+	OD_ASSERT(!odBenchmark_get_baseline_median_ns(baseline, "odTest_missing", &median_ns));
+}
+OD_TEST(odTest_odBenchmark_compare_baseline) {
+	const char* path = "odTest_odBenchmark_compare_baseline.json";
+	const char baseline[] =
+		"{\"benchmarks\":[\n"
+		"{\"name\":\"odTest_a\",\"median_ns\":100},\n"
+		"{\"name\":\"odTest_zero\",\"median_ns\":0}\n"
+		"]}\n";
+	OD_ASSERT(odFile_write_all(path, "wb", baseline, static_cast<int32_t>(sizeof(baseline) - 1)));
+
+	odTrivialArrayT<odBenchmarkResult> results;
+	OD_ASSERT(results.push(odBenchmarkResult{"odTest_a", "odTestSuite", 1, 0, 110, 0, 0}));
+	OD_ASSERT(results.push(odBenchmarkResult{"odTest_zero", "odTestSuite", 1, 0, 0, 0, 0}));
+	OD_ASSERT(results.push(odBenchmarkResult{"odTest_missing", "odTestSuite", 1, 0, 1000, 0, 0}));
+
+	// exactly at the threshold passes
+	OD_ASSERT(odBenchmark_compare_baseline(path, 10, &results));
+
+	results.get(0)->median_ns = 111;
+	{
+		odLogLevelScoped suppress_errors{OD_LOG_LEVEL_FATAL};
+		OD_ASSERT(!odBenchmark_compare_baseline(path, 10, &results));
+	}
+	OD_ASSERT(odBenchmark_compare_baseline(path, 11, &results));
+
+	results.get(0)->median_ns = 50;
+	OD_ASSERT(odBenchmark_compare_baseline(path, 0, &results));
+
+	results.get(1)->median_ns = 1;
+	{
+		odLogLevelScoped suppress_errors{OD_LOG_LEVEL_FATAL};
+		OD_ASSERT(!odBenchmark_compare_baseline(path, 10, &results));
+	}
+
+	OD_ASSERT(odFile_delete(path));
+}
+
+OD_TEST_SUITE(
+	odTestSuite_odBenchmark,
+	odTest_odBenchmarkResult_init,
+	odTest_odBenchmark_write_json,
+	odTest_odBenchmark_get_baseline_median_ns,
+	odTest_odBenchmark_compare_baseline,
+)
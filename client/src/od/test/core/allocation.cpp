@@ -80,6 +80,46 @@ OD_TEST(odTest_odAllocation_get_unallocated_fails) {
 		OD_ASSERT(odAllocation_get(&allocation) == nullptr);
 	}
 }
+OD_TEST(odTest_odAllocation_stats) {
+	const int32_t category = OD_ALLOCATION_CATEGORY_IMAGE;
+	const int32_t size = 64;
+
+	odAllocationStats start_stats{};
+	OD_ASSERT(odAllocation_get_stats(category, &start_stats));
+	odAllocation_end_frame();
+
+	odAllocation allocation;
+	OD_ASSERT(odAllocation_init_category(&allocation, size, category));
+	OD_ASSERT(odAllocation_get_size(&allocation) == size);
+
+	odAllocationStats stats{};
+	OD_ASSERT(odAllocation_get_stats(category, &stats));
+	OD_ASSERT(stats.allocation_count == start_stats.allocation_count + 1);
+	OD_ASSERT(stats.allocated_bytes == start_stats.allocated_bytes + size);
+	OD_ASSERT(stats.live_bytes == start_stats.live_bytes + size);
+
+	odAllocation_destroy(&allocation);
+	OD_ASSERT(odAllocation_get_size(&allocation) == 0);
+	OD_ASSERT(odAllocation_get_stats(category, &stats));
+	OD_ASSERT(stats.free_count == start_stats.free_count + 1);
+	OD_ASSERT(stats.live_bytes == start_stats.live_bytes);
+
+	// frame stats only cover the last completed frame
+	odAllocation_end_frame();
+	OD_ASSERT(odAllocation_get_frame_stats(category, &stats));
+	OD_ASSERT(stats.allocation_count == 1);
+	OD_ASSERT(stats.free_count == 1);
+	OD_ASSERT(stats.allocated_bytes == size);
+	OD_ASSERT(stats.peak_live_bytes == start_stats.live_bytes + size);
+
+	odAllocation_end_frame();
+	OD_ASSERT(odAllocation_get_frame_stats(category, &stats));
+	OD_ASSERT(stats.allocation_count == 0);
+	OD_ASSERT(stats.peak_live_bytes == stats.live_bytes);
+
+	OD_ASSERT(odAllocation_get_frame_stats(OD_ALLOCATION_CATEGORY_ALL, &stats));
+	OD_ASSERT(odAllocationCategory_get_name(category) != nullptr);
+}
 
 OD_TEST_SUITE(
 	odTestSuite_odAllocation,
@@ -89,5 +129,6 @@ OD_TEST_SUITE(
 	odTest_odAllocation_swap,
 	odTest_odAllocation_swap_unallocated,
 	odTest_odAllocation_get,
-	odTest_odAllocation_get_unallocated_fails
+	odTest_odAllocation_get_unallocated_fails,
+	odTest_odAllocation_stats
 )
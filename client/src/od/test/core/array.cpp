@@ -3,6 +3,7 @@
 #include <cstring>
 
 #include <od/test/test.hpp>
+#include <od/test/benchmark.hpp>
 
 struct odArrayTestingContainer;
 
@@ -467,3 +468,20 @@ OD_TEST_SUITE(
 	odTest_odArray_get,
 	odTest_odArray_begin_end,
 )
+
+OD_BENCHMARK(odBenchmark_odTrivialArray_push) {
+	// growth from empty, including reallocations
+	const int32_t count = 1 << 16;
+
+	while (odBenchmarkRun_next(run)) {
+		odTrivialArrayT<int32_t> array;
+		for (int32_t i = 0; i < count; i++) {
+			OD_ASSERT(array.push(i));
+		}
+	}
+}
+
+OD_BENCHMARK_SUITE(
+	odBenchmarkSuite_odArray,
+	odBenchmark_odTrivialArray_push,
+)
@@ -1,7 +1,13 @@
 #include <od/core/debug.hpp>
 
+#include <cstdio>
 #include <cstring>
 
+#if !OD_BUILD_EMSCRIPTEN
+#include <atomic>
+#include <thread>
+#endif
+
 #include <od/test/test.hpp>
 
 OD_TEST(odTest_odLog_get_level_name) {
@@ -19,8 +25,259 @@ OD_TEST(odTest_odLog_get_level_name) {
 		OD_ASSERT(strcmp(level_name, unknown_level_name) != 0);
 	}
 }
+OD_TEST(odTest_odDebugString_format_threads) {
+#if !OD_BUILD_EMSCRIPTEN
+	// enough strings to wrap each thread's buffer several times
+	const int32_t threads_count = 4;
+	const int32_t strings_count = 20000;
+
+	bool threads_ok[threads_count] = {};
+	std::thread threads[threads_count];
+	for (int32_t i = 0; i < threads_count; i++) {
+		bool* thread_ok = &threads_ok[i];
+		threads[i] = std::thread{[i, thread_ok]() {
+			*thread_ok = true;
+			for (int32_t j = 0; j < strings_count; j++) {
+				char expected[64] = {};
+				snprintf(expected, sizeof(expected), "{\"thread\": %d, \"string\": %d}", i, j);
+
+				const char* str = odDebugString_format("{\"thread\": %d, \"string\": %d}", i, j);
+				if (strcmp(str, expected) != 0) {
+					*thread_ok = false;
+				}
+			}
+		}};
+	}
+	for (int32_t i = 0; i < threads_count; i++) {
+		threads[i].join();
+		OD_ASSERT(threads_ok[i]);
+	}
+#endif  // !OD_BUILD_EMSCRIPTEN
+}
+#if !OD_BUILD_EMSCRIPTEN
+#define OD_TEST_LOG_ASYNC_OUT_CAPACITY 262144
+struct odTestLogAsyncOut {
+	char str[OD_TEST_LOG_ASYNC_OUT_CAPACITY];
+	int32_t size;
+	std::atomic<bool> paused;
+	std::atomic<bool> entered;
+};
+static odTestLogAsyncOut odTest_log_async_out;
+
+static void odTest_odLog_async_write(const char* str, int32_t size) {
+	odTest_log_async_out.entered.store(true);
+	while (odTest_log_async_out.paused.load()) {
+		std::this_thread::yield();
+	}
+
+	if ((odTest_log_async_out.size + size) < OD_TEST_LOG_ASYNC_OUT_CAPACITY) {
+		memcpy(odTest_log_async_out.str + odTest_log_async_out.size, str, static_cast<size_t>(size));
+		odTest_log_async_out.size += size;
+		odTest_log_async_out.str[odTest_log_async_out.size] = '\0';
+	}
+}
+static void odTest_odLog_async_begin() {
+	odTest_log_async_out.size = 0;
+	odTest_log_async_out.str[0] = '\0';
+	odTest_log_async_out.paused.store(false);
+	odTest_log_async_out.entered.store(false);
+
+	OD_ASSERT(!odLog_get_async());
+	OD_ASSERT(odLog_set_async_write_fn(odTest_odLog_async_write));
+	OD_ASSERT(odLog_set_async(true));
+}
+static void odTest_odLog_async_end() {
+	OD_ASSERT(odLog_set_async(false));
+	OD_ASSERT(odLog_set_async_write_fn(nullptr));
+}
+static int32_t odTest_odLog_async_count(const char* str) {
+	int32_t count = 0;
+	for (const char* found = strstr(odTest_log_async_out.str, str); found != nullptr; found = strstr(found + 1, str)) {
+		count++;
+	}
+	return count;
+}
+#endif  // !OD_BUILD_EMSCRIPTEN
+
+OD_TEST(odTest_odLog_async) {
+	OD_ASSERT(!odLog_get_async());
+#if OD_BUILD_EMSCRIPTEN
+	OD_ASSERT(!odLog_set_async(true));
+#else
+	odTest_odLog_async_begin();
+	OD_ASSERT(odLog_get_async());
+	OD_ASSERT(odLog_set_async(true));
+	OD_ASSERT(!odLog_set_async_write_fn(nullptr));
+
+	{
+		odLogLevelScoped log_level{OD_LOG_LEVEL_INFO};
+		OD_INFO("async log line, i=%d", 1);
+		OD_INFO("async log line longer than a slot: %01024d", 0);
+		OD_INFO("async log line, i=%d", 2);
+		OD_DEBUG("async log line above the max level");
+		odLog_flush();
+	}
+
+	const char* line_1 = strstr(odTest_log_async_out.str, "] async log line, i=1\n");
+	const char* line_long = strstr(odTest_log_async_out.str, "] async log line longer than a slot: 000");
+	const char* line_2 = strstr(odTest_log_async_out.str, "] async log line, i=2\n");
+	OD_ASSERT(strstr(odTest_log_async_out.str, " info ") != nullptr);
+	OD_ASSERT(line_1 != nullptr);
+	OD_ASSERT(line_long != nullptr);
+	OD_ASSERT(line_2 != nullptr);
+	OD_ASSERT((line_1 < line_long) && (line_long < line_2));
+	OD_ASSERT(strstr(odTest_log_async_out.str, "above the max level") == nullptr);
+
+	// the long line is truncated to one slot, and still ends in a newline
+	const char* line_long_begin = strchr(line_1, '\n') + 1;
+	const char* line_long_end = strchr(line_long, '\n') + 1;
+	OD_ASSERT((line_long_end - line_long_begin) == (OD_LOG_ASYNC_LINE_CAPACITY - 1));
+	OD_ASSERT((*line_long_end == '[') && (strchr(line_long_end, ']') == line_2));
+
+	odTest_odLog_async_end();
+	OD_ASSERT(!odLog_get_async());
+	OD_ASSERT(odLog_set_async(false));
+#endif  // #else  // OD_BUILD_EMSCRIPTEN
+}
+OD_TEST(odTest_odLog_async_dropped) {
+#if !OD_BUILD_EMSCRIPTEN
+	const int32_t lines_count = 4096;
+
+	odTest_odLog_async_begin();
+	{
+		odLogLevelScoped log_level{OD_LOG_LEVEL_INFO};
+
+		// the writer is held inside the first write, so the buffer fills up
+		odTest_log_async_out.paused.store(true);
+		OD_INFO("async first line");
+		while (!odTest_log_async_out.entered.load()) {
+			std::this_thread::yield();
+		}
+		for (int32_t i = 0; i < lines_count; i++) {
+			OD_INFO("async dropped test line=%d", i);
+		}
+		odTest_log_async_out.paused.store(false);
+		odLog_flush();
+	}
+
+	int32_t written_count = odTest_odLog_async_count("async dropped test line=");
+	int32_t dropped_count = odLog_get_async_dropped_count();
+	OD_ASSERT(dropped_count > 0);
+	OD_ASSERT((written_count + dropped_count) == lines_count);
+
+	int32_t reported_count = 0;
+	const char* report = strstr(odTest_log_async_out.str, "[log] async log buffer full, dropped ");
+	OD_ASSERT(report != nullptr);
+	OD_ASSERT(sscanf(report, "[log] async log buffer full, dropped %d line(s)", &reported_count) == 1);
+	OD_ASSERT(reported_count == dropped_count);
+	OD_ASSERT(odTest_odLog_async_count("[log] async log buffer full") == 1);
+
+	odTest_odLog_async_end();
+#endif  // !OD_BUILD_EMSCRIPTEN
+}
+OD_TEST(odTest_odLog_async_error_flush) {
+#if !OD_BUILD_EMSCRIPTEN
+	const int32_t lines_count = 64;
+
+	odTest_odLog_async_begin();
+	{
+		odLogLevelScoped log_level{OD_LOG_LEVEL_INFO};
+		for (int32_t i = 0; i < lines_count; i++) {
+			OD_INFO("async line before error=%d", i);
+		}
+
+		// an error is written, with every line before it, by the time logging it returns
+		int32_t logged_error_count = odLog_get_logged_error_count();
+		OD_ERROR("async error line");
+		odLog_set_logged_error_count(logged_error_count);
+	}
+	OD_ASSERT(strstr(odTest_log_async_out.str, "] async error line\n") != nullptr);
+	OD_ASSERT(odTest_odLog_async_count("async line before error=") == lines_count);
+	OD_ASSERT(odLog_get_async_dropped_count() == 0);
+
+	odTest_odLog_async_end();
+#endif  // !OD_BUILD_EMSCRIPTEN
+}
+OD_TEST_FILTERED(odTest_odLog_async_threads, OD_TEST_FILTER_SLOW) {
+#if !OD_BUILD_EMSCRIPTEN
+	const int32_t threads_count = 4;
+	const int32_t lines_count = 256;
+
+	odTest_odLog_async_begin();
+	{
+		odLogLevelScoped log_level{OD_LOG_LEVEL_INFO};
+
+		std::thread threads[threads_count];
+		for (int32_t i = 0; i < threads_count; i++) {
+			threads[i] = std::thread{[i]() {
+				for (int32_t j = 0; j < lines_count; j++) {
+					OD_INFO("thread=%d, line=%d", i, j);
+				}
+			}};
+		}
+		for (int32_t i = 0; i < threads_count; i++) {
+			threads[i].join();
+		}
+		odLog_flush();
+	}
+
+	// every line is whole, each thread's lines are in order, and every line is either written or dropped
+	int32_t last_lines[threads_count] = {-1, -1, -1, -1};
+	int32_t written_count = 0;
+	for (const char* found = strstr(odTest_log_async_out.str, "] thread="); found != nullptr;
+		 found = strstr(found + 1, "] thread=")) {
+		int32_t thread = -1;
+		int32_t line = -1;
+		OD_ASSERT(sscanf(found, "] thread=%d, line=%d\n", &thread, &line) == 2);
+		OD_ASSERT((thread >= 0) && (thread < threads_count));
+		OD_ASSERT(line > last_lines[thread]);
+		OD_ASSERT(strchr(found, '\n') != nullptr);
+		last_lines[thread] = line;
+		written_count++;
+	}
+	OD_ASSERT((written_count + odLog_get_async_dropped_count()) == (threads_count * lines_count));
+
+	odTest_odLog_async_end();
+#endif  // !OD_BUILD_EMSCRIPTEN
+}
+OD_TEST_FILTERED(odTest_odLog_async_stop_threads, OD_TEST_FILTER_SLOW) {
+#if !OD_BUILD_EMSCRIPTEN
+	const int32_t threads_count = 4;
+
+	// threads still logging while async logging stops fall back to writing directly, rather than waiting forever
+	odTest_odLog_async_begin();
+	{
+		odLogLevelScoped log_level{OD_LOG_LEVEL_INFO};
+
+		std::atomic<int32_t> started_count{0};
+		std::thread threads[threads_count];
+		for (int32_t i = 0; i < threads_count; i++) {
+			threads[i] = std::thread{[i, &started_count]() {
+				started_count.fetch_add(1);
+				while (odLog_get_async()) {
+					OD_INFO("thread=%d stopping", i);
+				}
+			}};
+		}
+		while (started_count.load() < threads_count) {
+			std::this_thread::yield();
+		}
+
+		odTest_odLog_async_end();
+		for (int32_t i = 0; i < threads_count; i++) {
+			threads[i].join();
+		}
+	}
+#endif  // !OD_BUILD_EMSCRIPTEN
+}
 
 OD_TEST_SUITE(
 	odTestSuite_odDebug,
 	odTest_odLog_get_level_name,
+	odTest_odDebugString_format_threads,
+	odTest_odLog_async,
+	odTest_odLog_async_dropped,
+	odTest_odLog_async_error_flush,
+	odTest_odLog_async_threads,
+	odTest_odLog_async_stop_threads,
 )
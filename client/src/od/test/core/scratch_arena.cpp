@@ -0,0 +1,81 @@
+#include <od/core/scratch_arena.hpp>
+
+#include <od/core/debug.h>
+#include <od/test/test.hpp>
+
+OD_TEST(odTest_odScratchArena_init_destroy) {
+	odScratchArena arena;
+	OD_ASSERT(odScratchArena_get_capacity(&arena) == 0);
+	OD_ASSERT(odScratchArena_allocate(&arena, 1, 1) == nullptr);
+
+	OD_ASSERT(odScratchArena_init(&arena, 64));
+	OD_ASSERT(odScratchArena_get_capacity(&arena) == 64);
+	OD_ASSERT(odScratchArena_get_size(&arena) == 0);
+
+	// test multiple init
+	OD_ASSERT(odScratchArena_init(&arena, 128));
+	OD_ASSERT(odScratchArena_get_capacity(&arena) == 128);
+
+	odScratchArena_destroy(&arena);
+	OD_ASSERT(odScratchArena_get_capacity(&arena) == 0);
+
+	// test multiple destroy
+	odScratchArena_destroy(&arena);
+	OD_ASSERT(odScratchArena_get_capacity(&arena) == 0);
+}
+OD_TEST(odTest_odScratchArena_allocate) {
+	odScratchArena arena;
+	OD_ASSERT(odScratchArena_init(&arena, 64));
+
+	char* chars = static_cast<char*>(odScratchArena_allocate(&arena, 3, 1));
+	OD_ASSERT(chars != nullptr);
+	OD_ASSERT((chars[0] == 0) && (chars[1] == 0) && (chars[2] == 0));
+	chars[0] = 1;
+
+	int64_t* ints = static_cast<int64_t*>(odScratchArena_allocate(&arena, 2 * sizeof(int64_t), alignof(int64_t)));
+	OD_ASSERT(ints != nullptr);
+	OD_ASSERT((reinterpret_cast<uintptr_t>(ints) % alignof(int64_t)) == 0);
+	OD_ASSERT((ints[0] == 0) && (ints[1] == 0));
+	OD_ASSERT(chars[0] == 1);
+
+	// allocations don't wrap; the arena is full until reset
+	OD_ASSERT(odScratchArena_allocate(&arena, 64, 1) == nullptr);
+	OD_ASSERT(odScratchArena_get_size(&arena) > 0);
+
+	odScratchArena_reset(&arena);
+	OD_ASSERT(odScratchArena_get_size(&arena) == 0);
+	OD_ASSERT(odScratchArena_allocate(&arena, 64, 1) != nullptr);
+	OD_ASSERT(odScratchArena_allocate(&arena, 1, 1) == nullptr);
+	OD_ASSERT(odScratchArena_allocate(&arena, 0, 1) != nullptr);
+}
+OD_TEST(odTest_odScratchArena_allocate_wrapping) {
+	odScratchArena arena;
+	OD_ASSERT(odScratchArena_init(&arena, 64));
+
+	void* first = odScratchArena_allocate_wrapping(&arena, 40, 1);
+	OD_ASSERT(first != nullptr);
+	OD_ASSERT(odScratchArena_allocate_wrapping(&arena, 40, 1) == first);
+	OD_ASSERT(odScratchArena_get_size(&arena) == 40);
+
+	// larger than the arena, even when empty
+	OD_ASSERT(odScratchArena_allocate_wrapping(&arena, 65, 1) == nullptr);
+}
+OD_TEST(odTest_odScratchArena_swap) {
+	odScratchArena arena1;
+	odScratchArena arena2;
+	OD_ASSERT(odScratchArena_init(&arena1, 16));
+	OD_ASSERT(odScratchArena_allocate(&arena1, 4, 1) != nullptr);
+
+	odScratchArena_swap(&arena1, &arena2);
+	OD_ASSERT(odScratchArena_get_capacity(&arena1) == 0);
+	OD_ASSERT(odScratchArena_get_capacity(&arena2) == 16);
+	OD_ASSERT(odScratchArena_get_size(&arena2) == 4);
+}
+
+OD_TEST_SUITE(
+	odTestSuite_odScratchArena,
+	odTest_odScratchArena_init_destroy,
+	odTest_odScratchArena_allocate,
+	odTest_odScratchArena_allocate_wrapping,
+	odTest_odScratchArena_swap,
+)
@@ -161,6 +161,11 @@ OD_TEST(odTest_odString_extend_formatted) {
 	OD_ASSERT(str_data != nullptr);
 	OD_ASSERT(strncmp(str_data, "yep 123", 7) == 0);
 }
+OD_TEST(odTest_odString_extend_json_string) {
+	odString str;
+	OD_ASSERT(odString_extend_json_string(&str, "a\"b\\c\nd\te\r"));
+	OD_ASSERT(strcmp(odString_get_c_str(&str), "\"a\\\"b\\\\c\\nd\\te\"") == 0);
+}
 
 OD_TEST_SUITE(
 	odTestSuite_odString,
@@ -175,4 +180,5 @@ OD_TEST_SUITE(
 	odTest_odString_debug_get_out_of_bounds_fails,
 	odTest_odString_compare,
 	odTest_odString_extend_formatted,
+	odTest_odString_extend_json_string,
 )
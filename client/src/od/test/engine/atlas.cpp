@@ -4,6 +4,7 @@
 #include <od/core/color.h>
 #include <od/platform/image.hpp>
 #include <od/test/test.hpp>
+#include <od/test/benchmark.hpp>
 
 OD_TEST(odTest_odAtlas_init_destroy) {
 	odAtlas atlas;
@@ -189,3 +190,24 @@ OD_TEST_SUITE(
 	odTest_odAtlas_set_reset_scaling_sizes,
 	odTest_odAtlas_set_reset_realistic,
 )
+
+OD_BENCHMARK(odBenchmark_odAtlas_set_region) {
+	// sprite-sized regions of mixed sizes, packed into a fresh atlas
+	const int32_t regions_count = 256;
+	const int32_t max_size = 32;
+	static const odColor pixels[max_size * max_size]{};
+
+	while (odBenchmarkRun_next(run)) {
+		odAtlas atlas;
+		for (odAtlasRegionId i = 0; i < regions_count; i++) {
+			int32_t width = 8 + ((i * 5) % (max_size - 7));
+			int32_t height = 8 + ((i * 11) % (max_size - 7));
+			OD_ASSERT(odAtlas_set_region(&atlas, i, width, height, pixels, max_size));
+		}
+	}
+}
+
+OD_BENCHMARK_SUITE(
+	odBenchmarkSuite_odAtlas,
+	odBenchmark_odAtlas_set_region,
+)
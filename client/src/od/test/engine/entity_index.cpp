@@ -2,9 +2,13 @@
 
 #include <od/core/debug.h>
 #include <od/core/bounds.h>
+#include <od/core/matrix.h>
+#include <od/core/vertex.h>
+#include <od/platform/primitive.h>
 #include <od/platform/timer.h>
 #include <od/engine/entity.h>
 #include <od/test/test.hpp>
+#include <od/test/benchmark.hpp>
 
 OD_TEST(odTest_odEntityIndex_init_destroy) {
 	odEntityIndex entity_index;
@@ -122,6 +126,102 @@ OD_TEST(odTest_odEntityIndex_search) {
 	search.bounds = odBounds{-65.0f, -64.0f, -64.0f, -63.0f};
 	OD_ASSERT(odEntityIndex_search(&entity_index, &search) == 0);
 }
+OD_TEST(odTest_odEntityIndex_get_all_vertices_interpolated) {
+	odEntityIndex entity_index{};
+	int32_t vertex_count = 0;
+
+	OD_ASSERT(odEntityIndex_get_all_vertices_interpolated(&entity_index, 0.5f, &vertex_count) == nullptr);
+	OD_ASSERT(vertex_count == 0);
+
+	odEntity entity{};
+	entity.sprite.transform = *odMatrix_get_identity();
+	entity.collider.bounds = odBounds{0.0f, 0.0f, 16.0f, 16.0f};
+	odEntityIndex_set(&entity_index, &entity);
+
+	// no previous state saved; matches current
+	const odVertex* vertices = odEntityIndex_get_all_vertices_interpolated(&entity_index, 0.5f, &vertex_count);
+	OD_ASSERT(vertices != nullptr);
+	OD_ASSERT(vertex_count == OD_ENTITY_VERTEX_COUNT);
+	OD_ASSERT(vertices[0].pos.x == 0.0f);
+
+	odEntityIndex_save_previous(&entity_index);
+	entity.collider.bounds = odBounds{8.0f, 0.0f, 24.0f, 16.0f};
+	odEntityIndex_set(&entity_index, &entity);
+
+	vertices = odEntityIndex_get_all_vertices_interpolated(&entity_index, 0.5f, &vertex_count);
+	OD_ASSERT(vertices != nullptr);
+	OD_ASSERT(vertex_count == OD_ENTITY_VERTEX_COUNT);
+	OD_ASSERT(vertices[0].pos.x == 4.0f);
+
+	vertices = odEntityIndex_get_all_vertices_interpolated(&entity_index, 0.0f, &vertex_count);
+	OD_ASSERT(vertices[0].pos.x == 0.0f);
+
+	vertices = odEntityIndex_get_all_vertices_interpolated(&entity_index, 1.0f, &vertex_count);
+	OD_ASSERT(vertices[0].pos.x == 8.0f);
+
+	odEntityIndex_save_previous(&entity_index);
+	vertices = odEntityIndex_get_all_vertices_interpolated(&entity_index, 0.5f, &vertex_count);
+	OD_ASSERT(vertices[0].pos.x == 8.0f);
+
+	// a destroyed id reused in the same step does not interpolate from its previous occupant
+	entity.collider.bounds = odBounds{0.0f, 0.0f, 0.0f, 0.0f};
+	odEntityIndex_set(&entity_index, &entity);
+	entity.collider.bounds = odBounds{64.0f, 0.0f, 80.0f, 16.0f};
+	odEntityIndex_set(&entity_index, &entity);
+	vertices = odEntityIndex_get_all_vertices_interpolated(&entity_index, 0.5f, &vertex_count);
+	OD_ASSERT(vertices[0].pos.x == 64.0f);
+
+	odEntityCollider collider = entity.collider;
+	collider.bounds = odBounds{0.0f, 0.0f, 0.0f, 0.0f};
+	odEntityIndex_set_collider(&entity_index, &collider);
+	collider.bounds = odBounds{32.0f, 0.0f, 48.0f, 16.0f};
+	odEntityIndex_set_collider(&entity_index, &collider);
+	vertices = odEntityIndex_get_all_vertices_interpolated(&entity_index, 0.5f, &vertex_count);
+	OD_ASSERT(vertices[0].pos.x == 32.0f);
+}
+OD_TEST(odTest_odEntityIndex_tagged) {
+	odEntityIndex entity_index{};
+	int32_t count = -1;
+	OD_ASSERT(odEntityIndex_get_all_tagged(&entity_index, 3, &count) == nullptr);
+	OD_ASSERT(count == 0);
+	OD_ASSERT(!odEntityIndex_get_is_tagged(&entity_index, 3, 1));
+
+	OD_ASSERT(odEntityIndex_add_tagged(&entity_index, 3, 1));
+	OD_ASSERT(odEntityIndex_add_tagged(&entity_index, 3, 7));
+	OD_ASSERT(odEntityIndex_add_tagged(&entity_index, 3, 4));
+	OD_ASSERT(!odEntityIndex_add_tagged(&entity_index, 3, 7));  // already tagged
+	OD_ASSERT(odEntityIndex_add_tagged(&entity_index, 0, 7));
+	OD_ASSERT(odEntityIndex_get_is_tagged(&entity_index, 3, 7));
+	OD_ASSERT(!odEntityIndex_get_is_tagged(&entity_index, 0, 1));
+
+	const odEntityId* entity_ids = odEntityIndex_get_all_tagged(&entity_index, 3, &count);
+	OD_ASSERT(count == 3);
+	OD_ASSERT((entity_ids[0] == 1) && (entity_ids[1] == 7) && (entity_ids[2] == 4));
+
+	int32_t tag_list_ids[4] = {};
+	OD_ASSERT(odEntityIndex_get_tag_lists(&entity_index, 7, tag_list_ids, 4) == 2);
+	OD_ASSERT((tag_list_ids[0] == 0) && (tag_list_ids[1] == 3));
+	OD_ASSERT(odEntityIndex_get_tag_lists(&entity_index, 7, tag_list_ids, 1) == 1);
+	OD_ASSERT(odEntityIndex_get_tag_lists(&entity_index, 100, tag_list_ids, 4) == 0);
+
+	// removal swaps the last entity into the removed slot
+	OD_ASSERT(odEntityIndex_remove_tagged(&entity_index, 3, 1));
+	OD_ASSERT(!odEntityIndex_remove_tagged(&entity_index, 3, 1));
+	OD_ASSERT(!odEntityIndex_remove_tagged(&entity_index, 5, 1));
+	entity_ids = odEntityIndex_get_all_tagged(&entity_index, 3, &count);
+	OD_ASSERT(count == 2);
+	OD_ASSERT((entity_ids[0] == 4) && (entity_ids[1] == 7));
+
+	OD_ASSERT(odEntityIndex_remove_tagged(&entity_index, 3, 7));
+	OD_ASSERT(odEntityIndex_get_is_tagged(&entity_index, 3, 4));
+	OD_ASSERT(odEntityIndex_remove_tagged(&entity_index, 3, 4));
+	OD_DISCARD(odEntityIndex_get_all_tagged(&entity_index, 3, &count));
+	OD_ASSERT(count == 0);
+	OD_ASSERT(odEntityIndex_get_is_tagged(&entity_index, 0, 7));
+
+	odEntityIndex_destroy(&entity_index);
+	OD_ASSERT(!odEntityIndex_get_is_tagged(&entity_index, 0, 7));
+}
 OD_TEST_FILTERED(odTest_odEntityIndex_search_performance, OD_TEST_FILTER_SLOW) {
 	const int32_t tile_width = 8;
 	const float tile_width_f = static_cast<float>(tile_width);
@@ -229,5 +329,52 @@ OD_TEST_SUITE(
 	odTest_odEntityIndex_init_destroy,
 	odTest_odEntityIndex_set_get,
 	odTest_odEntityIndex_search,
+	odTest_odEntityIndex_get_all_vertices_interpolated,
+	odTest_odEntityIndex_tagged,
 	odTest_odEntityIndex_search_performance,
 )
+
+OD_BENCHMARK(odBenchmark_odEntityIndex_search) {
+	// a tile grid filling the optimum world size, searched with small areas as collision checks do
+	const int32_t tile_width = 8;
+	const float tile_width_f = static_cast<float>(tile_width);
+	const int32_t grid_tile_width = (
+		1 << (OD_ENTITY_CHUNK_OPTIMUM_WORLD_WIDTH_BITS - OD_ENTITY_CHUNK_OPTIMUM_CHUNK_WIDTH_BITS));
+	const int32_t entities_count = grid_tile_width * grid_tile_width;
+	const int32_t searches_count = 1024;
+	const int32_t search_results_count = 16;
+
+	odEntityIndex entity_index{};
+	for (int32_t i = 0; i < entities_count; i++) {
+		float x = static_cast<float>((i % grid_tile_width) * tile_width);
+		float y = static_cast<float>((i / grid_tile_width) * tile_width);
+
+		odEntity entity{};
+		entity.collider.id = i;
+		entity.collider.bounds = odBounds{x, y, x + tile_width_f, y + tile_width_f};
+		odEntityIndex_set(&entity_index, &entity);
+	}
+
+	odEntityId search_results[search_results_count];
+	while (odBenchmarkRun_next(run)) {
+		int32_t found_count = 0;
+		for (int32_t i = 0; i < searches_count; i++) {
+			float x = static_cast<float>(((i * 7) % grid_tile_width) * tile_width) + 1.0f;
+			float y = static_cast<float>(((i * 13) % grid_tile_width) * tile_width) + 1.0f;
+
+			odEntitySearch search{
+				search_results,
+				search_results_count,
+				odBounds{x, y, x + tile_width_f, y + tile_width_f},
+				odTagset{},
+				nullptr};
+			found_count += odEntityIndex_search(&entity_index, &search);
+		}
+		OD_ASSERT(found_count > 0);
+	}
+}
+
+OD_BENCHMARK_SUITE(
+	odBenchmarkSuite_odEntityIndex,
+	odBenchmark_odEntityIndex_search,
+)
@@ -1,6 +1,7 @@
 #include <od/engine/lua/bindings.h>
 
 #include <od/core/debug.h>
+#include <od/platform/profile.h>
 #include <od/test/test.hpp>
 
 #include <od/engine/lua/client.hpp>
@@ -104,6 +105,7 @@ OD_TEST_FILTERED(odTest_odLuaBindings_odWindow, OD_TEST_FILTER_SLOW) {
 			local mouse_state = window:get_mouse_state()
 			local up_state = window:get_key_state("up")
 			local down_state = window:get_key_state("down")
+			local up_pressed = window:get_key_state("up", true)
 			if frames > 60 then
 				window:destroy()
 				window:destroy() -- re-destroy
@@ -113,6 +115,38 @@ OD_TEST_FILTERED(odTest_odLuaBindings_odWindow, OD_TEST_FILTER_SLOW) {
 
 	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
 }
+OD_TEST(odTest_odLuaBindings_odWindow_key_states) {
+	odLuaClient lua;
+	OD_ASSERT(odLuaClient_init(&lua));
+
+	const char test_script[] = R"(
+		local window = odClientWrapper.Window.new{headless = true}
+
+		local up = window:get_key_handle("up")
+		local down = window:get_key_handle("down")
+		assert(up ~= down)
+		assert(window:get_key_handle("up") == up)
+
+		local held, pressed = {}, {}
+		window:get_key_states({up, down}, held, pressed)
+		assert(held[up] == false and held[down] == false)
+		assert(pressed[up] == false and pressed[down] == false)
+
+		local key_handles = {}
+		for _, key_name in ipairs(odClientWrapper.Window.get_key_names()) do
+			key_handles[#key_handles + 1] = window:get_key_handle(key_name)
+		end
+		window:get_key_states(key_handles, held)
+		assert(window:get_last_frame_ms() == 0)
+		assert(window:step())
+		assert(window:step())
+		assert(window:get_last_frame_ms() == window:get_frame_stats().last_frame_ms)
+		assert(window:get_key_state("up") == false)
+		assert(window:get_key_state("up", true) == false)
+	)";
+
+	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
+}
 OD_TEST_FILTERED(odTest_odLuaBindings_odTexture, OD_TEST_FILTER_SLOW) {
 	odLuaClient lua;
 	OD_ASSERT(odLuaClient_init(&lua));
@@ -302,6 +336,17 @@ OD_TEST_FILTERED(odTest_odLuaBindings_odAudio, OD_TEST_FILTER_SLOW) {
 
 		audio:destroy()
 		audio:destroy() -- re-destroy
+
+		local filename = 'examples/engine_test/data/1_sample_silence_22050hz_s16.wav'
+		odClientWrapper.Audio.preload_files{filenames = {filename}, background = true}
+		assert(odClientWrapper.Audio.wait_preload())
+		local cached_audio = odClientWrapper.Audio.new_wav_file{filename = filename}
+		local stats = odClientWrapper.Audio.get_cache_stats()
+		assert(stats.preloaded_count >= 1)
+		assert(stats.hit_count >= 1)
+		assert(stats.decoded_bytes > 0)
+		odClientWrapper.Audio.release_preloaded()
+		cached_audio:destroy()
 	)";
 
 	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
@@ -358,15 +403,15 @@ OD_TEST(odTest_odLuaBindings_odEntityIndex) {
 		local entity_index = odClientWrapper.EntityIndex.new{}
 		entity_index:init{} -- re-init
 
-		entity_index:set_collider(1, 0,0,4,4, 0,1,95)
+		entity_index:set_collider(1, 0,0,4,4, 0,1,63)
 
-		entity_index:set_tags(1, 0,1,95)
+		entity_index:set_tags(1, 0,1,63)
 		entity_index:set_bounds(1, 0,0,8,8)
 		entity_index:set_sprite(1, 8,8,16,16, 255,255,255,255, 2, 1,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1)
 		entity_index:set_sprite(1, 8,8,16,16, 255,255,255,255, 2)
 
 
-		entity_index:set(1, 0,0,8,8, 8,8,16,16, 255,255,255,255, 2, 1,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1, 0,1,95)
+		entity_index:set(1, 0,0,8,8, 8,8,16,16, 255,255,255,255, 2, 1,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1, 0,1,63)
 		entity_index:set(1, 0,0,8,8, 8,8,16,16, 255,255,255,255, 2)
 
 		local x1,y1,x2,y2, u1,v1,u2,v2, r,g,b,a, depth = entity_index:get(1)
@@ -391,11 +436,12 @@ OD_TEST(odTest_odLuaBindings_odEntityIndex) {
 		assert(x2 == 8)
 		assert(y2 == 8)
 
-		entity_index:set_tags(1, 0,1,95)
+		local last_tag_id = entity_index.get_max_tag_id() - 1
+		entity_index:set_tags(1, 0,1,last_tag_id)
 		local tags = {entity_index:get_tags(1)}
 		assert(tags[1] == 0)
 		assert(tags[2] == 1)
-		assert(tags[3] == 95)
+		assert(tags[3] == last_tag_id)
 		assert(#tags == 3)
 
 		local u1,v1,u2,v2, r,g,b,a, depth = entity_index:get_sprite(1)
@@ -479,7 +525,7 @@ OD_TEST_FILTERED(odTest_odLuaBindings_odEntityIndex_odVertexArray_integration, O
 
 	const char test_script[] = R"(
 		local entity_index = odClientWrapper.EntityIndex.new{}
-		entity_index:set(1, 0,0,8,8, 8,8,16,16, 255,255,255,255, 0, 1,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1, 0,1,95)
+		entity_index:set(1, 0,0,8,8, 8,8,16,16, 255,255,255,255, 0, 1,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1, 0,1,63)
 
 		local vertex_array = odClientWrapper.VertexArray.new{}
 		entity_index:add_to_vertex_array{vertex_array = vertex_array}
@@ -487,6 +533,360 @@ OD_TEST_FILTERED(odTest_odLuaBindings_odEntityIndex_odVertexArray_integration, O
 
 	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
 }
+OD_TEST(odTest_odLuaBindings_odSnapshot) {
+	odLuaClient lua;
+	OD_ASSERT(odLuaClient_init(&lua));
+
+	const char test_script[] = R"(
+		local Snapshot = odClientWrapper.Snapshot
+
+		local function equals(a, b)
+			if type(a) ~= type(b) then
+				return false
+			end
+			if type(a) ~= "table" then
+				return a == b
+			end
+			for k, v in pairs(a) do
+				if not equals(v, b[k]) then
+					return false
+				end
+			end
+			for k, _ in pairs(b) do
+				if a[k] == nil then
+					return false
+				end
+			end
+			return true
+		end
+
+		local values = {
+			true, false, 0, 1, -1, 127, 128, -129, 2^40, -2^53, 0.5, -1e300, math.huge, -math.huge,
+			"", "hello", "\0\255", {}, {1, 2, 3}, {a = 1, b = {c = "d", e = {true, false}}},
+			{entities = {{x = 1.5, y = -2, tags = {"a", "b"}}, {x = 3, y = 4, tags = {}}}},
+		}
+		for _, value in ipairs(values) do
+			local encoded = Snapshot.encode(value)
+			assert(encoded:sub(1, #Snapshot.magic) == Snapshot.magic)
+			assert(equals(Snapshot.decode(encoded), value))
+		end
+
+		local nan = Snapshot.decode(Snapshot.encode(0/0))
+		assert(nan ~= nan)
+
+		-- integral numbers are varint-encoded
+		assert(#Snapshot.encode(1) < #Snapshot.encode(0.5))
+
+		for _, value in ipairs({function() end, {1, nil, 3}, {1, a = 2}, {[1.5] = 1}}) do
+			assert(not pcall(Snapshot.encode, value))
+		end
+		local cyclic = {}
+		cyclic.self = cyclic
+		assert(not pcall(Snapshot.encode, cyclic))
+
+		local encoded = Snapshot.encode({a = {1, 2, 3}})
+		assert(not pcall(Snapshot.decode, ""))
+		assert(not pcall(Snapshot.decode, "hello world"))
+		assert(not pcall(Snapshot.decode, encoded:sub(1, -2)))
+		assert(not pcall(Snapshot.decode, encoded.."x"))
+
+		local filename = "odTest_odLuaBindings_odSnapshot.snapshot"
+		local state = {world = {entities = {}}}
+		for i = 1, 5000 do
+			state.world.entities[i] = {id = i, x = i * 0.25, name = "entity"..i}
+		end
+		assert(Snapshot.save(filename, state))
+		assert(equals(Snapshot.load(filename), state))
+		os.remove(filename)
+	)";
+
+	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
+}
+OD_TEST(odTest_odLuaBindings_odSnapshot_copy_restore) {
+	odLuaClient lua;
+	OD_ASSERT(odLuaClient_init(&lua));
+
+	const char test_script[] = R"(
+		local Snapshot = odClientWrapper.Snapshot
+
+		local fn = function() end
+		local source = {a = 1, b = {c = "c", d = {1, 2, 3}}, e = {}, f = fn}
+		local copy = Snapshot.copy(source)
+		assert(copy ~= source and copy.b ~= source.b and copy.b.d ~= source.b.d and copy.e ~= source.e)
+		assert(copy.a == 1 and copy.b.c == "c" and #copy.b.d == 3 and copy.b.d[3] == 3 and copy.f == fn)
+		assert(Snapshot.copy(5) == 5 and Snapshot.copy(nil) == nil)
+
+		local cyclic = {}
+		cyclic.self = cyclic
+		assert(not pcall(Snapshot.copy, cyclic))
+		assert(not pcall(Snapshot.copy, {co = coroutine.create(fn)}))
+
+		-- unchanged tables are kept, changed fields are rewritten, extra fields are removed
+		local target = Snapshot.copy(source)
+		local target_b = target.b
+		local target_d = target.b.d
+		target.a = 2
+		target.b.c = nil
+		target.b.d[4] = 4
+		target.e = "e"
+		target.g = {h = true}
+		assert(Snapshot.restore(target, source) == target)
+		assert(target.b == target_b and target.b.d == target_d)
+		assert(target.a == 1 and target.b.c == "c" and #target.b.d == 3 and target.g == nil)
+		assert(type(target.e) == "table" and target.e ~= source.e)
+
+		-- aliased and shared tables are replaced by copies
+		local shared = {1}
+		local aliased = {a = shared, b = shared, c = source.b}
+		Snapshot.restore(aliased, {a = {2}, b = {3}, c = source.b})
+		assert(aliased.a ~= aliased.b and aliased.a[1] == 2 and aliased.b[1] == 3)
+		assert(aliased.c ~= source.b and aliased.c.c == "c")
+
+		assert(not pcall(Snapshot.restore, {}, 5))
+		assert(not pcall(Snapshot.restore, {}, cyclic))
+	)";
+
+	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
+}
+OD_TEST(odTest_odLuaBindings_odDebugging) {
+	odLuaClient lua;
+	OD_ASSERT(odLuaClient_init(&lua));
+
+	const char test_script[] = R"(
+		local Debugging = odClientWrapper.Debugging
+
+		local ok, a, b, c = Debugging.pcall(function(x, y) return x, y, nil end, 1, "two")
+		assert(ok == true and a == 1 and b == "two" and c == nil)
+		assert(select("#", Debugging.pcall(function() end)) == 1)
+
+		local ok, err = Debugging.pcall(function(x) error("failed "..x) end, "here")
+		assert(ok == false)
+		assert(string.find(err, "failed here", 1, true) ~= nil)
+		assert(string.find(err, "stack traceback", 1, true) ~= nil)
+
+		local error_value = {}
+		local ok, err = Debugging.pcall(error, error_value)
+		assert(ok == false and err == error_value)
+
+		assert(not pcall(Debugging.pcall))
+
+		-- successful calls must not allocate
+		local sys = {count = 0}
+		local function on_step(self, dt)
+			self.count = self.count + dt
+		end
+		collectgarbage("collect")
+		collectgarbage("stop")
+		local memory_kb = collectgarbage("count")
+		for _ = 1, 10000 do
+			Debugging.pcall(on_step, sys, 1)
+		end
+		assert(collectgarbage("count") == memory_kb)
+		collectgarbage("restart")
+		assert(sys.count == 10000)
+	)";
+
+	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
+}
+OD_TEST(odTest_odLuaBindings_odJson) {
+	odLuaClient lua;
+	OD_ASSERT(odLuaClient_init(&lua));
+
+	const char test_script[] = R"(
+		local Json = odClientWrapper.Json
+
+		assert(Json.encode(nil) == "null")
+		assert(Json.encode(true) == "true")
+		assert(Json.encode(0.5) == "0.5" and Json.encode(-3) == "-3" and Json.encode(1e300) == "1e+300")
+		assert(Json.encode(0/0) == "null" and Json.encode(math.huge) == "null")
+		assert(Json.encode("a\"b\\c\n\1\127") == [["a\"b\\c\n\u0001\u007f"]])
+		assert(Json.encode("\226\128\168") == [["\u2028"]])
+		assert(Json.encode({}) == "[]")
+		assert(Json.encode({1, 2, {3}}) == "[1,2,[3]]")
+		assert(Json.encode({1, nil, 3}) == "[1,null,3]")
+		assert(Json.encode({[20] = 1}) == [[{"20":1}]])
+		assert(Json.encode({a = {b = true}}, {indent = true}) == "{\n  \"a\":{\n    \"b\":true\n  }\n}")
+		assert(Json.encode(setmetatable({}, {__jsontype = "object"})) == "{}")
+		assert(Json.encode(setmetatable({}, {__tojson = function() return "null" end})) == "null")
+
+		assert(not pcall(Json.encode, function() end))
+		assert(not pcall(Json.encode, {[true] = 1}))
+		local cyclic = {}
+		cyclic.self = cyclic
+		assert(not pcall(Json.encode, cyclic))
+
+		local str = ' {"a": [1, 2.5e1, "x\\u00e9\\ud83d\\ude00", true, null], "b": {}} '
+		local value, pos = Json.decode(str)
+		assert(pos == #str)
+		assert(value.a[1] == 1 and value.a[2] == 25 and value.a[3] == "x\195\169\240\159\152\128")
+		assert(value.a[4] == true and value.a[5] == nil)
+		assert(getmetatable(value).__jsontype == "object" and getmetatable(value.a).__jsontype == "array")
+		assert(Json.encode(value.b) == "{}")
+		assert(Json.decode("// comment\n[1 /* 2 */]")[1] == 1)
+		assert(Json.decode("null", 1, "null") == "null")
+		assert(getmetatable(Json.decode("[]", 1, nil, nil)) == nil)
+
+		local value, pos, err = Json.decode("[1, 2")
+		assert(value == nil and pos == 6 and err == "unterminated array at line 1, column 1")
+		local value, pos, err = Json.decode("\n  [nope]")
+		assert(value == nil and pos == 5 and err == "no valid JSON value at line 2, column 4")
+		local value, pos, err = Json.decode("")
+		assert(value == nil and pos == 1 and err == 'no valid JSON value (reached the end)')
+		local value, pos, err = Json.decode("{null: 1}")
+		assert(value == nil and pos == 6 and err == 'cannot use nil as table index (at line 1, column 6)')
+
+		local state = {entities = {}}
+		for i = 1, 1000 do
+			state.entities[i] = {x = i * 0.25, y = -i, name = "entity"..i, tags = {"a", "b"}}
+		end
+		local encoded = Json.encode(state)
+		assert(Json.encode(Json.decode(encoded)) == encoded)
+	)";
+
+	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
+}
+OD_TEST(odTest_odLuaBindings_odProfile) {
+	odLuaClient lua;
+	OD_ASSERT(odLuaClient_init(&lua));
+
+	const char test_script[] = R"(
+		local Profile = odClientWrapper.Profile
+		assert(type(Profile.is_enabled()) == "boolean")
+
+		local zone_id = Profile.get_zone_id("odTest_odLuaBindings_odProfile")
+		assert(Profile.get_zone_id("odTest_odLuaBindings_odProfile") == zone_id)
+		assert(not pcall(Profile.begin_zone, -1))
+
+		for _ = 1, 3 do
+			Profile.begin_zone(zone_id)
+			assert(Profile.end_zone(zone_id))
+		end
+		assert(not Profile.end_zone(zone_id))
+		assert(Profile.get_frame_stats()["odTest_odLuaBindings_odProfile"] == nil)
+
+		local now_ns = Profile.get_now_ns()
+		assert(now_ns > 0 and Profile.get_now_ns() >= now_ns)
+	)";
+	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
+
+	odProfile_end_frame();
+
+	const char stats_script[] = R"(
+		local stats = odClientWrapper.Profile.get_frame_stats()["odTest_odLuaBindings_odProfile"]
+		assert(stats.count == 3)
+		assert(stats.total_ms >= 0 and stats.max_ms <= stats.total_ms)
+		assert(odClientWrapper.Profile.get_frame_count() > 0)
+	)";
+	OD_ASSERT(odLua_run_string(lua.lua, stats_script, nullptr, 0));
+}
+OD_TEST(odTest_odLuaBindings_odLuaProfiler) {
+	odLuaClient lua;
+	OD_ASSERT(odLuaClient_init(&lua));
+
+	const char test_script[] = R"(
+		local LuaProfiler = odClientWrapper.LuaProfiler
+		assert(not LuaProfiler.is_running())
+		assert(not LuaProfiler.stop())
+		assert(not pcall(LuaProfiler.start, 0))
+
+		local function hot(n)
+			local sum = 0
+			for i = 1, n do
+				sum = sum + (i % 7)
+			end
+			return sum
+		end
+		-- not tail calls, which lua 5.1 reports as anonymous frames
+		local function recurse(depth)
+			local sum
+			if depth == 0 then
+				sum = hot(20000)
+			else
+				sum = recurse(depth - 1)
+			end
+			return sum
+		end
+
+		LuaProfiler.start(100)
+		assert(LuaProfiler.is_running())
+		for _ = 1, 10 do
+			recurse(3)
+		end
+		assert(LuaProfiler.stop())
+		assert(not LuaProfiler.is_running())
+
+		local stats = LuaProfiler.get_stats()
+		assert(stats.samples > 100 and stats.samples_dropped == 0 and stats.period == 100)
+		assert(type(stats.caveat) == "string")
+
+		local hot_stats, recurse_stats
+		for _, function_stats in ipairs(stats.functions) do
+			if string.find(function_stats.name, "^hot ") then
+				hot_stats = function_stats
+			elseif string.find(function_stats.name, "^recurse ") then
+				recurse_stats = function_stats
+			end
+		end
+		assert(hot_stats.self_samples > 0 and hot_stats.total_samples == hot_stats.self_samples)
+		assert(recurse_stats.total_samples >= hot_stats.total_samples)
+		assert(recurse_stats.total_samples <= stats.samples)
+
+		local line_samples = 0
+		for _, line_stats in ipairs(stats.lines) do
+			if line_stats["function"] == hot_stats.name then
+				assert(line_stats.line > hot_stats.line)
+				line_samples = line_samples + line_stats.samples
+			end
+		end
+		assert(line_samples == hot_stats.self_samples)
+
+		local filename = "odTest_odLuaBindings_odLuaProfiler.folded"
+		assert(LuaProfiler.write_folded(filename))
+		local file = io.open(filename, "rb")
+		local folded = file:read("*a")
+		file:close()
+		os.remove(filename)
+		assert(string.find(folded, "recurse [^\n]*;recurse [^\n]*;hot [^\n]* %d+\n") ~= nil)
+
+		-- only one hook can be set at a time
+		debug.sethook(function() end, "", 1000)
+		assert(not pcall(LuaProfiler.start))
+		debug.sethook()
+	)";
+
+	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
+}
+OD_TEST(odTest_odLuaBindings_odFrameWatchdog) {
+	odLuaClient lua;
+	OD_ASSERT(odLuaClient_init(&lua));
+
+	const char test_script[] = R"(
+		local FrameWatchdog = odClientWrapper.FrameWatchdog
+		assert(not FrameWatchdog.is_running())
+		assert(not FrameWatchdog.stop())
+		assert(not pcall(FrameWatchdog.start, "odTest_odLuaBindings_odFrameWatchdog", 0))
+		assert(not pcall(FrameWatchdog.start, "odTest_odLuaBindings_odFrameWatchdog", 1, 0))
+
+		local filename = "odTest_odLuaBindings_odFrameWatchdog"
+		assert(FrameWatchdog.start(filename, 0.001, 1))
+		assert(FrameWatchdog.is_running())
+		FrameWatchdog.begin_frame()
+		local sum = 0
+		for i = 1, 100000 do
+			sum = sum + i
+		end
+		FrameWatchdog.end_frame("slow loop")
+		assert(FrameWatchdog.stop())
+		assert(FrameWatchdog.get_dump_count() == 1)
+
+		local file = io.open(filename..".0", "rb")
+		local dump = file:read("*a")
+		file:close()
+		os.remove(filename..".0")
+		assert(string.find(dump, '"note":"slow loop"', 1, true) ~= nil)
+	)";
+	OD_ASSERT(odLua_run_string(lua.lua, test_script, nullptr, 0));
+}
 
 OD_TEST_SUITE(
 	odTestSuite_odLuaBindings,
@@ -494,6 +894,7 @@ OD_TEST_SUITE(
 	odTest_odLuaBindings_odVertexArray,
 	odTest_odLuaBindings_odAsciiFont,
 	odTest_odLuaBindings_odWindow,
+	odTest_odLuaBindings_odWindow_key_states,
 	odTest_odLuaBindings_odTexture,
 	odTest_odLuaBindings_odTextureAtlas,
 	odTest_odLuaBindings_odRenderTexture,
@@ -502,5 +903,12 @@ OD_TEST_SUITE(
 	odTest_odLuaBindings_odAudio,
 	odTest_odLuaBindings_odMusic,
 	odTest_odLuaBindings_odEntityIndex,
-	odTest_odLuaBindings_odEntityIndex_odVertexArray_integration
+	odTest_odLuaBindings_odEntityIndex_odVertexArray_integration,
+	odTest_odLuaBindings_odSnapshot,
+	odTest_odLuaBindings_odSnapshot_copy_restore,
+	odTest_odLuaBindings_odDebugging,
+	odTest_odLuaBindings_odJson,
+	odTest_odLuaBindings_odProfile,
+	odTest_odLuaBindings_odLuaProfiler,
+	odTest_odLuaBindings_odFrameWatchdog
 )
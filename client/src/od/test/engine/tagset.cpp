@@ -0,0 +1,130 @@
+#include <od/engine/tagset.h>
+
+#include <od/core/debug.h>
+#include <od/core/bounds.h>
+#include <od/engine/entity.h>
+#include <od/engine/entity_index.hpp>
+#include <od/test/test.hpp>
+#include <od/test/benchmark.hpp>
+
+OD_TEST(odTest_odTagset_set_get) {
+	const int32_t tag_ids[] = {0, 1, OD_TAGSET_ELEMENT_BIT_SIZE - 1, OD_TAGSET_ELEMENT_BIT_SIZE, OD_TAG_ID_COUNT - 1};
+
+	odTagset tagset{};
+	int32_t tag_count = 0;
+	for (int32_t tag_id : tag_ids) {
+		OD_ASSERT(!odTagset_get(&tagset, tag_id));
+
+		// disabling an unset tag must not set it
+		odTagset_set(&tagset, tag_id, false);
+		OD_ASSERT(!odTagset_get(&tagset, tag_id));
+
+		odTagset_set(&tagset, tag_id, true);
+		odTagset_set(&tagset, tag_id, true);
+		OD_ASSERT(odTagset_get(&tagset, tag_id));
+
+		tag_count++;
+		OD_ASSERT(odTagset_get_count(&tagset) == tag_count);
+	}
+
+	for (int32_t tag_id : tag_ids) {
+		odTagset_set(&tagset, tag_id, false);
+		OD_ASSERT(!odTagset_get(&tagset, tag_id));
+	}
+	OD_ASSERT(odTagset_get_count(&tagset) == 0);
+}
+OD_TEST(odTest_odTagset_intersects) {
+	odTagset tagset{};
+	odTagset required{};
+	OD_ASSERT(odTagset_intersects(&tagset, &required));
+
+	odTagset_set(&tagset, 3, true);
+	odTagset_set(&tagset, OD_TAG_ID_COUNT - 1, true);
+	OD_ASSERT(odTagset_intersects(&tagset, &required));
+
+	// each 128-bit lane must match, not just the first
+	odTagset_set(&required, OD_TAG_ID_COUNT - 1, true);
+	OD_ASSERT(odTagset_intersects(&tagset, &required));
+	odTagset_set(&required, OD_TAG_ID_COUNT - 2, true);
+	OD_ASSERT(!odTagset_intersects(&tagset, &required));
+	odTagset_set(&tagset, OD_TAG_ID_COUNT - 2, true);
+	OD_ASSERT(odTagset_intersects(&tagset, &required));
+
+	odTagset_set(&required, 4, true);
+	OD_ASSERT(!odTagset_intersects(&tagset, &required));
+}
+OD_TEST(odTest_odTagset_get_equals) {
+	odTagset a{};
+	odTagset b{};
+	OD_ASSERT(odTagset_get_equals(&a, &b));
+
+	odTagset_set(&a, OD_TAG_ID_COUNT - 1, true);
+	OD_ASSERT(!odTagset_get_equals(&a, &b));
+	odTagset_set(&b, OD_TAG_ID_COUNT - 1, true);
+	OD_ASSERT(odTagset_get_equals(&a, &b));
+
+	odTagset_set(&b, 0, true);
+	OD_ASSERT(!odTagset_get_equals(&a, &b));
+}
+
+OD_TEST_SUITE(
+	odTestSuite_odTagset,
+	odTest_odTagset_set_get,
+	odTest_odTagset_intersects,
+	odTest_odTagset_get_equals,
+)
+
+/* Tagged searches as the entity index runs them, so the cost includes collider stride. The tagset width is
+fixed per build by OD_BUILD_TAGSET_BITS, so widths are compared by running this under each setting, with
+--benchmark-baseline set to the json written by another. */
+OD_BENCHMARK(odBenchmark_odTagset_entity_search) {
+	const int32_t tile_width = 8;
+	const float tile_width_f = static_cast<float>(tile_width);
+	const int32_t grid_tile_width = (
+		1 << (OD_ENTITY_CHUNK_OPTIMUM_WORLD_WIDTH_BITS - OD_ENTITY_CHUNK_OPTIMUM_CHUNK_WIDTH_BITS));
+	const int32_t entities_count = grid_tile_width * grid_tile_width;
+	const int32_t searches_count = 1024;
+	const int32_t search_results_count = 16;
+	const int32_t search_tile_width = 4;
+	const int32_t required_tag_id = 7;
+
+	odEntityIndex entity_index{};
+	for (int32_t i = 0; i < entities_count; i++) {
+		float x = static_cast<float>((i % grid_tile_width) * tile_width);
+		float y = static_cast<float>((i / grid_tile_width) * tile_width);
+
+		odEntity entity{};
+		entity.collider.id = i;
+		entity.collider.bounds = odBounds{x, y, x + tile_width_f, y + tile_width_f};
+		odTagset_set(&entity.collider.tagset, i % OD_TAG_ID_COUNT, true);
+		odTagset_set(&entity.collider.tagset, (i * 7) % OD_TAG_ID_COUNT, true);
+		odEntityIndex_set(&entity_index, &entity);
+	}
+
+	odTagset required{};
+	odTagset_set(&required, required_tag_id, true);
+
+	odEntityId search_results[search_results_count];
+	while (odBenchmarkRun_next(run)) {
+		int32_t found_count = 0;
+		for (int32_t i = 0; i < searches_count; i++) {
+			float x = static_cast<float>(((i * 7) % grid_tile_width) * tile_width);
+			float y = static_cast<float>(((i * 13) % grid_tile_width) * tile_width);
+			float search_width = static_cast<float>(search_tile_width * tile_width);
+
+			odEntitySearch search{
+				search_results,
+				search_results_count,
+				odBounds{x, y, x + search_width, y + search_width},
+				required,
+				nullptr};
+			found_count += odEntityIndex_search(&entity_index, &search);
+		}
+		OD_ASSERT(found_count > 0);
+	}
+}
+
+OD_BENCHMARK_SUITE(
+	odBenchmarkSuite_odTagset,
+	odBenchmark_odTagset_entity_search,
+)
@@ -6,7 +6,7 @@
 
 OD_TEST_FILTERED(odTest_odTextureAtlas_init_destroy, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odTextureAtlas atlas;
@@ -28,7 +28,7 @@ OD_TEST_FILTERED(odTest_odTextureAtlas_set_reset_get_region_bounds, OD_TEST_FILT
 	const odColor pixels[width * height]{};
 
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odTextureAtlas atlas;
@@ -58,7 +58,7 @@ OD_TEST_FILTERED(odTest_odTextureAtlas_set_reset_set_reused, OD_TEST_FILTER_SLOW
 	const odColor pixels[width * height]{};
 
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odTextureAtlas atlas;
@@ -87,7 +87,7 @@ OD_TEST_FILTERED(odTest_odTextureAtlas_set_reset_scaling_sizes, OD_TEST_FILTER_S
 	const odColor pixels[max_width * max_height]{};
 
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odTextureAtlas atlas;
@@ -169,7 +169,7 @@ OD_TEST_FILTERED(odTest_odTextureAtlas_set_reset_realistic, OD_TEST_FILTER_SLOW)
 	int32_t sum_set_area = 0;
 
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odTextureAtlas atlas;
@@ -7,6 +7,7 @@
 #include <od/core/color.h>
 #include <od/core/vertex.h>
 #include <od/test/test.hpp>
+#include <od/test/benchmark.hpp>
 
 OD_TEST(odTest_odAsciiFont_text_get_vertices) {
 	odAsciiFont font{
@@ -54,3 +55,49 @@ OD_TEST_SUITE(
 	odTestSuite_odAsciiFont,
 	odTest_odAsciiFont_text_get_vertices,
 )
+
+OD_BENCHMARK(odBenchmark_odAsciiFont_text_get_vertices) {
+	// a screen of wrapped text
+	const int32_t str_count = 2048;
+	const int32_t line_count = 64;
+
+	odAsciiFont font{
+		odBounds{0.0f, 160.0f, 64.0f, 256.0f},
+		8,
+		8,
+		' ',
+		'~'
+	};
+
+	char str[str_count];
+	for (int32_t i = 0; i < str_count; i++) {
+		str[i] = static_cast<char>(' ' + (i % ('~' - ' ' + 1)));
+		if ((i % line_count) == (line_count - 1)) {
+			str[i] = '\n';
+		}
+	}
+
+	odAsciiTextPrimitive text{
+		str,
+		str_count,
+		odBounds{0.0f, 0.0f, 320.0f, 4096.0f},
+		*odColor_get_white(),
+		1.0f
+	};
+	OD_ASSERT(odAsciiTextPrimitive_check_valid(&text));
+
+	odTrivialArrayT<odVertex> vertices{};
+	OD_ASSERT(vertices.set_count(odAsciiTextPrimitive_get_max_vertices_count(&text)));
+
+	while (odBenchmarkRun_next(run)) {
+		int32_t vertices_count = 0;
+		odBounds bounds{};
+		OD_ASSERT(odAsciiFont_text_get_vertices(&font, &text, &vertices_count, &bounds, vertices.begin()));
+		OD_ASSERT(vertices_count > 0);
+	}
+}
+
+OD_BENCHMARK_SUITE(
+	odBenchmarkSuite_odAsciiFont,
+	odBenchmark_odAsciiFont_text_get_vertices,
+)
@@ -2,6 +2,10 @@
 
 #include <cstring>
 
+#include <SDL2/SDL_mixer.h>
+
+#include <od/core/debug.hpp>
+#include <od/platform/file.h>
 #include <od/platform/timer.h>
 #include <od/platform/sdl.h>
 #include <od/test/test.hpp>
@@ -10,6 +14,8 @@ static OD_NO_DISCARD bool
 odTest_odAudio_wait_until_complete(odAudioPlaybackId playback_id, float max_time_sec);
 static OD_NO_DISCARD bool
 odTest_odAudio_init_sine(odAudio* audio);
+static OD_NO_DISCARD bool
+odTest_odAudio_write_wav_file(const char* filename);
 static const odAudioPlaybackSettings*
 odTest_odAudioPlaybackSettings_get_defaults();
 
@@ -46,6 +52,16 @@ bool odTest_odAudio_init_sine(odAudio* audio) {
 	const int32_t wav_size = sizeof(wav_sine_22050hz_s16);
 	return OD_CHECK(odAudio_init_wav(audio, wav_sine_22050hz_s16, wav_size));
 }
+bool odTest_odAudio_write_wav_file(const char* filename) {
+	const uint8_t wav_three_samples_22050hz_s16[] = {
+		0x52, 0x49, 0x46, 0x46, 0x2a, 0x00, 0x00, 0x00, 0x57, 0x41, 0x56, 0x45,
+		0x66, 0x6d, 0x74, 0x20, 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00,
+		0x22, 0x56, 0x00, 0x00, 0x44, 0xac, 0x00, 0x00, 0x02, 0x00, 0x10, 0x00,
+		0x64, 0x61, 0x74, 0x61, 0x06, 0x00, 0x00, 0x00, 0x66, 0x66, 0x67, 0x66, 0x68, 0x66
+	};
+	const int32_t wav_size = sizeof(wav_three_samples_22050hz_s16);
+	return OD_CHECK(odFile_write_all(filename, "wb", wav_three_samples_22050hz_s16, wav_size));
+}
 const odAudioPlaybackSettings* odTest_odAudioPlaybackSettings_get_defaults() {
 	static const odAudioPlaybackSettings settings{
 		/*loop_count*/ 0,
@@ -86,6 +102,31 @@ OD_TEST_FILTERED(odTest_odAudio_set_volume, OD_TEST_FILTER_SLOW) {
 	OD_ASSERT(odAudio_set_volume(&audio, 0.5f));
 	OD_ASSERT(odAudio_set_volume(&audio, 0.0f));
 }
+OD_TEST_FILTERED(odTest_odAudio_set_volume_while_playing, OD_TEST_FILTER_SLOW) {
+	OD_ASSERT(odAudio_stop_all());
+
+	odAudio audio;
+	OD_ASSERT(odTest_odAudio_init_sine(&audio));
+
+	odAudioPlaybackSettings settings = *odTest_odAudioPlaybackSettings_get_defaults();
+	settings.volume = 1.0f;
+	settings.is_cutoff_time_enabled = false;
+	odAudioPlaybackId playback_id = odAudio_play(&audio, &settings);
+	OD_ASSERT(odAudioPlaybackId_check_valid(playback_id));
+
+	OD_ASSERT(odAudio_set_volume(&audio, 0.5f));
+
+	int32_t playing_count = 0;
+	for (int channel = 0; channel < OD_AUDIO_MIXER_CHANNELS; channel++) {
+		if (Mix_Playing(channel) == 1) {
+			OD_ASSERT(Mix_Volume(channel, /*query*/ -1) == (MIX_MAX_VOLUME / 2));
+			playing_count++;
+		}
+	}
+	OD_ASSERT(playing_count == 1);
+
+	OD_ASSERT(odAudio_stop_all());
+}
 OD_TEST_FILTERED(odTest_odAudio_set_volume_out_of_range_fails, OD_TEST_FILTER_SLOW) {
 	odAudio audio;
 	OD_ASSERT(odTest_odAudio_init_sine(&audio));
@@ -179,15 +220,129 @@ OD_TEST_FILTERED(odTest_odAudio_play_stop, OD_TEST_FILTER_SLOW) {
 
 	OD_ASSERT(odAudio_stop_all());
 }
+OD_TEST_FILTERED(odTest_odAudioCache_shares_wav, OD_TEST_FILTER_SLOW) {
+	odAudioCacheStats stats_before{};
+	OD_ASSERT(odAudioCache_get_stats(&stats_before));
+
+	odAudio audio1;
+	odAudio audio2;
+	OD_ASSERT(odTest_odAudio_init_sine(&audio1));
+	OD_ASSERT(odTest_odAudio_init_sine(&audio2));
+	OD_ASSERT(audio1.audio_native == audio2.audio_native);
+
+	odAudioCacheStats stats{};
+	OD_ASSERT(odAudioCache_get_stats(&stats));
+	OD_ASSERT(stats.lookup_count == stats_before.lookup_count + 2);
+	OD_ASSERT(stats.hit_count == stats_before.hit_count + 1);
+	OD_ASSERT(stats.entry_count == stats_before.entry_count + 1);
+	OD_ASSERT(stats.decoded_bytes > stats_before.decoded_bytes);
+
+	odAudio_destroy(&audio1);
+	OD_ASSERT(odAudio_check_valid(&audio2));
+	OD_ASSERT(odAudioCache_get_stats(&stats));
+	OD_ASSERT(stats.entry_count == stats_before.entry_count + 1);
+
+	odAudio_destroy(&audio2);
+	OD_ASSERT(odAudioCache_get_stats(&stats));
+	OD_ASSERT(stats.entry_count == stats_before.entry_count);
+	OD_ASSERT(stats.decoded_bytes == stats_before.decoded_bytes);
+}
+OD_TEST_FILTERED(odTest_odAudioCache_destroy_stops_own_playback, OD_TEST_FILTER_SLOW) {
+	odAudio audio1;
+	odAudio audio2;
+	OD_ASSERT(odTest_odAudio_init_sine(&audio1));
+	OD_ASSERT(odTest_odAudio_init_sine(&audio2));
+
+	odAudioPlaybackId playback_id1 = odAudio_play(&audio1, odTest_odAudioPlaybackSettings_get_defaults());
+	odAudioPlaybackId playback_id2 = odAudio_play(&audio2, odTest_odAudioPlaybackSettings_get_defaults());
+	OD_ASSERT(odAudioPlaybackId_check_valid(playback_id1));
+	OD_ASSERT(odAudioPlaybackId_check_valid(playback_id2));
+
+	odAudio swapped_audio1;
+	odAudio_swap(&audio1, &swapped_audio1);  // playback is tracked by owner, not address
+	odAudio_destroy(&swapped_audio1);
+	OD_ASSERT(!odAudio_is_playing(playback_id1));
+	OD_ASSERT(odAudio_is_playing(playback_id2));
+
+	OD_ASSERT(odAudio_stop_all());
+}
+OD_TEST_FILTERED(odTest_odAudioCache_move_releases_once, OD_TEST_FILTER_SLOW) {
+	odAudioCacheStats stats_before{};
+	OD_ASSERT(odAudioCache_get_stats(&stats_before));
+
+	odAudio audio_other;
+	OD_ASSERT(odTest_odAudio_init_sine(&audio_other));
+	odAudio audio1;
+	OD_ASSERT(odTest_odAudio_init_sine(&audio1));
+	odAudio audio2{static_cast<odAudio&&>(audio1)};
+	OD_ASSERT(audio1.audio_native == nullptr);
+	OD_ASSERT(odAudio_check_valid(&audio2));
+
+	odAudio audio3;
+	audio3 = static_cast<odAudio&&>(audio2);
+	OD_ASSERT(audio2.audio_native == nullptr);
+	OD_ASSERT(odAudio_check_valid(&audio3));
+
+	odAudioCacheStats stats{};
+	odAudio_destroy(&audio1);
+	odAudio_destroy(&audio2);
+	odAudio_destroy(&audio_other);  // moves audio3 into the released mixer slot
+	OD_ASSERT(odAudioCache_get_stats(&stats));
+	OD_ASSERT(stats.entry_count == stats_before.entry_count + 1);
+
+	odAudio_destroy(&audio3);
+	OD_ASSERT(odAudioCache_get_stats(&stats));
+	OD_ASSERT(stats.entry_count == stats_before.entry_count);
+}
+OD_TEST_FILTERED(odTest_odAudioCache_preload_files, OD_TEST_FILTER_SLOW) {
+	const char* filename = "odTest_odAudioCache_preload_files.wav";
+	OD_ASSERT(odTest_odAudio_write_wav_file(filename));
+
+	odAudioCacheStats stats_before{};
+	OD_ASSERT(odAudioCache_get_stats(&stats_before));
+
+	const char* filenames[] = {filename, filename};
+	OD_ASSERT(odAudioCache_preload_files(filenames, 2, /*background*/ true));
+	OD_ASSERT(odAudioCache_wait_preload());
+	OD_ASSERT(!odAudioCache_get_preloading());
+
+	odAudioCacheStats stats{};
+	OD_ASSERT(odAudioCache_get_stats(&stats));
+	OD_ASSERT(stats.entry_count == stats_before.entry_count + 1);
+	OD_ASSERT(stats.preloaded_count == stats_before.preloaded_count + 1);
+	OD_ASSERT(stats.lookup_count == stats_before.lookup_count);
+
+	odAudio audio;
+	OD_ASSERT(odAudio_init_wav_file(&audio, filename));
+	OD_ASSERT(odAudioCache_get_stats(&stats));
+	OD_ASSERT(stats.hit_count == stats_before.hit_count + 1);
+
+	odAudioCache_release_preloaded();
+	OD_ASSERT(odAudio_check_valid(&audio));
+	OD_ASSERT(odAudioCache_get_stats(&stats));
+	OD_ASSERT(stats.entry_count == stats_before.entry_count + 1);
+	OD_ASSERT(stats.preloaded_count == stats_before.preloaded_count);
+
+	odAudio_destroy(&audio);
+	OD_ASSERT(odAudioCache_get_stats(&stats));
+	OD_ASSERT(stats.entry_count == stats_before.entry_count);
+
+	OD_ASSERT(odFile_delete(filename));
+}
 OD_TEST_SUITE(
 	odTestSuite_odAudio,
 	odTest_odAudio_init_destroy,
 	odTest_odAudio_init_wav,
 	odTest_odAudio_set_volume,
+	odTest_odAudio_set_volume_while_playing,
 	odTest_odAudio_set_volume_out_of_range_fails,
 	odTest_odAudio_play,
 	odTest_odAudio_play_simultaneous,
 	odTest_odAudio_play_simultaneous_above_max_fails,
 	odTest_odAudio_play_destroy,
 	odTest_odAudio_play_stop,
+	odTest_odAudioCache_shares_wav,
+	odTest_odAudioCache_destroy_stops_own_playback,
+	odTest_odAudioCache_move_releases_once,
+	odTest_odAudioCache_preload_files,
 )
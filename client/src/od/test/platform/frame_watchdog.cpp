@@ -0,0 +1,96 @@
+#include <od/platform/frame_watchdog.h>
+
+#include <cstring>
+
+#include <od/core/debug.hpp>
+#include <od/core/allocation.hpp>
+#include <od/core/string.hpp>
+#include <od/platform/file.h>
+#include <od/platform/profile.h>
+#include <od/platform/timer.h>
+#include <od/test/test.hpp>
+
+static void odTest_odFrameWatchdog_wait_ns(int64_t wait_ns) {
+	odTimer timer;
+	odTimer_start(&timer);
+	while (odTimer_get_elapsed_ns(&timer) < wait_ns) {
+	}
+}
+
+OD_TEST(odTest_odFrameWatchdog_under_budget) {
+	const char filename[] = "odTest_odFrameWatchdog_under_budget";
+	OD_ASSERT(!odFrameWatchdog_get_running());
+	OD_ASSERT(odFrameWatchdog_start(filename, 1000.0f, 1));
+	OD_ASSERT(odFrameWatchdog_get_running());
+	{
+		odLogLevelScoped suppress_errors{OD_LOG_LEVEL_FATAL};
+		OD_ASSERT(!odFrameWatchdog_start(filename, 1000.0f, 1));
+	}
+
+	for (int32_t i = 0; i < 3; i++) {
+		odFrameWatchdog_begin_frame();
+		odFrameWatchdog_end_frame();
+	}
+
+	OD_ASSERT(odFrameWatchdog_stop());
+	OD_ASSERT(!odFrameWatchdog_get_running());
+	OD_ASSERT(odFrameWatchdog_get_dump_count() == 0);
+	OD_ASSERT(!odFile_get_exists("odTest_odFrameWatchdog_under_budget.0"));
+}
+OD_TEST(odTest_odFrameWatchdog_over_budget) {
+	const char filename[] = "odTest_odFrameWatchdog_over_budget";
+	int32_t zone_id = odProfile_get_zone_id("odTest_odFrameWatchdog_over_budget");
+	OD_ASSERT(zone_id != OD_PROFILE_ZONE_ID_INVALID);
+
+	const float budget_ms = 1.0f;
+	const int64_t slow_frame_ns = 2000000;
+	OD_ASSERT(odFrameWatchdog_start(filename, budget_ms, 2));
+
+	odFrameWatchdog_begin_frame();
+	odFrameWatchdog_end_frame();
+
+	odFrameWatchdog_begin_frame();
+	odProfile_add_sample(zone_id, 0, slow_frame_ns);
+	odTest_odFrameWatchdog_wait_ns(slow_frame_ns);
+	odFrameWatchdog_set_note("slow \"system\"");
+	odFrameWatchdog_end_frame();
+	odProfile_end_frame();
+
+	// the dump waits for the profile's frame stats, published before the next frame begins
+	OD_ASSERT(odFrameWatchdog_get_dump_count() == 0);
+	odFrameWatchdog_begin_frame();
+	OD_ASSERT(odFrameWatchdog_get_dump_count() == 1);
+	odFrameWatchdog_end_frame();
+
+	odAllocation allocation;
+	int32_t size = 0;
+	OD_ASSERT(odFile_read_all("odTest_odFrameWatchdog_over_budget.0", "rb", &allocation, &size));
+	OD_ASSERT(odFile_delete("odTest_odFrameWatchdog_over_budget.0"));
+
+	odString json_str;
+	OD_ASSERT(odString_assign(&json_str, static_cast<const char*>(allocation.ptr), size));
+	const char* json = odString_get_c_str(&json_str);
+	OD_ASSERT(strstr(json, "\"slow_frame\":1,") != nullptr);
+	OD_ASSERT(strstr(json, "{\"frame\":0,") != nullptr);
+	OD_ASSERT(strstr(json, "\"note\":\"slow \\\"system\\\"\"") != nullptr);
+	OD_ASSERT(strstr(json, "{\"name\":\"odTest_odFrameWatchdog_over_budget\",\"count\":1,\"total_ms\":2.000") != nullptr);
+	OD_ASSERT(strstr(json, "{\"frame\":2,") == nullptr);
+
+	// dumps rotate through file_count files, and stopping writes a dump still waiting on the next frame
+	for (int32_t i = 0; i < 2; i++) {
+		odFrameWatchdog_begin_frame();
+		odTest_odFrameWatchdog_wait_ns(slow_frame_ns);
+		odFrameWatchdog_end_frame();
+	}
+	OD_ASSERT(odFrameWatchdog_stop());
+	OD_ASSERT(odFrameWatchdog_get_dump_count() == 3);
+	OD_ASSERT(odFile_delete("odTest_odFrameWatchdog_over_budget.0"));
+	OD_ASSERT(odFile_delete("odTest_odFrameWatchdog_over_budget.1"));
+	OD_ASSERT(!odFile_get_exists("odTest_odFrameWatchdog_over_budget.2"));
+}
+
+OD_TEST_SUITE(
+	odTestSuite_odFrameWatchdog,
+	odTest_odFrameWatchdog_under_budget,
+	odTest_odFrameWatchdog_over_budget,
+)
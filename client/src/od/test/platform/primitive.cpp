@@ -0,0 +1,84 @@
+#include <od/platform/primitive.h>
+
+#include <cstring>
+
+#include <od/core/array.hpp>
+#include <od/core/vertex.h>
+#include <od/test/test.hpp>
+#include <od/test/benchmark.hpp>
+
+// shuffled depths, each shared by triangles_count / depths_count triangles; u holds the original triangle index
+static void odTest_odTrianglePrimitive_init_depths(odVertex* vertices, int32_t triangles_count, int32_t depths_count) {
+	for (int32_t i = 0; i < triangles_count; i++) {
+		for (int32_t j = 0; j < OD_TRIANGLE_VERTEX_COUNT; j++) {
+			odVertex* vertex = &vertices[(i * OD_TRIANGLE_VERTEX_COUNT) + j];
+			*vertex = odVertex{};
+			vertex->pos.z = static_cast<float>((i * 7919) % depths_count);
+			vertex->u = static_cast<float>(i);
+		}
+	}
+}
+
+OD_TEST(odTest_odTrianglePrimitive_sort_vertices) {
+	const int32_t triangles_count = 256;
+
+	// many triangles per depth, as sprites on one layer share a depth; then all triangles at one depth
+	const int32_t depths_counts[] = {16, 1};
+	for (int32_t depths_count: depths_counts) {
+		odTrivialArrayT<odVertex> vertices;
+		OD_ASSERT(vertices.set_count(triangles_count * OD_TRIANGLE_VERTEX_COUNT));
+		odTest_odTrianglePrimitive_init_depths(vertices.begin(), triangles_count, depths_count);
+
+		odTrianglePrimitive_sort_vertices(vertices.begin(), vertices.get_count());
+
+		// back to front, triangles kept whole, and triangles of equal depth kept in their original order
+		int32_t equal_depths_count = 0;
+		for (int32_t i = 0; i < triangles_count; i++) {
+			const odVertex* triangle = vertices.get(i * OD_TRIANGLE_VERTEX_COUNT);
+			OD_ASSERT((triangle[1].u == triangle[0].u) && (triangle[2].u == triangle[0].u));
+
+			if (i > 0) {
+				const odVertex* prev_triangle = vertices.get((i - 1) * OD_TRIANGLE_VERTEX_COUNT);
+				OD_ASSERT(prev_triangle->pos.z >= triangle->pos.z);
+				if (prev_triangle->pos.z == triangle->pos.z) {
+					OD_ASSERT(prev_triangle->u < triangle->u);
+					equal_depths_count++;
+				}
+			}
+		}
+
+		// every triangle after the first of its depth went through the stability check
+		OD_ASSERT(equal_depths_count == (triangles_count - depths_count));
+	}
+}
+
+OD_TEST_SUITE(
+	odTestSuite_odPrimitive,
+	odTest_odTrianglePrimitive_sort_vertices,
+)
+
+OD_BENCHMARK(odBenchmark_odTrianglePrimitive_sort_vertices) {
+	// a frame's worth of sprites; timings include restoring the unsorted vertices
+	const int32_t triangles_count = 1 << 14;
+	const int32_t vertices_count = triangles_count * OD_TRIANGLE_VERTEX_COUNT;
+
+	odTrivialArrayT<odVertex> unsorted_vertices;
+	OD_ASSERT(unsorted_vertices.set_count(vertices_count));
+	odTest_odTrianglePrimitive_init_depths(unsorted_vertices.begin(), triangles_count, /*depths_count*/ 1024);
+
+	odTrivialArrayT<odVertex> vertices;
+	OD_ASSERT(vertices.set_count(vertices_count));
+
+	while (odBenchmarkRun_next(run)) {
+		memcpy(
+			static_cast<void*>(vertices.begin()),
+			static_cast<const void*>(unsorted_vertices.begin()),
+			sizeof(odVertex) * static_cast<size_t>(vertices_count));
+		odTrianglePrimitive_sort_vertices(vertices.begin(), vertices_count);
+	}
+}
+
+OD_BENCHMARK_SUITE(
+	odBenchmarkSuite_odPrimitive,
+	odBenchmark_odTrianglePrimitive_sort_vertices,
+)
@@ -0,0 +1,117 @@
+#include <od/platform/profile.hpp>
+
+#include <cstring>
+
+#include <od/core/allocation.hpp>
+#include <od/core/string.hpp>
+#include <od/platform/file.h>
+#include <od/test/test.hpp>
+
+OD_TEST(odTest_odProfile_get_zone_id) {
+	int32_t zone_id = odProfile_get_zone_id("odTest_odProfile_get_zone_id");
+	OD_ASSERT(zone_id != OD_PROFILE_ZONE_ID_INVALID);
+	OD_ASSERT(odProfile_get_zone_id("odTest_odProfile_get_zone_id") == zone_id);
+	OD_ASSERT(odProfile_get_zone_id("odTest_odProfile_get_zone_id_other") != zone_id);
+	OD_ASSERT(strcmp(odProfile_get_zone_name(zone_id), "odTest_odProfile_get_zone_id") == 0);
+}
+OD_TEST(odTest_odProfile_frame_stats) {
+	int32_t zone_id = odProfile_get_zone_id("odTest_odProfile_frame_stats");
+	OD_ASSERT(zone_id != OD_PROFILE_ZONE_ID_INVALID);
+
+	odProfile_end_frame();
+	int32_t frame_count = odProfile_get_frame_count();
+	odProfile_add_sample(zone_id, 100, 110);
+	odProfile_add_sample(zone_id, 200, 230);
+	odProfile_add_sample(zone_id, 300, 320);
+
+	// stats are published once the frame ends
+	OD_ASSERT(odProfile_get_frame_stats(zone_id)->count == 0);
+	odProfile_end_frame();
+	OD_ASSERT(odProfile_get_frame_count() == (frame_count + 1));
+
+	const odProfileZoneStats* stats = odProfile_get_frame_stats(zone_id);
+	OD_ASSERT(stats->count == 3);
+	OD_ASSERT(stats->total_ns == 60);
+	OD_ASSERT(stats->max_ns == 30);
+
+	odProfile_end_frame();
+	OD_ASSERT(odProfile_get_frame_stats(zone_id)->count == 0);
+}
+OD_TEST(odTest_odProfile_begin_end) {
+	int32_t outer_id = odProfile_get_zone_id("odTest_odProfile_begin_end_outer");
+	int32_t inner_id = odProfile_get_zone_id("odTest_odProfile_begin_end_inner");
+	OD_ASSERT(outer_id != OD_PROFILE_ZONE_ID_INVALID);
+	OD_ASSERT(inner_id != OD_PROFILE_ZONE_ID_INVALID);
+
+	odProfile_end_frame();
+	OD_ASSERT(odProfile_begin(outer_id));
+	OD_ASSERT(odProfile_begin(inner_id));
+	OD_ASSERT(odProfile_end(inner_id));
+	OD_ASSERT(!odProfile_end(inner_id));
+
+	// ending the outer zone discards an inner zone left open, e.g. by a lua error
+	OD_ASSERT(odProfile_begin(inner_id));
+	OD_ASSERT(odProfile_end(outer_id));
+	OD_ASSERT(!odProfile_end(inner_id));
+	odProfile_end_frame();
+
+	OD_ASSERT(odProfile_get_frame_stats(outer_id)->count == 1);
+	OD_ASSERT(odProfile_get_frame_stats(inner_id)->count == 1);
+	OD_ASSERT(odProfile_get_frame_stats(outer_id)->total_ns >= odProfile_get_frame_stats(inner_id)->total_ns);
+}
+OD_TEST(odTest_odProfile_scope) {
+	odProfile_end_frame();
+	for (int32_t i = 0; i < 3; i++) {
+		OD_PROFILE_SCOPE("odTest_odProfile_scope");
+	}
+	odProfile_end_frame();
+
+	int32_t zone_id = odProfile_get_zone_id("odTest_odProfile_scope");
+	OD_ASSERT(zone_id != OD_PROFILE_ZONE_ID_INVALID);
+	OD_ASSERT(odProfile_get_frame_stats(zone_id)->count == (OD_BUILD_PROFILE ? 3 : 0));
+}
+OD_TEST(odTest_odProfile_trace) {
+	const char filename[] = "odTest_odProfile_trace.json";
+	int32_t zone_id = odProfile_get_zone_id("odTest_odProfile_trace");
+	int32_t counter_id = odProfile_get_zone_id("odTest_odProfile_trace_counter");
+	OD_ASSERT(zone_id != OD_PROFILE_ZONE_ID_INVALID);
+	OD_ASSERT(counter_id != OD_PROFILE_ZONE_ID_INVALID);
+
+	// counters are only recorded while tracing
+	odProfile_add_counter(counter_id, 1);
+
+	OD_ASSERT(!odProfile_get_tracing());
+	OD_ASSERT(odProfile_begin_trace(filename, 2));
+	OD_ASSERT(odProfile_get_tracing());
+	odProfile_add_sample(zone_id, 100, 110);
+	odProfile_add_counter(counter_id, 42);
+	odProfile_end_frame();
+	OD_ASSERT(odProfile_get_tracing());
+	odProfile_end_frame();
+	OD_ASSERT(!odProfile_get_tracing());
+
+	odAllocation allocation;
+	int32_t size = 0;
+	OD_ASSERT(odFile_read_all(filename, "rb", &allocation, &size));
+	OD_ASSERT(odFile_delete(filename));
+
+	odString json_str;
+	OD_ASSERT(size > 0);
+	OD_ASSERT(odString_assign(&json_str, static_cast<const char*>(allocation.ptr), size));
+	const char* json = odString_get_c_str(&json_str);
+	OD_ASSERT(json[size - 1] == '\n');
+	OD_ASSERT(strstr(json, "\"traceEvents\":[") != nullptr);
+	OD_ASSERT(strstr(json, "{\"name\":\"odTest_odProfile_trace\",\"ph\":\"X\"") != nullptr);
+	OD_ASSERT(strstr(json, "\"args\":{\"value\":42}") != nullptr);
+	OD_ASSERT(strstr(json, "\"args\":{\"value\":1}") == nullptr);
+	OD_ASSERT(strstr(json, "{\"name\":\"frame\",\"ph\":\"X\"") != nullptr);
+}
+
+OD_TEST_SUITE(
+	odTestSuite_odProfile,
+	odTest_odProfile_get_zone_id,
+	odTest_odProfile_frame_stats,
+	odTest_odProfile_begin_end,
+	odTest_odProfile_scope,
+	odTest_odProfile_trace,
+)
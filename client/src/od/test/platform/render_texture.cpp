@@ -9,7 +9,7 @@
 
 OD_TEST_FILTERED(odTest_odRenderTexture_init_destroy, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odRenderTexture render_texture;
@@ -32,7 +32,7 @@ OD_TEST_FILTERED(odTest_odRenderTexture_init_destroy, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odRenderTexture_init_large, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odRenderTexture render_texture;
@@ -40,7 +40,7 @@ OD_TEST_FILTERED(odTest_odRenderTexture_init_large, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odRenderTexture_destroy_after_window_destroy_fails, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	{
@@ -6,6 +6,7 @@
 #include <od/core/array.hpp>
 #include <od/core/bounds.h>
 #include <od/core/color.h>
+#include <od/core/matrix.h>
 #include <od/core/vector.h>
 #include <od/core/vertex.h>
 #include <od/platform/primitive.h>
@@ -13,6 +14,7 @@
 #include <od/platform/texture.hpp>
 #include <od/platform/render_texture.hpp>
 #include <od/test/test.hpp>
+#include <od/test/benchmark.hpp>
 
 #define OD_RENDER_TEST_VERTEX_COUNT OD_TRIANGLE_VERTEX_COUNT
 
@@ -27,11 +29,28 @@ static const odBounds odTest_odRenderer_viewport{0.0f, 0.0f, 640.0f, 480.0f};
 static odRenderState odTest_odRenderer_create_state() {
 	return odRenderState{*odMatrix_get_identity(), *odMatrix_get_identity(), odTest_odRenderer_viewport};
 }
+static odRenderState odTest_odRenderer_create_ortho_state(int32_t width, int32_t height) {
+	odRenderState state{*odMatrix_get_identity(), *odMatrix_get_identity(),
+						odBounds{0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)}};
+	odMatrix_init_ortho_2d(&state.projection, width, height);
+	return state;
+}
+static odWindowSettings odTest_odRenderer_create_software_settings() {
+	odWindowSettings settings = *odWindowSettings_get_headless_defaults();
+	settings.is_software_renderer_enabled = true;
+	return settings;
+}
+static bool odTest_odRenderer_draw_sprite(odRenderer* renderer, const odRenderState* state, const odTexture* texture,
+										  const odSpritePrimitive* sprite, odRenderTexture* render_texture) {
+	odVertex vertices[OD_SPRITE_VERTEX_COUNT]{};
+	odSpritePrimitive_get_vertices(sprite, vertices);
+	return odRenderer_draw_vertices(renderer, vertices, OD_SPRITE_VERTEX_COUNT, state, texture, render_texture);
+}
 
 
 OD_TEST_FILTERED(odTest_odRenderer_init_destroy, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odRenderer renderer;
@@ -54,7 +73,7 @@ OD_TEST_FILTERED(odTest_odRenderer_init_destroy, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odRenderer_destroy_after_window_destroy_fails, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	{
@@ -69,7 +88,7 @@ OD_TEST_FILTERED(odTest_odRenderer_destroy_after_window_destroy_fails, OD_TEST_F
 }
 OD_TEST_FILTERED(odTest_odRenderer_flush, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	odRenderer renderer;
 	OD_ASSERT(odRenderer_init(&renderer, &window));
 
@@ -77,7 +96,7 @@ OD_TEST_FILTERED(odTest_odRenderer_flush, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odRenderer_clear, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	odRenderer renderer;
 	OD_ASSERT(odRenderer_init(&renderer, &window));
 	odTexture texture;
@@ -91,7 +110,7 @@ OD_TEST_FILTERED(odTest_odRenderer_clear, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odRenderer_draw_vertices, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	odRenderer renderer;
 	OD_ASSERT(odRenderer_init(&renderer, &window));
 	odTexture texture;
@@ -108,7 +127,7 @@ OD_TEST_FILTERED(odTest_odRenderer_draw_vertices, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odRenderer_draw_texture, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	odRenderer renderer;
 	OD_ASSERT(odRenderer_init(&renderer, &window));
 	odTexture texture;
@@ -128,7 +147,7 @@ OD_TEST_FILTERED(odTest_odRenderer_draw_texture, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odRenderer_init_multiple_renderers, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	odRenderer renderer;
 	OD_ASSERT(odRenderer_init(&renderer, &window));
 	odTexture texture;
@@ -153,6 +172,148 @@ OD_TEST_FILTERED(odTest_odRenderer_init_multiple_renderers, OD_TEST_FILTER_SLOW)
 	OD_ASSERT(odRenderer_draw_vertices(&renderer, odTest_odRenderer_test_vertices, OD_RENDER_TEST_VERTEX_COUNT, &state, &texture, nullptr));
 	OD_ASSERT(odRenderer_flush(&renderer));
 }
+OD_TEST(odTest_odRenderer_draw_headless) {
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	odRenderer renderer;
+	OD_ASSERT(odRenderer_init(&renderer, &window));
+	OD_ASSERT(odRenderer_check_valid(&renderer));
+	odTexture texture;
+	OD_ASSERT(odTexture_init_blank(&texture, &window));
+	odRenderTexture render_texture;
+	OD_ASSERT(odRenderTexture_init(&render_texture, &window, 640, 480));
+	odRenderState state = odTest_odRenderer_create_state();
+
+	OD_ASSERT(odRenderer_clear(&renderer, odColor_get_white(), &render_texture));
+	OD_ASSERT(odRenderer_draw_vertices(&renderer, odTest_odRenderer_test_vertices, OD_RENDER_TEST_VERTEX_COUNT, &state, &texture, &render_texture));
+	OD_ASSERT(odRenderer_draw_texture(&renderer, &state, odRenderTexture_get_texture(&render_texture), nullptr, nullptr, nullptr));
+	OD_ASSERT(odRenderer_flush(&renderer));
+
+	odRenderer_destroy(&renderer);
+	OD_ASSERT(odWindow_step(&window));
+}
+OD_TEST(odTest_odRenderer_software_draw_opaque) {
+	odWindowSettings settings = odTest_odRenderer_create_software_settings();
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, &settings));
+	odRenderer renderer;
+	OD_ASSERT(odRenderer_init(&renderer, &window));
+	odTexture texture;
+	OD_ASSERT(odTexture_init_blank(&texture, &window));
+
+	const int32_t width = 8;
+	const int32_t height = 8;
+	odRenderTexture render_texture;
+	OD_ASSERT(odRenderTexture_init(&render_texture, &window, width, height));
+	odRenderState state = odTest_odRenderer_create_ortho_state(width, height);
+
+	// top half of the view; rows are stored bottom-up, as in opengl
+	odSpritePrimitive sprite{
+		odBounds{0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height / 2)},
+		odBounds{0.0f, 0.0f, 1.0f, 1.0f},
+		*odColor_get_red(),
+		0.0f};
+	OD_ASSERT(odRenderer_clear(&renderer, odColor_get_black(), &render_texture));
+	OD_ASSERT(odTest_odRenderer_draw_sprite(&renderer, &state, &texture, &sprite, &render_texture));
+
+	const odColor* pixels = render_texture.texture.pixels.begin();
+	for (int32_t y = 0; y < height; y++) {
+		const odColor* expected = (y >= (height / 2)) ? odColor_get_red() : odColor_get_black();
+		for (int32_t x = 0; x < width; x++) {
+			OD_ASSERT(odColor_get_equals(&pixels[(y * width) + x], expected));
+		}
+	}
+}
+OD_TEST(odTest_odRenderer_software_draw_textured) {
+	odWindowSettings settings = odTest_odRenderer_create_software_settings();
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, &settings));
+	odRenderer renderer;
+	OD_ASSERT(odRenderer_init(&renderer, &window));
+
+	const odColor texture_pixels[2] = {*odColor_get_red(), *odColor_get_blue()};
+	odTexture texture;
+	OD_ASSERT(odTexture_init(&texture, &window, texture_pixels, 2, 1));
+
+	const int32_t width = 8;
+	const int32_t height = 8;
+	odRenderTexture render_texture;
+	OD_ASSERT(odRenderTexture_init(&render_texture, &window, width, height));
+	odRenderState state = odTest_odRenderer_create_ortho_state(width, height);
+
+	// each texel is stretched over half the target, with nearest sampling
+	odSpritePrimitive sprite{
+		odBounds{0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)},
+		odBounds{0.0f, 0.0f, 2.0f, 1.0f},
+		*odColor_get_white(),
+		0.0f};
+	OD_ASSERT(odRenderer_clear(&renderer, odColor_get_black(), &render_texture));
+	OD_ASSERT(odTest_odRenderer_draw_sprite(&renderer, &state, &texture, &sprite, &render_texture));
+
+	const odColor* pixels = render_texture.texture.pixels.begin();
+	for (int32_t y = 0; y < height; y++) {
+		for (int32_t x = 0; x < width; x++) {
+			const odColor* expected = (x < (width / 2)) ? odColor_get_red() : odColor_get_blue();
+			OD_ASSERT(odColor_get_equals(&pixels[(y * width) + x], expected));
+		}
+	}
+}
+OD_TEST(odTest_odRenderer_software_draw_blended) {
+	odWindowSettings settings = odTest_odRenderer_create_software_settings();
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, &settings));
+	odRenderer renderer;
+	OD_ASSERT(odRenderer_init(&renderer, &window));
+	odTexture texture;
+	OD_ASSERT(odTexture_init_blank(&texture, &window));
+
+	// odd width, so rows blend in both 4-pixel batches and single pixels
+	const int32_t width = 7;
+	const int32_t height = 5;
+	odRenderTexture render_texture;
+	OD_ASSERT(odRenderTexture_init(&render_texture, &window, width, height));
+	odRenderState state = odTest_odRenderer_create_ortho_state(width, height);
+
+	odSpritePrimitive sprite{
+		odBounds{0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)},
+		odBounds{0.0f, 0.0f, 1.0f, 1.0f},
+		odColor{0xff, 0x00, 0x00, 0x80},
+		0.0f};
+	OD_ASSERT(odRenderer_clear(&renderer, odColor_get_blue(), &render_texture));
+	OD_ASSERT(odTest_odRenderer_draw_sprite(&renderer, &state, &texture, &sprite, &render_texture));
+
+	// src*src_alpha + dest*(1-src_alpha) on every channel; pixels on the quad's diagonal are blended only once
+	const odColor expected{0x80, 0x00, 0x7f, 0xbf};
+	const odColor* pixels = render_texture.texture.pixels.begin();
+	for (int32_t i = 0; i < (width * height); i++) {
+		OD_ASSERT(odColor_get_equals(&pixels[i], &expected));
+	}
+}
+OD_TEST(odTest_odRenderer_software_draw_to_window) {
+	odWindowSettings settings = odTest_odRenderer_create_software_settings();
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, &settings));
+	odRenderer renderer;
+	OD_ASSERT(odRenderer_init(&renderer, &window));
+	odTexture texture;
+	OD_ASSERT(odTexture_init_blank(&texture, &window));
+	odRenderState state = odTest_odRenderer_create_ortho_state(settings.width, settings.height);
+
+	odSpritePrimitive sprite{
+		odBounds{0.0f, 0.0f, 1.0f, 1.0f},
+		odBounds{0.0f, 0.0f, 1.0f, 1.0f},
+		*odColor_get_green(),
+		0.0f};
+	OD_ASSERT(odRenderer_clear(&renderer, odColor_get_black(), nullptr));
+	OD_ASSERT(odTest_odRenderer_draw_sprite(&renderer, &state, &texture, &sprite, nullptr));
+
+	// view top-left is the last framebuffer row
+	const odColor* pixels = window.software_framebuffer.begin();
+	int32_t top_left = (settings.height - 1) * settings.width;
+	OD_ASSERT(odColor_get_equals(&pixels[top_left], odColor_get_green()));
+	OD_ASSERT(odColor_get_equals(&pixels[top_left + 1], odColor_get_black()));
+	OD_ASSERT(odColor_get_equals(&pixels[0], odColor_get_black()));
+}
 OD_TEST(odTest_odRenderer_init_without_context_fails) {
 	odLogLevelScoped suppress_errors{OD_LOG_LEVEL_FATAL};
 	odRenderer renderer;
@@ -172,6 +333,64 @@ OD_TEST_SUITE(
 	odTest_odRenderer_draw_vertices,
 	odTest_odRenderer_draw_texture,
 	odTest_odRenderer_init_multiple_renderers,
+	odTest_odRenderer_draw_headless,
+	odTest_odRenderer_software_draw_opaque,
+	odTest_odRenderer_software_draw_textured,
+	odTest_odRenderer_software_draw_blended,
+	odTest_odRenderer_software_draw_to_window,
 	odTest_odRenderer_init_without_context_fails,
 	odTest_odRenderer_destroy_invalid,
 )
+
+OD_BENCHMARK(odBenchmark_odRenderer_software_draw) {
+	// one sample per frame: 2000 textured sprites drawn to a render texture, then to the window
+	odWindowSettings settings = odTest_odRenderer_create_software_settings();
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, &settings));
+	odRenderer renderer;
+	OD_ASSERT(odRenderer_init(&renderer, &window));
+
+	const int32_t texture_size = 16;
+	odColor texture_pixels[texture_size * texture_size]{};
+	for (int32_t i = 0; i < (texture_size * texture_size); i++) {
+		texture_pixels[i] = odColor{static_cast<uint8_t>(i), 0x80, 0xff, static_cast<uint8_t>((i % 2) ? 0xff : 0x80)};
+	}
+	odTexture texture;
+	OD_ASSERT(odTexture_init(&texture, &window, texture_pixels, texture_size, texture_size));
+	odRenderTexture render_texture;
+	OD_ASSERT(odRenderTexture_init(&render_texture, &window, settings.width, settings.height));
+	odRenderState state = odTest_odRenderer_create_ortho_state(settings.width, settings.height);
+	odRenderState window_state = odTest_odRenderer_create_state();
+	window_state.viewport = state.viewport;
+
+	const int32_t sprite_count = 2000;
+	odTrivialArrayT<odVertex> vertices;
+	OD_ASSERT(vertices.set_count(sprite_count * OD_SPRITE_VERTEX_COUNT));
+
+	int32_t frame = 0;
+	while (odBenchmarkRun_next(run)) {
+		for (int32_t i = 0; i < sprite_count; i++) {
+			float x = static_cast<float>(((i * 16) + frame) % settings.width);
+			float y = static_cast<float>(((i * 16) / settings.width) * 8 % settings.height);
+			odSpritePrimitive sprite{
+				odBounds{x, y, x + 16.0f, y + 16.0f},
+				odBounds{0.0f, 0.0f, static_cast<float>(texture_size), static_cast<float>(texture_size)},
+				*odColor_get_white(),
+				0.0f};
+			odSpritePrimitive_get_vertices(&sprite, vertices.get(i * OD_SPRITE_VERTEX_COUNT));
+		}
+
+		OD_ASSERT(odRenderer_clear(&renderer, odColor_get_black(), &render_texture));
+		OD_ASSERT(odRenderer_draw_vertices(
+			&renderer, vertices.begin(), vertices.get_count(), &state, &texture, &render_texture));
+		OD_ASSERT(odRenderer_draw_texture(
+			&renderer, &window_state, odRenderTexture_get_texture(&render_texture), nullptr, nullptr, nullptr));
+		OD_ASSERT(odWindow_step(&window));
+		frame++;
+	}
+}
+
+OD_BENCHMARK_SUITE(
+	odBenchmarkSuite_odRenderer,
+	odBenchmark_odRenderer_software_draw,
+)
@@ -9,7 +9,7 @@
 
 OD_TEST_FILTERED(odTest_odTexture_init_destroy, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odTexture texture;
@@ -32,7 +32,7 @@ OD_TEST_FILTERED(odTest_odTexture_init_destroy, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odTexture_init_large, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	const int32_t width = 256;
@@ -46,7 +46,7 @@ OD_TEST_FILTERED(odTest_odTexture_init_large, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odTexture_destroy_after_window_destroy_fails, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	{
@@ -61,7 +61,7 @@ OD_TEST_FILTERED(odTest_odTexture_destroy_after_window_destroy_fails, OD_TEST_FI
 }
 OD_TEST_FILTERED(odTest_odTexture_get_size, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odTexture texture;
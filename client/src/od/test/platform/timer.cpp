@@ -0,0 +1,30 @@
+#include <od/platform/timer.h>
+
+#include <od/test/test.hpp>
+
+OD_TEST(odTest_odTimer_monotonic) {
+	int64_t last_ns = odTimer_get_now_ns();
+	for (int32_t i = 0; i < 1000; i++) {
+		int64_t now_ns = odTimer_get_now_ns();
+		OD_ASSERT(now_ns >= last_ns);
+		last_ns = now_ns;
+	}
+}
+OD_TEST(odTest_odTimer_sub_second_resolution) {
+	odTimer timer;
+	odTimer_start(&timer);
+
+	// busy-wait until the clock visibly advances; a one second clock would take a full second here.
+	// the upper bound is generous so that preemption of the test thread can't fail it
+	int64_t elapsed_ns = 0;
+	while ((elapsed_ns = odTimer_get_elapsed_ns(&timer)) == 0) {
+	}
+	OD_ASSERT(elapsed_ns > 0);
+	OD_ASSERT(elapsed_ns < 500000000);
+}
+
+OD_TEST_SUITE(
+	odTestSuite_odTimer,
+	odTest_odTimer_monotonic,
+	odTest_odTimer_sub_second_resolution,
+)
@@ -2,15 +2,17 @@
 
 #include <cstring>
 
+#include <SDL2/SDL.h>
+
 #include <od/test/test.hpp>
 
 OD_TEST_FILTERED(odTest_odWindow_init_destroy, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	// test double init
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odWindow_destroy(&window);
@@ -20,7 +22,7 @@ OD_TEST_FILTERED(odTest_odWindow_init_destroy, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odWindow_step, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 
 	for (int32_t i = 0; i < 10; i++) {
 		OD_ASSERT(odWindow_step(&window));
@@ -29,7 +31,7 @@ OD_TEST_FILTERED(odTest_odWindow_step, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odWindow_set_visible, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	// be extremely sparing with the number of tests that make a window visible
@@ -39,7 +41,7 @@ OD_TEST_FILTERED(odTest_odWindow_set_visible, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odWindow_set_size, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	OD_ASSERT(odWindow_set_size(&window, 1, 1));
@@ -49,10 +51,10 @@ OD_TEST_FILTERED(odTest_odWindow_set_size, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odWindow_set_settings_headless, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
-	odWindowSettings settings = *odWindowSettings_get_headless_defaults();
+	odWindowSettings settings = *odWindowSettings_get_hidden_defaults();
 	settings.caption = "no";
 	settings.width = 44;
 	settings.is_vsync_enabled = false;
@@ -66,13 +68,13 @@ OD_TEST_FILTERED(odTest_odWindow_set_settings_headless, OD_TEST_FILTER_SLOW) {
 
 OD_TEST_FILTERED(odTest_odWindow_set_settings_visible, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	// be extremely sparing with the number of tests that make a window visible
 	OD_ASSERT(odWindow_set_visible(&window, true));
 
-	odWindowSettings settings = *odWindowSettings_get_headless_defaults();
+	odWindowSettings settings = *odWindowSettings_get_hidden_defaults();
 	settings.caption = "no";
 	settings.width = 44;
 	settings.is_vsync_enabled = true;
@@ -87,14 +89,14 @@ OD_TEST_FILTERED(odTest_odWindow_set_settings_visible, OD_TEST_FILTER_SLOW) {
 OD_TEST_FILTERED(odTest_odWindow_get_open, OD_TEST_FILTER_SLOW) {
 	odWindow window;
 
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odWindow_destroy(&window);
 }
 OD_TEST_FILTERED(odTest_odWindow_get_mouse_state, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odWindowMouseState state;
@@ -102,7 +104,7 @@ OD_TEST_FILTERED(odTest_odWindow_get_mouse_state, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odWindow_get_key_state, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	OD_DISCARD(odWindow_get_key_state(&window, "Up"));
@@ -112,7 +114,7 @@ OD_TEST_FILTERED(odTest_odWindow_get_key_state, OD_TEST_FILTER_SLOW) {
 }
 OD_TEST_FILTERED(odTest_odWindow_get_key_state_invalid_name_fails, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	{
@@ -120,13 +122,42 @@ OD_TEST_FILTERED(odTest_odWindow_get_key_state_invalid_name_fails, OD_TEST_FILTE
 		OD_ASSERT(!odWindow_get_key_state(&window, "Top"));
 	}
 }
+OD_TEST_FILTERED(odTest_odWindow_get_frame_stats, OD_TEST_FILTER_SLOW) {
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
+	OD_ASSERT(odWindow_check_valid(&window));
+
+	odWindowSettings settings = *odWindowSettings_get_hidden_defaults();
+	settings.fps_limit = 100;
+	settings.is_fps_limit_enabled = true;
+	OD_ASSERT(odWindow_set_settings(&window, &settings));
+
+	odWindowFrameStats stats{};
+	odWindow_get_frame_stats(&window, &stats);
+	OD_ASSERT(stats.frame_count == 0);
+	OD_ASSERT(odWindow_get_last_frame_ms(&window) == 0.0f);
+
+	for (int32_t i = 0; i < 11; i++) {
+		OD_ASSERT(odWindow_step(&window));
+	}
+
+	odWindow_get_frame_stats(&window, &stats);
+	OD_ASSERT(stats.frame_count == 10);
+	OD_ASSERT(odWindow_get_last_frame_ms(&window) == stats.last_frame_ms);
+	OD_ASSERT(stats.missed_frame_count <= stats.frame_count);
+
+	// frames are paced to never finish early, only late
+	OD_ASSERT(stats.mean_frame_ms >= 9.0f);
+	OD_ASSERT(stats.max_frame_ms >= stats.p99_frame_ms);
+	OD_ASSERT(stats.max_frame_ms >= stats.mean_frame_ms);
+}
 OD_TEST_FILTERED(odTest_odWindow_init_multiple_windows, OD_TEST_FILTER_SLOW) {
 	odWindow window;
-	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window));
 
 	odWindow window2;
-	OD_ASSERT(odWindow_init(&window2, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_init(&window2, odWindowSettings_get_hidden_defaults()));
 	OD_ASSERT(odWindow_check_valid(&window2));
 
 	odWindow_destroy(&window);
@@ -134,6 +165,117 @@ OD_TEST_FILTERED(odTest_odWindow_init_multiple_windows, OD_TEST_FILTER_SLOW) {
 
 	odWindow_destroy(&window2);
 }
+OD_TEST(odTest_odWindow_headless) {
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+	OD_ASSERT(odWindow_check_valid(&window));
+	OD_ASSERT(odWindow_is_headless(&window));
+	OD_ASSERT(window.window_native == nullptr);
+	OD_ASSERT(window.render_context_native == nullptr);
+
+	odWindowSettings settings = *odWindowSettings_get_headless_defaults();
+	settings.width = 44;
+	settings.is_visible = true;
+	OD_ASSERT(odWindow_set_settings(&window, &settings));
+	OD_ASSERT(window.settings.width == 44);
+
+	// headless steps are not throttled
+	for (int32_t i = 0; i < 100; i++) {
+		OD_ASSERT(odWindow_step(&window));
+	}
+
+	odWindowFrameStats stats{};
+	odWindow_get_frame_stats(&window, &stats);
+	OD_ASSERT(stats.frame_count == 99);
+	OD_ASSERT(stats.mean_frame_ms < 1.0f);
+	OD_ASSERT(odWindow_get_last_frame_ms(&window) == stats.last_frame_ms);
+
+	OD_ASSERT(!odWindow_get_key_state(&window, "Up"));
+
+	odWindow_destroy(&window);
+	OD_ASSERT(!odWindow_step(&window));
+}
+OD_TEST(odTest_odWindow_get_key_states_headless) {
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_headless_defaults()));
+
+	int32_t key_handles[3] = {};
+	OD_ASSERT(odWindow_get_key_handle(&window, "Up", &key_handles[0]));
+	OD_ASSERT(odWindow_get_key_handle(&window, "Down", &key_handles[1]));
+	OD_ASSERT(odWindow_get_key_handle(&window, "Space", &key_handles[2]));
+	OD_ASSERT(key_handles[0] != key_handles[1]);
+	for (int32_t key_handle: key_handles) {
+		OD_ASSERT((key_handle > 0) && (key_handle < OD_WINDOW_KEY_COUNT));
+	}
+
+	odWindowKeyState key_states[3] = {};
+	OD_ASSERT(odWindow_step(&window));
+	OD_ASSERT(odWindow_get_key_states(&window, key_handles, 3, key_states));
+	for (const odWindowKeyState& key_state: key_states) {
+		OD_ASSERT(!key_state.is_down && !key_state.is_pressed && !key_state.is_released);
+	}
+	OD_ASSERT(odWindow_get_key_states(&window, nullptr, 0, nullptr));
+
+	{
+		odLogLevelScoped suppress_errors{OD_LOG_LEVEL_FATAL};
+		int32_t key_handle = 0;
+		OD_ASSERT(!odWindow_get_key_handle(&window, "Top", &key_handle));
+
+		key_handle = OD_WINDOW_KEY_COUNT;
+		OD_ASSERT(!odWindow_get_key_states(&window, &key_handle, 1, key_states));
+	}
+}
+static void odTest_odWindow_push_key_event(uint32_t type, int32_t key_handle) {
+	SDL_Event event{};
+	event.type = type;
+	event.key.state = static_cast<Uint8>((type == SDL_KEYDOWN) ? SDL_PRESSED : SDL_RELEASED);
+	event.key.keysym.scancode = static_cast<SDL_Scancode>(key_handle);
+	event.key.keysym.sym = SDL_GetKeyFromScancode(event.key.keysym.scancode);
+	OD_ASSERT(SDL_PushEvent(&event) == 1);
+}
+static odWindowKeyState odTest_odWindow_step_key_state(odWindow* window, int32_t key_handle) {
+	OD_ASSERT(odWindow_step(window));
+
+	odWindowKeyState key_state{};
+	OD_ASSERT(odWindow_get_key_states(window, &key_handle, 1, &key_state));
+	return key_state;
+}
+OD_TEST_FILTERED(odTest_odWindow_get_key_states_events, OD_TEST_FILTER_SLOW) {
+	odWindow window;
+	OD_ASSERT(odWindow_init(&window, odWindowSettings_get_hidden_defaults()));
+
+	int32_t key_handle = 0;
+	OD_ASSERT(odWindow_get_key_handle(&window, "Up", &key_handle));
+
+	odWindowKeyState key_state = odTest_odWindow_step_key_state(&window, key_handle);
+	OD_ASSERT(!key_state.is_down && !key_state.is_pressed && !key_state.is_released);
+
+	// pressed for exactly the step the key went down in, down until it goes up
+	odTest_odWindow_push_key_event(SDL_KEYDOWN, key_handle);
+	key_state = odTest_odWindow_step_key_state(&window, key_handle);
+	OD_ASSERT(key_state.is_down && key_state.is_pressed && !key_state.is_released);
+	for (int32_t i = 0; i < 3; i++) {
+		key_state = odTest_odWindow_step_key_state(&window, key_handle);
+		OD_ASSERT(key_state.is_down && !key_state.is_pressed && !key_state.is_released);
+	}
+
+	// released for exactly the step the key went up in
+	odTest_odWindow_push_key_event(SDL_KEYUP, key_handle);
+	key_state = odTest_odWindow_step_key_state(&window, key_handle);
+	OD_ASSERT(!key_state.is_down && !key_state.is_pressed && key_state.is_released);
+	key_state = odTest_odWindow_step_key_state(&window, key_handle);
+	OD_ASSERT(!key_state.is_down && !key_state.is_pressed && !key_state.is_released);
+
+	// a tap within one step is both pressed and released, but not left down
+	odTest_odWindow_push_key_event(SDL_KEYDOWN, key_handle);
+	odTest_odWindow_push_key_event(SDL_KEYUP, key_handle);
+	key_state = odTest_odWindow_step_key_state(&window, key_handle);
+	OD_ASSERT(!key_state.is_down && key_state.is_pressed && key_state.is_released);
+	key_state = odTest_odWindow_step_key_state(&window, key_handle);
+	OD_ASSERT(!key_state.is_down && !key_state.is_pressed && !key_state.is_released);
+
+	odWindow_destroy(&window);
+}
 OD_TEST(odTest_odWindow_destroy_invalid) {
 	odWindow window;
 	odWindow_destroy(&window);
@@ -151,6 +293,10 @@ OD_TEST_SUITE(
 	odTest_odWindow_get_mouse_state,
 	odTest_odWindow_get_key_state,
 	odTest_odWindow_get_key_state_invalid_name_fails,
+	odTest_odWindow_get_frame_stats,
 	odTest_odWindow_init_multiple_windows,
+	odTest_odWindow_headless,
+	odTest_odWindow_get_key_states_headless,
+	odTest_odWindow_get_key_states_events,
 	odTest_odWindow_destroy_invalid,
 )
@@ -16,8 +16,10 @@ bool odTest_run(int32_t filters, char const* opt_name_filter) {
 		odTestSuite_odBounds(),
 		odTestSuite_odMatrix(),
 		odTestSuite_odString(),
+		odTestSuite_odScratchArena(),
 
 		odTestSuite_odAsciiFont(),
+		odTestSuite_odPrimitive(),
 		odTestSuite_odFile(),
 		odTestSuite_odImage(),
 		odTestSuite_odWindow(),
@@ -26,13 +28,19 @@ bool odTest_run(int32_t filters, char const* opt_name_filter) {
 		odTestSuite_odRenderer(),
 		odTestSuite_odAudio(),
 		odTestSuite_odMusic(),
+		odTestSuite_odTimer(),
+		odTestSuite_odProfile(),
+		odTestSuite_odFrameWatchdog(),
 
 		odTestSuite_odAtlas(),
 		odTestSuite_odTextureAtlas(),
+		odTestSuite_odTagset(),
 		odTestSuite_odEntityIndex(),
 		odTestSuite_odLua(),
 		odTestSuite_odLuaBindings(),
 		odTestSuite_odLuaClient(),
+
+		odTestSuite_odBenchmark(),
 	};
 
 	OD_INFO("Running client c++ tests");
@@ -21,6 +21,39 @@ function Container.deep_copy(xs)
 		error("cannot deep-copy type "..xs_type)
 	end
 end
+function Container._restore(xs, ys, visited)
+	visited[xs] = true
+
+	for key, y in pairs(ys) do
+		local x = xs[key]
+		if type(y) == "table" then
+			-- tables aliased within xs, or shared with ys, are replaced by copies rather than restored
+			if type(x) == "table" and x ~= y and not visited[x] then
+				Container._restore(x, y, visited)
+			else
+				xs[key] = Container.deep_copy(y)
+			end
+		elseif x ~= y then
+			xs[key] = y
+		end
+	end
+
+	for key, _ in pairs(xs) do
+		if ys[key] == nil then
+			xs[key] = nil
+		end
+	end
+end
+-- makes xs deep-equal to ys, writing only the fields which differ and reusing xs's tables
+function Container.restore(xs, ys)
+	if debug_checks_enabled then
+		assert(Schema.Table(xs))
+		assert(Schema.Table(ys))
+	end
+
+	Container._restore(xs, ys, {})
+	return xs
+end
 function Container.get_keys(xs)
 	if debug_checks_enabled then
 		assert(Schema.Table(xs))
@@ -294,6 +327,37 @@ Container.tests = Testing.add_suite("core.Container", {
 
 		assert(Container.deep_copy(nil) == nil)
 	end,
+	restore = function()
+		local ys = {a = 1, b = {c = 2, d = {3, 4}}, e = {}, f = "f"}
+		local xs = Container.deep_copy(ys)
+		local xs_b = xs.b
+		local xs_d = xs.b.d
+
+		xs.a = 5
+		xs.b.c = nil
+		xs.b.d[3] = 5
+		xs.e = 6
+		xs.f = {}
+		xs.g = {h = 7}
+		assert(Container.restore(xs, ys) == xs)
+		Container.assert_equal(xs, ys)
+		assert(xs.b == xs_b)
+		assert(xs.b.d == xs_d)
+		assert(xs.e ~= ys.e)
+
+		local shared = {1}
+		local aliased = {a = shared, b = shared}
+		Container.restore(aliased, {a = {2}, b = {3}})
+		assert(aliased.a ~= aliased.b)
+		Container.assert_equal(aliased, {a = {2}, b = {3}})
+
+		local source = {a = {1}}
+		local target = {a = source.a}
+		Container.restore(target, source)
+		assert(target.a ~= source.a)
+		target.a[1] = 2
+		assert(source.a[1] == 1)
+	end,
 	get_keys = function()
 		local test_value_expected_pairs = {
 			{{}, {}},
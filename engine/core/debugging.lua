@@ -1,8 +1,28 @@
-local Shim = require("engine/core/shim")
 local Logging = require("engine/core/logging")
 
 local debugger_lib = nil
 
+-- native pcall passes arguments through and only builds a traceback on failure; missing outside of the client
+local native_pcall = rawget(_G, "odClientWrapper") and odClientWrapper.Debugging.pcall
+
+-- native profiling zones (see OD_PROFILE_SCOPE); only available in profile builds of the client
+local Profile = rawget(_G, "odClientWrapper") and odClientWrapper.Profile
+local profile_zone_ids = {}
+local function get_profile_zone_id(name)
+	local zone_id = profile_zone_ids[name]
+	if zone_id == nil then
+		zone_id = Profile.get_zone_id(name)
+		profile_zone_ids[name] = zone_id
+	end
+	return zone_id
+end
+
+-- native sampling profiler for lua code; missing outside of the client
+local LuaProfiler = rawget(_G, "odClientWrapper") and odClientWrapper.LuaProfiler
+
+-- native frame budget watchdog (see odFrameWatchdog); missing outside of the client
+local FrameWatchdog = rawget(_G, "odClientWrapper") and odClientWrapper.FrameWatchdog
+
 local function noop()
 end
 
@@ -13,6 +33,7 @@ local Debugging = {}
 Debugging.debugger_enabled = false
 Debugging.debug_checks_enabled = false
 Debugging.expensive_debug_checks_enabled = false
+Debugging.profile_enabled = (Profile ~= nil) and Profile.is_enabled()
 Debugging.breakpoint = breakpoint
 function Debugging.set_debugger_enabled(enabled)
 	Debugging.debugger_enabled = enabled
@@ -32,17 +53,149 @@ function Debugging.set_debugger_enabled(enabled)
 	return Debugging
 end
 function Debugging.pcall(fn, ...)
-	local args = {...}
+	if Debugging.debugger_enabled then
+		return debugger_lib.call(fn, ...)
+	end
 
-	if not Debugging.debugger_enabled then
-		local function fn_wrapped()
-			fn(Shim.unpack(args))
-		end
+	if native_pcall ~= nil then
+		return native_pcall(fn, ...)
+	end
 
-		return pcall(fn_wrapped)
+	return pcall(fn, ...)
+end
+-- zone ids are looked up once per name; nil when profiling is disabled, which begin/end ignore
+function Debugging.get_profile_zone(name)
+	if not Debugging.profile_enabled then
+		return nil
 	end
 
-	return debugger_lib.call(fn, Shim.unpack(args))
+	return get_profile_zone_id(name)
+end
+-- for zones only opened while tracing, which works in any build of the client
+function Debugging.get_profile_trace_zone(name)
+	if Profile == nil then
+		return nil
+	end
+
+	return get_profile_zone_id(name)
+end
+function Debugging.profile_begin(zone_id)
+	if zone_id ~= nil then
+		Profile.begin_zone(zone_id)
+	end
+end
+function Debugging.profile_end(zone_id)
+	if zone_id ~= nil then
+		Profile.end_zone(zone_id)
+	end
+end
+-- {[zone_name] = {count = n, total_ms = ms, max_ms = ms}}, for zones recorded in the last frame
+function Debugging.get_profile_frame_stats()
+	if not Debugging.profile_enabled then
+		return {}
+	end
+
+	return Profile.get_frame_stats()
+end
+-- records zones for the next frame_count frames to filename, as chrome trace event json (see odProfile_begin_trace)
+function Debugging.begin_profile_trace(filename, frame_count)
+	if Profile == nil then
+		return false
+	end
+
+	return Profile.begin_trace(filename, frame_count)
+end
+function Debugging.end_profile_trace()
+	if Profile == nil then
+		return false
+	end
+
+	return Profile.end_trace()
+end
+function Debugging.get_profile_tracing()
+	return (Profile ~= nil) and Profile.is_tracing()
+end
+-- monotonic time in nanoseconds, for benchmarks; falls back to (coarser) cpu time outside of the client
+function Debugging.get_time_ns()
+	if Profile == nil then
+		return os.clock() * 1e9
+	end
+
+	return Profile.get_now_ns()
+end
+--[[ Lua 5.1 has no gc hooks, and collection runs incrementally inside allocations,
+so the heap size is traced instead; collections show up as drops between zones ]]
+function Debugging.trace_lua_heap()
+	Profile.add_counter(get_profile_zone_id("lua_heap_kb"), collectgarbage("count"))
+end
+-- samples the lua call stack every period vm instructions, until end_lua_profile()
+function Debugging.begin_lua_profile(period)
+	if LuaProfiler == nil then
+		return false
+	end
+
+	LuaProfiler.start(period)
+	return true
+end
+-- stops sampling, and writes the samples to filename (if given) as folded stacks, for flamegraphs
+function Debugging.end_lua_profile(filename)
+	if LuaProfiler == nil or not LuaProfiler.stop() then
+		return false
+	end
+
+	if filename ~= nil then
+		return LuaProfiler.write_folded(filename)
+	end
+	return true
+end
+function Debugging.get_lua_profiling()
+	return (LuaProfiler ~= nil) and LuaProfiler.is_running()
+end
+-- {samples = n, functions = {{name, self_samples, total_samples, ...}}, lines = {{function, line, samples, ...}}}
+function Debugging.get_lua_profile_stats()
+	if LuaProfiler == nil then
+		return nil
+	end
+
+	return LuaProfiler.get_stats()
+end
+--[[ times frames against budget_ms, and writes the last few frames to rotating files filename.0, filename.1, ...
+when one goes over (see odFrameWatchdog_start); budget_ms and file_count are optional ]]
+function Debugging.start_frame_watchdog(filename, budget_ms, file_count)
+	if FrameWatchdog == nil then
+		return false
+	end
+
+	return FrameWatchdog.start(filename, budget_ms, file_count)
+end
+-- writes any pending dump, which would otherwise wait for the next frame to begin
+function Debugging.stop_frame_watchdog()
+	if FrameWatchdog == nil then
+		return false
+	end
+
+	return FrameWatchdog.stop()
+end
+function Debugging.get_frame_watchdog_running()
+	return (FrameWatchdog ~= nil) and FrameWatchdog.is_running()
+end
+function Debugging.get_frame_watchdog_dump_count()
+	if FrameWatchdog == nil then
+		return 0
+	end
+
+	return FrameWatchdog.get_dump_count()
+end
+function Debugging.frame_watchdog_begin_frame()
+	if FrameWatchdog ~= nil then
+		FrameWatchdog.begin_frame()
+	end
+end
+-- opt_note is written with the frame, e.g. its slowest system
+function Debugging.frame_watchdog_end_frame(opt_note)
+	if FrameWatchdog ~= nil then
+		FrameWatchdog.end_frame(opt_note)
+	end
 end
 Logging.add_error_handler(Debugging.breakpoint)
 
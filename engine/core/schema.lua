@@ -1,6 +1,7 @@
 local Testing = require("engine/core/testing")
 local Logging = require("engine/core/logging")
 local Math = require("engine/core/math")
+local Shim = require("engine/core/shim")
 
 local integer_min = Math.integer_min
 local integer_max = Math.integer_max
@@ -12,6 +13,13 @@ Schema.integer_max = integer_max
 function Schema.error(format, ...)
 	return string.format("Schema error:\n"..format, ...)
 end
+
+-- describes how each schema was built, for Schema.compile()
+local descriptors = setmetatable({}, {__mode = "k"})
+local function describe(descriptor, fn)
+	descriptors[fn] = descriptor
+	return fn
+end
 function Schema.Any()
 	return true
 end
@@ -63,7 +71,7 @@ end
 function Schema.Array(condition, opt_length)
 	assert(Schema.Function(condition))
 
-	return function(x)
+	return describe({kind = "Array", condition = condition, length = opt_length}, function(x)
 		if type(x) ~= "table" then
 			return false, Schema.error("Schema.Array(%s): not a table", x)
 		end
@@ -88,13 +96,13 @@ function Schema.Array(condition, opt_length)
 			return false, Schema.error("Schema.Array(%s): sparse array", x)
 		end
 		return true
-	end
+	end)
 end
 function Schema.Mapping(key_condition, value_condition)
 	assert(Schema.Function(key_condition))
 	assert(Schema.Function(value_condition))
 
-	return function(x)
+	return describe({kind = "Mapping", key_condition = key_condition, value_condition = value_condition}, function(x)
 		if type(x) ~= "table" then
 			return false, Schema.error("Schema.Mapping(%s): not a table", x)
 		end
@@ -113,14 +121,16 @@ function Schema.Mapping(key_condition, value_condition)
 			end
 		end
 		return true
-	end
+	end)
 end
 function Schema.Object(condition_map, additional_value_condition)
 	assert(Schema.Mapping(Schema.String, Schema.Function)(condition_map))
 	assert(Schema.Optional(Schema.Function)(additional_value_condition))
 	additional_value_condition = additional_value_condition or Schema.None
 
-	return function(x)
+	local descriptor = {
+		kind = "Object", condition_map = condition_map, additional_value_condition = additional_value_condition}
+	return describe(descriptor, function(x)
 		if type(x) ~= "table" then
 			return false, Schema.error("Schema.Object(%s): not a table", x)
 		end
@@ -151,7 +161,7 @@ function Schema.Object(condition_map, additional_value_condition)
 			end
 		end
 		return true
-	end
+	end)
 end
 function Schema.AnyOf(...)
 	local conditions = {...}
@@ -159,7 +169,7 @@ function Schema.AnyOf(...)
 		assert(Schema.Function(condition))
 	end
 
-	return function(x)
+	return describe({kind = "AnyOf", conditions = conditions}, function(x)
 		local failures = {}
 		for _, condition in ipairs(conditions) do
 			local result, err = condition(x)
@@ -171,7 +181,7 @@ function Schema.AnyOf(...)
 
 		local failures_str = table.concat(failures, "\n")
 		return false, Schema.error("Schema.AnyOf(%s): no match, match failures=\n%s", x, failures_str)
-	end
+	end)
 end
 function Schema.OneOf(...)
 	local conditions = {...}
@@ -179,7 +189,7 @@ function Schema.OneOf(...)
 		assert(Schema.Function(condition))
 	end
 
-	return function(x)
+	return describe({kind = "OneOf", conditions = conditions}, function(x)
 		local found = false
 		local failures = {}
 		for _, condition in ipairs(conditions) do
@@ -199,7 +209,7 @@ function Schema.OneOf(...)
 
 		local failures_str = table.concat(failures, "\n")
 		return false, Schema.error("Schema.OneOf(%s): no match, match failures=\n%s", x, failures_str)
-	end
+	end)
 end
 function Schema.AllOf(...)
 	local conditions = {...}
@@ -207,7 +217,7 @@ function Schema.AllOf(...)
 		assert(Schema.Function(condition))
 	end
 
-	return function(x)
+	return describe({kind = "AllOf", conditions = conditions}, function(x)
 		for _, condition in ipairs(conditions) do
 			local result, err = condition(x)
 			if not result then
@@ -215,7 +225,7 @@ function Schema.AllOf(...)
 			end
 		end
 		return true
-	end
+	end)
 end
 function Schema.Enum(...)
 	local values = {...}
@@ -226,25 +236,25 @@ function Schema.Enum(...)
 		values_lookup[value] = true
 	end
 
-	return function(x)
+	return describe({kind = "Enum", values_lookup = values_lookup}, function(x)
 		if values_lookup[x] == true then
 			return true
 		end
 		return false, Schema.error("Schema.Enum(%s): no match, values={%s}", x, values_str)
-	end
+	end)
 end
 function Schema.Const(const)
-	return function(x)
+	return describe({kind = "Const", const = const}, function(x)
 		if x ~= const then
 			return false, Schema.error("Schema.Const(%s): no match, const=%s", x, const)
 		end
 		return true
-	end
+	end)
 end
 function Schema.Optional(condition)
 	assert(Schema.Function(condition))
 
-	return function(x)
+	return describe({kind = "Optional", condition = condition}, function(x)
 		if x == nil then
 			return true
 		end
@@ -253,18 +263,18 @@ function Schema.Optional(condition)
 			return true
 		end
 		return false, Schema.error("Schema.Optional(%s): no match, err=%s", x, err)
-	end
+	end)
 end
 function Schema.Check(condition)
 	assert(Schema.Function(condition))
 
-	return function(x)
+	return describe({kind = "Check", condition = condition}, function(x)
 		local result, err = condition(x)
 		if not result then
 			return false, Schema.error("Schema.Check(%s): no match, err=%s, check=%s", x, err, string.dump(condition))
 		end
 		return true
-	end
+	end)
 end
 function Schema.Integer(x)
 	if type(x) == "number" and floor(x) == x and x >= integer_min and x <= integer_max then
@@ -303,20 +313,20 @@ function Schema.PositiveInteger(x)
 	return false, Schema.error("Schema.PositiveInteger(%s): no match", x)
 end
 function Schema.BoundedNumber(min, max)
-	return function(x)
+	return describe({kind = "Number", min = min, max = max}, function(x)
 		if type(x) == "number" and x >= min and x <= max then
 			return true
 		end
 		return false, Schema.error("Schema.BoundedNumber(%s): no match, min=%s, max=%s", x, min, max)
-	end
+	end)
 end
 function Schema.BoundedInteger(min, max)
-	return function(x)
+	return describe({kind = "Number", integer = true, min = min, max = max}, function(x)
 		if type(x) == "number" and floor(x) == x and x >= min and x <= max then
 			return true
 		end
 		return false, Schema.error("Schema.BoundedInteger(%s): no match, min=%s, max=%s", x, min, max)
-	end
+	end)
 end
 local label_regex = "[a-z_][a-z0-9_]*"
 function Schema.LabelString(x)
@@ -332,19 +342,19 @@ function Schema.NonEmptyString(x)
 	return false, Schema.error("Schema.NonEmptyString(%s): no match", x)
 end
 function Schema.BoundedString(min, max)
-	return function(x)
+	return describe({kind = "String", min_length = min, max_length = max}, function(x)
 		if type(x) == "string" and #x >= min and #x <= max then
 			return true
 		end
 		return false, Schema.error("Schema.BoundedString(%s): no match, min=%s, max=%s", x, min, max)
-	end
+	end)
 end
 function Schema.NonEmptyArray(condition, opt_length)
 	assert(Schema.Function(condition))
 	assert(Schema.Optional(Schema.PositiveInteger)(opt_length))
 	local array_condition = Schema.Array(condition, opt_length)
 
-	return function(x)
+	return describe({kind = "Array", condition = condition, length = opt_length, min_length = 1}, function(x)
 		local result, err = array_condition(x)
 		if not result then
 			return false, Schema.error("Schema.NonEmptyArray(%s): no match, err=%s", x, err)
@@ -353,7 +363,7 @@ function Schema.NonEmptyArray(condition, opt_length)
 			return false, Schema.error("Schema.NonEmptyArray(%s): empty", x)
 		end
 		return true
-	end
+	end)
 end
 function Schema.BoundedArray(condition, min_length, max_length)
 	assert(Schema.Function(condition))
@@ -362,7 +372,8 @@ function Schema.BoundedArray(condition, min_length, max_length)
 	assert(min_length <= max_length)
 	local array_condition = Schema.Array(condition)
 
-	return function(x)
+	local descriptor = {kind = "Array", condition = condition, min_length = min_length, max_length = max_length}
+	return describe(descriptor, function(x)
 		local result, err = array_condition(x)
 		if not result then
 			return false, Schema.error(
@@ -377,18 +388,40 @@ function Schema.BoundedArray(condition, min_length, max_length)
 				"Schema.BoundedArray(%s): above max length=%s", x, max_length)
 		end
 		return true
-	end
+	end)
 end
 function Schema.PartialObject(condition_map)
 	return Schema.Object(condition_map, Schema.Any)
 end
 local SerializableArray
 local SerializableObject
-function Schema.Serializable(x)
+-- same as Schema.Serializable, without building errors
+local function is_serializable(x)
 	local x_type = type(x)
 	if x_type == "string" or x_type == "number" or x_type == "boolean" then
 		return true
 	end
+	if x_type ~= "table" then
+		return false
+	end
+
+	-- arrays have only number keys and no holes, objects have only string keys
+	local is_array, is_object, count = true, true, 0
+	for key, value in pairs(x) do
+		local key_type = type(key)
+		is_array = is_array and key_type == "number"
+		is_object = is_object and key_type == "string"
+		if not (is_array or is_object) or not is_serializable(value) then
+			return false
+		end
+		count = count + 1
+	end
+	return is_object or count <= #x
+end
+function Schema.Serializable(x)
+	if is_serializable(x) then
+		return true
+	end
 	local array_result, array_err = SerializableArray(x)
 	if array_result then
 		return true
@@ -406,6 +439,316 @@ Schema.SerializableObject = SerializableObject
 Schema.AnyArray = Schema.Array(Schema.Any)
 Schema.AnyObject = Schema.Object({}, Schema.Any)
 
+describe({kind = "Any"}, Schema.Any)
+describe({kind = "None"}, Schema.None)
+describe({kind = "Nil"}, Schema.Nil)
+describe({kind = "Type", type = "boolean"}, Schema.Boolean)
+describe({kind = "String"}, Schema.String)
+describe({kind = "Number"}, Schema.Number)
+describe({kind = "Type", type = "function"}, Schema.Function)
+describe({kind = "Type", type = "table"}, Schema.Table)
+describe({kind = "Type", type = "userdata"}, Schema.Userdata)
+describe({kind = "Number", integer = true, min = integer_min, max = integer_max}, Schema.Integer)
+describe({kind = "Number", min = 0, max = 1}, Schema.NormalizedNumber)
+describe({kind = "Number", min = 0}, Schema.NonNegativeNumber)
+describe({kind = "Number", integer = true, min = 0, max = integer_max}, Schema.NonNegativeInteger)
+describe({kind = "Number", above = 0}, Schema.PositiveNumber)
+describe({kind = "Number", integer = true, above = 0, max = integer_max}, Schema.PositiveInteger)
+describe({kind = "LabelString"}, Schema.LabelString)
+describe({kind = "String", min_length = 1}, Schema.NonEmptyString)
+describe({kind = "Serializable"}, Schema.Serializable)
+
+--[[ Schema.compile(schema) turns the nested closures of a schema into one generated validator, with each
+condition inlined as straight-line code (loops for arrays and mappings).  The validator only decides pass or fail;
+failures rerun the original schema to build the error.  Conditions with no descriptor (hand-written functions) are
+called as-is. ]]
+local Compiler = {}
+Compiler.__index = Compiler
+Compiler.emitters = {}
+function Compiler.new()
+	local compiler = {
+		lines = {},
+		refs = {},
+		ref_ids = {},
+		var_count = 0,
+		functions = {},
+		function_ids = {},
+	}
+	return setmetatable(compiler, Compiler)
+end
+function Compiler:emit(format, ...)
+	self.lines[#self.lines + 1] = string.format(format, ...)
+end
+function Compiler:new_var()
+	self.var_count = self.var_count + 1
+	return "v"..self.var_count
+end
+function Compiler:ref(value)
+	local ref_id = self.ref_ids[value]
+	if ref_id == nil then
+		ref_id = #self.refs + 1
+		self.refs[ref_id] = value
+		self.ref_ids[value] = ref_id
+	end
+	return string.format("refs[%d]", ref_id)
+end
+function Compiler:literal(value)
+	local value_type = type(value)
+	if value_type == "nil" or value_type == "boolean" then
+		return tostring(value)
+	elseif value_type == "string" then
+		return string.format("%q", value)
+	elseif value_type == "number" and value == value and value ~= math.huge and value ~= -math.huge then
+		return string.format("%.17g", value)
+	end
+	return self:ref(value)
+end
+function Compiler:get_is_any(schema)
+	local descriptor = descriptors[schema]
+	return descriptor ~= nil and descriptor.kind == "Any"
+end
+function Compiler:function_name(schema)
+	-- conditions used as values (alternatives of AnyOf/OneOf) are compiled to separate functions
+	local function_id = self.function_ids[schema]
+	if function_id == nil then
+		function_id = #self.functions + 1
+		self.function_ids[schema] = function_id
+		self.functions[function_id] = ""
+
+		local lines = self.lines
+		self.lines = {}
+		local var = self:new_var()
+		self:emit("f%d = function(%s)", function_id, var)
+		self:condition(schema, var)
+		self:emit("return true")
+		self:emit("end")
+		self.functions[function_id] = table.concat(self.lines, "\n")
+		self.lines = lines
+	end
+	return "f"..function_id
+end
+function Compiler:condition(schema, var)
+	local descriptor = descriptors[schema]
+	local emitter = descriptor and Compiler.emitters[descriptor.kind]
+	if emitter == nil then
+		self:emit("if not %s(%s) then return false end", self:ref(schema), var)
+		return
+	end
+	emitter(self, descriptor, var)
+end
+function Compiler:compile(schema)
+	self:condition(schema, "x")
+
+	local source = {
+		"local refs = ...",
+		"local type, pairs, floor, match = type, pairs, math.floor, string.match",
+	}
+	if #self.functions > 0 then
+		local function_names = {}
+		for function_id = 1, #self.functions do
+			function_names[function_id] = "f"..function_id
+		end
+		source[#source + 1] = "local "..table.concat(function_names, ", ")
+		for _, function_source in ipairs(self.functions) do
+			source[#source + 1] = function_source
+		end
+	end
+	source[#source + 1] = "return function(x)"
+	for _, line in ipairs(self.lines) do
+		source[#source + 1] = line
+	end
+	source[#source + 1] = "return true"
+	source[#source + 1] = "end"
+
+	local chunk = assert(Shim.loadstring(table.concat(source, "\n"), "=Schema.compile"))
+	return chunk(self.refs)
+end
+function Compiler.emitters.Any()
+end
+function Compiler.emitters.None(compiler)
+	compiler:emit("do return false end")
+end
+function Compiler.emitters.Nil(compiler, _, var)
+	compiler:emit("if %s ~= nil then return false end", var)
+end
+function Compiler.emitters.Type(compiler, descriptor, var)
+	compiler:emit("if type(%s) ~= %q then return false end", var, descriptor.type)
+end
+function Compiler.emitters.Number(compiler, descriptor, var)
+	local checks = {string.format("type(%s) == \"number\"", var)}
+	if descriptor.integer then
+		checks[#checks + 1] = string.format("floor(%s) == %s", var, var)
+	end
+	if descriptor.above ~= nil then
+		checks[#checks + 1] = string.format("%s > %s", var, compiler:literal(descriptor.above))
+	end
+	if descriptor.min ~= nil then
+		checks[#checks + 1] = string.format("%s >= %s", var, compiler:literal(descriptor.min))
+	end
+	if descriptor.max ~= nil then
+		checks[#checks + 1] = string.format("%s <= %s", var, compiler:literal(descriptor.max))
+	end
+	compiler:emit("if not (%s) then return false end", table.concat(checks, " and "))
+end
+function Compiler.emitters.String(compiler, descriptor, var)
+	local checks = {string.format("type(%s) == \"string\"", var)}
+	if descriptor.min_length ~= nil then
+		checks[#checks + 1] = string.format("#%s >= %s", var, compiler:literal(descriptor.min_length))
+	end
+	if descriptor.max_length ~= nil then
+		checks[#checks + 1] = string.format("#%s <= %s", var, compiler:literal(descriptor.max_length))
+	end
+	compiler:emit("if not (%s) then return false end", table.concat(checks, " and "))
+end
+function Compiler.emitters.LabelString(compiler, _, var)
+	compiler:emit(
+		"if not (type(%s) == \"string\" and match(%s, %q) == %s and #%s > 0 and #%s < 64) then return false end",
+		var, var, label_regex, var, var, var)
+end
+function Compiler.emitters.Serializable(compiler, _, var)
+	local type_var = compiler:new_var()
+	compiler:emit("do local %s = type(%s)", type_var, var)
+	compiler:emit(
+		"if %s ~= \"string\" and %s ~= \"number\" and %s ~= \"boolean\" and not %s(%s) then return false end",
+		type_var, type_var, type_var, compiler:ref(is_serializable), var)
+	compiler:emit("end")
+end
+function Compiler.emitters.Enum(compiler, descriptor, var)
+	compiler:emit("if %s[%s] ~= true then return false end", compiler:ref(descriptor.values_lookup), var)
+end
+function Compiler.emitters.Const(compiler, descriptor, var)
+	compiler:emit("if %s ~= %s then return false end", var, compiler:literal(descriptor.const))
+end
+function Compiler.emitters.Optional(compiler, descriptor, var)
+	compiler:emit("if %s ~= nil then", var)
+	compiler:condition(descriptor.condition, var)
+	compiler:emit("end")
+end
+function Compiler.emitters.Check(compiler, descriptor, var)
+	compiler:emit("if not %s(%s) then return false end", compiler:ref(descriptor.condition), var)
+end
+function Compiler.emitters.AllOf(compiler, descriptor, var)
+	for _, condition in ipairs(descriptor.conditions) do
+		compiler:condition(condition, var)
+	end
+end
+function Compiler.emitters.AnyOf(compiler, descriptor, var)
+	local calls = {}
+	for i, condition in ipairs(descriptor.conditions) do
+		calls[i] = string.format("%s(%s)", compiler:function_name(condition), var)
+	end
+	compiler:emit("if not (%s) then return false end", table.concat(calls, " or "))
+end
+function Compiler.emitters.OneOf(compiler, descriptor, var)
+	local matches_var = compiler:new_var()
+	compiler:emit("do local %s = 0", matches_var)
+	for _, condition in ipairs(descriptor.conditions) do
+		compiler:emit(
+			"if %s(%s) then %s = %s + 1 end", compiler:function_name(condition), var, matches_var, matches_var)
+	end
+	compiler:emit("if %s ~= 1 then return false end", matches_var)
+	compiler:emit("end")
+end
+function Compiler.emitters.Array(compiler, descriptor, var)
+	local length_var = compiler:new_var()
+	local count_var = compiler:new_var()
+	local key_var = compiler:new_var()
+	local value_var = compiler:new_var()
+
+	compiler:emit("if type(%s) ~= \"table\" then return false end", var)
+	compiler:emit("do local %s, %s = #%s, 0", length_var, count_var, var)
+	if descriptor.length ~= nil then
+		compiler:emit("if %s ~= %s then return false end", length_var, compiler:literal(descriptor.length))
+	end
+	compiler:emit("for %s, %s in pairs(%s) do", key_var, value_var, var)
+	compiler:emit("if type(%s) ~= \"number\" then return false end", key_var)
+	compiler:condition(descriptor.condition, value_var)
+	compiler:emit("%s = %s + 1", count_var, count_var)
+	compiler:emit("end")
+	compiler:emit("if %s > %s then return false end", count_var, length_var)
+	if descriptor.min_length ~= nil then
+		compiler:emit("if %s < %s then return false end", length_var, compiler:literal(descriptor.min_length))
+	end
+	if descriptor.max_length ~= nil then
+		compiler:emit("if %s > %s then return false end", length_var, compiler:literal(descriptor.max_length))
+	end
+	compiler:emit("end")
+end
+function Compiler.emitters.Mapping(compiler, descriptor, var)
+	compiler:emit("if type(%s) ~= \"table\" then return false end", var)
+	if compiler:get_is_any(descriptor.key_condition) and compiler:get_is_any(descriptor.value_condition) then
+		return
+	end
+
+	local key_var = compiler:new_var()
+	local value_var = compiler:new_var()
+	compiler:emit("for %s, %s in pairs(%s) do", key_var, value_var, var)
+	compiler:condition(descriptor.key_condition, key_var)
+	compiler:condition(descriptor.value_condition, value_var)
+	compiler:emit("end")
+end
+function Compiler.emitters.Object(compiler, descriptor, var)
+	compiler:emit("if type(%s) ~= \"table\" or #%s > 0 then return false end", var, var)
+
+	local condition_map = descriptor.condition_map
+	local keys = {}
+	for key, _ in pairs(condition_map) do
+		keys[#keys + 1] = key
+	end
+	table.sort(keys)
+	for _, key in ipairs(keys) do
+		local value_var = compiler:new_var()
+		compiler:emit("do local %s = %s[%s]", value_var, var, compiler:literal(key))
+		compiler:condition(condition_map[key], value_var)
+		compiler:emit("end")
+	end
+
+	-- partial objects skip the walk over their other keys entirely
+	if not compiler:get_is_any(descriptor.additional_value_condition) then
+		local key_var = compiler:new_var()
+		local value_var = compiler:new_var()
+		compiler:emit("for %s, %s in pairs(%s) do", key_var, value_var, var)
+		compiler:emit("if %s[%s] == nil then", compiler:ref(condition_map), key_var)
+		compiler:condition(descriptor.additional_value_condition, value_var)
+		compiler:emit("end")
+		compiler:emit("end")
+	end
+end
+
+-- returns a function of x which only returns true or false, for callers that do not need the error
+function Schema.compile_check(schema)
+	assert(Schema.Function(schema))
+
+	return Compiler.new():compile(schema)
+end
+local compiled_schemas = setmetatable({}, {__mode = "k"})
+function Schema.compile(schema)
+	assert(Schema.Function(schema))
+
+	local descriptor = descriptors[schema]
+	if descriptor == nil or compiled_schemas[schema] then
+		return schema
+	end
+
+	local check = Schema.compile_check(schema)
+	local function compiled(x)
+		if check(x) then
+			return true
+		end
+		return schema(x)
+	end
+	compiled_schemas[compiled] = true
+
+	-- compiled schemas keep the original descriptor, so they are inlined when composed into other schemas
+	return describe(descriptor, compiled)
+end
+
+-- used by most sys schemas
+SerializableArray = Schema.compile(SerializableArray)
+SerializableObject = Schema.compile(SerializableObject)
+Schema.SerializableArray = SerializableArray
+Schema.SerializableObject = SerializableObject
+
 Schema.tests = Testing.add_suite("core.Schema", {
 	serialize_deserialize = function()
 		local test_schema_values = {
@@ -436,6 +779,7 @@ Schema.tests = Testing.add_suite("core.Schema", {
 			[Schema.PartialObject{}] = {{}, {a=2}, {b=3}, {c=2, d={3, "4", {"5"}}}},
 		}
 		for value_schema, values in pairs(test_schema_values) do
+			local compiled_schema = Schema.compile(value_schema)
 			for _, value in ipairs(values) do
 				local result, err = value_schema(value)
 				if err then
@@ -443,6 +787,8 @@ Schema.tests = Testing.add_suite("core.Schema", {
 				end
 				assert(err == nil)
 				assert(result == true)
+				assert(Schema.compile_check(value_schema)(value) == true)
+				assert(compiled_schema(value) == true)
 			end
 		end
 
@@ -478,10 +824,16 @@ Schema.tests = Testing.add_suite("core.Schema", {
 			[Schema.PartialObject{}] = {-1, "", {1, 2}, {a=2, 3}},
 		}
 		for value_schema, failure_values in pairs(test_schema_failure_values) do
+			local compiled_schema = Schema.compile(value_schema)
 			for _, failure_value in ipairs(failure_values) do
 				local result, err = value_schema(failure_value)
 				assert(result == false)
 				assert(type(err) == "string")
+				assert(Schema.compile_check(value_schema)(failure_value) == false)
+
+				local compiled_result, compiled_err = compiled_schema(failure_value)
+				assert(compiled_result == false)
+				assert(compiled_err == err)
 			end
 		end
 
@@ -493,6 +845,77 @@ Schema.tests = Testing.add_suite("core.Schema", {
 		assert(not Schema.None())
 		assert(not Schema.None(nil))
 	end,
+	compile = function()
+		local Position = Schema.Object{x = Schema.Integer, y = Schema.Integer}
+		local Item = Schema.OneOf(Schema.Object{destroyed = Schema.Const(true)}, Schema.AllOf(
+			Schema.SerializableObject,
+			Schema.PartialObject{
+				destroyed = Schema.Nil,
+				kind = Schema.Optional(Schema.Enum("a", "b")),
+				tags = Schema.Optional(Schema.Mapping(Schema.LabelString, Schema.Boolean)),
+				position = Schema.Optional(Position),
+				scale = Schema.Optional(Schema.BoundedNumber(0.5, 2)),
+				even = Schema.Optional(Schema.Check(function(x) return x % 2 == 0 end)),
+				custom = Schema.Optional(function(x) return x == "custom" end),
+			}))
+		local Inventory = Schema.Object({
+			items = Schema.Array(Item),
+			names = Schema.BoundedArray(Schema.NonEmptyString, 0, 2),
+			slot = Schema.AnyOf(Schema.Nil, Schema.PositiveInteger, Schema.Const("none")),
+		}, Schema.Number)
+
+		local compiled_inventory = Schema.compile(Inventory)
+		local inventory_check = Schema.compile_check(Inventory)
+		assert(compiled_inventory ~= Inventory)
+		assert(Schema.compile(compiled_inventory) == compiled_inventory)
+		assert(Schema.compile(function() return true end) ~= nil)
+
+		local valid_values = {
+			{items = {}, names = {}},
+			{items = {{destroyed = true}, {kind = "a", tags = {on = true}}, {}}, names = {"x", "y"}, slot = 2},
+			{items = {{position = {x = 1, y = -2}, scale = 2, even = 4, custom = "custom", data = {1, {a = "b"}}}},
+				names = {}, slot = "none", extra = 1.5},
+		}
+		local invalid_values = {
+			{items = {}},
+			{items = {}, names = {}, slot = 0},
+			{items = {}, names = {}, extra = "not a number"},
+			{items = {{destroyed = true, kind = "a"}}, names = {}},
+			{items = {{destroyed = false}}, names = {}},
+			{items = {{kind = "c"}}, names = {}},
+			{items = {{tags = {On = true}}}, names = {}},
+			{items = {{position = {x = 1}}}, names = {}},
+			{items = {{position = {x = 1, y = 2, z = 3}}}, names = {}},
+			{items = {{scale = 3}}, names = {}},
+			{items = {{even = 3}}, names = {}},
+			{items = {{custom = "other"}}, names = {}},
+			{items = {{data = {[1] = 1, [3] = 3}}}, names = {}},
+			{items = {{data = {print}}}, names = {}},
+			{items = {[2] = {}}, names = {}},
+			{items = {}, names = {"a", "b", "c"}},
+			{items = {}, names = {""}},
+			{1, items = {}, names = {}},
+			"not a table",
+		}
+		for _, value in ipairs(valid_values) do
+			assert(Inventory(value))
+			assert(inventory_check(value) == true)
+			assert(compiled_inventory(value) == true)
+		end
+		for _, value in ipairs(invalid_values) do
+			local result, err = Inventory(value)
+			assert(result == false)
+			assert(inventory_check(value) == false)
+			local compiled_result, compiled_err = compiled_inventory(value)
+			assert(compiled_result == false)
+			assert(compiled_err == err)
+		end
+
+		-- compiled schemas compose like the schemas they were compiled from
+		local Inventories = Schema.compile(Schema.Mapping(Schema.LabelString, compiled_inventory))
+		assert(Inventories{a = valid_values[1], b = valid_values[2]})
+		assert(not Inventories{a = valid_values[1], b = invalid_values[1]})
+	end,
 })
 
 return Schema
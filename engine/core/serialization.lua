@@ -1,4 +1,6 @@
+local json = require("engine/lib/json/json")
 local Testing = require("engine/core/testing")
+local Container = require("engine/core/container")
 
 local Serialization = {}
 function Serialization.get_escaped_string(str)
@@ -86,6 +88,95 @@ function Serialization.deserialize(str)
 	end
 	return result
 end
+
+-- native json codec when running under the native client, with the same behavior as json.lua
+Serialization.Json = rawget(_G, "odClientWrapper") and odClientWrapper.Json or json
+
+-- compact binary snapshots, when running under the native client; json files otherwise
+Serialization.Snapshot = rawget(_G, "odClientWrapper") and odClientWrapper.Snapshot
+function Serialization.save_file(filename, xs)
+	local Snapshot = Serialization.Snapshot
+	if Snapshot ~= nil then
+		return Snapshot.save(filename, xs)
+	end
+
+	local file, err = io.open(filename, "w")
+	if file == nil then
+		return false, err
+	end
+	file:write(Serialization.Json.encode(xs, {indent = true}))
+	file:close()
+	return true
+end
+function Serialization.load_file(filename)
+	local file, err = io.open(filename, "rb")
+	if file == nil then
+		return nil, err
+	end
+
+	-- snapshots are detected by their header, so json saves still load
+	local Snapshot = Serialization.Snapshot
+	local header = file:read(4) or ""
+	if Snapshot ~= nil and header == Snapshot.magic then
+		file:close()
+		return Snapshot.load(filename)
+	end
+
+	local contents = header..(file:read("*a") or "")
+	file:close()
+	return Serialization.Json.decode(contents)
+end
+function Serialization.encode(xs)
+	local Snapshot = Serialization.Snapshot
+	if Snapshot ~= nil then
+		return Snapshot.encode(xs)
+	end
+	return Serialization.Json.encode(xs)
+end
+function Serialization.decode(str)
+	local Snapshot = Serialization.Snapshot
+	if Snapshot ~= nil and str:sub(1, #Snapshot.magic) == Snapshot.magic then
+		return Snapshot.decode(str)
+	end
+	return Serialization.Json.decode(str)
+end
+-- record files are a sequence of "<size>\n<encoded bytes>" records, so they can be appended to without rewriting
+function Serialization.append_record_file(filename, xs)
+	local file, err = io.open(filename, "ab")
+	if file == nil then
+		return false, err
+	end
+
+	local encoded = Serialization.encode(xs)
+	file:write(#encoded, "\n", encoded)
+	file:close()
+	return true
+end
+function Serialization.load_record_file(filename)
+	local file, err = io.open(filename, "rb")
+	if file == nil then
+		return nil, err
+	end
+
+	local records = {}
+	while true do
+		local size = tonumber(file:read("*l") or "")
+		local encoded = size and file:read(size)
+
+		-- a truncated final record is from an interrupted write, and is dropped
+		if encoded == nil or #encoded ~= size then
+			break
+		end
+		records[#records + 1] = Serialization.decode(encoded)
+	end
+
+	file:close()
+	return records
+end
+
+-- copy and restore of serializable state, natively when available
+Serialization.copy = Serialization.Snapshot and Serialization.Snapshot.copy or Container.deep_copy
+Serialization.restore = Serialization.Snapshot and Serialization.Snapshot.restore or Container.restore
 Serialization.tests = Testing.add_suite("core.serialization", {
 	serialize_deserialize = function()
 		local test_values = {
@@ -116,6 +207,112 @@ Serialization.tests = Testing.add_suite("core.serialization", {
 			assert(Serialization.serialize(deserialized) == serialized)
 		end
 	end,
+	copy_restore = function()
+		local ys = {a = {1, 2.5, "3"}, b = {c = true, d = {e = false}}}
+		local xs = Serialization.copy(ys)
+		assert(xs ~= ys and xs.b ~= ys.b)
+		Container.assert_equal(xs, ys)
+
+		local xs_b = xs.b
+		xs.a[4] = 4
+		xs.b.d = nil
+		xs.f = {}
+		assert(Serialization.restore(xs, ys) == xs)
+		Container.assert_equal(xs, ys)
+		assert(xs.b == xs_b and xs.b.d ~= ys.b.d)
+	end,
+	save_load_file = function()
+		local filename = "core_serialization_save_load_file.save"
+		local xs = {a = {1, 2.5, "3"}, b = {c = true, d = false}, e = {}}
+		assert(Serialization.save_file(filename, xs))
+		local loaded = Serialization.load_file(filename)
+		os.remove(filename)
+
+		assert(Serialization.serialize(loaded.a) == Serialization.serialize(xs.a))
+		assert(loaded.b.c == true and loaded.b.d == false)
+		assert(type(loaded.e) == "table" and next(loaded.e) == nil)
+		assert(Serialization.load_file(filename) == nil)
+
+		-- failures are reported with a message, so callers can log why
+		local ok, err = Serialization.save_file("core_serialization_missing_dir/save_load_file.save", xs)
+		assert(ok == false and type(err) == "string")
+		local missing, load_err = Serialization.load_file(filename)
+		assert(missing == nil and type(load_err) == "string")
+	end,
+	json = function()
+		-- the native codec must match json.lua exactly, including on the example data
+		local Json = Serialization.Json
+		local values = {
+			0,
+			-0.5,
+			1e300,
+			0/0,
+			"",
+			"a\"b\\c\n\0\1\127/",
+			"\226\128\168\194\173\195\169",
+			{},
+			{1, nil, 3},
+			{[20] = 1},
+			{n = 3},
+			{[1.5] = 1, x = 2},
+			{a = {b = {true, false}}, c = "d", [""] = {{}}},
+			setmetatable({}, {__jsontype = "object"}),
+		}
+		for _, filename in ipairs({"ld50/data/map.json", "ld50/data/map_test.json"}) do
+			local file = io.open(filename, "rb")
+			if file ~= nil then
+				values[#values + 1] = json.decode(file:read("*a"))
+				file:close()
+			end
+		end
+
+		for _, value in ipairs(values) do
+			for _, indent in ipairs({false, true}) do
+				local encoded = json.encode(value, {indent = indent})
+				assert(Json.encode(value, {indent = indent}) == encoded)
+
+				local decoded, pos = Json.decode(encoded)
+				local lib_decoded, lib_pos = json.decode(encoded)
+				assert(pos == lib_pos)
+				Container.assert_equal(decoded, lib_decoded)
+				assert(Json.encode(decoded) == json.encode(lib_decoded))
+			end
+		end
+
+		local invalid_strs = {"", "  ", "[1, 2", "{\"a\": 1", "\"abc", "\n  [nope]", "{null: 1}", "[1.2.3]", "tru", "/* x"}
+		for _, str in ipairs(invalid_strs) do
+			local value, pos, err = Json.decode(str)
+			local lib_value, lib_pos, lib_err = json.decode(str)
+			assert(value == nil and lib_value == nil)
+			assert(pos == lib_pos and err == lib_err)
+		end
+
+		for _, value in ipairs({function() end, {[true] = 1}}) do
+			assert(not pcall(Json.encode, value))
+		end
+	end,
+	append_load_record_file = function()
+		local filename = "core_serialization_append_load_record_file.log"
+		os.remove(filename)
+		assert(Serialization.load_record_file(filename) == nil)
+
+		local records = {{a = 1}, {"\n", "2\n3"}, {b = {c = true}}}
+		for _, record in ipairs(records) do
+			assert(Serialization.append_record_file(filename, record))
+		end
+
+		local file = io.open(filename, "ab")
+		file:write("100\ntruncated")
+		file:close()
+
+		local loaded = Serialization.load_record_file(filename)
+		os.remove(filename)
+
+		assert(#loaded == #records)
+		for i, record in ipairs(records) do
+			assert(Serialization.serialize(loaded[i]) == Serialization.serialize(record))
+		end
+	end,
 })
 
 return Serialization
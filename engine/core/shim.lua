@@ -3,4 +3,6 @@ Shim.unpack = unpack or table.unpack  -- luacheck: globals unpack, ignore table
 
 Shim.atan2 = math.atan2 or math.atan  -- luacheck: globals math
 
+Shim.loadstring = loadstring or load  -- luacheck: globals loadstring
+
 return Shim
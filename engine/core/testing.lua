@@ -158,6 +158,202 @@ function Testing.run_all()
 	Logging.info("Completed %s lua tests", count)
 	return true
 end
+--[[ Benchmarks mirror the client's c++ benchmarks (see OD_BENCHMARK): fn(run) repeats its body
+while run:next() is true, and each repetition after warmup is timed as one sample.
+The gc is collected before and stopped during each sample, so samples do not pay for earlier garbage,
+and each sample's heap growth is the memory it allocated. ]]
+Testing.BENCHMARK_WARMUP_COUNT = 3
+Testing.BENCHMARK_SAMPLE_COUNT = 30
+
+Testing.BenchmarkRun = {}
+Testing.BenchmarkRun.__index = Testing.BenchmarkRun
+function Testing.BenchmarkRun:next()
+	local now_ns = Debugging.get_time_ns()
+	local heap_kb = collectgarbage("count")
+
+	local sample_i = self.iteration - self.warmup_count
+	if sample_i >= 1 and sample_i <= self.sample_count then
+		self.samples_ns[sample_i] = now_ns - self._start_ns
+		self.samples_allocated_kb[sample_i] = heap_kb - self._start_kb
+	end
+
+	self.iteration = self.iteration + 1
+	if self.iteration > self.warmup_count + self.sample_count then
+		collectgarbage("restart")
+		return false
+	end
+
+	collectgarbage("collect")
+	collectgarbage("stop")
+	self._start_kb = collectgarbage("count")
+	self._start_ns = Debugging.get_time_ns()
+	return true
+end
+function Testing.BenchmarkRun.create(warmup_count, sample_count)
+	local run = {
+		warmup_count = warmup_count,
+		sample_count = sample_count,
+		iteration = 0,
+		samples_ns = {},
+		samples_allocated_kb = {},
+		_start_ns = 0,
+		_start_kb = 0,
+	}
+	setmetatable(run, Testing.BenchmarkRun)
+	return run
+end
+
+Testing.Benchmark = {}
+Testing.Benchmark.__index = Testing.Benchmark
+-- {name, suite, samples, min_ns, median_ns, p95_ns, mean_ns, allocated_bytes}, or nil on failure
+function Testing.Benchmark:run()
+	Logging.debug("Running benchmark %s.%s", self.suite_name, self.name)
+
+	local run = Testing.BenchmarkRun.create(self.warmup_count, self.sample_count)
+	local ok, err = Debugging.pcall(self.fn, run)
+	collectgarbage("restart")
+	if not ok then
+		Logging.error("Failed benchmark %s.%s, err=\n%s", self.suite_name, self.name, err)
+		return nil
+	end
+	if run.iteration <= self.warmup_count + self.sample_count then
+		Logging.error("Benchmark %s.%s ended before taking all samples", self.suite_name, self.name)
+		return nil
+	end
+
+	local samples_ns = run.samples_ns
+	local total_ns = 0
+	local total_allocated_kb = 0
+	for i = 1, self.sample_count do
+		total_ns = total_ns + samples_ns[i]
+		total_allocated_kb = total_allocated_kb + run.samples_allocated_kb[i]
+	end
+	table.sort(samples_ns)
+
+	-- same indexing as the c++ benchmarks, shifted for 1-based arrays
+	local sample_count = self.sample_count
+	return {
+		name = self.name,
+		suite = self.suite_name,
+		samples = sample_count,
+		min_ns = math.floor(samples_ns[1]),
+		median_ns = math.floor(samples_ns[math.floor(sample_count / 2) + 1]),
+		p95_ns = math.floor(samples_ns[math.max(math.ceil(sample_count * 0.95), 1)]),
+		mean_ns = math.floor(total_ns / sample_count),
+		allocated_bytes = math.floor((total_allocated_kb * 1024) / sample_count),
+	}
+end
+function Testing.Benchmark.create(suite_name, name, fn, warmup_count, sample_count)
+	assert(type(suite_name) == "string", "suite_name must be a string")
+	assert(type(name) == "string", "name must be a string")
+	assert(type(fn) == "function", "fn must be a function")
+	assert(type(warmup_count) == "number" and warmup_count >= 0, "warmup_count must be a non-negative number")
+	assert(type(sample_count) == "number" and sample_count > 0, "sample_count must be a positive number")
+
+	local benchmark = {
+		suite_name = suite_name,
+		name = name,
+		fn = fn,
+		warmup_count = warmup_count,
+		sample_count = sample_count,
+	}
+	setmetatable(benchmark, Testing.Benchmark)
+	return benchmark
+end
+
+Testing.benchmark_suites = {}
+-- settings: {warmup_count = n, sample_count = n}, both optional
+function Testing.add_benchmark_suite(suite_name, benchmark_name_fn_map, settings)
+	assert(type(suite_name) == "string", "suite_name must be a string")
+	assert(type(benchmark_name_fn_map) == "table", "benchmark_name_fn_map must be a table")
+	settings = settings or {}
+
+	local benchmark_suite = {
+		name = suite_name,
+		benchmarks = {},
+	}
+	for benchmark_name, benchmark_fn in pairs(benchmark_name_fn_map) do
+		benchmark_suite.benchmarks[#benchmark_suite.benchmarks + 1] = Testing.Benchmark.create(
+			suite_name,
+			benchmark_name,
+			benchmark_fn,
+			settings.warmup_count or Testing.BENCHMARK_WARMUP_COUNT,
+			settings.sample_count or Testing.BENCHMARK_SAMPLE_COUNT)
+	end
+	table.sort(benchmark_suite.benchmarks, function(a, b) return a.name < b.name end)
+
+	Testing.benchmark_suites[#Testing.benchmark_suites + 1] = benchmark_suite
+	return benchmark_suite
+end
+-- same layout as the c++ benchmark results (see odBenchmark_write_json), with allocated_bytes added
+function Testing.write_benchmark_json(filename, results)
+	local lines = {}
+	for i, result in ipairs(results) do
+		lines[i] = string.format(
+			'{"name":"%s","suite":"%s","samples":%d,'
+			..'"min_ns":%d,"median_ns":%d,"p95_ns":%d,"mean_ns":%d,"allocated_bytes":%d}',
+			result.name,
+			result.suite,
+			result.samples,
+			result.min_ns,
+			result.median_ns,
+			result.p95_ns,
+			result.mean_ns,
+			result.allocated_bytes)
+	end
+
+	local file = io.open(filename, "wb")
+	if file == nil then
+		Logging.error("Failed to open benchmark results file, filename=%s", filename)
+		return false
+	end
+	file:write('{"benchmarks":[\n', table.concat(lines, ",\n"), (#lines > 0) and "\n" or "", "]}\n")
+	file:close()
+
+	Logging.info("Benchmark results written, filename=%s, benchmarks=%d", filename, #results)
+	return true
+end
+--[[ settings: {name_filter = str, json_filename = str}, both optional.
+name_filter is matched as plain text against "suite.name".  Returns the results, or nil on failure. ]]
+function Testing.run_all_benchmarks(settings)
+	settings = settings or {}
+
+	Logging.info("Running all lua benchmarks")
+	if Debugging.debug_checks_enabled then
+		Logging.warning("Benchmarking with debug checks enabled; disable them for representative results")
+	end
+
+	local results = {}
+	for _, benchmark_suite in ipairs(Testing.benchmark_suites) do
+		for _, benchmark in ipairs(benchmark_suite.benchmarks) do
+			local full_name = benchmark.suite_name.."."..benchmark.name
+			if settings.name_filter == nil or string.find(full_name, settings.name_filter, 1, true) then
+				local result = benchmark:run()
+				if result == nil then
+					Logging.info("Not all lua benchmarks completed successfully")
+					return nil
+				end
+				results[#results + 1] = result
+
+				Logging.info(
+					"Benchmark %s: min=%.3fus, median=%.3fus, p95=%.3fus, allocated=%dB, samples=%d",
+					full_name,
+					result.min_ns / 1e3,
+					result.median_ns / 1e3,
+					result.p95_ns / 1e3,
+					result.allocated_bytes,
+					result.samples)
+			end
+		end
+	end
+
+	if settings.json_filename ~= nil and not Testing.write_benchmark_json(settings.json_filename, results) then
+		return nil
+	end
+
+	Logging.info("Completed %s lua benchmarks", #results)
+	return results
+end
 function Testing.suppress_errors(fn)
 	local debugger_enabled = Debugging.debugger_enabled
 	if debugger_enabled then
@@ -174,4 +370,40 @@ function Testing.suppress_errors(fn)
 	assert(Logging.pop_level() == true)
 end
 
+Testing.tests = Testing.add_suite("core.testing", {
+	benchmark = function()
+		local table_count = 100
+		local calls = 0
+		local benchmark = Testing.Benchmark.create("core.testing", "allocate", function(run)
+			local xs
+			while run:next() do
+				calls = calls + 1
+				xs = {}
+				for i = 1, table_count do
+					xs[i] = {i}
+				end
+			end
+			return xs
+		end, 2, 5)
+
+		local result = benchmark:run()
+		assert(calls == 7)
+		assert(result.name == "allocate" and result.suite == "core.testing" and result.samples == 5)
+		assert(result.min_ns <= result.median_ns and result.median_ns <= result.p95_ns)
+		assert(result.allocated_bytes >= table_count * 16)
+
+		Testing.suppress_errors(function()
+			assert(Testing.Benchmark.create("core.testing", "no_samples", function() end, 0, 1):run() == nil)
+		end)
+
+		local filename = "core_testing_benchmark.json"
+		assert(Testing.write_benchmark_json(filename, {result}))
+		local file = io.open(filename, "rb")
+		local json = file:read("*a")
+		file:close()
+		os.remove(filename)
+		assert(string.find(json, '{"name":"allocate","suite":"core.testing","samples":5,', 1, true))
+	end,
+})
+
 return Testing
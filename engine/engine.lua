@@ -1,6 +1,7 @@
 local Engine = {}
 
 Engine.Animation = require("engine/engine/animation")
+Engine.Autosave = require("engine/engine/autosave")
 Engine.Camera = require("engine/engine/camera")
 Engine.CameraTarget = require("engine/engine/camera_target")
 Engine.Client = require("engine/engine/client")
@@ -8,6 +9,7 @@ Engine.Controller = require("engine/engine/controller")
 Engine.Core = require("engine/core")
 Engine.Entity = require("engine/engine/entity")
 Engine.Game = require("engine/engine/game")
+Engine.History = require("engine/engine/history")
 Engine.Image = require("engine/engine/image")
 Engine.Sim = require("engine/engine/sim")
 Engine.Systems = require("engine/engine/systems")
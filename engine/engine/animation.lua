@@ -45,9 +45,10 @@ Animation.WorldSys.State.defaults = {
 Animation.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
 	state = Animation.WorldSys.State.Schema,
 	_client_world = Client.WorldSys.Schema,
-	_entity_world = Entity.WorldSys.Schema,
+	_entity_world = Entity.WorldSys.ShallowSchema,
 	_image_world = Image.WorldSys.Schema,
 	_entity_reindex_required = Schema.Boolean,
+	_tagged_ids = Schema.Array(Schema.PositiveInteger),
 })
 function Animation.WorldSys:index(anim_name, animation)
 	if debug_checks_enabled then
@@ -319,6 +320,7 @@ function Animation.WorldSys:on_init()
 	self._image_world = self.sim:require(Image.WorldSys)
 
 	self._entity_reindex_required = true
+	self._tagged_ids = {}
 
 	self:index_all()
 
@@ -327,7 +329,9 @@ function Animation.WorldSys:on_init()
 	end
 end
 function Animation.WorldSys:on_step()
-	for _, entity in ipairs(self._entity_world:get_all_tagged_array(self.tag)) do
+	local entities = self._entity_world:get_all_raw()
+	for _, entity_id in ipairs(self._entity_world:get_all_tagged_ids(self.tag, self._tagged_ids)) do
+		local entity = entities[entity_id]
 		local anim_name = entity.anim_name
 		if anim_name ~= nil then
 			local animation = self:find(anim_name)
@@ -345,7 +349,6 @@ function Animation.WorldSys:on_step()
 
 			entity.anim_pos = anim_pos
 
-			local entity_id = self._entity_world:find_id(entity)
 			local frame_id = math_floor(anim_pos) + 1
 			self._image_world:entity_set(entity_id, frames[frame_id], entity)
 		end
@@ -0,0 +1,314 @@
+local Debugging = require("engine/core/debugging")
+local Testing = require("engine/core/testing")
+local Logging = require("engine/core/logging")
+local Schema = require("engine/core/schema")
+local Container = require("engine/core/container")
+local Serialization = require("engine/core/serialization")
+local Sim = require("engine/engine/sim")
+local World = require("engine/engine/world")
+local Game = require("engine/engine/game")
+local Entity = require("engine/engine/entity")
+
+local debug_checks_enabled = Debugging.debug_checks_enabled
+local expensive_debug_checks_enabled = Debugging.expensive_debug_checks_enabled
+
+--[[ Incremental world saves, as a record file (see Serialization.append_record_file).
+Each record holds the entities changed since the previous record, and all non-entity state.
+Loading replays the records in order.
+
+Compaction rewrites the file from scratch, to bound its size.  It is spread over several saves
+(compact_chunk_size entities per save) to a separate file, which replaces the save once complete,
+so no single save writes the whole world. ]]
+local Autosave = {}
+
+Autosave.Record = {}
+Autosave.Record.Schema = Schema.Object{
+	ids = Schema.Array(Schema.PositiveInteger),
+	entities = Schema.Array(Entity.Entity.Schema),
+	state = Schema.SerializableObject,
+}
+
+Autosave.WorldSys = World.Sys.new_metatable("autosave")
+Autosave.WorldSys.State = {}
+Autosave.WorldSys.State.Schema = Schema.Object{
+	filename = Schema.Optional(Schema.NonEmptyString),  -- autosave is disabled if not set
+	period = Schema.PositiveInteger,  -- steps between saves
+	compact_period = Schema.PositiveInteger,  -- saves between compactions
+	compact_chunk_size = Schema.PositiveInteger,  -- entities rewritten per save while compacting
+}
+Autosave.WorldSys.State.defaults = {
+	period = 300,
+	compact_period = 20,
+	compact_chunk_size = 2000,
+}
+Autosave.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
+	state = Autosave.WorldSys.State.Schema,
+	_entity_world = Entity.WorldSys.ShallowSchema,
+	_steps_until_save = Schema.NonNegativeInteger,
+	_saves_until_compact = Schema.NonNegativeInteger,
+	_compact_next_id = Schema.Optional(Schema.PositiveInteger),
+	-- the save file is only appended to once this world has been fully written by a compaction
+	_is_save_current = Schema.Boolean,
+})
+function Autosave.get_compact_filename(filename)
+	return filename..".compact"
+end
+function Autosave.load_file(filename)
+	if debug_checks_enabled then
+		assert(Schema.NonEmptyString(filename))
+	end
+
+	local records, err = Serialization.load_record_file(filename)
+	if records == nil then
+		return nil, err
+	end
+
+	local state = {entity = {entities = {}}}
+	for _, record in ipairs(records) do
+		if expensive_debug_checks_enabled then
+			assert(Autosave.Record.Schema(record))
+		end
+
+		for sys_name, sys_state in pairs(record.state) do
+			if sys_name == Entity.WorldSys.sys_name then
+				Container.update(state.entity, sys_state)
+			else
+				state[sys_name] = sys_state
+			end
+		end
+
+		local entities = state.entity.entities
+		local record_entities = record.entities
+		for i, entity_id in ipairs(record.ids) do
+			entities[entity_id] = record_entities[i]
+		end
+	end
+
+	return state
+end
+function Autosave.WorldSys:_add_entity(record, entity_id)
+	local entities = self._entity_world.state.entities
+	record.ids[#record.ids + 1] = entity_id
+	record.entities[#record.entities + 1] = entities[entity_id]
+end
+function Autosave.WorldSys:_get_state()
+	local state = {}
+	for sys_name, sys_state in pairs(self.sim.state) do
+		if sys_name == Entity.WorldSys.sys_name then
+			local entity_state = {}
+			for key, value in pairs(sys_state) do
+				if key ~= "entities" then
+					entity_state[key] = value
+				end
+			end
+			state[sys_name] = entity_state
+		else
+			state[sys_name] = sys_state
+		end
+	end
+	return state
+end
+function Autosave.WorldSys:_append(filename, record)
+	local ok, err = Serialization.append_record_file(filename, record)
+	if not ok then
+		Logging.warning("failed to append autosave, filename=%s, err=%s", filename, err)
+	end
+	return ok
+end
+function Autosave.WorldSys:compact()
+	if debug_checks_enabled then
+		if expensive_debug_checks_enabled then
+			assert(Autosave.WorldSys.Schema(self))
+		end
+		assert(self.state.filename ~= nil)
+	end
+
+	if self._compact_next_id == nil then
+		os.remove(Autosave.get_compact_filename(self.state.filename))
+		self._compact_next_id = 1
+	end
+end
+function Autosave.WorldSys:save()
+	if debug_checks_enabled then
+		if expensive_debug_checks_enabled then
+			assert(Autosave.WorldSys.Schema(self))
+		end
+		assert(self.state.filename ~= nil)
+		assert(self.sim.status == Sim.Status.started)
+	end
+
+	local filename = self.state.filename
+	local entity_ids_changed = self._entity_world:take_changed_ids()
+	local state = self:_get_state()
+
+	if self._is_save_current then
+		local record = {ids = {}, entities = {}, state = state}
+		for entity_id, _ in pairs(entity_ids_changed) do
+			self:_add_entity(record, entity_id)
+		end
+		self:_append(filename, record)
+
+		self._saves_until_compact = math.max(self._saves_until_compact - 1, 0)
+		if self._saves_until_compact == 0 then
+			self:compact()
+		end
+	end
+
+	local compact_next_id = self._compact_next_id
+	if compact_next_id == nil then
+		return
+	end
+
+	-- changes to entities written by earlier compaction records are included, later chunks cover the rest
+	local record = {ids = {}, entities = {}, state = state}
+	for entity_id, _ in pairs(entity_ids_changed) do
+		if entity_id < compact_next_id then
+			self:_add_entity(record, entity_id)
+		end
+	end
+
+	local entity_count = #self._entity_world.state.entities
+	local compact_last_id = math.min(compact_next_id + self.state.compact_chunk_size - 1, entity_count)
+	for entity_id = compact_next_id, compact_last_id do
+		self:_add_entity(record, entity_id)
+	end
+
+	local compact_filename = Autosave.get_compact_filename(filename)
+	if not self:_append(compact_filename, record) then
+		self._compact_next_id = nil
+		return
+	end
+
+	if compact_last_id < entity_count then
+		self._compact_next_id = compact_last_id + 1
+		return
+	end
+
+	if not os.rename(compact_filename, filename) then
+		-- rename does not replace existing files on all platforms
+		os.remove(filename)
+		if not os.rename(compact_filename, filename) then
+			Logging.warning("failed to replace autosave with compacted file, filename=%s", filename)
+			self._compact_next_id = nil
+			return
+		end
+	end
+
+	self._compact_next_id = nil
+	self._is_save_current = true
+	self._saves_until_compact = self.state.compact_period
+end
+function Autosave.WorldSys:on_init()
+	Container.set_defaults(self.state, Autosave.WorldSys.State.defaults)
+
+	self._entity_world = self.sim:require(Entity.WorldSys)
+	self._steps_until_save = self.state.period
+	self._saves_until_compact = self.state.compact_period
+	self._compact_next_id = nil
+	self._is_save_current = false
+
+	if expensive_debug_checks_enabled then
+		assert(Autosave.WorldSys.Schema(self))
+	end
+end
+function Autosave.WorldSys:on_start()
+	-- the existing save may be from another world, so this world is written out in full first
+	if self.state.filename ~= nil then
+		self:compact()
+	end
+end
+function Autosave.WorldSys:on_step_end()
+	if self.state.filename == nil then
+		return
+	end
+
+	self._steps_until_save = self._steps_until_save - 1
+	if self._steps_until_save <= 0 then
+		self._steps_until_save = self.state.period
+		self:save()
+	end
+end
+
+Autosave.GameSys = Game.Sys.new_metatable("autosave")
+Autosave.GameSys.WorldSys = Autosave.WorldSys
+function Autosave.GameSys:load(filename)
+	if debug_checks_enabled then
+		assert(Schema.NonEmptyString(filename))
+	end
+
+	local state, err = Autosave.load_file(filename)
+	if state == nil then
+		Logging.error("failed to read autosave, filename=%s, err=%s", filename, err)
+		return false
+	end
+
+	self._world_game:set(self._world_game:new_world(state))
+	return true
+end
+function Autosave.GameSys:on_init()
+	self._world_game = self.sim:require(World.GameSys)
+end
+
+Autosave.tests = Testing.add_suite("engine.autosave", {
+	save_load = function()
+		local filename = "engine_autosave_save_load.log"
+		os.remove(filename)
+
+		local world = World.World.new(nil, {
+			autosave = {filename = filename, period = 1, compact_period = 2, compact_chunk_size = 3},
+		})
+		local entity_world = world:require(Entity.WorldSys)
+		local autosave_world = world:require(Autosave.WorldSys)
+		world:start()
+
+		local entity_ids = {}
+		for i = 1, 10 do
+			entity_ids[i] = entity_world:add{x = i, y = 0, width = 1, height = 1}
+		end
+
+		-- the first compaction spans several saves, and the save file only appears once it completes
+		world:step()
+		assert(autosave_world._compact_next_id ~= nil)
+		assert(io.open(filename, "rb") == nil)
+		for _ = 1, 3 do
+			world:step()
+		end
+		assert(autosave_world._compact_next_id == nil)
+		assert(autosave_world._is_save_current)
+		Container.assert_equal(Autosave.load_file(filename).entity.entities, entity_world.state.entities)
+
+		-- changes are appended, until the next compaction
+		entity_world:set_pos(entity_ids[2], 20, 0)
+		entity_world:destroy(entity_ids[3])
+		local id = entity_world:add{x = 11, y = 0}
+		world:step()
+		local loaded = Autosave.load_file(filename)
+		Container.assert_equal(loaded.entity.entities, entity_world.state.entities)
+		assert(loaded.entity.entities[id].x == 11)
+		assert(loaded.autosave.filename == filename)
+
+		for i = 1, 6 do
+			entity_world:set_pos(entity_ids[1], 100 + i, 0)
+			world:step()
+			Container.assert_equal(Autosave.load_file(filename).entity.entities, entity_world.state.entities)
+		end
+
+		world:finalize()
+		os.remove(filename)
+		os.remove(Autosave.get_compact_filename(filename))
+	end,
+	disabled = function()
+		local world = World.World.new()
+		world:require(Entity.WorldSys)
+		local autosave_world = world:require(Autosave.WorldSys)
+		world:start()
+		for _ = 1, Autosave.WorldSys.State.defaults.period + 1 do
+			world:step()
+		end
+		assert(autosave_world._compact_next_id == nil)
+		assert(not autosave_world._is_save_current)
+		world:finalize()
+	end,
+})
+
+return Autosave
@@ -26,7 +26,8 @@ CameraTarget.WorldSys = World.Sys.new_metatable("camera_target")
 CameraTarget.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
 	_client_world = Client.WorldSys.Schema,
 	_camera_world = Camera.WorldSys.Schema,
-	_entity_world = Entity.WorldSys.Schema,
+	_entity_world = Entity.WorldSys.ShallowSchema,
+	_tagged_ids = Schema.Array(Schema.PositiveInteger),
 })
 function CameraTarget.WorldSys:entity_set(entity_id, camera_name, speed, entity)
 	if debug_checks_enabled then
@@ -79,6 +80,7 @@ function CameraTarget.WorldSys:on_init()
 	self._client_world = self.sim:require(Client.WorldSys)
 	self._camera_world = self.sim:require(Camera.WorldSys)
 	self._entity_world = self.sim:require(Entity.WorldSys)
+	self._tagged_ids = {}
 
 	if expensive_debug_checks_enabled then
 		assert(CameraTarget.WorldSys.Schema(self))
@@ -91,10 +93,8 @@ function CameraTarget.WorldSys:on_step_end()
 		end
 	end
 
-	local target_entities = self._entity_world:get_all_tagged_array(self.sys_name)
-
 	if expensive_debug_checks_enabled then
-		assert(Schema.Array(CameraTarget.Entity.Schema)(target_entities))
+		assert(Schema.Array(CameraTarget.Entity.Schema)(self._entity_world:get_all_tagged_array(self.sys_name)))
 	end
 
 	local seen_cameras
@@ -102,7 +102,9 @@ function CameraTarget.WorldSys:on_step_end()
 		seen_cameras = {}
 	end
 
-	for _, entity in ipairs(target_entities) do
+	local entities = self._entity_world:get_all_raw()
+	for _, entity_id in ipairs(self._entity_world:get_all_tagged_ids(self.sys_name, self._tagged_ids)) do
+		local entity = entities[entity_id]
 		local camera_name = entity.camera_name or self._camera_world.default_camera_name
 		local camera = self._camera_world:find(camera_name)
 
@@ -2,6 +2,7 @@ local Debugging = require("engine/core/debugging")
 local Schema = require("engine/core/schema")
 local Container = require("engine/core/container")
 local Testing = require("engine/core/testing")
+local Sim = require("engine/engine/sim")
 local Game = require("engine/engine/game")
 local World = require("engine/engine/world")
 local Camera = require("engine/engine/camera")
@@ -30,6 +31,10 @@ Client.Context.State.Schema = Schema.Object{
 	caption = Schema.Optional(Schema.String),
 	vsync = Schema.Optional(Schema.Boolean),
 	visible = Schema.Optional(Schema.Boolean),
+	headless = Schema.Optional(Schema.Boolean),
+	software_renderer = Schema.Optional(Schema.Boolean),
+	sim_hz = Schema.Optional(Schema.PositiveNumber),
+	max_catch_up_steps = Schema.Optional(Schema.PositiveInteger),
 }
 Client.Context.State.defaults = {
 	caption = "",
@@ -37,6 +42,10 @@ Client.Context.State.defaults = {
 	height = 768,
 	vsync = true,
 	visible = true,
+	headless = false,
+	software_renderer = false,
+	sim_hz = 60,
+	max_catch_up_steps = 4,
 }
 Client.Context.Schema = Schema.Object{
 	state = Client.Context.State.Schema,
@@ -157,6 +166,7 @@ Client.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
 	_vertex_array = Client.Wrappers.Schema("VertexArray"),
 	_context = Schema.Optional(Client.Context.Schema),
 	_render_target = Schema.Optional(Client.RenderTarget.Schema),
+	_interpolation = Schema.NormalizedNumber,
 })
 function Client.WorldSys:draw()
 	if debug_checks_enabled then
@@ -208,6 +218,21 @@ function Client.WorldSys:get_vertex_array()
 
 	return self._vertex_array
 end
+function Client.WorldSys:get_interpolation()
+	if debug_checks_enabled then
+		assert(Client.WorldSys.Schema(self))
+	end
+
+	return self._interpolation
+end
+function Client.WorldSys:set_interpolation(interpolation)
+	if debug_checks_enabled then
+		assert(Client.WorldSys.Schema(self))
+		assert(Schema.NormalizedNumber(interpolation))
+	end
+
+	self._interpolation = interpolation
+end
 function Client.WorldSys:get_size()
 	if debug_checks_enabled then
 		assert(Client.WorldSys.Schema(self))
@@ -301,6 +326,7 @@ function Client.WorldSys:on_init()
 	Container.set_defaults(self.state, Client.WorldSys.State.defaults)
 
 	self.clear_color = {255, 255, 255, 255}
+	self._interpolation = 1
 	self._camera_world = self.sim:require(Camera.WorldSys)
 	self._vertex_array = Client.Wrappers.VertexArray.new{}
 
@@ -329,6 +355,7 @@ Client.GameSys.Schema = Schema.AllOf(Game.Sys.Schema, Schema.PartialObject{
 	context = Schema.Optional(Client.Context.Schema),
 	_vertex_array = Client.Wrappers.Schema("VertexArray"),
 	_world_game = World.GameSys.Schema,
+	_step_accumulator = Schema.NonNegativeNumber,
 })
 function Client.GameSys:get_size()
 	if debug_checks_enabled then
@@ -355,6 +382,14 @@ function Client.GameSys:get_vertex_array()
 
 	return self._vertex_array
 end
+function Client.GameSys:get_interpolation()
+	if debug_checks_enabled then
+		assert(Client.GameSys.Schema(self))
+	end
+
+	-- fraction of a sim step elapsed since the last world step
+	return math.min(self._step_accumulator * self.state.sim_hz, 1)
+end
 function Client.GameSys:draw()
 	if debug_checks_enabled then
 		assert(Client.GameSys.Schema(self))
@@ -370,7 +405,9 @@ function Client.GameSys:draw()
 
 	local world = self._world_game.world
 	if world ~= nil then
-		world:get(Client.WorldSys):draw()
+		local client_world = world:get(Client.WorldSys)
+		client_world:set_interpolation(self:get_interpolation())
+		client_world:draw()
 	end
 
 	self.sim:broadcast("on_draw")
@@ -391,8 +428,10 @@ function Client.GameSys:on_init()
 
 	self._vertex_array = Client.Wrappers.VertexArray.new{}
 	self._world_game = self.sim:require(World.GameSys)
+	self._step_accumulator = 0
 
-	if self.state.visible then
+	-- a headless context runs the full draw path with no window or render context, for benchmarks/servers
+	if self.state.visible or self.state.headless then
 		self.context = Client.Context.new(self.state)
 		self.sim._context = self.context
 	end
@@ -401,20 +440,62 @@ function Client.GameSys:on_init()
 		assert(Client.GameSys.Schema(self))
 	end
 end
-function Client.GameSys:on_step()
+function Client.GameSys:on_step_begin()
 	if debug_checks_enabled then
 		assert(Client.GameSys.Schema(self))
 	end
 
-	if self.context == nil then
+	-- headless runs stay lock-step: one world step per game step
+	if self.context == nil or self.state.headless then
 		return
 	end
 
-	if not self.context:step() then
+	-- fixed timestep: step the world once per 1/sim_hz of real time elapsed, dropping
+	-- any time beyond max_catch_up_steps so a long stall does not spiral
+	local step_seconds = 1 / self.state.sim_hz
+	-- 0 until the first frame is measured; step once
+	local last_frame_ms = self.context.window:get_last_frame_ms()
+	local accumulator = self._step_accumulator + (last_frame_ms / 1000)
+	if last_frame_ms == 0 then
+		accumulator = step_seconds
+	end
+
+	local step_count = math.min(math.floor(accumulator / step_seconds), self.state.max_catch_up_steps)
+	accumulator = math.min(accumulator - (step_count * step_seconds), step_seconds)
+
+	self._step_accumulator = accumulator
+	self._world_game:set_step_count(step_count)
+end
+function Client.GameSys:on_step()
+	if debug_checks_enabled then
+		assert(Client.GameSys.Schema(self))
+	end
+
+	-- native allocation counters are per game step (see odAllocation_end_frame)
+	Client.Wrappers.Allocation.end_frame()
+
+	-- watchdog frames run from after the window step, which waits for the next frame, until here
+	local watchdog_running = Debugging.get_frame_watchdog_running()
+	Sim.set_system_timing_enabled(watchdog_running)
+	if watchdog_running then
+		local slowest, slowest_ns = Sim.take_slowest_system()
+		Debugging.frame_watchdog_end_frame(
+			slowest and string.format("slowest system: %s (%.3fms)", slowest, slowest_ns / 1e6))
+	end
+
+	if self.context ~= nil and not self.context:step() then
 		self.sim:stop()
 		return
 	end
 
+	if watchdog_running then
+		Debugging.frame_watchdog_begin_frame()
+	end
+
+	if self.context == nil then
+		return
+	end
+
 	self:draw()
 
 	Container.update(self.state, self.context.state)
@@ -455,7 +536,81 @@ Client.tests = Testing.add_suite("engine.client", {
 
 		world:finalize()
 		game:finalize()
-	end
+	end,
+	run_headless_context = function()
+		local game = Game.Game.new({client = {headless = true}})
+		local client_game = game:require(Client.GameSys)
+		local world_game = game:require(World.GameSys)
+
+		game:start()
+		assert(client_game.context ~= nil)
+		assert(client_game.context.window:get_settings().headless == true)
+
+		-- headless stays lock-step, regardless of frame time
+		local step_id = world_game.world.step_id
+		for _ = 1, 3 do
+			game:step()
+		end
+		assert(world_game.world.step_id == step_id + 3)
+
+		game:finalize()
+	end,
+	headless_steps_allocate_nothing = function()
+		local game = Game.Game.new({client = {headless = true}})
+		game:require(Client.GameSys)
+		game:require(World.GameSys)
+
+		-- native buffers grow during the first steps, then are reused
+		game:start()
+		for _ = 1, 3 do
+			game:step()
+		end
+		for _ = 1, 10 do
+			game:step()
+			local frame_stats = Client.Wrappers.Allocation.get_frame_stats()
+			assert(frame_stats.all.allocation_count == 0, "native allocations in a steady-state step")
+			assert(frame_stats.all.peak_live_bytes == frame_stats.all.live_bytes)
+		end
+
+		game:finalize()
+	end,
+	frame_watchdog = function()
+		-- must not clobber a watchdog started for the whole run
+		if Debugging.get_frame_watchdog_running() then
+			return
+		end
+
+		local SlowSys = World.Sys.new_metatable("frame_watchdog_slow")
+		function SlowSys:on_step()
+			local sum = 0
+			for i = 1, 100000 do
+				sum = sum + i
+			end
+			self.sum = sum
+		end
+
+		local game = Game.Game.new({client = {headless = true}})
+		game:require(Client.GameSys)
+		local world_game = game:require(World.GameSys)
+		world_game:require_world_sys(SlowSys)
+		game:start()
+
+		local filename = "engine_client_frame_watchdog"
+		assert(Debugging.start_frame_watchdog(filename, 0.001, 1))
+		for _ = 1, 3 do
+			game:step()
+		end
+		assert(Debugging.stop_frame_watchdog())
+		assert(Debugging.get_frame_watchdog_dump_count() >= 1)
+
+		local file = io.open(filename..".0", "rb")
+		local dump = file:read("*a")
+		file:close()
+		os.remove(filename..".0")
+		assert(string.find(dump, '"note":"slowest system: [^"]*frame_watchdog_slow:on_step') ~= nil)
+
+		game:finalize()
+	end,
 })
 
 return Client
@@ -269,29 +269,71 @@ Controller.GameSys.State.defaults.bindings.controllers[Controller.Controller.def
 Controller.GameSys.Schema = Schema.AllOf(Game.Sys.Schema, Schema.PartialObject{
 	state = Controller.GameSys.State.Schema,
 	_world_game = Schema.Optional(World.GameSys.Schema),
+	_input_enabled = Schema.Boolean,
+	-- keyboard keys are resolved to window key handles once, and all are polled in one call per step
+	_key_handles = Schema.Array(Schema.NonNegativeInteger),
+	_key_handles_by_name = Schema.Mapping(Controller.KeyboardKey.Schema, Schema.NonNegativeInteger),
+	_keys_held = Schema.Mapping(Schema.NonNegativeInteger, Schema.Boolean),
 })
 function Controller.GameSys:on_init()
 	Container.set_defaults(self.state, Controller.GameSys.State.defaults)
 
 	self._world_game = self.sim:require(World.GameSys)
+	self._input_enabled = true
+	self._key_handles = {}
+	self._key_handles_by_name = {}
+	self._keys_held = {}
 
 	if debug_checks_enabled then
 		assert(Controller.GameSys.Schema(self))
 	end
 end
+-- while disabled, live input is not sent to the world, e.g. during replays
+function Controller.GameSys:set_input_enabled(enabled)
+	if debug_checks_enabled then
+		assert(Controller.GameSys.Schema(self))
+		assert(Schema.Boolean(enabled))
+	end
+
+	self._input_enabled = enabled
+end
+function Controller.GameSys:_poll_keys(window)
+	local key_handles = self._key_handles
+	local key_handles_by_name = self._key_handles_by_name
+	for _, controller_bindings in ipairs(self.state.bindings.controllers) do
+		for _, input_bindings in pairs(controller_bindings.inputs) do
+			for _, binding in ipairs(input_bindings.bindings) do
+				local keyboard_key = binding.keyboard_key
+				if keyboard_key ~= nil and key_handles_by_name[keyboard_key] == nil then
+					local key_handle = window:get_key_handle(keyboard_key)
+					key_handles_by_name[keyboard_key] = key_handle
+					key_handles[#key_handles + 1] = key_handle
+				end
+			end
+		end
+	end
+
+	window:get_key_states(key_handles, self._keys_held)
+end
 function Controller.GameSys:handle_input_changes()
 	if debug_checks_enabled then
 		assert(Controller.GameSys.Schema(self))
 	end
 
 	local world = self._world_game.world
-	if world == nil then
+	if world == nil or not self._input_enabled then
 		return
 	end
 
 	local context = self.sim._context
 	local controller_world = world:get(Controller.WorldSys)
 
+	if context ~= nil then
+		self:_poll_keys(context.window)
+	end
+	local keys_held = self._keys_held
+	local key_handles_by_name = self._key_handles_by_name
+
 	local controllers = controller_world.state.controllers
 	for controller_id, controller in ipairs(controllers) do
 		for input_name, input in pairs(controller.inputs) do
@@ -300,7 +342,7 @@ function Controller.GameSys:handle_input_changes()
 			local held = false
 			for _, binding in ipairs(bindings) do
 				if binding.type == Controller.BindingType.keyboard then
-					held = context ~= nil and context.window:get_key_state(binding.keyboard_key)
+					held = context ~= nil and keys_held[key_handles_by_name[binding.keyboard_key]] == true
 				elseif binding.type == Controller.BindingType.virtual then
 					held = binding.virtual_value == true
 				end
@@ -418,7 +460,70 @@ Controller.tests = Testing.add_suite("engine.controller", {
 
 		game:stop()
 		game:finalize()
-	end
+	end,
+	run_game_keyboard = function()
+		local game = Game.Game.new({client = {headless = true}})
+		local controller_game = game:require(Controller.GameSys)
+		game:require(Client.GameSys)
+		local world_game = game:require(World.GameSys)
+		game:start()
+
+		local world = world_game.world
+		local controller_world = world:get(Controller.WorldSys)
+		local window = game._context.window
+
+		-- keyboard keys are resolved once, and all polled together
+		game:step()
+		local up_handle = controller_game._key_handles_by_name["up"]
+		assert(up_handle == window:get_key_handle("up"))
+		assert(controller_game._keys_held[up_handle] == false)
+		local key_handle_count = #controller_game._key_handles
+
+		game:step()
+		assert(#controller_game._key_handles == key_handle_count)
+		assert(controller_world:get_held(controller_world.default_id, Controller.InputName.up) == false)
+
+		-- headless windows never see key events, so key states are scripted in front of the window
+		local keys_down = {}
+		game._context.window = setmetatable({
+			get_key_states = function(_, key_handles, out_held)
+				for _, key_handle in ipairs(key_handles) do
+					out_held[key_handle] = keys_down[key_handle] == true
+				end
+			end,
+		}, {
+			__index = function(_, method_name)
+				return function(_, ...)
+					return window[method_name](window, ...)
+				end
+			end,
+		})
+
+		local function assert_up(held, pressed, released)
+			assert(controller_world:get_held(controller_world.default_id, Controller.InputName.up) == held)
+			assert(controller_world:get_pressed(controller_world.default_id, Controller.InputName.up) == pressed)
+			assert(controller_world:get_released(controller_world.default_id, Controller.InputName.up) == released)
+		end
+
+		-- pressed for exactly one step, held while down, released for exactly one step
+		keys_down[up_handle] = true
+		game:step()
+		assert_up(true, true, false)
+		game:step()
+		assert_up(true, false, false)
+		game:step()
+		assert_up(true, false, false)
+
+		keys_down[up_handle] = nil
+		game:step()
+		assert_up(false, false, true)
+		game:step()
+		assert_up(false, false, false)
+
+		game._context.window = window
+		game:stop()
+		game:finalize()
+	end,
 })
 
 return Controller
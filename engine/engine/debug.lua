@@ -12,7 +12,7 @@ function Debug.GameSys:on_init()
 	self._world_game = self.sim:require(World.GameSys)
 end
 function Debug.GameSys:on_step()
-	local quicksave_filename = "quicksave_world.save.json"
+	local quicksave_filename = "quicksave_world.save"
 	local context = self.sim._context
 	if debug_checks_enabled and context ~= nil then
 		local window = context.window
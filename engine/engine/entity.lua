@@ -16,10 +16,10 @@ local Entity = {}
 
 Entity.Entity = {}
 Entity.Entity.max_tag_id = Client.Wrappers.EntityIndex.get_max_tag_id() - 1  -- -1 for lua array indexing
-Entity.Entity.DestroyedSchema = Schema.Object{
+Entity.Entity.DestroyedSchema = Schema.compile(Schema.Object{
 	destroyed = Schema.Const(true),
-}
-Entity.Entity.ExistsSchema = Schema.AllOf(Schema.SerializableObject, Schema.PartialObject{
+})
+Entity.Entity.ExistsSchema = Schema.compile(Schema.AllOf(Schema.SerializableObject, Schema.PartialObject{
 	destroyed = Schema.Nil,
 	tags = Schema.Optional(Schema.Mapping(Schema.LabelString, Schema.Boolean)),
 	x = Schema.Optional(Schema.Integer),
@@ -35,8 +35,8 @@ Entity.Entity.ExistsSchema = Schema.AllOf(Schema.SerializableObject, Schema.Part
 	translate_y = Schema.Optional(Schema.Number),
 	scale_x = Schema.Optional(Schema.BoundedNumber(Math.epsilon, Math.integer_max)),
 	scale_y = Schema.Optional(Schema.BoundedNumber(Math.epsilon, Math.integer_max)),
-})
-Entity.Entity.Schema = Schema.OneOf(Entity.Entity.DestroyedSchema, Entity.Entity.ExistsSchema)
+}))
+Entity.Entity.Schema = Schema.compile(Schema.OneOf(Entity.Entity.DestroyedSchema, Entity.Entity.ExistsSchema))
 -- Entity.Entity.Schema = Entity.Entity.ExistsSchema
 Entity.Entity.defaults = {}
 
@@ -48,7 +48,7 @@ Entity.WorldSys.State.Schema = Schema.Object{
 Entity.WorldSys.State.defaults = {
 	entities = {},
 }
-Entity.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
+Entity.WorldSys.fields = {
 	state = Entity.WorldSys.State.Schema,
 	_tag_id_to_tag = Schema.BoundedArray(Schema.LabelString, 0, Entity.Entity.max_tag_id),
 	_tag_to_tag_id = Schema.Mapping(Schema.LabelString, Schema.BoundedInteger(0, Entity.Entity.max_tag_id)),
@@ -56,15 +56,56 @@ Entity.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
 	_entity_index = Client.Wrappers.Schema("EntityIndex"),
 	_entity_ids_free = Schema.Mapping(Schema.PositiveInteger, Schema.Const(true)),
 	_entity_to_entity_id = Schema.Mapping(Entity.Entity.Schema, Schema.PositiveInteger),
-	_tag_to_entities = Schema.Mapping(Schema.LabelString, Schema.Array(Entity.Entity.Schema)),
-	-- for efficient cleanup of _tag_to_entities
-	_entity_id_to_tag_indices = Schema.Mapping(
-		Schema.PositiveInteger, Schema.Mapping(Schema.LabelString, Schema.PositiveInteger)),
-})
+	-- membership of every tag is tracked by the entity index, in tag lists
+	_tag_list_id_to_tag = Schema.Array(Schema.LabelString),
+	_tag_to_tag_list_id = Schema.Mapping(Schema.LabelString, Schema.PositiveInteger),
+	-- ids of entities changed through this sys since the last take_changed_ids(), for incremental saves
+	_entity_ids_changed = Schema.Mapping(Schema.PositiveInteger, Schema.Const(true)),
+	-- ids of entities changed since the last on_check_state(), only tracked with expensive debug checks
+	_entity_ids_unchecked = Schema.Mapping(Schema.PositiveInteger, Schema.Const(true)),
+	-- scratch arrays refilled by the entity index, so lookups in loops don't allocate
+	_tagged_ids = Schema.Array(Schema.PositiveInteger),
+	_tag_list_ids = Schema.Array(Schema.NonNegativeInteger),
+}
+Entity.WorldSys.Schema = Schema.compile(Schema.AllOf(World.Sys.Schema, Schema.PartialObject(Entity.WorldSys.fields)))
+-- checked on every call instead of the full schema; entities are checked one at a time as they change (check_entity)
+local shallow_fields = {sys_name = Schema.LabelString}
+local shallow_field_overrides = {
+	state = Schema.Object{entities = Schema.Table},
+	_entity_ids_free = Schema.Table,
+	_entity_to_entity_id = Schema.Table,
+	_entity_ids_changed = Schema.Table,
+	_entity_ids_unchecked = Schema.Table,
+	_tagged_ids = Schema.Table,
+	_tag_list_ids = Schema.Table,
+}
+for key, condition in pairs(Entity.WorldSys.fields) do
+	shallow_fields[key] = shallow_field_overrides[key] or condition
+end
+for key, _ in pairs(shallow_field_overrides) do
+	assert(Entity.WorldSys.fields[key] ~= nil, key)
+end
+Entity.WorldSys.ShallowSchema = Schema.compile(Schema.PartialObject(shallow_fields))
+function Entity.WorldSys:check_entity(entity_id)
+	local entity = self.state.entities[entity_id]
+	local result, err = Entity.Entity.Schema(entity)
+	if not result then
+		return false, err
+	end
+
+	local is_destroyed = entity.destroyed == true
+	if self._entity_ids_free[entity_id] ~= (is_destroyed or nil) then
+		return false, Schema.error("Entity.WorldSys:check_entity(%s): free id not tracked", entity_id)
+	end
+	if self._entity_to_entity_id[entity] ~= ((not is_destroyed) and entity_id or nil) then
+		return false, Schema.error("Entity.WorldSys:check_entity(%s): entity not mapped to its id", entity_id)
+	end
+	return true
+end
 function Entity.WorldSys:index(entity_id, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Entity.Entity.Schema)(entity))
 		end
 		assert(Schema.PositiveInteger(entity_id))
@@ -75,18 +116,24 @@ function Entity.WorldSys:index(entity_id, entity)
 	local entity_to_entity_id = self._entity_to_entity_id
 	entity = entity or entities[entity_id]
 	entities[entity_id] = entity
-	entity_to_entity_id[entity] = entity_id
+	-- destroyed entities are unmapped up front, so tag() and untag() see consistent bookkeeping
+	if entity.destroyed then
+		entity_to_entity_id[entity] = nil
+	else
+		entity_to_entity_id[entity] = entity_id
+	end
 	self._entity_ids_free[entity_id] = entity.destroyed
 
-	local entity_id_to_tag_indices = self._entity_id_to_tag_indices
-	local entity_tag_indices = entity_id_to_tag_indices[entity_id] or {}
-	entity_id_to_tag_indices[entity_id] = entity_tag_indices
-
 	-- check for any removed tags
 	local entity_tags = entity.tags or {}
+	local tag_list_id_to_tag = self._tag_list_id_to_tag
+	local indexed_tags = {}
 	local removed_tags = {}
-	for tag, _ in pairs(entity_tag_indices) do
-		if entity_tags[tag] ~= true then
+	for _, tag_list_id in ipairs(self._entity_index:get_tag_lists(entity_id, self._tag_list_ids)) do
+		local tag = tag_list_id_to_tag[tag_list_id]
+		if entity_tags[tag] == true then
+			indexed_tags[tag] = true
+		else
 			removed_tags[#removed_tags + 1] = tag
 		end
 	end
@@ -105,7 +152,7 @@ function Entity.WorldSys:index(entity_id, entity)
 				bounds_indexed_tag_ids[#bounds_indexed_tag_ids + 1] = tag_id
 			end
 
-			if entity_tag_indices[tag] == nil then
+			if indexed_tags[tag] == nil then
 				added_tags[#added_tags + 1] = tag
 			end
 		end
@@ -119,15 +166,14 @@ function Entity.WorldSys:index(entity_id, entity)
 
 	self._entity_index:set_collider(entity_id, x1, y1, x2, y2, Shim.unpack(bounds_indexed_tag_ids))
 
-	if entity.destroyed then
-		entity_to_entity_id[entity] = nil
-		entity_id_to_tag_indices[entity_id] = nil
+	self._entity_ids_changed[entity_id] = true
+	if expensive_debug_checks_enabled then
+		self._entity_ids_unchecked[entity_id] = true
 	end
-
 	self.sim:broadcast("on_entity_index", entity_id, entity)
 
 	if expensive_debug_checks_enabled then
-		assert(Entity.Entity.Schema(entity))
+		assert(self:check_entity(entity_id))
 	end
 end
 function Entity.WorldSys:index_all()
@@ -140,8 +186,8 @@ function Entity.WorldSys:index_all()
 	self._entity_index = Client.Wrappers.EntityIndex.new{}
 	self._entity_ids_free = {}
 	self._entity_to_entity_id = {}
-	self._tag_to_entities = {}
-	self._entity_id_to_tag_indices = {}
+	self._entity_ids_changed = {}
+	self._entity_ids_unchecked = {}
 
 	for entity_id, entity in ipairs(self.state.entities) do
 		self:index(entity_id, entity)
@@ -154,7 +200,7 @@ end
 function Entity.WorldSys:add(entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Entity.Entity.ExistsSchema)(entity))
 		end
 		assert(self.sim.status == Sim.Status.started)
@@ -168,8 +214,7 @@ function Entity.WorldSys:add(entity)
 
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 		end
 		assert(Schema.PositiveInteger(entity_id))
 	end
@@ -179,7 +224,7 @@ end
 function Entity.WorldSys:set(entity_id, state, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Entity.Entity.ExistsSchema(state))
 		end
 		assert(Schema.PositiveInteger(entity_id))
@@ -202,7 +247,7 @@ end
 function Entity.WorldSys:destroy(entity_id, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 		end
 		assert(Schema.PositiveInteger(entity_id))
 		assert(entity == nil or self.state.entities[entity_id] == entity)
@@ -219,14 +264,14 @@ function Entity.WorldSys:destroy(entity_id, entity)
 	self:index(entity_id, entity)
 
 	if expensive_debug_checks_enabled then
-		assert(Entity.WorldSys.Schema(self))
+		assert(Entity.WorldSys.ShallowSchema(self))
 		assert(Entity.Entity.DestroyedSchema(entity))
 	end
 end
 function Entity.WorldSys:tag(entity_id, tags, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.NonEmptyArray(Schema.LabelString)(tags))
 			assert(Schema.Optional(Entity.Entity.Schema)(entity))
 		end
@@ -239,30 +284,17 @@ function Entity.WorldSys:tag(entity_id, tags, entity)
 	local entity_tags = entity.tags or {}
 	entity.tags = entity_tags
 
-	local entity_id_to_tag_indices = self._entity_id_to_tag_indices
-	local entity_tag_indices = entity_id_to_tag_indices[entity_id] or {}
-	entity_id_to_tag_indices[entity_id] = entity_tag_indices
-
-	local tag_to_entities = self._tag_to_entities
+	local entity_index = self._entity_index
 	local tag_to_tag_id = self._tag_to_tag_id
 	local added_bounds_indexed_tag_ids = {}
 	local added_tags = {}
 	for _, tag in ipairs(tags) do
-		if entity_tag_indices[tag] == nil then
+		if entity_index:add_tagged(self:_get_tag_list_id(tag), entity_id) then
 			local tag_id = tag_to_tag_id[tag]
 			if tag_id ~= nil then
 				added_bounds_indexed_tag_ids[#added_bounds_indexed_tag_ids + 1] = tag_id
 			end
 
-			local tag_entities = tag_to_entities[tag]
-			if tag_entities == nil then
-				tag_entities = {}
-				tag_to_entities[tag] = tag_entities
-			end
-
-			local tag_index = #tag_entities + 1
-			tag_entities[tag_index] = entity
-			entity_tag_indices[tag] = tag_index
 			entity_tags[tag] = true
 
 			added_tags[#added_tags + 1] = tag
@@ -278,13 +310,21 @@ function Entity.WorldSys:tag(entity_id, tags, entity)
 	end
 
 	if #added_tags > 0 then
+		self._entity_ids_changed[entity_id] = true
+		if expensive_debug_checks_enabled then
+			self._entity_ids_unchecked[entity_id] = true
+		end
 		self.sim:broadcast("on_entity_tag", entity_id, added_tags, entity)
 	end
+
+	if expensive_debug_checks_enabled then
+		assert(self:check_entity(entity_id))
+	end
 end
 function Entity.WorldSys:untag(entity_id, tags, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.NonEmptyArray(Schema.LabelString)(tags))
 			assert(Schema.Optional(Entity.Entity.Schema)(entity))
 		end
@@ -296,45 +336,25 @@ function Entity.WorldSys:untag(entity_id, tags, entity)
 	entity = entity or self:find(entity_id)
 	local entity_tags = entity.tags
 
-	local entity_to_entity_id = self._entity_to_entity_id
-	local entity_id_to_tag_indices = self._entity_id_to_tag_indices
-	local entity_tag_indices = entity_id_to_tag_indices[entity_id]
-	if entity_tag_indices == nil then
-		return
-	end
-
-	entity_id_to_tag_indices[entity_id] = entity_tag_indices
-
-	local tag_to_entities = self._tag_to_entities
+	local entity_index = self._entity_index
+	local tag_to_tag_list_id = self._tag_to_tag_list_id
 	local tag_to_tag_id = self._tag_to_tag_id
 	local removed_bounds_indexed_tag_ids = {}
 	local removed_tags = {}
 	local has_removed_bounds_indexed_tag_ids = false
 	for _, tag in ipairs(tags) do
-		local tag_index = entity_tag_indices[tag]
-		if tag_index ~= nil then
+		local tag_list_id = tag_to_tag_list_id[tag]
+		if tag_list_id ~= nil and entity_index:remove_tagged(tag_list_id, entity_id) then
 			local tag_id = tag_to_tag_id[tag]
 			if tag_id ~= nil then
 				removed_bounds_indexed_tag_ids[tag_id] = true
 				has_removed_bounds_indexed_tag_ids = true
 			end
 
-			local tag_entities = tag_to_entities[tag]
-
-			local swap_tag_index = #tag_entities
-			local swap_entity = tag_entities[swap_tag_index]
-			local swap_entity_id = entity_to_entity_id[swap_entity]
-			local swap_entity_tag_indices = entity_id_to_tag_indices[swap_entity_id]
-
 			if entity_tags ~= nil then
 				entity_tags[tag] = nil
 			end
 
-			swap_entity_tag_indices[tag] = tag_index
-			tag_entities[tag_index] = swap_entity
-			tag_entities[swap_tag_index] = nil
-			entity_tag_indices[tag] = nil
-
 			removed_tags[#removed_tags + 1] = tag
 		end
 	end
@@ -352,13 +372,21 @@ function Entity.WorldSys:untag(entity_id, tags, entity)
 	end
 
 	if #removed_tags > 0 then
+		self._entity_ids_changed[entity_id] = true
+		if expensive_debug_checks_enabled then
+			self._entity_ids_unchecked[entity_id] = true
+		end
 		self.sim:broadcast("on_entity_untag", entity_id, removed_tags, entity)
 	end
+
+	if expensive_debug_checks_enabled then
+		assert(self:check_entity(entity_id))
+	end
 end
 function Entity.WorldSys:has_tags(entity_id, tags, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Entity.Entity.Schema)(entity))
 			assert(Schema.NonEmptyArray(Schema.LabelString)(tags))
 		end
@@ -383,7 +411,7 @@ end
 function Entity.WorldSys:get_bounds(entity_id, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Entity.Entity.Schema)(entity))
 		end
 
@@ -398,7 +426,7 @@ end
 function Entity.WorldSys:set_bounds(entity_id, x, y, width, height, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Entity.Entity.Schema)(entity))
 		end
 
@@ -420,11 +448,17 @@ function Entity.WorldSys:set_bounds(entity_id, x, y, width, height, entity)
 	entity.height = height
 
 	self._entity_index:set_bounds(entity_id, x1, y1, x2, y2)
+	self._entity_ids_changed[entity_id] = true
+
+	if expensive_debug_checks_enabled then
+		self._entity_ids_unchecked[entity_id] = true
+		assert(self:check_entity(entity_id))
+	end
 end
 function Entity.WorldSys:set_pos(entity_id, x, y, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Entity.Entity.Schema)(entity))
 		end
 
@@ -446,11 +480,17 @@ function Entity.WorldSys:set_pos(entity_id, x, y, entity)
 	entity.height = height
 
 	self._entity_index:set_bounds(entity_id, x1, y1, x2, y2)
+	self._entity_ids_changed[entity_id] = true
+
+	if expensive_debug_checks_enabled then
+		self._entity_ids_unchecked[entity_id] = true
+		assert(self:check_entity(entity_id))
+	end
 end
 function Entity.WorldSys:set_size(entity_id, width, height, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Entity.Entity.Schema)(entity))
 		end
 
@@ -472,11 +512,17 @@ function Entity.WorldSys:set_size(entity_id, width, height, entity)
 	entity.height = height
 
 	self._entity_index:set_bounds(entity_id, x1, y1, x2, y2)
+	self._entity_ids_changed[entity_id] = true
+
+	if expensive_debug_checks_enabled then
+		self._entity_ids_unchecked[entity_id] = true
+		assert(self:check_entity(entity_id))
+	end
 end
 function Entity.WorldSys:find(entity_id)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 		end
 
 		assert(Schema.PositiveInteger(entity_id))
@@ -493,7 +539,7 @@ end
 function Entity.WorldSys:find_in(x, y, width, height, tags, exclude_entity_id)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Schema.NonEmptyArray(Schema.LabelString))(tags))
 		end
 
@@ -522,7 +568,7 @@ end
 function Entity.WorldSys:find_all_in(x, y, width, height, tags, exclude_entity_id)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Schema.Array(Schema.LabelString))(tags))
 		end
 
@@ -547,7 +593,7 @@ end
 function Entity.WorldSys:find_relative(entity_id, x, y, tags, entity)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.Optional(Schema.NonEmptyArray(Schema.LabelString))(tags))
 		end
 
@@ -575,7 +621,7 @@ end
 function Entity.WorldSys:tag_bounds_index_get(tags)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.NonEmptyArray(Schema.LabelString)(tags))
 		end
 
@@ -593,7 +639,7 @@ end
 function Entity.WorldSys:tag_bounds_index_add(tags)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.NonEmptyArray(Schema.LabelString)(tags))
 		end
 	end
@@ -612,68 +658,104 @@ function Entity.WorldSys:tag_bounds_index_add(tags)
 		end
 	end
 end
+function Entity.WorldSys:_get_tag_list_id(tag)
+	local tag_list_id = self._tag_to_tag_list_id[tag]
+	if tag_list_id == nil then
+		tag_list_id = #self._tag_list_id_to_tag + 1
+		self._tag_list_id_to_tag[tag_list_id] = tag
+		self._tag_to_tag_list_id[tag] = tag_list_id
+	end
+	return tag_list_id
+end
 function Entity.WorldSys:find_id(entity)
 	return self._entity_to_entity_id[entity]
 end
 function Entity.WorldSys:find_tagged(tag)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.LabelString(tag))
 		end
 
 		assert(self.sim.status == Sim.Status.started)
 	end
 
-	local tag_to_entities = self._tag_to_entities
-	local tag_entities = tag_to_entities[tag] or {}
-	tag_to_entities[tag] = tag_entities
-
-	local _, entity = next(tag_entities)
-	if entity == nil then
+	local tag_list_id = self._tag_to_tag_list_id[tag]
+	local entity_id = tag_list_id and self._entity_index:first_tagged(tag_list_id)
+	if entity_id == nil then
 		return nil
 	end
 
-	return self._entity_to_entity_id[entity], entity
+	return entity_id, self.state.entities[entity_id]
 end
-function Entity.WorldSys:get_all_tagged_array(tag)
+--[[ Returns an array of the ids tagged at the time of the call, so tagging or destroying entities while iterating
+doesn't change it.  Callers in hot loops pass opt_out_ids, an array they own, which is refilled and returned instead
+of allocating a new one; calls are only nested safely with different arrays.  An id destroyed or untagged after the
+call is still listed (and may since have been reused), so loops that can destroy or untag other entities should skip
+ids whose entity no longer has the tag. ]]
+function Entity.WorldSys:get_all_tagged_ids(tag, opt_out_ids)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.LabelString(tag))
+			assert(Schema.Optional(Schema.Table)(opt_out_ids))
 		end
 
 		assert(self.sim.status == Sim.Status.started)
 	end
 
-	local tag_to_entities = self._tag_to_entities
-	local tag_entities = tag_to_entities[tag] or {}
-	tag_to_entities[tag] = tag_entities
+	local tag_list_id = self._tag_to_tag_list_id[tag]
+	if tag_list_id == nil then
+		if opt_out_ids == nil then
+			return {}
+		end
+
+		for i = #opt_out_ids, 1, -1 do
+			opt_out_ids[i] = nil
+		end
+		return opt_out_ids
+	end
+
+	return self._entity_index:all_tagged(tag_list_id, opt_out_ids)
+end
+function Entity.WorldSys:get_all_tagged_array(tag)
+	if debug_checks_enabled then
+		if expensive_debug_checks_enabled then
+			assert(Entity.WorldSys.ShallowSchema(self))
+			assert(Schema.LabelString(tag))
+		end
+
+		assert(self.sim.status == Sim.Status.started)
+	end
 
+	local entities = self.state.entities
+	local tag_entities = {}
+	for i, entity_id in ipairs(self:get_all_tagged_ids(tag, self._tagged_ids)) do
+		tag_entities[i] = entities[entity_id]
+	end
 	return tag_entities
 end
 function Entity.WorldSys:get_all_tagged(tag)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 			assert(Schema.LabelString(tag))
 		end
 
 		assert(self.sim.status == Sim.Status.started)
 	end
 
-	local entity_to_entity_id = self._entity_to_entity_id
+	local entities = self.state.entities
 	local entity_by_id = {}
-	for _, entity in ipairs(self:get_all_tagged_array(tag)) do
-		local entity_id = entity_to_entity_id[entity]
-		entity_by_id[entity_id] = entity
+	for _, entity_id in ipairs(self:get_all_tagged_ids(tag, self._tagged_ids)) do
+		entity_by_id[entity_id] = entities[entity_id]
 	end
 	return entity_by_id
 end
 function Entity.WorldSys:get_all_raw()
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 		end
 
 		assert(self.sim.status == Sim.Status.started)
@@ -681,10 +763,24 @@ function Entity.WorldSys:get_all_raw()
 
 	return self.state.entities
 end
+-- changes made directly to entity tables, rather than through this sys, are not tracked
+function Entity.WorldSys:take_changed_ids()
+	if debug_checks_enabled then
+		if expensive_debug_checks_enabled then
+			assert(Entity.WorldSys.ShallowSchema(self))
+		end
+
+		assert(self.sim.status == Sim.Status.started)
+	end
+
+	local entity_ids_changed = self._entity_ids_changed
+	self._entity_ids_changed = {}
+	return entity_ids_changed
+end
 function Entity.WorldSys:get_max_id()
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Entity.WorldSys.Schema(self))
+			assert(Entity.WorldSys.ShallowSchema(self))
 		end
 
 		assert(self.sim.status == Sim.Status.started)
@@ -694,7 +790,7 @@ function Entity.WorldSys:get_max_id()
 end
 function Entity.WorldSys:get_entity_index()
 	if expensive_debug_checks_enabled then
-		assert(Entity.WorldSys.Schema(self))
+		assert(Entity.WorldSys.ShallowSchema(self))
 	end
 
 	return self._entity_index
@@ -708,8 +804,12 @@ function Entity.WorldSys:on_init()
 	self._entity_index = Client.Wrappers.EntityIndex.new{}
 	self._entity_ids_free = {}
 	self._entity_to_entity_id = {}
-	self._tag_to_entities = {}
-	self._entity_id_to_tag_indices = {}
+	self._tag_list_id_to_tag = {}
+	self._tag_to_tag_list_id = {}
+	self._entity_ids_changed = {}
+	self._entity_ids_unchecked = {}
+	self._tagged_ids = {}
+	self._tag_list_ids = {}
 
 	if debug_checks_enabled then
 		assert(Entity.WorldSys.Schema(self))
@@ -718,6 +818,26 @@ end
 function Entity.WorldSys:on_start()
 	self:index_all()
 end
+-- per step, checks entities changed since the last check; a full check covers every entity
+function Entity.WorldSys:on_check_state(is_full)
+	if is_full then
+		assert(Entity.WorldSys.Schema(self))
+		for entity_id, _ in ipairs(self.state.entities) do
+			assert(self:check_entity(entity_id))
+		end
+	else
+		assert(Entity.WorldSys.ShallowSchema(self))
+		for entity_id, _ in pairs(self._entity_ids_unchecked) do
+			assert(self:check_entity(entity_id))
+		end
+	end
+
+	self._entity_ids_unchecked = {}
+end
+function Entity.WorldSys:on_step_begin()
+	-- snapshot for render interpolation between the previous and current step
+	self._entity_index:save_previous()
+end
 
 Entity.GameSys = Game.Sys.new_metatable("entity")
 Entity.GameSys.WorldSys = Entity.WorldSys
@@ -846,6 +966,82 @@ Entity.tests = Testing.add_suite("engine.entity", {
 			entity_world:destroy(entity_id)
 		end)
 	end,
+	check_entity = function()
+		local world = World.World.new()
+		local entity_world = world:require(Entity.WorldSys)
+		world:start()
+
+		local a = entity_world:add{x = 1}
+		local b = entity_world:add{}
+		entity_world:destroy(b)
+		assert(entity_world:check_entity(a))
+		assert(entity_world:check_entity(b))
+		assert(Entity.WorldSys.ShallowSchema(entity_world))
+
+		-- damage to one entity is caught by its own check, without rechecking the world
+		entity_world.state.entities[a].x = "1"
+		assert(not entity_world:check_entity(a))
+		assert(entity_world:check_entity(b))
+		entity_world.state.entities[a].x = 1
+
+		entity_world._entity_ids_free[b] = nil
+		assert(not entity_world:check_entity(b))
+		entity_world._entity_ids_free[b] = true
+
+		entity_world._entity_to_entity_id[entity_world.state.entities[a]] = b
+		assert(not entity_world:check_entity(a))
+		entity_world._entity_to_entity_id[entity_world.state.entities[a]] = a
+		assert(Entity.WorldSys.Schema(entity_world))
+	end,
+	take_changed_ids = function()
+		local world = World.World.new()
+		local entity_world = world:require(Entity.WorldSys)
+		world:start()
+
+		local a = entity_world:add{}
+		local b = entity_world:add{}
+		local c = entity_world:add{}
+		Container.assert_equal(entity_world:take_changed_ids(), {[a] = true, [b] = true, [c] = true})
+		Container.assert_equal(entity_world:take_changed_ids(), {})
+
+		entity_world:set_pos(a, 8, 8)
+		entity_world:tag(b, {"hello"})
+		Container.assert_equal(entity_world:take_changed_ids(), {[a] = true, [b] = true})
+
+		entity_world:untag(b, {"hello"})
+		entity_world:destroy(c)
+		Container.assert_equal(entity_world:take_changed_ids(), {[b] = true, [c] = true})
+	end,
+	check_state = function()
+		local world = World.World.new()
+		local entity_world = world:require(Entity.WorldSys)
+		world:start()
+
+		local a = entity_world:add{x = 0}
+		local b = entity_world:add{x = 0}
+		world:check_state(false)
+		world:check_state(true)
+
+		-- changed entities are checked at the next step, others only by full checks
+		if expensive_debug_checks_enabled then
+			entity_world:set_pos(a, 8, 8)
+			entity_world:find(a).x = "invalid"
+			Testing.assert_fails(function()
+				world:check_state(false)
+			end)
+			entity_world:find(a).x = 8
+
+			entity_world:find(b).x = "invalid"
+			world:check_state(false)
+			Testing.assert_fails(function()
+				world:check_state(true)
+			end)
+			entity_world:find(b).x = 0
+		end
+
+		world:finalize()
+	end,
+
 	tag_untag = function()
 		local world = World.World.new()
 		local entity_world = world:require(Entity.WorldSys)
@@ -871,6 +1067,11 @@ Entity.tests = Testing.add_suite("engine.entity", {
 		Container.assert_equal(entity_world:get_all_tagged_array("yes"), {entity})
 		Container.assert_equal(entity_world:get_all_tagged_array("no"), {})
 		Container.assert_equal({entity_world._entity_index:get_tags(entity_id)}, {1})
+		local tag_list_ids = {entity_world._entity_index:get_tag_lists(entity_id)}
+		Container.assert_equal(tag_list_ids, {entity_world._tag_to_tag_list_id["yes"]})
+		local out_tag_list_ids = {100, 101, 102}
+		assert(entity_world._entity_index:get_tag_lists(entity_id, out_tag_list_ids) == out_tag_list_ids)
+		Container.assert_equal(out_tag_list_ids, tag_list_ids)
 
 		entity_world:untag(entity_id, {"yes", "no"}, entity)
 		Container.assert_equal(entity.tags, {})
@@ -884,6 +1085,68 @@ Entity.tests = Testing.add_suite("engine.entity", {
 		Container.assert_equal(entity_world:get_all_tagged_array("no"), {})
 		Container.assert_equal({entity_world._entity_index:get_tags(entity_id)}, {})
 	end,
+	get_all_tagged_ids = function()
+		local world = World.World.new()
+		local entity_world = world:require(Entity.WorldSys)
+		world:start()
+
+		local function get_sorted_ids(tag)
+			local ids = Container.deep_copy(entity_world:get_all_tagged_ids(tag))
+			table.sort(ids)
+			return ids
+		end
+
+		Container.assert_equal(entity_world:get_all_tagged_ids("a"), {})
+		assert(entity_world:find_tagged("a") == nil)
+
+		local a = entity_world:add{tags = {a = true}}
+		local ab = entity_world:add{tags = {a = true, b = true}}
+		local b = entity_world:add{tags = {b = true}}
+		Container.assert_equal(get_sorted_ids("a"), {a, ab})
+		Container.assert_equal(get_sorted_ids("b"), {ab, b})
+		assert(entity_world:find_tagged("b") == ab)
+
+		-- each result is a snapshot: nested calls and destroying tagged entities don't change it
+		local seen_ids = {}
+		local added_ids = {}
+		for _, entity_id in ipairs(entity_world:get_all_tagged_ids("a")) do
+			seen_ids[#seen_ids + 1] = entity_id
+			added_ids[#added_ids + 1] = entity_world:add{tags = {a = true}}
+			assert(#entity_world:get_all_tagged_ids("a") == 2 + #added_ids)
+		end
+		table.sort(seen_ids)
+		Container.assert_equal(seen_ids, {a, ab})
+		for _, entity_id in ipairs(added_ids) do
+			entity_world:destroy(entity_id)
+		end
+		local snapshot = entity_world:get_all_tagged_ids("a")
+		entity_world:destroy(a)
+		assert(entity_world:get_all_tagged_ids("a") ~= snapshot)
+		Container.assert_equal(#snapshot, 2)
+		Container.assert_equal(entity_world:get_all_tagged_ids("a"), {ab})
+		-- the snapshot still lists the destroyed id, whose entity no longer has the tag
+		assert(entity_world:get_all_raw()[a].tags == nil)
+
+		-- a caller-owned array is refilled in place, with stale entries cleared
+		local out_ids = {100, 101, 102}
+		assert(entity_world:get_all_tagged_ids("a", out_ids) == out_ids)
+		Container.assert_equal(out_ids, {ab})
+		assert(entity_world:get_all_tagged_ids("missing", out_ids) == out_ids)
+		Container.assert_equal(out_ids, {})
+
+		-- tags changed directly on the entity are picked up on index
+		local entity = entity_world:find(b)
+		entity.tags = {a = true}
+		entity_world:index(b, entity)
+		Container.assert_equal(get_sorted_ids("a"), {ab, b})
+		Container.assert_equal(get_sorted_ids("b"), {ab})
+		Container.assert_equal(entity_world:get_all_tagged("b"), {[ab] = entity_world:find(ab)})
+
+		-- reindexing rebuilds the same membership
+		entity_world:index_all()
+		Container.assert_equal(get_sorted_ids("a"), {ab, b})
+		Container.assert_equal(get_sorted_ids("b"), {ab})
+	end,
 	has_tags = function()
 		local world = World.World.new()
 		local entity_world = world:require(Entity.WorldSys)
@@ -1088,4 +1351,44 @@ Entity.tests = Testing.add_suite("engine.entity", {
 	end,
 })
 
+Entity.benchmarks = Testing.add_benchmark_suite("engine.entity", {
+	find_in = function(run)
+		local world = World.World.new()
+		local entity_world = world:require(Entity.WorldSys)
+		entity_world:tag_bounds_index_add({"solid"})
+		world:start()
+
+		-- a level-sized grid of tiles, half of them solid, queried with entity-sized collision checks
+		local grid_size = 8
+		local grid_count = 64
+		for x = 1, grid_count do
+			for y = 1, grid_count do
+				local entity_id = entity_world:add{x = x * grid_size, y = y * grid_size, width = grid_size, height = grid_size}
+				if (x + y) % 2 == 0 then
+					entity_world:tag(entity_id, {"solid"})
+				end
+			end
+		end
+
+		local solid_tags = {"solid"}
+		local query_count = 1000
+		local found_count = 0
+		while run:next() do
+			for i = 1, query_count do
+				local x = (i * 7) % (grid_count * grid_size)
+				local y = (i * 13) % (grid_count * grid_size)
+				if entity_world:find_in(x, y, grid_size, grid_size, nil, nil) ~= nil then
+					found_count = found_count + 1
+				end
+				if entity_world:find_in(x, y, grid_size, grid_size, solid_tags, nil) ~= nil then
+					found_count = found_count + 1
+				end
+			end
+		end
+		assert(found_count > 0)
+
+		world:finalize()
+	end,
+})
+
 return Entity
@@ -0,0 +1,386 @@
+local Debugging = require("engine/core/debugging")
+local Testing = require("engine/core/testing")
+local Logging = require("engine/core/logging")
+local Schema = require("engine/core/schema")
+local Container = require("engine/core/container")
+local Model = require("engine/core/model")
+local Serialization = require("engine/core/serialization")
+local World = require("engine/engine/world")
+local Game = require("engine/engine/game")
+local Controller = require("engine/engine/controller")
+
+local debug_checks_enabled = Debugging.debug_checks_enabled
+local expensive_debug_checks_enabled = Debugging.expensive_debug_checks_enabled
+
+--[[ Input history of the current world, for replays.
+
+The inputs sent to the world between steps are recorded as one frame per world step, keyed by the
+world's step_id when they were sent.  Frames are strings of "controller_id,input_name,held;" entries,
+so repeated frames (almost always empty) are run-length encoded by comparing them.
+
+Encoded snapshots of world state are kept every snapshot_period steps.  Seeking rebuilds the world
+from the nearest earlier snapshot, and re-simulates with the recorded inputs up to the target step.
+The world then plays back the remaining inputs, until the end of the history is reached or resume()
+is called, after which live input is recorded again from that step. ]]
+local History = {}
+
+History.Mode = Model.Enum("disabled", "recording", "seeking", "playing")
+
+History.WorldSys = World.Sys.new_metatable("history")
+History.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
+	_history_game = Schema.Optional(Schema.Table),
+})
+function History.WorldSys:on_init()
+	local game = self.sim._game
+	self._history_game = game and game:get(History.GameSys)
+end
+function History.WorldSys:on_input_set(controller_id, input_name, held)
+	local history_game = self._history_game
+	if history_game ~= nil and history_game._mode == History.Mode.recording then
+		history_game:_record_input(controller_id, input_name, held)
+	end
+end
+function History.WorldSys:on_step_begin()
+	local history_game = self._history_game
+	if history_game == nil then
+		return
+	end
+
+	-- the sim increments step_id before other systems see on_step_begin
+	local frame_step_id = self.sim.step_id - 1
+	local mode = history_game._mode
+	if mode == History.Mode.recording then
+		history_game:_record_frame(frame_step_id)
+	elseif mode == History.Mode.seeking or mode == History.Mode.playing then
+		history_game:_play_frame(self.sim, frame_step_id)
+	end
+end
+
+History.GameSys = Game.Sys.new_metatable("history")
+History.GameSys.WorldSys = History.WorldSys
+History.GameSys.State = {}
+History.GameSys.State.Schema = Schema.Object{
+	enabled = Schema.Boolean,
+	snapshot_period = Schema.PositiveInteger,  -- world steps between snapshots
+}
+History.GameSys.State.defaults = {
+	enabled = false,
+	snapshot_period = 600,
+}
+History.GameSys.Schema = Schema.AllOf(Game.Sys.Schema, Schema.PartialObject{
+	state = History.GameSys.State.Schema,
+	_world_game = World.GameSys.Schema,
+	_controller_game = Controller.GameSys.Schema,
+	_mode = History.Mode.Schema,
+
+	-- runs of identical frames, starting at step ids _run_step_ids[i] and repeating _run_counts[i] times
+	_run_frames = Schema.Array(Schema.String),
+	_run_step_ids = Schema.Array(Schema.PositiveInteger),
+	_run_counts = Schema.Array(Schema.PositiveInteger),
+	_frame_entries = Schema.Array(Schema.String),
+	_play_run_index = Schema.NonNegativeInteger,
+
+	_snapshot_step_ids = Schema.Array(Schema.PositiveInteger),
+	_snapshots = Schema.Array(Schema.String),
+})
+function History.GameSys:_clear()
+	self._run_frames = {}
+	self._run_step_ids = {}
+	self._run_counts = {}
+	self._frame_entries = {}
+	self._play_run_index = 0
+
+	self._snapshot_step_ids = {}
+	self._snapshots = {}
+end
+function History.GameSys:_snapshot(world)
+	local snapshot_step_ids = self._snapshot_step_ids
+	snapshot_step_ids[#snapshot_step_ids + 1] = world.step_id
+	self._snapshots[#self._snapshots + 1] = Serialization.encode(world.state)
+end
+function History.GameSys:_record_input(controller_id, input_name, held)
+	local frame_entries = self._frame_entries
+	frame_entries[#frame_entries + 1] = controller_id..","..input_name..","..(held and "1" or "0")..";"
+end
+function History.GameSys:_record_frame(step_id)
+	local frame = table.concat(self._frame_entries)
+	self._frame_entries = {}
+
+	local run_frames = self._run_frames
+	local run_step_ids = self._run_step_ids
+	local run_counts = self._run_counts
+	local run_count = #run_frames
+	if (run_count > 0) and (run_frames[run_count] == frame)
+		and (run_step_ids[run_count] + run_counts[run_count] == step_id) then
+		run_counts[run_count] = run_counts[run_count] + 1
+		return
+	end
+
+	run_frames[run_count + 1] = frame
+	run_step_ids[run_count + 1] = step_id
+	run_counts[run_count + 1] = 1
+end
+-- index of the last element of ids less than or equal to id, or 0
+function History._find_le(ids, id)
+	local low, high = 1, #ids
+	local result = 0
+	while low <= high do
+		local mid = math.floor((low + high) / 2)
+		if ids[mid] <= id then
+			result = mid
+			low = mid + 1
+		else
+			high = mid - 1
+		end
+	end
+	return result
+end
+function History.GameSys:_play_frame(world, step_id)
+	local run_step_ids = self._run_step_ids
+	local run_index = self._play_run_index
+	if (run_index == 0) or (step_id < run_step_ids[run_index])
+		or (step_id >= run_step_ids[run_index] + self._run_counts[run_index]) then
+		run_index = History._find_le(run_step_ids, step_id)
+		if (run_index == 0) or (step_id >= run_step_ids[run_index] + self._run_counts[run_index]) then
+			-- end of history, so this step's live input was never read; record it as empty and continue live
+			self:resume()
+			self:_record_frame(step_id)
+			return
+		end
+		self._play_run_index = run_index
+	end
+
+	for controller_id, input_name, held in self._run_frames[run_index]:gmatch("(%d+),([^,;]+),([01]);") do
+		world:broadcast("on_input_set", tonumber(controller_id), input_name, held == "1")
+	end
+end
+function History.GameSys:get_step_id_range()
+	if expensive_debug_checks_enabled then
+		assert(History.GameSys.Schema(self))
+	end
+
+	local snapshot_step_ids = self._snapshot_step_ids
+	if #snapshot_step_ids == 0 then
+		return nil
+	end
+
+	local run_count = #self._run_step_ids
+	local last_step_id = snapshot_step_ids[1]
+	if run_count > 0 then
+		last_step_id = math.max(last_step_id, self._run_step_ids[run_count] + self._run_counts[run_count])
+	end
+	if self._mode == History.Mode.recording then
+		last_step_id = math.max(last_step_id, self._world_game.world.step_id)
+	end
+
+	return snapshot_step_ids[1], last_step_id
+end
+function History.GameSys:get_stats()
+	if expensive_debug_checks_enabled then
+		assert(History.GameSys.Schema(self))
+	end
+
+	local snapshot_size = 0
+	for _, snapshot in ipairs(self._snapshots) do
+		snapshot_size = snapshot_size + #snapshot
+	end
+
+	local first_step_id, last_step_id = self:get_step_id_range()
+	return {
+		step_count = first_step_id and (last_step_id - first_step_id) or 0,
+		run_count = #self._run_frames,
+		snapshot_count = #self._snapshots,
+		snapshot_size = snapshot_size,
+	}
+end
+function History.GameSys:seek(step_id)
+	if debug_checks_enabled then
+		if expensive_debug_checks_enabled then
+			assert(History.GameSys.Schema(self))
+		end
+		assert(Schema.PositiveInteger(step_id))
+		assert(self._mode ~= History.Mode.disabled and self._mode ~= History.Mode.seeking)
+	end
+
+	local first_step_id, last_step_id = self:get_step_id_range()
+	if (first_step_id == nil) or (step_id < first_step_id) or (step_id > last_step_id) then
+		Logging.error("cannot seek outside of history, step_id=%d", step_id)
+		return false
+	end
+
+	local snapshot_index = History._find_le(self._snapshot_step_ids, step_id)
+
+	self._mode = History.Mode.seeking
+	self._controller_game:set_input_enabled(false)
+	self._frame_entries = {}
+	self._play_run_index = 0
+
+	local world_game = self._world_game
+	local world = world_game:new_world(Serialization.decode(self._snapshots[snapshot_index]))
+	world.step_id = self._snapshot_step_ids[snapshot_index]
+	world_game:set(world)
+
+	while world.step_id < step_id do
+		world:step()
+	end
+
+	-- reaching the end of the history while seeking resumes recording
+	if self._mode == History.Mode.seeking then
+		self._mode = History.Mode.playing
+	end
+
+	return true
+end
+function History.GameSys:resume()
+	if debug_checks_enabled then
+		if expensive_debug_checks_enabled then
+			assert(History.GameSys.Schema(self))
+		end
+		assert(self._mode ~= History.Mode.disabled)
+	end
+
+	-- the history after the current step is discarded
+	local step_id = self._world_game.world.step_id
+	local run_step_ids = self._run_step_ids
+	local run_index = History._find_le(run_step_ids, step_id - 1)
+	for i = #run_step_ids, run_index + 1, -1 do
+		self._run_frames[i] = nil
+		run_step_ids[i] = nil
+		self._run_counts[i] = nil
+	end
+	if run_index > 0 then
+		self._run_counts[run_index] = math.min(self._run_counts[run_index], step_id - run_step_ids[run_index])
+	end
+
+	local snapshot_step_ids = self._snapshot_step_ids
+	for i = #snapshot_step_ids, History._find_le(snapshot_step_ids, step_id) + 1, -1 do
+		snapshot_step_ids[i] = nil
+		self._snapshots[i] = nil
+	end
+
+	self._frame_entries = {}
+	self._play_run_index = 0
+	self._mode = History.Mode.recording
+	self._controller_game:set_input_enabled(true)
+end
+function History.GameSys:on_init()
+	Container.set_defaults(self.state, History.GameSys.State.defaults)
+
+	self._world_game = self.sim:require(World.GameSys)
+	self._controller_game = self.sim:require(Controller.GameSys)
+	self._mode = History.Mode.disabled
+	self:_clear()
+
+	if expensive_debug_checks_enabled then
+		assert(History.GameSys.Schema(self))
+	end
+end
+function History.GameSys:on_world_set()
+	if self._mode == History.Mode.seeking then
+		return
+	end
+
+	-- a new world starts a new history, from its initial state
+	self:_clear()
+	self._mode = self.state.enabled and History.Mode.recording or History.Mode.disabled
+	self._controller_game:set_input_enabled(true)
+	if self._mode == History.Mode.recording then
+		self:_snapshot(self._world_game.world)
+	end
+end
+function History.GameSys:on_step_end()
+	if self._mode ~= History.Mode.recording then
+		return
+	end
+
+	local world = self._world_game.world
+	local snapshot_step_ids = self._snapshot_step_ids
+	if world.step_id >= snapshot_step_ids[#snapshot_step_ids] + self.state.snapshot_period then
+		self:_snapshot(world)
+	end
+end
+
+History.tests = Testing.add_suite("engine.history", {
+	seek_replay = function()
+		local TestSys = World.Sys.new_metatable("test_history")
+		function TestSys:on_init()
+			self._controller_world = self.sim:require(Controller.WorldSys)
+			Container.set_defaults(self.state, {count = 0})
+		end
+		function TestSys:on_step()
+			local controller_world = self._controller_world
+			local dir_x, dir_y = controller_world:get_dirs(controller_world.default_id)
+			self.state.count = (self.state.count * 3 + dir_x + (2 * dir_y)) % 1000003
+		end
+
+		local game = Game.Game.new({history = {enabled = true, snapshot_period = 4}})
+		local controller_game = game:require(Controller.GameSys)
+		local world_game = game:require(World.GameSys)
+		world_game:require_world_sys(TestSys)
+		local history_game = game:require(History.GameSys)
+		game:start()
+
+		local bindings = controller_game.state.bindings.controllers[Controller.Controller.default_id].inputs
+		local up_binding = {type = "virtual", virtual_value = false}
+		local left_binding = {type = "virtual", virtual_value = false}
+		bindings[Controller.InputName.up].bindings = {up_binding}
+		bindings[Controller.InputName.left].bindings = {left_binding}
+
+		local counts = {}
+		for i = 1, 40 do
+			up_binding.virtual_value = (i % 7) < 3
+			left_binding.virtual_value = (i >= 20) and (i < 23)
+			game:step()
+			counts[world_game.world.step_id] = world_game.world.state.test_history.count
+		end
+
+		local stats = history_game:get_stats()
+		assert(stats.step_count == 40)
+		assert(stats.run_count < 40)
+		assert(stats.snapshot_count == 11)
+
+		for _, step_id in ipairs({41, 10, 2, 23, 24, 38, 20}) do
+			assert(history_game:seek(step_id))
+			assert(world_game.world.step_id == step_id)
+			assert(world_game.world.state.test_history.count == counts[step_id])
+		end
+		assert(history_game._mode == History.Mode.playing)
+
+		-- playback ignores live input, then recording resumes at the end of the history
+		up_binding.virtual_value = true
+		for _ = 1, 21 do
+			game:step()
+			assert(world_game.world.state.test_history.count == counts[world_game.world.step_id])
+		end
+		assert(history_game._mode == History.Mode.playing)
+		game:step()
+		assert(history_game._mode == History.Mode.recording)
+		local count = world_game.world.state.test_history.count
+		assert(count == (counts[41] * 3) % 1000003)
+		game:step()
+		assert(world_game.world.state.test_history.count == ((count * 3) - 2) % 1000003)
+
+		-- resuming discards the history after the current step
+		assert(history_game:seek(30))
+		history_game:resume()
+		local _, last_step_id = history_game:get_step_id_range()
+		assert(last_step_id == 30)
+		game:step()
+		assert(history_game._mode == History.Mode.recording)
+		assert(history_game:seek(31))
+
+		game:finalize()
+	end,
+	disabled = function()
+		local game = Game.Game.new()
+		game:require(Controller.GameSys)
+		local history_game = game:require(History.GameSys)
+		game:start()
+		game:step()
+		assert(history_game._mode == History.Mode.disabled)
+		assert(history_game:get_step_id_range() == nil)
+		game:finalize()
+	end,
+})
+
+return History
@@ -141,7 +141,7 @@ Image.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
 	state = Image.WorldSys.State.Schema,
 	_allocator = Schema.Optional(Image.Allocator.Schema),
 	_client_world = Client.WorldSys.Schema,
-	_entity_world = Entity.WorldSys.Schema,
+	_entity_world = Entity.WorldSys.ShallowSchema,
 	_image_bounds = Schema.Mapping(Schema.LabelString, Schema.BoundedArray(Schema.Integer, 4, 4)),
 	_entity_reindex_required = Schema.Boolean,
 })
@@ -443,7 +443,10 @@ function Image.WorldSys:on_draw()
 
 	local vertex_array = self._client_world:get_vertex_array()
 	local entity_index = self._entity_world:get_entity_index()
-	entity_index:add_to_vertex_array{vertex_array = vertex_array}
+	entity_index:add_to_vertex_array{
+		vertex_array = vertex_array,
+		interpolation = self._client_world:get_interpolation(),
+	}
 end
 function Image.WorldSys:on_entity_index(entity_id, entity)
 	if debug_checks_enabled then
@@ -559,4 +562,47 @@ Image.tests = Testing.add_suite("engine.entity", {
 	end,
 })
 
+Image.benchmarks = Testing.add_benchmark_suite("engine.image", {
+	on_draw = function(run)
+		local game = Game.Game.new({client = {visible = false}})
+		local image_game = game:require(Image.GameSys)
+		local world_game = game:require(World.GameSys)
+
+		local filename = "./examples/engine_test/data/sprites.png"
+		local grid_size = 8
+		image_game:load(filename)
+		game:start()
+
+		local world = world_game.world
+		local image_world = world:get(Image.WorldSys)
+		local entity_world = world:get(Entity.WorldSys)
+		local client_world = world:get(Client.WorldSys)
+		image_world:set_batch({wall = {16, 24}}, filename, "png", grid_size)
+		image_world:index_all()
+
+		local grid_count = 32
+		for x = 1, grid_count do
+			for y = 1, grid_count do
+				local entity_id = entity_world:add{
+					x = x * grid_size,
+					y = y * grid_size,
+					width = grid_size,
+					height = grid_size,
+					image_name = "wall",
+				}
+				image_world:entity_index(entity_id)
+			end
+		end
+
+		local vertex_array = client_world:get_vertex_array()
+		while run:next() do
+			vertex_array:init{}
+			image_world:on_draw()
+		end
+
+		game:stop()
+		game:finalize()
+	end,
+})
+
 return Image
@@ -1,4 +1,3 @@
-local json = require("engine/lib/json/json")
 local Debugging = require("engine/core/debugging")
 local Logging = require("engine/core/logging")
 local Testing = require("engine/core/testing")
@@ -6,6 +5,7 @@ local Shim = require("engine/core/shim")
 local Schema = require("engine/core/schema")
 local Container = require("engine/core/container")
 local Model = require("engine/core/model")
+local Serialization = require("engine/core/serialization")
 
 local debug_checks_enabled = Debugging.debug_checks_enabled
 local expensive_debug_checks_enabled = Debugging.expensive_debug_checks_enabled
@@ -14,9 +14,65 @@ local Sim = {}
 
 Sim.Status = Model.Enum("new", "started", "finalized")
 
+--[[ Times every system call made by broadcast() and broadcast_pcall(), in all sims, while enabled (see Sim.set_system_timing_enabled).
+Calls are ranked by self time, excluding calls nested inside them, so the slowest is not just the outermost.
+The systems and events on the call stack are kept separately, and only named when a new slowest is found. ]]
+local system_timing = nil
+local function system_timing_call(timing, sys, event_name, ...)
+	local depth = timing.depth + 1
+	timing.depth = depth
+	timing.stack_sys[depth] = sys
+	timing.stack_event_name[depth] = event_name
+	timing.stack_child_ns[depth] = 0
+
+	local start_ns = Debugging.get_time_ns()
+	sys[event_name](sys, ...)
+	local elapsed_ns = Debugging.get_time_ns() - start_ns
+
+	timing.depth = depth - 1
+	if depth > 1 then
+		timing.stack_child_ns[depth - 1] = timing.stack_child_ns[depth - 1] + elapsed_ns
+	end
+
+	local self_ns = elapsed_ns - timing.stack_child_ns[depth]
+	if self_ns > timing.slowest_ns then
+		local names = {}
+		for i = 1, depth do
+			names[i] = (timing.stack_sys[i].sys_name or "sim")..":"..timing.stack_event_name[i]
+		end
+		timing.slowest_ns = self_ns
+		timing.slowest = table.concat(names, " > ")
+	end
+end
+function Sim.set_system_timing_enabled(enabled)
+	if not enabled then
+		system_timing = nil
+	elseif system_timing == nil then
+		system_timing = {
+			depth = 0,
+			stack_sys = {},
+			stack_event_name = {},
+			stack_child_ns = {},
+			slowest_ns = 0,
+			slowest = nil,
+		}
+	end
+end
+-- returns the slowest system call by self time since the last take (e.g. "world:on_step > entity:on_step"), and its ns
+function Sim.take_slowest_system()
+	if system_timing == nil or system_timing.slowest == nil then
+		return nil, 0
+	end
+
+	local slowest, slowest_ns = system_timing.slowest, system_timing.slowest_ns
+	system_timing.slowest = nil
+	system_timing.slowest_ns = 0
+	return slowest, slowest_ns
+end
+
 Sim.Sys = {}
 Sim.Sys.__index = Sim.Sys
-Sim.Sys.Schema = Schema.PartialObject{
+Sim.Sys.Schema = Schema.compile(Schema.PartialObject{
 	sys_name = Schema.String,
 	sim = Schema.PartialObject{_is_sim_instance = Schema.Optional(Schema.Const(true))},
 	state = Schema.SerializableObject,
@@ -27,7 +83,7 @@ Sim.Sys.Schema = Schema.PartialObject{
 	on_stop = Schema.Optional(Schema.Function),
 	_is_sys = Schema.Const(true),
 	_is_sys_instance = Schema.Const(true),
-}
+})
 Sim.Sys.MetatableSchema = Schema.PartialObject{
 	_is_sys = Schema.Const(true),
 	_is_sys_instance = Schema.Optional(Schema.Const(false)),
@@ -59,7 +115,7 @@ function Sim.Sys.new_metatable(sys_name, metatable)
 end
 
 Sim.Sim = {}
-Sim.Sim.Schema = Schema.PartialObject{
+Sim.Sim.Schema = Schema.compile(Schema.PartialObject{
 	state = Schema.SerializableObject,
 	status = Sim.Status.Schema,
 	step_id = Schema.PositiveInteger,
@@ -70,13 +126,30 @@ Sim.Sim.Schema = Schema.PartialObject{
 	_systems = Schema.Mapping(Schema.String, Sim.Sys.Schema),
 	_event_listeners_ordered = Schema.Array(Schema.AnyObject),
 	_event_listeners_cached = Schema.Mapping(Schema.String, Schema.Array(Schema.AnyObject)),
-}
+	_event_profile_zones = Schema.Mapping(Schema.String, Schema.Array(Schema.NonNegativeInteger)),
+	_event_stats = Schema.Optional(Schema.Mapping(Schema.String, Schema.Object{
+		count = Schema.NonNegativeInteger,
+		total_seconds = Schema.NonNegativeNumber,
+		max_seconds = Schema.NonNegativeNumber,
+	})),
+})
+-- for per-event checks; leaves out state, which would walk the whole world and is checked on each step instead
+Sim.Sim.ShallowSchema = Schema.compile(Schema.PartialObject{
+	status = Sim.Status.Schema,
+	step_id = Schema.PositiveInteger,
+	stopping = Schema.Boolean,
+	_is_sim = Schema.Const(true),
+	_is_sim_instance = Schema.Const(true),
+	_systems = Schema.Mapping(Schema.String, Schema.Table),
+})
 Sim.Sim.MetatableSchema = Schema.PartialObject{
 	_is_sim = Schema.Const(true),
 	_is_sim_instance = Schema.Optional(Schema.Const(false)),
 }
 Sim.Sim.__index = Sim.Sim
 Sim.Sim._is_sim = true
+-- steps between full state checks (Sim.Sim.Schema walks all state); other steps check incrementally
+Sim.Sim.full_check_step_period = 300
 Sim.Sim.Sys = Sim.Sys
 function Sim.Sim.new(state, metatable)
 	if expensive_debug_checks_enabled then
@@ -97,6 +170,7 @@ function Sim.Sim.new(state, metatable)
 		_systems = {},
 		_event_listeners_ordered = {},
 		_event_listeners_cached = {},
+		_event_profile_zones = {},
 	}
 	setmetatable(sim, metatable)
 	sim._event_listeners_ordered[1] = sim
@@ -150,6 +224,7 @@ function Sim.Sim:require(sys_metatable)
 
 	-- clear event cache
 	self._event_listeners_cached = {}
+	self._event_profile_zones = {}
 
 	if expensive_debug_checks_enabled then
 		assert(Sim.Sim.Schema(self))
@@ -164,7 +239,7 @@ function Sim.Sim:get(sys_metatable)
 	local sys_name = sys_metatable.sys_name
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Sim.Sim.Schema(self))
+			assert(Sim.Sim.ShallowSchema(self))
 			assert(self.Sys.MetatableSchema(sys_metatable))
 		end
 
@@ -177,13 +252,11 @@ function Sim.Sim:get_all()
 	return self._event_listeners_ordered
 end
 function Sim.Sim:broadcast(event_name, ...)
-	local message = {event_name, ...}
-
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Sim.Sim.Schema(self))
+			assert(Sim.Sim.ShallowSchema(self))
 			assert(Schema.LabelString(event_name))
-			assert(Schema.SerializableArray(message))
+			assert(Schema.SerializableArray({event_name, ...}))
 		end
 		assert(self.status == Sim.Status.started)
 	end
@@ -193,21 +266,47 @@ function Sim.Sim:broadcast(event_name, ...)
 		event_systems = self:_cache_systems_for_event(event_name)
 	end
 
-	for _, sys in ipairs(event_systems) do
-		sys[event_name](sys, ...)
+	local event_stats = self._event_stats
+	local start_time
+	if event_stats ~= nil then
+		start_time = os.clock()
+	end
+
+	local profile_zones
+	if Debugging.get_profile_tracing() then
+		profile_zones = self:_get_event_profile_zones(event_name, event_systems)
+	end
+
+	local timing = system_timing
+	for i = 1, #event_systems do
+		local sys = event_systems[i]
+		if profile_zones ~= nil then
+			Debugging.profile_begin(profile_zones[i])
+		end
+		if timing ~= nil then
+			system_timing_call(timing, sys, event_name, ...)
+		else
+			sys[event_name](sys, ...)
+		end
+		if profile_zones ~= nil then
+			Debugging.profile_end(profile_zones[i])
+			Debugging.trace_lua_heap()
+		end
+	end
+
+	if event_stats ~= nil then
+		self:_add_event_stats(event_name, os.clock() - start_time)
 	end
 
 	if expensive_debug_checks_enabled then
-		assert(Sim.Sim.Schema(self))
+		assert(Sim.Sim.ShallowSchema(self))
 	end
 end
 function Sim.Sim:broadcast_pcall(event_name, ...)
-	local message = {event_name, ...}
-
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Sim.Sim.Schema(self))
-			assert(Schema.SerializableArray(message))
+			assert(Sim.Sim.ShallowSchema(self))
+			assert(Schema.SerializableArray({event_name, ...}))
 		end
 		assert(Schema.LabelString(event_name))
 		assert(self.status == Sim.Status.started)
@@ -218,20 +317,90 @@ function Sim.Sim:broadcast_pcall(event_name, ...)
 		event_systems = self:_cache_systems_for_event(event_name)
 	end
 
+	local event_stats = self._event_stats
+	local start_time
+	if event_stats ~= nil then
+		start_time = os.clock()
+	end
+
+	local profile_zones
+	if Debugging.get_profile_tracing() then
+		profile_zones = self:_get_event_profile_zones(event_name, event_systems)
+	end
+
+	local timing = system_timing
 	local send_ok = true
-	for _, sys in ipairs(event_systems) do
-		local result, err = Debugging.pcall(sys[event_name], sys, ...)
+	for i = 1, #event_systems do
+		local sys = event_systems[i]
+		if profile_zones ~= nil then
+			Debugging.profile_begin(profile_zones[i])
+		end
+		local result, err
+		if timing ~= nil then
+			-- calls which raise errors leave their entries on the timing stack
+			local depth = timing.depth
+			result, err = Debugging.pcall(system_timing_call, timing, sys, event_name, ...)
+			timing.depth = depth
+		else
+			result, err = Debugging.pcall(sys[event_name], sys, ...)
+		end
+		if profile_zones ~= nil then
+			Debugging.profile_end(profile_zones[i])
+			Debugging.trace_lua_heap()
+		end
 		if result == false then
 			Logging.error("broadcast(%s) failed for sys_name=%s, err=%s", event_name, sys.sys_name, err)
 			send_ok = false
 		end
 	end
 
+	if event_stats ~= nil then
+		self:_add_event_stats(event_name, os.clock() - start_time)
+	end
+
 	if expensive_debug_checks_enabled then
-		assert(Sim.Sim.Schema(self))
+		assert(Sim.Sim.ShallowSchema(self))
 	end
 	return send_ok
 end
+function Sim.Sim:set_event_stats_enabled(enabled)
+	if debug_checks_enabled then
+		if expensive_debug_checks_enabled then
+			assert(Sim.Sim.Schema(self))
+		end
+		assert(Schema.Boolean(enabled))
+	end
+
+	if not enabled then
+		self._event_stats = nil
+	elseif self._event_stats == nil then
+		self._event_stats = {}
+	end
+end
+function Sim.Sim:get_event_stats()
+	if expensive_debug_checks_enabled then
+		assert(Sim.Sim.Schema(self))
+	end
+
+	return self._event_stats
+end
+function Sim.Sim:_add_event_stats(event_name, elapsed_seconds)
+	local stats = self._event_stats[event_name]
+	if stats == nil then
+		stats = {
+			count = 0,
+			total_seconds = 0,
+			max_seconds = 0,
+		}
+		self._event_stats[event_name] = stats
+	end
+
+	stats.count = stats.count + 1
+	stats.total_seconds = stats.total_seconds + elapsed_seconds
+	if elapsed_seconds > stats.max_seconds then
+		stats.max_seconds = elapsed_seconds
+	end
+end
 function Sim.Sim:start()
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
@@ -258,7 +427,7 @@ end
 function Sim.Sim:step()
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
-			assert(Sim.Sim.Schema(self))
+			assert(Sim.Sim.ShallowSchema(self))
 		end
 		assert(self.status == Sim.Status.started)
 		assert(not self.stopping)
@@ -269,7 +438,20 @@ function Sim.Sim:step()
 	self:broadcast_pcall("on_step_end")
 
 	if expensive_debug_checks_enabled then
+		self:check_state(self.step_id % self.full_check_step_period == 0)
+	end
+end
+--[[ Validates the sim, then lets systems validate what they changed (on_check_state).
+A full check walks all state instead, so is only done periodically and on save. ]]
+function Sim.Sim:check_state(is_full)
+	if is_full then
 		assert(Sim.Sim.Schema(self))
+	else
+		assert(Sim.Sim.ShallowSchema(self))
+	end
+
+	if self.status == Sim.Status.started then
+		self:broadcast("on_check_state", is_full)
 	end
 end
 function Sim.Sim:stop()
@@ -296,33 +478,34 @@ function Sim.Sim:finalize()
 	self.status = Sim.Status.finalized
 end
 function Sim.Sim:save(filename)
-	local dump_json = json.encode(self.state, {indent = true})
+	if expensive_debug_checks_enabled then
+		self:check_state(true)
+	end
 
-	local file, err = io.open(filename, "w")
-	if file == nil then
-		Logging.warning("failed to open save file for writing, filename=%s, err=%s", filename, err)
+	local ok, err = Serialization.save_file(filename, self.state)
+	if not ok then
+		Logging.warning("failed to write save file, filename=%s, err=%s", filename, err)
 		return false
 	end
-	file:write(dump_json)
-	file:close()
 	return true
 end
 function Sim.Sim:load(filename)
-	local file, err = io.open(filename, "r")
-	if file == nil then
-		Logging.info("failed to open save file for reading, filename=%s, err=%s", filename, err)
+	local loaded_state, err = Serialization.load_file(filename)
+	if loaded_state == nil then
+		Logging.info("failed to read save file, filename=%s, err=%s", filename, err)
 		return false
 	end
-	local state_json = file:read("*a")
-	file:close()
 
-	local loaded_state = json.decode(state_json)
 	Container.update(self.state, loaded_state)
+
+	if expensive_debug_checks_enabled then
+		assert(Sim.Sim.Schema(self))
+	end
 	return true
 end
 function Sim.Sim:running()
 	if expensive_debug_checks_enabled then
-		assert(Sim.Sim.Schema(self))
+		assert(Sim.Sim.ShallowSchema(self))
 	end
 
 	return self.status == Sim.Status.started and not self.stopping
@@ -347,9 +530,23 @@ end
 function Sim.Sim:on_step_begin()
 	self.step_id = self.step_id + 1
 end
+-- trace zones for each system handling an event, in the same order as the cached systems
+function Sim.Sim:_get_event_profile_zones(event_name, event_systems)
+	local profile_zones = self._event_profile_zones[event_name]
+	if profile_zones ~= nil then
+		return profile_zones
+	end
+
+	profile_zones = {}
+	for i, sys in ipairs(event_systems) do
+		profile_zones[i] = Debugging.get_profile_trace_zone((sys.sys_name or "sim").."."..event_name)
+	end
+	self._event_profile_zones[event_name] = profile_zones
+	return profile_zones
+end
 function Sim.Sim:_cache_systems_for_event(event_name)
 	if expensive_debug_checks_enabled then
-		assert(Sim.Sim.Schema(self))
+		assert(Sim.Sim.ShallowSchema(self))
 		assert(Schema.LabelString(event_name))
 	end
 
@@ -365,7 +562,7 @@ function Sim.Sim:_cache_systems_for_event(event_name)
 	self._event_listeners_cached[event_name] = event_systems
 
 	if expensive_debug_checks_enabled then
-		assert(Sim.Sim.Schema(self))
+		assert(Sim.Sim.ShallowSchema(self))
 	end
 
 	return event_systems
@@ -440,6 +637,101 @@ Sim.tests = Testing.add_suite("engine.sim", {
 			assert(sim:broadcast_pcall("on_test_event") == false)
 		end)
 	end,
+	event_stats = function()
+		local TestSys = Sim.Sys.new_metatable("test")
+		TestSys.on_test_event = function() end
+
+		local sim = Sim.Sim.new()
+		sim:require(TestSys)
+		sim:start()
+
+		assert(sim:get_event_stats() == nil)
+		sim:set_event_stats_enabled(true)
+		sim:broadcast("on_test_event")
+		sim:broadcast_pcall("on_test_event")
+
+		local stats = sim:get_event_stats().on_test_event
+		assert(stats.count == 2)
+		assert(stats.total_seconds >= stats.max_seconds)
+
+		sim:set_event_stats_enabled(false)
+		assert(sim:get_event_stats() == nil)
+	end,
+	system_timing = function()
+		local SlowSys = Sim.Sys.new_metatable("slow")
+		function SlowSys:on_test_event()
+			local sum = 0
+			for i = 1, 100000 do
+				sum = sum + i
+			end
+			self.sum = sum
+		end
+		local inner_sim = Sim.Sim.new()
+		inner_sim:require(SlowSys)
+		inner_sim:start()
+
+		-- the outer system's time includes the nested broadcast, but its self time does not
+		local OuterSys = Sim.Sys.new_metatable("outer")
+		function OuterSys:on_test_event()
+			inner_sim:broadcast("on_test_event")
+		end
+		local FastSys = Sim.Sys.new_metatable("fast")
+		FastSys.on_test_event = function() end
+		local sim = Sim.Sim.new()
+		sim:require(OuterSys)
+		sim:require(FastSys)
+		sim:start()
+
+		sim:broadcast("on_test_event")
+		assert(Sim.take_slowest_system() == nil)
+
+		Sim.set_system_timing_enabled(true)
+		sim:broadcast("on_test_event")
+		Sim.set_system_timing_enabled(true)
+		local slowest, slowest_ns = Sim.take_slowest_system()
+		assert(slowest == "outer:on_test_event > slow:on_test_event")
+		assert(slowest_ns > 0)
+		assert(Sim.take_slowest_system() == nil)
+
+		Sim.set_system_timing_enabled(false)
+		sim:broadcast("on_test_event")
+		assert(Sim.take_slowest_system() == nil)
+	end,
+	profile_trace = function()
+		-- needs the native client, and must not clobber a trace already in progress
+		if rawget(_G, "odClientWrapper") == nil or Debugging.get_profile_tracing() then
+			return
+		end
+
+		local TestSys = Sim.Sys.new_metatable("test")
+		TestSys.on_test_event = function() end
+
+		local sim = Sim.Sim.new()
+		sim:require(TestSys)
+		sim:start()
+
+		local filename = "engine_sim_profile_trace.json"
+		assert(Debugging.begin_profile_trace(filename, 1000))
+		sim:broadcast("on_test_event")
+		sim:broadcast_pcall("on_test_event")
+		assert(Debugging.end_profile_trace())
+		assert(not Debugging.end_profile_trace())
+
+		local zone_count, heap_count = 0, 0
+		for _, event in ipairs(Serialization.load_file(filename).traceEvents) do
+			if event.name == "test.on_test_event" then
+				assert(event.ph == "X" and event.dur >= 0)
+				zone_count = zone_count + 1
+			elseif event.name == "lua_heap_kb" then
+				assert(event.ph == "C" and event.args.value > 0)
+				heap_count = heap_count + 1
+			end
+		end
+		assert(zone_count == 2)
+		assert(heap_count == 2)
+
+		os.remove(filename)
+	end,
 	step = function()
 		local TestSys = Sim.Sys.new_metatable("test")
 
@@ -484,6 +776,62 @@ Sim.tests = Testing.add_suite("engine.sim", {
 			sim:stop()
 		end)
 	end,
+	check_state = function()
+		local TestSys = Sim.Sys.new_metatable("test")
+		local checks = {}
+		function TestSys:on_check_state(is_full)
+			checks[#checks + 1] = is_full
+		end
+
+		local sim = Sim.Sim.new()
+		sim:require(TestSys)
+		sim.full_check_step_period = 2
+		sim:start()
+
+		sim:check_state(true)
+		sim:check_state(false)
+		Container.assert_equal(checks, {true, false})
+
+		-- steps check incrementally, with a full check every full_check_step_period steps
+		if expensive_debug_checks_enabled then
+			checks = {}
+			local expected = {}
+			for i = 1, 4 do
+				sim:step()
+				expected[i] = (sim.step_id % 2) == 0
+			end
+			Container.assert_equal(checks, expected)
+		end
+
+		sim:finalize()
+	end,
+})
+
+Sim.benchmarks = Testing.add_benchmark_suite("engine.sim", {
+	broadcast = function(run)
+		local ListenerSys = Sim.Sys.new_metatable("benchmark_listener")
+		function ListenerSys:on_init()
+			self.event_count = 0
+		end
+		function ListenerSys:on_benchmark_event(x, y)
+			self.event_count = self.event_count + x + y
+		end
+
+		local sim = Sim.Sim.new()
+		local listener_sys = sim:require(ListenerSys)
+		sim:start()
+
+		local broadcast_count = 10000
+		while run:next() do
+			for _ = 1, broadcast_count do
+				sim:broadcast("on_benchmark_event", 1, 0)
+			end
+		end
+		assert(listener_sys.event_count == broadcast_count * (run.warmup_count + run.sample_count))
+
+		sim:stop()
+		sim:finalize()
+	end,
 })
 
 return Sim
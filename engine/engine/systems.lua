@@ -1,12 +1,14 @@
 local Systems = {}
 
 Systems.Animation = require("engine/engine/animation")
+Systems.Autosave = require("engine/engine/autosave")
 Systems.Camera = require("engine/engine/camera")
 Systems.CameraTarget = require("engine/engine/camera_target")
 Systems.Client = require("engine/engine/client")
 Systems.Controller = require("engine/engine/controller")
 Systems.Debug = require("engine/engine/debug")
 Systems.Entity = require("engine/engine/entity")
+Systems.History = require("engine/engine/history")
 Systems.Image = require("engine/engine/image")
 Systems.Text = require("engine/engine/text")
 Systems.Template = require("engine/engine/template")
@@ -27,7 +27,7 @@ Template.WorldSys.State.defaults = {
 }
 Template.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
 	state = Template.WorldSys.State.Schema,
-	_entity = Entity.WorldSys.Schema,
+	_entity = Entity.WorldSys.ShallowSchema,
 })
 function Template.WorldSys:set(template_name, template)
 	if debug_checks_enabled then
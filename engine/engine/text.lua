@@ -80,9 +80,10 @@ Text.WorldSys.State.defaults = {
 Text.WorldSys.Schema = Schema.AllOf(World.Sys.Schema, Schema.PartialObject{
 	state = Text.WorldSys.State.Schema,
 	_client_world = Client.WorldSys.Schema,
-	_entity_world = Entity.WorldSys.Schema,
+	_entity_world = Entity.WorldSys.ShallowSchema,
 	_image_world = Image.WorldSys.Schema,
 	_ascii_fonts = Schema.Mapping(Schema.LabelString, Client.Wrappers.Schema("AsciiFont")),
+	_tagged_ids = Schema.Array(Schema.PositiveInteger),
 })
 local font_image_name_template = "font_%s"
 function Text.WorldSys:draw(font_name, text, x, y, max_width, max_height, r, g, b, a, z)
@@ -228,6 +229,7 @@ function Text.WorldSys:on_init()
 	self._entity_world = self.sim:require(Entity.WorldSys)
 	self._image_world = self.sim:require(Image.WorldSys)
 	self._ascii_fonts = {}
+	self._tagged_ids = {}
 
 	self:font_index_all()
 
@@ -244,13 +246,13 @@ function Text.WorldSys:on_draw()
 		assert(self.sim.status == Sim.Status.started)
 	end
 
-	local text_entities = self._entity_world:get_all_tagged_array(self.tag)
-
 	if expensive_debug_checks_enabled then
-		assert(Schema.Array(Text.Entity.Schema)(text_entities))
+		assert(Schema.Array(Text.Entity.Schema)(self._entity_world:get_all_tagged_array(self.tag)))
 	end
 
-	for _, entity in ipairs(self._entity_world:get_all_tagged_array(self.tag)) do
+	local entities = self._entity_world:get_all_raw()
+	for _, entity_id in ipairs(self._entity_world:get_all_tagged_ids(self.tag, self._tagged_ids)) do
+		local entity = entities[entity_id]
 		if entity.text ~= nil then
 			self:draw(
 				entity.font_name or self.font_default_name,
@@ -1,8 +1,8 @@
-local json = require("engine/lib/json/json")
 local Debugging = require("engine/core/debugging")
 local Logging = require("engine/core/logging")
 local Schema = require("engine/core/schema")
 local Container = require("engine/core/container")
+local Serialization = require("engine/core/serialization")
 local Testing = require("engine/core/testing")
 local Sim = require("engine/engine/sim")
 local Game = require("engine/engine/game")
@@ -65,17 +65,15 @@ World.GameSys.State.defaults = {}
 World.GameSys.Schema = Schema.AllOf(Game.Sys.Schema, Schema.PartialObject{
 	state = World.GameSys.State.Schema,
 	_world_systems = Schema.Array(World.Sys.MetatableSchema),
+	_step_count = Schema.NonNegativeInteger,
 })
 function World.GameSys:load(filename)
-	local file, err = io.open(filename, "r")
-	if file == nil then
-		Logging.error("failed to open save file for reading, filename=%s, err=%s", filename, err)
+	local loaded_state, err = Serialization.load_file(filename)
+	if loaded_state == nil then
+		Logging.error("failed to read save file, filename=%s, err=%s", filename, err)
 		return
 	end
-	local state_json = file:read("*a")
-	file:close()
 
-	local loaded_state = json.decode(state_json)
 	local state = {}
 	Container.update(state, loaded_state)
 
@@ -159,6 +157,21 @@ function World.GameSys:set(world)
 		assert(World.World.Schema(world))
 	end
 end
+-- starts a new world from self.state, reusing the previous world's state tables where possible
+-- so the cost scales with what changed since the last start, rather than with the whole state
+function World.GameSys:restart()
+	local previous_world = self.world
+	self:reset()
+
+	local state
+	if previous_world ~= nil and previous_world.state ~= self.state then
+		state = Serialization.restore(previous_world.state, self.state)
+	else
+		state = Serialization.copy(self.state)
+	end
+
+	self:set(self:new_world(state))
+end
 function World.GameSys:require_world_sys(sys_metatable)
 	if debug_checks_enabled then
 		if expensive_debug_checks_enabled then
@@ -171,24 +184,34 @@ function World.GameSys:require_world_sys(sys_metatable)
 
 	self._world_systems[#self._world_systems + 1] = sys_metatable
 end
+function World.GameSys:set_step_count(step_count)
+	if debug_checks_enabled then
+		assert(Schema.NonNegativeInteger(step_count))
+	end
+
+	self._step_count = step_count
+end
 function World.GameSys:on_init()
 	Container.set_defaults(self.state, World.GameSys.State.defaults)
 
 	self._world_systems = {}
+	self._step_count = 1
 
 	if expensive_debug_checks_enabled then
 		assert(World.GameSys.State.Schema(self.state))
 	end
 end
 function World.GameSys:on_step()
-	if self.world == nil or self.world.stopping == true or self.world.status == Sim.Status.finalized then
-		self:set(self:new_world(Container.deep_copy(self.state)))
-	end
+	for _ = 1, self._step_count do
+		if self.world == nil or self.world.stopping == true or self.world.status == Sim.Status.finalized then
+			self:restart()
+		end
 
-	self.world:step()
+		self.world:step()
+	end
 end
 function World.GameSys:on_start_begin()
-	self:set(self:new_world(Container.deep_copy(self.state)))
+	self:restart()
 end
 
 World.tests = Testing.add_suite("engine.world", {
@@ -210,7 +233,58 @@ World.tests = Testing.add_suite("engine.world", {
 		world_game:set(world_game:new_world())
 		game:step()
 		game:finalize()
-	end
+	end,
+	step_count = function()
+		local step_count = 0
+		local TestSys = World.Sys.new_metatable("test_step_count")
+		function TestSys:on_step()
+			step_count = step_count + 1
+		end
+
+		local game = Game.Game.new()
+		local world_game = game:require(World.GameSys)
+		world_game:require_world_sys(TestSys)
+		game:start()
+
+		world_game:set_step_count(3)
+		game:step()
+		assert(step_count == 3)
+
+		world_game:set_step_count(0)
+		game:step()
+		assert(step_count == 3)
+
+		game:finalize()
+	end,
+	restart = function()
+		local TestSys = World.Sys.new_metatable("test_restart")
+		function TestSys:on_step()
+			self.state.items[#self.state.items + 1] = {step = true}
+			self.state.count = self.state.count + 1
+		end
+
+		local game = Game.Game.new({world = {test_restart = {count = 0, items = {{initial = true}}}}})
+		local world_game = game:require(World.GameSys)
+		world_game:require_world_sys(TestSys)
+		game:start()
+		game:step()
+
+		local world = world_game.world
+		local items = world.state.test_restart.items
+		assert(world.state.test_restart.count == 1)
+		assert(#items == 2)
+
+		world:stop()
+		game:step()
+		assert(world_game.world ~= world)
+		assert(world_game.world.state.test_restart.count == 1)
+		assert(world_game.world.state.test_restart.items == items)
+		assert(#items == 2 and items[1].initial and items[2].step)
+		assert(world_game.state.test_restart.count == 0)
+		assert(#world_game.state.test_restart.items == 1)
+
+		game:finalize()
+	end,
 })
 
 return World
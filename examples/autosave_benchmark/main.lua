@@ -0,0 +1,83 @@
+local Logging = require("engine/core/logging")
+local World = require("engine/engine/world")
+local Entity = require("engine/engine/entity")
+local Autosave = require("engine/engine/autosave")
+
+local entity_count = 20000
+local changed_entity_count = 100
+local save_count = 100
+local filename = "autosave_benchmark.log"
+local full_filename = "autosave_benchmark.save"
+local grid_size = 8
+
+local function get_stats_str(times)
+	table.sort(times)
+	local total = 0
+	for _, time in ipairs(times) do
+		total = total + time
+	end
+	return string.format(
+		"mean %.2fms, max %.2fms", (total / #times) * 1e3, times[#times] * 1e3)
+end
+
+local BenchmarkWorld = World.Sys.new_metatable("autosave_benchmark")
+function BenchmarkWorld:on_init()
+	self._entity_world = self.sim:require(Entity.WorldSys)
+	self._autosave_world = self.sim:require(Autosave.WorldSys)
+end
+function BenchmarkWorld:on_start()
+	for i = 1, entity_count do
+		self._entity_world:add{
+			x = (i * grid_size) % 1024,
+			y = math.floor((i * grid_size) / 1024) * grid_size,
+			width = grid_size,
+			height = grid_size,
+			tags = {benchmark = true},
+		}
+	end
+end
+function BenchmarkWorld:on_step()
+	local sim = self.sim
+	local entity_world = self._entity_world
+	local autosave_world = self._autosave_world
+
+	local full_times = {}
+	local delta_times = {}
+	local compact_times = {}
+	for _ = 1, save_count do
+		for _ = 1, changed_entity_count do
+			local entity_id = math.random(entity_count)
+			local entity = entity_world:find(entity_id)
+			entity_world:set_pos(entity_id, entity.x + 1, entity.y, entity)
+		end
+
+		local start_time = os.clock()
+		assert(sim:save(full_filename))
+		full_times[#full_times + 1] = os.clock() - start_time
+
+		local is_compacting = autosave_world._compact_next_id ~= nil
+		start_time = os.clock()
+		autosave_world:save()
+		local times = is_compacting and compact_times or delta_times
+		times[#times + 1] = os.clock() - start_time
+	end
+
+	local loaded = Autosave.load_file(filename)
+	for entity_id, entity in ipairs(entity_world.state.entities) do
+		assert(loaded.entity.entities[entity_id].x == entity.x)
+	end
+	os.remove(filename)
+	os.remove(full_filename)
+
+	Logging.info("full save x%d entities: %s", entity_count, get_stats_str(full_times))
+	Logging.info("autosave delta x%d changes: %s", changed_entity_count, get_stats_str(delta_times))
+	Logging.info(
+		"autosave compacting x%d entities per save: %s",
+		autosave_world.state.compact_chunk_size, get_stats_str(compact_times))
+
+	sim:stop()
+end
+
+local world = World.World.new(nil, {autosave = {filename = filename}})
+world:require(BenchmarkWorld)
+world:run()
@@ -0,0 +1,69 @@
+local Logging = require("engine/core/logging")
+local Game = require("engine/engine/game")
+local World = require("engine/engine/world")
+local Client = require("engine/engine/client")
+local Entity = require("engine/engine/entity")
+local Image = require("engine/engine/image")
+
+local entity_count = 2000
+local step_count = 1000
+local sprites_filename = "./examples/engine_test/data/sprites.png"
+local grid_size = 8
+
+local BenchmarkWorld = World.Sys.new_metatable("headless_benchmark")
+function BenchmarkWorld:on_init()
+	self._entity_world = self.sim:require(Entity.WorldSys)
+	self._image_world = self.sim:require(Image.WorldSys)
+	self._entity_ids = {}
+end
+function BenchmarkWorld:on_start()
+	self._image_world:set_batch({wall = {16, 24}}, sprites_filename, Image.FileType.png, grid_size)
+
+	for i = 1, entity_count do
+		local entity_id = self._entity_world:add{
+			x = (i * grid_size) % 256,
+			y = math.floor((i * grid_size) / 256) * grid_size,
+			width = grid_size,
+			height = grid_size,
+		}
+		self._image_world:entity_set(entity_id, "wall")
+		self._entity_ids[#self._entity_ids + 1] = entity_id
+	end
+end
+function BenchmarkWorld:on_step()
+	local entity_world = self._entity_world
+	for _, entity_id in ipairs(self._entity_ids) do
+		local entity = entity_world:find(entity_id)
+		entity_world:set_pos(entity_id, (entity.x + 1) % 256, entity.y, entity)
+	end
+end
+
+local BenchmarkGame = Game.Sys.new_metatable("headless_benchmark")
+function BenchmarkGame:on_init()
+	self._step_count = 0
+end
+function BenchmarkGame:on_start()
+	self._start_time = os.clock()
+end
+function BenchmarkGame:on_step()
+	self._step_count = self._step_count + 1
+	if self._step_count < step_count then
+		return
+	end
+
+	local elapsed_seconds = os.clock() - self._start_time
+	Logging.info(
+		"headless x%d steps, %d entities: %.3fs, %.1f steps/s, %.3fms per step",
+		self._step_count, entity_count, elapsed_seconds,
+		self._step_count / elapsed_seconds, (elapsed_seconds / self._step_count) * 1e3)
+
+	self.sim:stop()
+end
+
+local game = Game.Game.new({client = {headless = true, visible = false}})
+game:require(Client.GameSys)
+game:require(Image.GameSys)
+game:require(Entity.GameSys)
+game:require(World.GameSys):require_world_sys(BenchmarkWorld)
+game:require(BenchmarkGame)
+game:run()
@@ -0,0 +1,87 @@
+local Logging = require("engine/core/logging")
+local Game = require("engine/engine/game")
+local World = require("engine/engine/world")
+local Controller = require("engine/engine/controller")
+local Entity = require("engine/engine/entity")
+local History = require("engine/engine/history")
+
+local step_count = 60 * 60 * 60  -- an hour at 60 steps per second
+local entity_count = 1000
+local seek_count = 20
+local grid_size = 8
+
+local PlayerWorld = World.Sys.new_metatable("history_benchmark_player")
+function PlayerWorld:on_init()
+	self._controller_world = self.sim:require(Controller.WorldSys)
+	self._entity_world = self.sim:require(Entity.WorldSys)
+end
+function PlayerWorld:on_start()
+	if #self._entity_world.state.entities > 0 then
+		return
+	end
+	for i = 1, entity_count do
+		self._entity_world:add{x = i * grid_size, y = 0, width = grid_size, height = grid_size}
+	end
+end
+function PlayerWorld:on_step()
+	local controller_world = self._controller_world
+	local dir_x, dir_y = controller_world:get_dirs(controller_world.default_id)
+	if dir_x ~= 0 or dir_y ~= 0 then
+		local entity_id = (self.sim.step_id % entity_count) + 1
+		local entity = self._entity_world:find(entity_id)
+		self._entity_world:set_pos(entity_id, entity.x + dir_x, entity.y + dir_y, entity)
+	end
+end
+
+local function main()
+	local game = Game.Game.new({history = {enabled = true, snapshot_period = 600}})
+	local controller_game = game:require(Controller.GameSys)
+	local world_game = game:require(World.GameSys)
+	world_game:require_world_sys(PlayerWorld)
+	local history_game = game:require(History.GameSys)
+	game:start()
+
+	local bindings = controller_game.state.bindings.controllers[Controller.Controller.default_id].inputs
+	local right_binding = {type = "virtual", virtual_value = false}
+	local down_binding = {type = "virtual", virtual_value = false}
+	bindings[Controller.InputName.right].bindings = {right_binding}
+	bindings[Controller.InputName.down].bindings = {down_binding}
+
+	-- inputs change every half second or so, as when playing
+	math.randomseed(1)
+	local start_time = os.clock()
+	for _ = 1, step_count do
+		if math.random(30) == 1 then
+			right_binding.virtual_value = not right_binding.virtual_value
+		end
+		if math.random(30) == 1 then
+			down_binding.virtual_value = not down_binding.virtual_value
+		end
+		game:step()
+	end
+	local record_seconds = os.clock() - start_time
+
+	local stats = history_game:get_stats()
+	Logging.info(
+		"recorded x%d steps: %.1fus per step, %d runs, %d snapshots, %.1fKiB of snapshots",
+		stats.step_count, (record_seconds / step_count) * 1e6, stats.run_count, stats.snapshot_count,
+		stats.snapshot_size / 1024)
+
+	local first_step_id, last_step_id = history_game:get_step_id_range()
+	local seek_seconds = 0
+	local max_seek_seconds = 0
+	for _ = 1, seek_count do
+		local step_id = math.random(first_step_id, last_step_id)
+		start_time = os.clock()
+		assert(history_game:seek(step_id))
+		local elapsed_seconds = os.clock() - start_time
+		seek_seconds = seek_seconds + elapsed_seconds
+		max_seek_seconds = math.max(max_seek_seconds, elapsed_seconds)
+	end
+	Logging.info(
+		"seek x%d: mean %.1fms, max %.1fms", seek_count, (seek_seconds / seek_count) * 1e3, max_seek_seconds * 1e3)
+
+	game:finalize()
+end
+
+main()
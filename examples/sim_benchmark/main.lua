@@ -0,0 +1,55 @@
+local Logging = require("engine/core/logging")
+local World = require("engine/engine/world")
+
+local broadcast_count = 1000000
+
+local ListenerWorld = World.Sys.new_metatable("sim_benchmark_listener")
+function ListenerWorld:on_init()
+	self.event_count = 0
+end
+function ListenerWorld:on_benchmark_event(x, y)
+	self.event_count = self.event_count + x + y
+end
+
+local BenchmarkWorld = World.Sys.new_metatable("sim_benchmark")
+function BenchmarkWorld:on_init()
+	self._listener_world = self.sim:require(ListenerWorld)
+end
+function BenchmarkWorld:on_step()
+	local sim = self.sim
+
+	collectgarbage("collect")
+	collectgarbage("stop")
+	local start_kb = collectgarbage("count")
+	local start_time = os.clock()
+
+	for _ = 1, broadcast_count do
+		sim:broadcast("on_benchmark_event", 1, 0)
+	end
+
+	local elapsed_seconds = os.clock() - start_time
+	local allocated_kb = collectgarbage("count") - start_kb
+	collectgarbage("restart")
+
+	assert(self._listener_world.event_count == broadcast_count)
+	Logging.info(
+		"broadcast x%d: %.3fs, %.1fns per broadcast, %.1fKiB allocated",
+		broadcast_count, elapsed_seconds, (elapsed_seconds / broadcast_count) * 1e9, allocated_kb)
+
+	sim:set_event_stats_enabled(true)
+	for _ = 1, broadcast_count do
+		sim:broadcast("on_benchmark_event", 1, 0)
+	end
+	local stats = sim:get_event_stats().on_benchmark_event
+	sim:set_event_stats_enabled(false)
+
+	Logging.info(
+		"broadcast x%d with event stats: %.3fs total, %.1fns mean, %.1fns max",
+		stats.count, stats.total_seconds, (stats.total_seconds / stats.count) * 1e9, stats.max_seconds * 1e9)
+
+	sim:stop()
+end
+
+local world = World.World.new()
+world:require(BenchmarkWorld)
+world:run()
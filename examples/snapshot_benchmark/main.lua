@@ -0,0 +1,63 @@
+local Logging = require("engine/core/logging")
+local Serialization = require("engine/core/serialization")
+local World = require("engine/engine/world")
+local Entity = require("engine/engine/entity")
+
+local entity_count = 20000
+local filename = "snapshot_benchmark.save"
+local grid_size = 8
+
+local BenchmarkWorld = World.Sys.new_metatable("snapshot_benchmark")
+function BenchmarkWorld:on_init()
+	self._entity_world = self.sim:require(Entity.WorldSys)
+end
+function BenchmarkWorld:on_start()
+	for i = 1, entity_count do
+		self._entity_world:add{
+			x = (i * grid_size) % 1024,
+			y = math.floor((i * grid_size) / 1024) * grid_size,
+			width = grid_size,
+			height = grid_size,
+			tags = {benchmark = true},
+		}
+	end
+end
+function BenchmarkWorld:benchmark(label)
+	local sim = self.sim
+
+	collectgarbage("collect")
+	local save_start_time = os.clock()
+	assert(sim:save(filename))
+	local save_seconds = os.clock() - save_start_time
+
+	local file = assert(io.open(filename, "rb"))
+	local size = file:seek("end")
+	file:close()
+
+	collectgarbage("collect")
+	local load_start_time = os.clock()
+	local loaded_state = assert(Serialization.load_file(filename))
+	local load_seconds = os.clock() - load_start_time
+	os.remove(filename)
+
+	assert(#loaded_state.entity.entities == #sim.state.entity.entities)
+	Logging.info(
+		"%s x%d entities: save %.1fms, load %.1fms, %.1fKiB",
+		label, entity_count, save_seconds * 1e3, load_seconds * 1e3, size / 1024)
+end
+function BenchmarkWorld:on_step()
+	local Snapshot = Serialization.Snapshot
+	if Snapshot ~= nil then
+		self:benchmark("snapshot")
+	end
+
+	Serialization.Snapshot = nil
+	self:benchmark("json")
+	Serialization.Snapshot = Snapshot
+
+	self.sim:stop()
+end
+
+local world = World.World.new()
+world:require(BenchmarkWorld)
+world:run()
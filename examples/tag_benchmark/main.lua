@@ -0,0 +1,79 @@
+local Logging = require("engine/core/logging")
+local World = require("engine/engine/world")
+local Entity = require("engine/engine/entity")
+
+local entity_count = 20000
+local tags = {"a", "b", "c", "d", "e", "f", "g", "h"}
+local iterations = 100
+local churn_count = 20000
+
+local BenchmarkWorld = World.Sys.new_metatable("tag_benchmark")
+function BenchmarkWorld:on_init()
+	self._entity_world = self.sim:require(Entity.WorldSys)
+	self._tagged_ids = {}
+end
+function BenchmarkWorld:on_start()
+	for i = 1, entity_count do
+		local entity_tags = {}
+		entity_tags[tags[(i % #tags) + 1]] = true
+		entity_tags[tags[((i * 7) % #tags) + 1]] = true
+		self._entity_world:add{x = i, y = 0, tags = entity_tags}
+	end
+end
+function BenchmarkWorld:benchmark(label, fn, count)
+	collectgarbage("collect")
+	local memory_before_kib = collectgarbage("count")
+	local start_time = os.clock()
+	local visited = fn()
+	local seconds = os.clock() - start_time
+	Logging.info(
+		"%s x%d: %.1fms total, %.1fns per op, %.1fKiB allocated, visited=%d",
+		label, count, seconds * 1e3, seconds * 1e9 / count, collectgarbage("count") - memory_before_kib, visited)
+end
+function BenchmarkWorld:on_step()
+	local entity_world = self._entity_world
+	local entities = entity_world:get_all_raw()
+
+	self:benchmark("iterate tagged ids", function()
+		local visited = 0
+		for _ = 1, iterations do
+			for _, tag in ipairs(tags) do
+				for _, entity_id in ipairs(entity_world:get_all_tagged_ids(tag, self._tagged_ids)) do
+					if entities[entity_id].x ~= nil then
+						visited = visited + 1
+					end
+				end
+			end
+		end
+		return visited
+	end, iterations * #tags)
+
+	self:benchmark("iterate tagged entities + find_id", function()
+		local visited = 0
+		for _ = 1, iterations do
+			for _, tag in ipairs(tags) do
+				for _, entity in ipairs(entity_world:get_all_tagged_array(tag)) do
+					if entity_world:find_id(entity) ~= nil then
+						visited = visited + 1
+					end
+				end
+			end
+		end
+		return visited
+	end, iterations * #tags)
+
+	self:benchmark("untag + tag", function()
+		for i = 1, churn_count do
+			local entity_id = (i % entity_count) + 1
+			entity_world:untag(entity_id, {"z"})
+			entity_world:tag(entity_id, {"z"})
+		end
+		return churn_count
+	end, churn_count)
+
+	self.sim:stop()
+end
+
+local world = World.World.new()
+world:require(BenchmarkWorld)
+world:run()
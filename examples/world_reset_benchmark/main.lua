@@ -0,0 +1,78 @@
+local Logging = require("engine/core/logging")
+local Container = require("engine/core/container")
+local Serialization = require("engine/core/serialization")
+local Game = require("engine/engine/game")
+local World = require("engine/engine/world")
+local Entity = require("engine/engine/entity")
+
+local entity_count = 20000
+local reset_count = 100
+local changed_entity_count = 100
+local grid_size = 8
+
+local function play(state)
+	local entities = state.entity.entities
+	for i = 1, changed_entity_count do
+		local entity = entities[math.random(#entities)]
+		entity.x = entity.x + grid_size
+	end
+end
+local function benchmark(label, fn)
+	local elapsed_seconds = 0
+	local allocated_kb = 0
+	for _ = 1, reset_count do
+		collectgarbage("collect")
+		collectgarbage("stop")
+		local start_kb = collectgarbage("count")
+		local start_time = os.clock()
+
+		fn()
+
+		elapsed_seconds = elapsed_seconds + (os.clock() - start_time)
+		allocated_kb = allocated_kb + (collectgarbage("count") - start_kb)
+		collectgarbage("restart")
+	end
+
+	Logging.info(
+		"%s x%d: %.2fms per reset, %.1fKiB allocated per reset",
+		label, reset_count, (elapsed_seconds / reset_count) * 1e3, allocated_kb / reset_count)
+end
+
+local function main()
+	local entities = {}
+	for i = 1, entity_count do
+		entities[i] = {
+			x = (i * grid_size) % 1024,
+			y = math.floor((i * grid_size) / 1024) * grid_size,
+			width = grid_size,
+			height = grid_size,
+			tags = {benchmark = true},
+		}
+	end
+
+	local game = Game.Game.new({world = {entity = {entities = entities}}})
+	local world_game = game:require(World.GameSys)
+	world_game:require_world_sys(Entity.WorldSys)
+	game:start()
+
+	local template = world_game.state
+	local state = Container.deep_copy(template)
+	benchmark("state deep_copy", function()
+		play(state)
+		state = Container.deep_copy(template)
+	end)
+	benchmark("state restore", function()
+		play(state)
+		Serialization.restore(state, template)
+	end)
+	Container.assert_equal(state, template)
+
+	benchmark("world restart", function()
+		play(world_game.world.state)
+		world_game:restart()
+	end)
+
+	game:finalize()
+end
+
+main()
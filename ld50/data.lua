@@ -1,4 +1,3 @@
-local json = require("engine/lib/json/json")
 local Engine = require("engine/engine")
 local Core = Engine.Core
 
@@ -237,7 +236,7 @@ function Data.WorldSys:load_tilemap(src_filename, tileset)
 	local tilemap_json = file:read("*a")
 	file:close()
 
-	local tilemap = json.decode(tilemap_json)
+	local tilemap = Core.Serialization.Json.decode(tilemap_json)
 	assert(tilemap.tilewidth == tileset.tile_width)
 	assert(tilemap.tileheight == tileset.tile_height)
 	assert(tilemap.orientation == "orthogonal")
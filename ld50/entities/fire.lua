@@ -17,24 +17,30 @@ function Fire.GameSys.WorldSys:on_init()
 
 	self._entity = self.sim:require(Engine.Entity.WorldSys)
 	self._template = self.sim:require(Engine.Template.WorldSys)
+	self._tagged_ids = {}
 end
 function Fire.GameSys.WorldSys:on_step()
-	for _, entity in ipairs(self._entity:get_all_tagged_array(self.sys_name)) do
-		local entity_id = self._entity:find_id(entity)
+	local entities = self._entity:get_all_raw()
+	for _, entity_id in ipairs(self._entity:get_all_tagged_ids(self.sys_name, self._tagged_ids)) do
+		local entity = entities[entity_id]
+		local entity_tags = entity.tags
 
-		if self.state.is_raining then
-			self._template:instantiate("wood", {
-				x = entity.x, y = entity.y, z = entity.z, tags = {wood_spawn = false},
-			})
-			self._template:instantiate("rock", {
-				x = entity.x, y = entity.y, z = entity.z, tags = {rock_spawn = false},
-			})
-			self._entity:destroy(entity_id)
-		elseif self.state.turn_id - (entity.turn_id or 0) >= self.state.fire_burn_length then
-			self._template:instantiate("rock", {
-				x = entity.x, y = entity.y, z = entity.z, tags = {rock_spawn = false},
-			})
-			self._entity:destroy(entity_id)
+		-- skip fires destroyed (and maybe reused) since the ids were taken
+		if entity_tags ~= nil and entity_tags[self.sys_name] then
+			if self.state.is_raining then
+				self._template:instantiate("wood", {
+					x = entity.x, y = entity.y, z = entity.z, tags = {wood_spawn = false},
+				})
+				self._template:instantiate("rock", {
+					x = entity.x, y = entity.y, z = entity.z, tags = {rock_spawn = false},
+				})
+				self._entity:destroy(entity_id)
+			elseif self.state.turn_id - (entity.turn_id or 0) >= self.state.fire_burn_length then
+				self._template:instantiate("rock", {
+					x = entity.x, y = entity.y, z = entity.z, tags = {rock_spawn = false},
+				})
+				self._entity:destroy(entity_id)
+			end
 		end
 	end
 end
@@ -838,6 +838,7 @@ function Player.WorldSys:on_init()
 	self._controller = self.sim:require(Engine.Controller.WorldSys)
 	self._client = self.sim:require(Engine.Client.WorldSys)
 	self._camera = self.sim:require(Engine.Camera.WorldSys)
+	self._tagged_ids = {}
 
 	self._entity:tag_bounds_index_add({self.sys_name, "solid"})
 	self._template:update("player", {
@@ -879,10 +880,14 @@ function Player.WorldSys:on_step()
 	end
 
 	local is_turn = false
-	for _, entity in ipairs(self._entity:get_all_tagged_array(self.sys_name)) do
-		local entity_id = self._entity:find_id(entity)
-
-		if self._entity:find_relative(entity_id, move_x, move_y, {"solid"}) == nil then
+	local entities = self._entity:get_all_raw()
+	for _, entity_id in ipairs(self._entity:get_all_tagged_ids(self.sys_name, self._tagged_ids)) do
+		local entity = entities[entity_id]
+		local entity_tags = entity.tags
+
+		-- skip players destroyed (and maybe reused) since the ids were taken
+		if entity_tags ~= nil and entity_tags[self.sys_name]
+			and self._entity:find_relative(entity_id, move_x, move_y, {"solid"}) == nil then
 			if (move_x ~= 0) or (move_y ~= 0) then
 				local base_image_name = "player"
 				if move_x > 0 or (move_x == 0 and entity.day_image_name == "player_right") then
@@ -13,7 +13,13 @@ local function main()
 		world = {client = {width = 128, height = 96}},
 	}
 
-	-- local game_save = "game.save.json"
+	-- decoded while the game loads, then shared by each world's audio through the cache
+	Engine.Client.Wrappers.Audio.preload_files{
+		filenames = {'./ld50/data/menu_navigate.wav'},
+		background = true,
+	}
+
+	-- local game_save = "game.save"
 	local game = Engine.Game.Game.new(state)
 	-- game:load(game_save)
 
@@ -40,7 +46,7 @@ local function main()
 	-- game:save(game_save)
 
 	if debug_checks_enabled then
-		game._world:save("world.save.json")
+		game._world:save("world.save")
 	end
 end
 
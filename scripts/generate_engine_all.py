@@ -26,6 +26,11 @@ def main():
         "--entrypoint", type=str, default=None)
     arg_parser.add_argument(
         "--debugger", action=argparse.BooleanOptionalAction, default=True)
+    arg_parser.add_argument(
+        "--benchmark", action=argparse.BooleanOptionalAction, default=False,
+        help="run benchmarks instead of tests, without debug checks")
+    arg_parser.add_argument(
+        "--benchmark-json", type=str, default=None)
 
     args = arg_parser.parse_args()
 
@@ -34,19 +39,28 @@ def main():
     entrypoint = (f'require("{to_lua_path(pathlib.Path(args.entrypoint))}")'
                   if args.entrypoint else "-- entrypoint")
 
+    run_all = 'require("engine/core/testing").run_all()'
+    if args.benchmark:
+        json_filename = (f'"{pathlib.Path(args.benchmark_json).as_posix()}"'
+                         if args.benchmark_json else "nil")
+        run_all = ('assert(require("engine/core/testing").run_all_benchmarks'
+                   f'{{json_filename = {json_filename}}} ~= nil)')
+    # debug checks and the debugger hook would dominate benchmark timings
+    debug_enabled = "false" if args.benchmark else "true"
+
     paths = pathlib.Path('engine').glob('**/*.lua')
     requires = '\n\t'.join(f"require('{to_lua_path(path)}')" for path in paths)
 
     lua_script = (
         f"local function main()\n"
         f'\t{requires}\n'
-        f'\trequire("engine/core/testing").run_all()\n'
+        f'\t{run_all}\n'
         f"\t{entrypoint}\n"
         f"end\n"
         f'local Debugging = require("engine/core/debugging")\n'
-        f'Debugging.debug_checks_enabled = true\n'
+        f'Debugging.debug_checks_enabled = {debug_enabled}\n'
         f'Debugging.expensive_debug_checks_enabled = false\n'
-        f'Debugging.set_debugger_enabled(true)\n'
+        f'Debugging.set_debugger_enabled({debug_enabled})\n'
         f"{run_main}"
     )
 